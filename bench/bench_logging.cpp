@@ -0,0 +1,70 @@
+// Cost of a log line on the calling thread: a runtime-disabled LOG_DEBUG
+// with an expensive argument, the shared_ptr Logger::get() path it
+// replaces, an enabled LOG_INFO handed to the async worker, and a
+// LOG_TRACE compiled out by PMM_LOG_LEVEL.
+//
+// Usage: bench_logging [iterations]
+
+#include "utils/logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace pmm;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+size_t g_evaluations = 0;
+
+// Stands in for building a book summary or similar for a debug line
+std::string describeBook(size_t i) {
+    g_evaluations++;
+    std::string out;
+    for (int level = 0; level < 8; level++) {
+        out += std::to_string(0.40 + level * 0.01 + i * 1e-9);
+        out += ' ';
+    }
+    return out;
+}
+
+template<typename Fn>
+void run(const char* name, size_t iterations, Fn&& fn) {
+    g_evaluations = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        fn(i);
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    std::printf("%-18s n=%-10zu %.1f ns/call (%zu argument evaluations)\n",
+                name, iterations, ns / iterations, g_evaluations);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    Logger::init("./logs", "bench_logging");
+    Logger::get()->set_level(spdlog::level::info);
+    Logger::get()->sinks().front()->set_level(spdlog::level::warn);  // Keep the console quiet
+
+    run("debug_disabled", iterations, [](size_t i) {
+        LOG_DEBUG("book {}", describeBook(i));
+    });
+    run("debug_get_path", iterations, [](size_t i) {
+        Logger::get()->debug("book {}", describeBook(i));
+    });
+    run("trace_elided", iterations, [](size_t i) {
+        LOG_TRACE("book {}", describeBook(i));
+    });
+    // Fewer lines so the queue is not simply overwriting itself
+    run("info_async", iterations / 100, [](size_t i) {
+        LOG_INFO("tick {} mid {:.4f}", i, 0.45 + i * 1e-6);
+    });
+
+    Logger::shutdown();
+    return 0;
+}
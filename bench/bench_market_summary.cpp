@@ -0,0 +1,78 @@
+// Cost of one MarketSummaryLogger::logSummaries pass with every market's
+// rolling windows full, and of an updateMarket call on the strategy
+// thread once they are.
+//
+// Usage: bench_market_summary [markets] [passes]
+
+#include "utils/market_summary_logger.hpp"
+#include "utils/logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace pmm;
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char** argv) {
+    size_t markets = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    size_t passes = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 20;
+
+    Logger::init("./logs", "bench_market_summary");
+    Logger::get()->set_level(spdlog::level::warn);
+
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "pmm_bench_market_summary";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    MarketSummaryLogger summaries(dir);
+
+    std::vector<TokenId> tokens;
+    for (size_t m = 0; m < markets; m++) {
+        tokens.push_back("TOKEN_" + std::to_string(m));
+    }
+
+    // Producer-side cost only: updates go in bursts that fit the sample
+    // queue, and the analytics thread catches up between bursts
+    constexpr size_t BURST = MarketSummaryLogger::SAMPLE_QUEUE_CAPACITY / 2;
+    double update_ns = 0.0;
+    auto fillWindows = [&](size_t round) {
+        update_ns = 0.0;
+        size_t in_burst = 0;
+        auto start = Clock::now();
+        for (size_t i = 0; i < RollingWindow::MAX_SAMPLES; i++) {
+            for (size_t m = 0; m < markets; m++) {
+                double bid = 0.40 + ((i + m + round) % 17) * 0.001;
+                summaries.updateMarket("Market", "MARKET_ID", "0xCOND", tokens[m], bid + 0.005, 250.0,
+                                       bid, bid + 0.01, 1000.0 + i % 13, 800.0 + m % 7, 5, 4);
+                if (++in_burst == BURST) {
+                    update_ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                    summaries.flush();
+                    in_burst = 0;
+                    start = Clock::now();
+                }
+            }
+        }
+        update_ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        summaries.flush();
+    };
+    // The first round creates each market's state; time the second
+    fillWindows(0);
+    size_t updates = RollingWindow::MAX_SAMPLES * markets;
+    fillWindows(1);
+
+    auto start = Clock::now();
+    for (size_t p = 0; p < passes; p++) {
+        summaries.logSummaries();
+    }
+    double pass_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::printf("%-18s n=%-10zu %.1f ns/update (%llu dropped)\n", "update_market", updates, update_ns / updates,
+                static_cast<unsigned long long>(summaries.droppedSamples()));
+    std::printf("%-18s n=%-10zu %.2f ms/pass (%zu markets)\n", "log_summaries", passes, pass_ms / passes, markets);
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
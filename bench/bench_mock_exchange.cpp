@@ -0,0 +1,150 @@
+// End-to-end latency and throughput against the local mock exchange.
+//
+//   order_round_trip : OrderGateway -> mock order entry -> ack event
+//   tick_to_order    : mock feed tick -> WebSocket client -> StrategyEngine
+//                      -> OrderGateway -> order arriving at the mock
+//
+// Usage: bench_mock_exchange [orders] [ticks]
+
+#include "core/event_queue.hpp"
+#include "network/order_gateway.hpp"
+#include "network/websocket_client.hpp"
+#include "sim/mock_exchange.hpp"
+#include "strategy/strategy_engine.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace pmm;
+using Clock = std::chrono::steady_clock;
+
+static void printLatencies(const char* name, std::vector<double> micros) {
+    if (micros.empty()) {
+        std::printf("%-18s no samples\n", name);
+        return;
+    }
+    std::sort(micros.begin(), micros.end());
+    auto pct = [&](double p) { return micros[static_cast<size_t>(p * (micros.size() - 1))]; };
+    std::printf("%-18s n=%-6zu p50=%8.1fus p90=%8.1fus p99=%8.1fus max=%8.1fus\n",
+                name, micros.size(), pct(0.50), pct(0.90), pct(0.99), micros.back());
+}
+
+static void benchOrderRoundTrip(size_t orders) {
+    MockExchange exchange;
+    exchange.start();
+
+    EventQueue queue;
+    OrderGateway gateway(queue, exchange.gatewayConfig());
+    gateway.start();
+
+    // Resting orders far from the touch so nothing matches
+    std::vector<Clock::time_point> submitted(orders + 1);
+    std::vector<double> round_trips;
+    round_trips.reserve(orders);
+
+    auto start = Clock::now();
+    size_t acked = 0;
+    for (OrderId id = 1; id <= orders; id++) {
+        GatewayCommand command;
+        command.order_id = id;
+        command.token_id = "BENCH";
+        command.side = (id % 2) ? Side::BUY : Side::SELL;
+        command.price = (id % 2) ? 0.10 : 0.90;
+        command.size = 1.0;
+        submitted[id] = Clock::now();
+        while (!gateway.submit(command)) {
+            std::this_thread::yield();
+        }
+
+        Event event;
+        while (queue.tryPop(event)) {
+            if (event.type == EventType::ORDER_ACKED) {
+                OrderId acked_id = std::get<OrderAckedPayload>(event.payload).order_id;
+                round_trips.push_back(std::chrono::duration<double, std::micro>(Clock::now() - submitted[acked_id]).count());
+                acked++;
+            }
+        }
+    }
+    while (acked < orders) {
+        Event event = queue.pop();
+        if (event.type == EventType::ORDER_ACKED) {
+            OrderId acked_id = std::get<OrderAckedPayload>(event.payload).order_id;
+            round_trips.push_back(std::chrono::duration<double, std::micro>(Clock::now() - submitted[acked_id]).count());
+            acked++;
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    gateway.stop();
+    exchange.stop();
+
+    printLatencies("order_round_trip", round_trips);
+    std::printf("%-18s %.0f orders/s over %llu requests\n", "throughput",
+                orders / seconds, static_cast<unsigned long long>(gateway.requestsSent()));
+}
+
+static void benchTickToOrder(size_t ticks) {
+    MockExchange exchange;
+    exchange.start();
+    const TokenId token = "71321045679252212594626385532706912750332728571942532289631379312455583992563";
+    exchange.setBook(token, {{0.45, 100.0}}, {{0.55, 100.0}});
+
+    EventQueue queue;
+    OrderGateway gateway(queue, exchange.gatewayConfig());
+    gateway.start();
+
+    StrategyEngine strategy(queue, TradingMode::LIVE);
+    strategy.setOrderGateway(&gateway);
+    strategy.registerMarket(token, "Bench", "Yes", "bench-market", "bench-condition");
+    strategy.start();
+
+    PolymarketWebSocketClient client(queue, exchange.wsUrl());
+    client.connect();
+    client.subscribe({token});
+
+    // Let the initial snapshot produce the first quotes
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    Scenario walk = Scenario::randomWalk(token, 0.50, 0.10, ticks, std::chrono::microseconds(0));
+    std::vector<double> latencies;
+    latencies.reserve(ticks);
+
+    for (const ScenarioStep& step : walk.steps()) {
+        uint64_t before = exchange.ordersReceived();
+        Clock::time_point tick = exchange.setBook(token, step.bids, step.asks);
+
+        // Not every tick moves our quotes; give up on a tick after 100ms
+        auto deadline = Clock::now() + std::chrono::milliseconds(100);
+        while (exchange.ordersReceived() == before && Clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        if (exchange.ordersReceived() != before) {
+            latencies.push_back(std::chrono::duration<double, std::micro>(exchange.lastOrderArrival() - tick).count());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    client.disconnect();
+    strategy.stop();
+    gateway.stop();
+    exchange.stop();
+
+    printLatencies("tick_to_order", latencies);
+}
+
+int main(int argc, char** argv) {
+    size_t orders = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    size_t ticks = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 500;
+
+    Logger::init("./logs", "bench_mock_exchange");
+    Logger::get()->set_level(spdlog::level::warn);
+
+    benchOrderRoundTrip(orders);
+    benchTickToOrder(ticks);
+    return 0;
+}
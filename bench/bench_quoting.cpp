@@ -0,0 +1,229 @@
+// Quote generation: the original monolithic MarketMaker::generateQuote
+// against the policy kernel it was split into, one token at a time and
+// batched. Those rows are the single-outcome path; the condition row is
+// ConditionQuoter, which quotes every outcome of a condition together and
+// never goes through the batch kernel.
+//
+// Usage: bench_quoting [iterations]
+
+#include "strategy/batch_quoter.hpp"
+#include "strategy/condition_quoter.hpp"
+#include "data/order_book.hpp"
+#include "utils/logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace pmm;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// generateQuote before the split, minus the volatility update and TTL
+// phase logging that both paths share
+std::optional<Quote> legacyQuote(const OrderBook& book, const QuoteInputs& s) {
+    Price mid = book.getMid();
+    Price market_spread = book.getSpread();
+
+    if (market_spread < 0.01) {
+        LOG_DEBUG("Market spread too tight ({}), not quoting", market_spread);
+        return std::nullopt;
+    }
+
+    double adjusted_spread_pct = s.spread_pct * s.spread_multiplier;
+    double target_spread_dollars = mid * adjusted_spread_pct;
+
+    double q = s.inventory / 100.0;
+    double gamma = s.risk_aversion;
+    double sigma_sq = s.volatility * s.volatility;
+
+    double reservation_bid = mid - (q + 1.0) * gamma * sigma_sq;
+    double reservation_ask = mid + (q - 1.0) * gamma * sigma_sq;
+
+    LOG_DEBUG("reservation_bid: {}", reservation_bid);
+    LOG_DEBUG("reservation_ask: {}", reservation_ask);
+    Price our_bid = reservation_bid - target_spread_dollars / 2.0;
+    Price our_ask = reservation_ask + target_spread_dollars / 2.0;
+
+    double imbalance = book.getImbalance();
+    double imbalance_adjustment = imbalance * 0.005;
+    our_bid += imbalance_adjustment;
+    our_ask += imbalance_adjustment;
+
+    our_bid = std::round(our_bid * 100.0) / 100.0;
+    our_ask = std::round(our_ask * 100.0) / 100.0;
+
+    if (s.inventory > 0 && s.avg_cost > 0) {
+        double inventory_risk = std::abs(s.inventory_dollars) / s.max_position;
+        double urgency_factor = std::max(s.time_urgency, inventory_risk);
+        double min_profit_pct = 0.015 * (1.0 - urgency_factor);
+        if (urgency_factor > 0.9) {
+            min_profit_pct = -0.01;
+        }
+        double min_ask = s.avg_cost * (1.0 + min_profit_pct);
+        if (our_ask < min_ask) {
+            our_ask = min_ask;
+        }
+    }
+
+    our_bid = std::max(0.01, std::min(0.99, our_bid));
+    our_ask = std::max(0.01, std::min(0.99, our_ask));
+
+    if (our_ask <= our_bid) {
+        return std::nullopt;
+    }
+    if (our_bid >= book.getBestAsk() || our_ask <= book.getBestBid()) {
+        return std::nullopt;
+    }
+
+    double remaining_capacity = s.max_position - std::abs(s.inventory);
+    Size quote_size = std::min(100.0, remaining_capacity / mid);
+    if (quote_size < 10.0) {
+        return std::nullopt;
+    }
+
+    return Quote{our_bid, quote_size, our_ask, quote_size, s.ttl_seconds, Clock::now()};
+}
+
+struct Case {
+    OrderBook book;
+    QuoteInputs inputs;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+
+    Logger::init("./logs", "bench_quoting");
+    Logger::get()->set_level(spdlog::level::warn);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> cents(5, 90);
+    std::uniform_int_distribution<int> width(1, 6);
+    std::uniform_real_distribution<double> volume(10.0, 5000.0);
+    std::uniform_real_distribution<double> position(-1500.0, 1500.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    std::vector<Case> cases;
+    for (int i = 0; i < 1024; i++) {
+        Price bid = cents(rng) / 100.0;
+        Price ask = bid + width(rng) / 100.0;
+        OrderBook book("token_" + std::to_string(i));
+        book.updateBid(bid, volume(rng));
+        book.updateBid(bid - 0.01, volume(rng));
+        book.updateAsk(ask, volume(rng));
+        book.updateAsk(ask + 0.01, volume(rng));
+
+        QuoteInputs in;
+        in.best_bid = book.getBestBid();
+        in.best_ask = book.getBestAsk();
+        in.mid = book.getMid();
+        in.imbalance = book.getImbalance();
+        in.inventory = position(rng);
+        in.avg_cost = (in.inventory != 0.0) ? in.mid + (unit(rng) - 0.5) * 0.1 : 0.0;
+        in.inventory_dollars = in.inventory * in.avg_cost;
+        in.spread_pct = 0.02 + unit(rng) * 0.04;
+        in.spread_multiplier = 1.0 + unit(rng);
+        in.time_urgency = unit(rng);
+        cases.push_back({std::move(book), in});
+    }
+
+    // Same quotes, bit for bit
+    size_t mismatches = 0;
+    for (const Case& c : cases) {
+        auto legacy = legacyQuote(c.book, c.inputs);
+        Quote kernel;
+        bool ok = DefaultQuoting::quote(c.inputs, kernel);
+        if (ok != legacy.has_value() ||
+            (ok && (kernel.bid_price != legacy->bid_price || kernel.ask_price != legacy->ask_price ||
+                    kernel.bid_size != legacy->bid_size))) {
+            mismatches++;
+        }
+    }
+
+    auto report = [&](const char* name, double ns, size_t quoted) {
+        std::printf("%-18s n=%-10zu %.1f ns/quote (%zu quoted)\n", name, iterations, ns / iterations, quoted);
+    };
+
+    std::printf("-- single-outcome path (MarketMaker, DefaultQuoting) --\n");
+    size_t quoted = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        const Case& c = cases[i & 1023];
+        quoted += legacyQuote(c.book, c.inputs).has_value();
+    }
+    report("legacy", std::chrono::duration<double, std::nano>(Clock::now() - start).count(), quoted);
+
+    // Kernel including the book reads the legacy path does
+    quoted = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        const Case& c = cases[i & 1023];
+        QuoteInputs in = c.inputs;
+        in.best_bid = c.book.getBestBid();
+        in.best_ask = c.book.getBestAsk();
+        in.mid = c.book.getMid();
+        in.imbalance = c.book.getImbalance();
+        Quote quote;
+        quoted += DefaultQuoting::quote(in, quote);
+    }
+    report("kernel+book", std::chrono::duration<double, std::nano>(Clock::now() - start).count(), quoted);
+
+    quoted = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        Quote quote;
+        quoted += DefaultQuoting::quote(cases[i & 1023].inputs, quote);
+    }
+    report("kernel", std::chrono::duration<double, std::nano>(Clock::now() - start).count(), quoted);
+
+    QuoteBatch batch;
+    for (const Case& c : cases) {
+        batch.add(c.inputs);
+    }
+    auto runBatch = [&](const char* name, BatchKernel kernel) {
+        size_t rounds = iterations / cases.size();
+        size_t quoted_tokens = 0;
+        auto batch_start = Clock::now();
+        for (size_t r = 0; r < rounds; r++) {
+            quoteBatch(batch, kernel);
+            quoted_tokens += batch.quoted[r & 1023];
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - batch_start).count();
+        std::printf("%-18s n=%-10zu %.1f ns/quote\n", name, rounds * cases.size(), ns / (rounds * cases.size()));
+        return quoted_tokens;
+    };
+    runBatch("batch_scalar", BatchKernel::SCALAR);
+    if (bestBatchKernel() == BatchKernel::AVX2) {
+        runBatch("batch_avx2", BatchKernel::AVX2);
+    }
+
+    // Binary conditions built from neighbouring cases, priced per outcome
+    std::vector<ConditionQuoter> conditions(cases.size() / 2);
+    for (size_t i = 0; i < conditions.size(); i++) {
+        for (size_t outcome = 0; outcome < 2; outcome++) {
+            conditions[i].addOutcome(static_cast<TokenHandle>(2 * i + outcome));
+            conditions[i].setInputs(outcome, cases[2 * i + outcome].inputs);
+        }
+    }
+    std::printf("-- condition path (ConditionQuoter, scalar, not batched) --\n");
+    quoted = 0;
+    size_t rounds = iterations / 2;
+    start = Clock::now();
+    for (size_t r = 0; r < rounds; r++) {
+        ConditionQuoter& quoter = conditions[r & (conditions.size() - 1)];
+        quoter.quote();
+        quoted += (quoter.bidSize(0) > 0.0) + (quoter.bidSize(1) > 0.0);
+    }
+    double condition_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    std::printf("%-18s n=%-10zu %.1f ns/quote (%zu bids quoted)\n", "condition", rounds * 2,
+                condition_ns / (rounds * 2), quoted);
+
+    std::printf("mismatches: %zu of %zu\n", mismatches, cases.size());
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+// Cost of one pre-trade check on the order path.
+//
+// Usage: bench_risk_gate [iterations]
+
+#include "strategy/risk_gate.hpp"
+#include "utils/logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace pmm;
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char** argv) {
+    size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+
+    Logger::init("./logs", "bench_risk_gate");
+    Logger::get()->set_level(spdlog::level::warn);
+
+    // Limits high enough that every check runs to the rate limiter
+    RiskLimits limits;
+    limits.max_orders_per_second = 1e12;
+    limits.order_burst = 1e6;
+    RiskGate gate(limits);
+
+    RiskGate::ConditionHandle conditions[64];
+    for (size_t i = 0; i < 64; i++) {
+        conditions[i] = gate.registerCondition("condition_" + std::to_string(i));
+        uint32_t yes = gate.registerOutcome(conditions[i]);
+        gate.registerOutcome(conditions[i]);
+        gate.onPositionChanged(conditions[i], yes, 20.0, 0.5);
+    }
+
+    size_t passed = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        Side side = (i & 1) ? Side::BUY : Side::SELL;
+        passed += gate.checkOrder(conditions[i & 63], 0, side, 0.45, 20.0) == RiskCheck::OK;
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::printf("%-18s n=%-10zu %.1f ns/check (%zu passed)\n", "risk_check", iterations, ns / iterations, passed);
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Strategy-thread cost of one trade log call, with the writer thread
+// draining the journal in the background. Calls are timed in bursts that
+// fit in the ring, flushing between bursts, so this is the cost of
+// logging rather than of waiting on the disk.
+//
+// Usage: bench_trade_journal [iterations] [csv|binary]
+
+#include "utils/trading_logger.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+using namespace pmm;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr size_t BURST = 1000;
+
+template <typename LogCall>
+double timeBursts(TradingLogger& logger, size_t iterations, double& drain_ms, LogCall&& log) {
+    double ns = 0.0;
+    drain_ms = 0.0;
+    for (size_t done = 0; done < iterations; done += BURST) {
+        size_t n = std::min(BURST, iterations - done);
+        auto start = Clock::now();
+        for (size_t i = 0; i < n; i++) {
+            log(done + i);
+        }
+        auto logged = Clock::now();
+        logger.flush();
+        ns += std::chrono::duration<double, std::nano>(logged - start).count();
+        drain_ms += std::chrono::duration<double, std::milli>(Clock::now() - logged).count();
+    }
+    return ns / iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    bool binary = (argc > 2) && std::strcmp(argv[2], "binary") == 0;
+    const char* format = binary ? "binary" : "csv";
+
+    Logger::init("./logs", "bench_trade_journal");
+    Logger::get()->set_level(spdlog::level::warn);
+
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "pmm_bench_trade_journal";
+    std::filesystem::remove_all(dir);
+    TradingLogger logger(dir, binary ? JournalFormat::BINARY : JournalFormat::CSV);
+    logger.startSession("bench");
+
+    const TokenId token = "71321045679252212594626385532706912750332728571942532289631379312455583992563";
+    Order order;
+    order.token_id = token;
+    order.side = Side::BUY;
+    order.price = 0.45;
+    order.size = 20.0;
+
+    double drain_ms;
+    double place_ns = timeBursts(logger, iterations, drain_ms, [&](size_t i) {
+        order.order_id = i;
+        logger.logOrderPlaced(order, "0xmarket", 0.46, 0.02, 0.45, 0.47, 0.45, 0.47);
+    });
+    std::printf("%-18s n=%-10zu %.1f ns/call, writer %.0f ns/record (%s)\n", "log_order_placed",
+                iterations, place_ns, drain_ms * 1e6 / iterations, format);
+
+    double price_ns = timeBursts(logger, iterations, drain_ms, [&](size_t) {
+        logger.logPriceUpdate("Will it happen?", "0xmarket", "0xcondition", token, 0.46, 0.1, 0.001,
+                              0.45, 0.47, 0.02, 434.0, 1200.0, 900.0, 2100.0, 0.14, 12, 9, 40.0, 36.0, 0.2);
+    });
+    std::printf("%-18s n=%-10zu %.1f ns/call, writer %.0f ns/record (%s, %llu dropped)\n", "log_price_update",
+                iterations, price_ns, drain_ms * 1e6 / iterations, format,
+                static_cast<unsigned long long>(logger.droppedPriceUpdates()));
+
+    logger.endSession();
+    std::filesystem::remove_all(dir);
+    return 0;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types.hpp"
+#include <chrono>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
@@ -18,6 +19,12 @@ public:
     
     Event pop();
     
+    // Non-blocking pop, returns false if the queue is empty
+    bool tryPop(Event& event);
+    
+    // Blocks until an event arrives or the deadline passes, returns false on timeout
+    bool popUntil(Event& event, std::chrono::steady_clock::time_point deadline);
+    
     bool empty() const;
     
     size_t size() const;
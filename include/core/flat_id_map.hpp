@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace pmm {
+
+// Open-addressing map from non-zero 64-bit ids to 32-bit values.
+// Linear probing with backward-shift deletion, so erases leave no
+// tombstones and inserts/erases never allocate until the table has to
+// grow past half load. Sequential ids spread perfectly under the mask.
+class FlatIdMap {
+public:
+    static constexpr uint32_t NOT_FOUND = std::numeric_limits<uint32_t>::max();
+
+    explicit FlatIdMap(size_t initial_capacity = 64) {
+        size_t capacity = 16;
+        while (capacity < initial_capacity) {
+            capacity <<= 1;
+        }
+        entries_.resize(capacity);
+        mask_ = capacity - 1;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Key must be non-zero; an existing key is overwritten
+    void insert(uint64_t key, uint32_t value) {
+        if ((size_ + 1) * 2 > entries_.size()) {
+            grow();
+        }
+        size_t i = key & mask_;
+        while (entries_[i].key != 0 && entries_[i].key != key) {
+            i = (i + 1) & mask_;
+        }
+        if (entries_[i].key == 0) {
+            size_++;
+        }
+        entries_[i] = Entry{key, value};
+    }
+
+    uint32_t find(uint64_t key) const {
+        if (key == 0) return NOT_FOUND;
+        for (size_t i = key & mask_; entries_[i].key != 0; i = (i + 1) & mask_) {
+            if (entries_[i].key == key) {
+                return entries_[i].value;
+            }
+        }
+        return NOT_FOUND;
+    }
+
+    bool erase(uint64_t key) {
+        if (key == 0) return false;
+        size_t i = key & mask_;
+        while (entries_[i].key != key) {
+            if (entries_[i].key == 0) return false;
+            i = (i + 1) & mask_;
+        }
+
+        // Shift later members of the probe run back into the hole
+        size_t j = i;
+        while (true) {
+            j = (j + 1) & mask_;
+            if (entries_[j].key == 0) break;
+            size_t home = entries_[j].key & mask_;
+            bool home_in_gap = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+            if (!home_in_gap) {
+                entries_[i] = entries_[j];
+                i = j;
+            }
+        }
+        entries_[i].key = 0;
+        size_--;
+        return true;
+    }
+
+private:
+    struct Entry {
+        uint64_t key = 0;  // 0 = empty
+        uint32_t value = 0;
+    };
+
+    std::vector<Entry> entries_;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+
+    void grow() {
+        std::vector<Entry> old;
+        old.swap(entries_);
+        entries_.resize(old.size() * 2);
+        mask_ = entries_.size() - 1;
+        size_ = 0;
+        for (const Entry& entry : old) {
+            if (entry.key != 0) {
+                insert(entry.key, entry.value);
+            }
+        }
+    }
+};
+
+} // namespace pmm
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pmm {
+
+// Fixed-capacity FIFO ring with no allocation after construction.
+// Elements are addressed either relative to the front or by an absolute
+// sequence number that keeps increasing as elements are pushed, so callers
+// can hold stable cursors into the ring.
+template <typename T, size_t Capacity>
+class FixedRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "FixedRing capacity must be a power of two");
+
+public:
+    static constexpr size_t capacity() { return Capacity; }
+
+    size_t size() const { return static_cast<size_t>(tail_ - head_); }
+    bool empty() const { return head_ == tail_; }
+    bool full() const { return size() == Capacity; }
+
+    // Caller must make room first (pop_front) when full
+    T& push_back(const T& value) {
+        T& slot = items_[tail_ & MASK];
+        slot = value;
+        tail_++;
+        return slot;
+    }
+
+    void pop_front() { head_++; }
+    void pop_back() { tail_--; }
+    void clear() { head_ = tail_; }
+
+    T& front() { return items_[head_ & MASK]; }
+    const T& front() const { return items_[head_ & MASK]; }
+    T& back() { return items_[(tail_ - 1) & MASK]; }
+    const T& back() const { return items_[(tail_ - 1) & MASK]; }
+
+    // Index relative to the oldest element
+    T& operator[](size_t i) { return items_[(head_ + i) & MASK]; }
+    const T& operator[](size_t i) const { return items_[(head_ + i) & MASK]; }
+
+    // Absolute sequence numbers: [headSeq(), tailSeq()) are live
+    uint64_t headSeq() const { return head_; }
+    uint64_t tailSeq() const { return tail_; }
+    T& atSeq(uint64_t seq) { return items_[seq & MASK]; }
+    const T& atSeq(uint64_t seq) const { return items_[seq & MASK]; }
+
+private:
+    static constexpr uint64_t MASK = Capacity - 1;
+
+    std::array<T, Capacity> items_{};
+    uint64_t head_ = 0;
+    uint64_t tail_ = 0;
+};
+
+} // namespace pmm
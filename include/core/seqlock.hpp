@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace pmm {
+
+// Single-writer sequence lock for small trivially copyable snapshots.
+// The payload is kept in atomic words so a reader overlapping a write never
+// races, it just retries. Readers never block the writer. Word stores are
+// release and word loads acquire instead of using fences, which is free on
+// x86 and keeps the protocol visible to ThreadSanitizer.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock payload must be trivially copyable");
+    static_assert(std::is_default_constructible_v<T>, "SeqLock payload must be default constructible");
+
+public:
+    SeqLock() {
+        store(T{});
+    }
+
+    // Writer side - must only be called from one thread
+    void store(const T& value) {
+        std::array<uint64_t, WORDS> words{};
+        std::memcpy(words.data(), reinterpret_cast<const unsigned char*>(&value), sizeof(T));
+
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);  // Odd = write in progress
+
+        // A reader that sees any new word also sees the odd sequence
+        for (size_t i = 0; i < WORDS; i++) {
+            words_[i].store(words[i], std::memory_order_release);
+        }
+
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Reader side - safe from any number of threads
+    T load() const {
+        std::array<uint64_t, WORDS> words;
+        uint64_t before;
+        uint64_t after;
+
+        do {
+            before = seq_.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; i++) {
+                words[i] = words_[i].load(std::memory_order_acquire);
+            }
+            after = seq_.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+
+        // Byte-wise, so payloads with default member initializers copy
+        // without -Wclass-memaccess; trivially copyable makes it well defined
+        T value;
+        std::memcpy(reinterpret_cast<unsigned char*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+    // Number of completed stores (including the initial default value)
+    uint64_t version() const {
+        return seq_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> seq_{0};
+    std::array<std::atomic<uint64_t>, WORDS> words_{};
+};
+
+} // namespace pmm
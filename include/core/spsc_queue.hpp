@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace pmm {
+
+// Bounded lock-free queue for exactly one producer and one consumer thread.
+// Head and tail live on separate cache lines and each side caches the
+// other's index, so the common path touches no shared line at all.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Producer side. Returns false when full; value is left untouched.
+    bool tryPush(T&& value) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == Capacity) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == Capacity) {
+                return false;
+            }
+        }
+        items_[tail & MASK] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(const T& value) {
+        T copy = value;
+        return tryPush(std::move(copy));
+    }
+
+    // Consumer side. Returns false when empty.
+    bool tryPop(T& value) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        value = std::move(items_[head & MASK]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called concurrently with the other side
+    size_t size() const {
+        return static_cast<size_t>(tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire));
+    }
+    bool empty() const { return size() == 0; }
+
+private:
+    static constexpr uint64_t MASK = Capacity - 1;
+    static constexpr size_t CACHE_LINE = 64;
+
+    alignas(CACHE_LINE) std::atomic<uint64_t> head_{0};
+    uint64_t cached_tail_ = 0;  // Consumer's view of tail_
+
+    alignas(CACHE_LINE) std::atomic<uint64_t> tail_{0};
+    uint64_t cached_head_ = 0;  // Producer's view of head_
+
+    alignas(CACHE_LINE) std::array<T, Capacity> items_{};
+};
+
+} // namespace pmm
@@ -1,5 +1,6 @@
 #pragma once 
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <variant>
@@ -10,10 +11,17 @@ namespace pmm {
 using Price = double;
 using Size = double;
 using Volume = double;
-using OrderId = std::string;
+using OrderId = uint64_t;  // Local order id, shown as "ORD_<n>" in logs
 using TokenId = std::string;
 using MarketId = std::string;
 
+constexpr OrderId INVALID_ORDER_ID = 0;
+
+// String form for the exchange and for tests; logging writes "ORD_" and the number directly
+inline std::string orderIdToString(OrderId order_id) {
+    return "ORD_" + std::to_string(order_id);
+}
+
 enum class Side {
     BUY,
     SELL
@@ -26,12 +34,21 @@ enum class MarketPhase {
     IN_PLAY             // Event started
 };
 
+// What a market's quotes are centred on
+enum class FairValueModel {
+    MID,             // Plain mid, leaned by book imbalance
+    MICROPRICE,      // Mid weighted by size at the touch
+    DEPTH_WEIGHTED   // Mean of the bid and ask VWAPs over the top levels
+};
+
 enum class EventType {
     BOOK_SNAPSHOT,
     PRICE_LEVEL_UPDATE,
     TRADE,
     ORDER_FILL,
     ORDER_REJECTED,
+    ORDER_ACKED,
+    ORDER_CANCELLED,
     TIMER_TICK,
     SHUTDOWN
 };
@@ -48,6 +65,15 @@ struct PriceLevelUpdatePayload {
     std::vector<std::pair<Price, Size>> asks;
 };
 
+// A market trade print (last_trade_price); side is the aggressor's
+struct TradePayload {
+    TokenId token_id;
+    Price price;
+    Size size;
+    Side side;
+    int64_t exchange_time_ms;
+};
+
 struct OrderFillPayload {
     OrderId order_id;
     TokenId token_id;
@@ -57,11 +83,27 @@ struct OrderFillPayload {
     
 };
 
+// Which request the exchange (or the gateway) turned down
+enum class RejectedRequest {
+    PLACE,   // The order never existed
+    CANCEL   // The order is still working
+};
+
 struct OrderRejectedPayload {
     OrderId order_id;
+    RejectedRequest request;
     std::string reason;
 };
 
+struct OrderAckedPayload {
+    OrderId order_id;
+    std::string exchange_order_id;
+};
+
+struct OrderCancelledPayload {
+    OrderId order_id;
+};
+
 struct TimerTickPayload {};
 
 struct ShutdownPayload {
@@ -75,8 +117,11 @@ struct Event {
     std::variant<
         BookSnapshotPayload,
         PriceLevelUpdatePayload,
+        TradePayload,
         OrderFillPayload,
         OrderRejectedPayload,
+        OrderAckedPayload,
+        OrderCancelledPayload,
         TimerTickPayload,
         ShutdownPayload
     > payload;
@@ -101,6 +146,14 @@ struct Event {
         };
     }
 
+    static Event trade(TokenId token_id, Price price, Size size, Side side, int64_t exchange_time_ms = 0) {
+        return Event{
+            EventType::TRADE,
+            std::chrono::system_clock::now(),
+            TradePayload{std::move(token_id), price, size, side, exchange_time_ms}
+        };
+    }
+
     static Event orderFill(OrderId order_id,
                            TokenId token_id,
                            Price fill_price,
@@ -114,11 +167,29 @@ struct Event {
     }
 
     static Event orderRejected(OrderId order_id,
+                               RejectedRequest request,
                                std::string reason) {
         return Event{
             EventType::ORDER_REJECTED,
             std::chrono::system_clock::now(),
-            OrderRejectedPayload{std::move(order_id), std::move(reason)}
+            OrderRejectedPayload{std::move(order_id), request, std::move(reason)}
+        };
+    }
+
+    static Event orderAcked(OrderId order_id,
+                            std::string exchange_order_id) {
+        return Event{
+            EventType::ORDER_ACKED,
+            std::chrono::system_clock::now(),
+            OrderAckedPayload{order_id, std::move(exchange_order_id)}
+        };
+    }
+
+    static Event orderCancelled(OrderId order_id) {
+        return Event{
+            EventType::ORDER_CANCELLED,
+            std::chrono::system_clock::now(),
+            OrderCancelledPayload{order_id}
         };
     }
 
@@ -174,6 +245,7 @@ struct MarketMetadata {
     std::string condition_id; // Polymarket condition ID (groups related outcome markets)
     std::chrono::system_clock::time_point event_end_time;  // When the event ends
     bool has_end_time = false;
+    FairValueModel fair_value_model = FairValueModel::MID;
     
     // Get market phase based on time to event
     MarketPhase getMarketPhase() const {
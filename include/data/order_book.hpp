@@ -6,11 +6,31 @@
 namespace pmm {
 
 class OrderBook {
+public:
+    // Levels per side behind the cached depth figures
+    static constexpr int DEPTH_LEVELS = 5;
+
 private:
     TokenId token_id_;
     std::map<Price, Size, std::greater<Price>> bids_;
     std::map<Price, Size> asks_;
 
+    // Figures derived from the top of the book, recomputed in one pass over
+    // DEPTH_LEVELS levels a side on the first read after an update
+    struct TopOfBook {
+        Size bid_volume = 0.0;
+        Size ask_volume = 0.0;
+        double bid_notional = 0.0;
+        double ask_notional = 0.0;
+        double imbalance = 0.0;
+        Price microprice = 0.0;
+        Price depth_weighted_mid = 0.0;
+    };
+    mutable TopOfBook top_;
+    mutable bool top_dirty_ = true;
+
+    const TopOfBook& top() const;
+
 public:
     explicit OrderBook(TokenId token_id) : token_id_(std::move(token_id)) {}
     
@@ -29,7 +49,28 @@ public:
     Size getTotalBidVolume(int levels = 5) const;
     Size getTotalAskVolume(int levels = 5) const;
 
-    double getImbalance() const;
+    // Displayed size at one price, 0 if the level is empty
+    Size getBidSize(Price price) const;
+    Size getAskSize(Price price) const;
+
+    // Size that would trade against a buy (sell) limited at price
+    Size getAskDepthThrough(Price price) const;
+    Size getBidDepthThrough(Price price) const;
+
+    double getImbalance() const;  // Over DEPTH_LEVELS levels
+    double getImbalance(int levels) const;
+
+    // Mid weighted toward the side with less size at the touch:
+    // (bid * ask_size + ask * bid_size) / (bid_size + ask_size)
+    Price getMicroprice() const;
+
+    // Mean of the bid and ask VWAPs over DEPTH_LEVELS levels
+    Price getDepthWeightedMid() const;
+
+    // Average price to buy (sell) size shares against the book, 0.0 when
+    // there is not that much depth
+    Price getBuyVwap(Size size) const;
+    Price getSellVwap(Size size) const;
     
     int getBidLevelCount() const;
     int getAskLevelCount() const;
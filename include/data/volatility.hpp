@@ -0,0 +1,83 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "core/ring_buffer.hpp"
+#include <chrono>
+#include <cstdint>
+
+namespace pmm {
+
+// Annualized mid-price volatility, one figure per estimator
+struct VolatilityEstimates {
+    double ewma = 0.0;
+    double realized = 0.0;
+    double parkinson = 0.0;
+};
+
+// Mid-price volatility for one token, sampled on a fixed one-second grid so
+// the estimate does not depend on how often the book updates or we quote.
+// Each interval contributes its return (close over the previous close) and
+// its high-low range of mids, and three estimators are kept incrementally:
+//
+// - EWMA of squared returns (lambda 0.94)
+// - Realized: mean squared return over the last WINDOW intervals
+// - Parkinson: mean squared log range over the same window, / (4 ln 2)
+//
+// An interval closes when the first mid of a later one arrives; intervals
+// with no updates count as unchanged. Square roots are taken once per
+// closed interval, so reads are plain loads.
+class VolatilityEstimator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int64_t INTERVAL_MS = 1000;
+    static constexpr size_t WINDOW = 300;  // Five minutes of intervals
+    static constexpr double EWMA_LAMBDA = 0.94;
+    static constexpr double INITIAL_VOLATILITY = 0.05;
+
+    // What quoting uses: the EWMA, kept within this range
+    static constexpr double MIN_QUOTE_VOLATILITY = 0.01;
+    static constexpr double MAX_QUOTE_VOLATILITY = 0.50;
+
+    VolatilityEstimator();
+
+    void onMid(Price mid, Clock::time_point now = Clock::now());
+
+    double ewma() const { return estimates_.ewma; }
+    double realized() const { return estimates_.realized; }   // 0.0 until an interval closes
+    double parkinson() const { return estimates_.parkinson; } // 0.0 until an interval closes
+    const VolatilityEstimates& estimates() const { return estimates_; }
+    double quoteVolatility() const { return quote_volatility_; }
+
+    size_t windowSamples() const { return samples_.size(); }
+
+private:
+    struct Sample {
+        double squared_return;
+        double squared_range;  // Already divided by 4 ln 2
+    };
+
+    // Per interval -> per year, assuming 252 days of 24 hours
+    static constexpr double ANNUALIZE = 252.0 * 24.0 * 3600.0 * 1000.0 / INTERVAL_MS;
+
+    bool started_ = false;
+    int64_t interval_ = 0;
+    Price previous_close_ = 0.0;
+    Price close_ = 0.0;
+    Price high_ = 0.0;
+    Price low_ = 0.0;
+
+    double ewma_variance_;  // Per interval
+    FixedRing<Sample, 512> samples_;
+    static_assert(WINDOW < decltype(samples_)::capacity(), "Sample ring must hold the window");
+    double sum_squared_returns_ = 0.0;
+    double sum_squared_ranges_ = 0.0;
+
+    VolatilityEstimates estimates_;
+    double quote_volatility_ = INITIAL_VOLATILITY;
+
+    void addSample(double squared_return, double squared_range);
+    void refresh();
+};
+
+} // namespace pmm
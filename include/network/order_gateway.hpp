@@ -0,0 +1,182 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "core/event_queue.hpp"
+#include "core/spsc_queue.hpp"
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl/context.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pmm {
+
+struct GatewayConfig {
+    std::string host = "clob.polymarket.com";
+    std::string port = "443";
+    bool use_tls = true;
+    size_t max_batch = 15;                              // Orders per POST /orders (CLOB batch limit)
+    size_t max_pipeline_depth = 16;                     // Requests written before reading responses
+    std::chrono::milliseconds idle_wait{1};             // Longest sleep when the queue looks empty
+    std::chrono::milliseconds reconnect_backoff{500};
+};
+
+enum class GatewayCommandType {
+    PLACE,
+    CANCEL
+};
+
+struct GatewayCommand {
+    GatewayCommandType type = GatewayCommandType::PLACE;
+    OrderId order_id = INVALID_ORDER_ID;
+    TokenId token_id;
+    Side side = Side::BUY;
+    Price price = 0.0;
+    Size size = 0.0;
+};
+
+// Lifecycle of an order as seen by the gateway
+enum class InFlightState {
+    PENDING_NEW,
+    ACKED,
+    PENDING_CANCEL,
+    UNKNOWN         // Placement sent but the connection failed before its response
+};
+
+// Sends live orders to the exchange from its own I/O thread.
+//
+// The strategy thread hands commands over through an SPSC queue and never
+// waits on the network. The I/O thread keeps one persistent HTTP/1.1
+// connection, batches placements (POST /orders) and cancels (DELETE /orders),
+// writes up to max_pipeline_depth requests back to back and then reads the
+// responses in order. Acks, rejects, cancels and immediate matches are posted back to
+// the EventQueue. A cancel for an order no longer in flight (already rejected,
+// matched or cancelled) is answered with a cancel right away.
+//
+// A placement whose request was written but never answered may or may not
+// be on the exchange, so it is not reported either way until the open
+// orders (GET /data/orders, every page) have been fetched: a resting order
+// matching its token, side, price and size is acked, otherwise it is
+// rejected. A failed query is retried after reconnect_backoff.
+//
+// Order signing and API authentication headers are not implemented yet.
+class OrderGateway {
+public:
+    static constexpr size_t COMMAND_QUEUE_CAPACITY = 4096;
+
+    OrderGateway(EventQueue& event_queue, GatewayConfig config = GatewayConfig{});
+    ~OrderGateway();
+
+    void start();
+    void stop();
+
+    bool isRunning() const { return running_.load(); }
+
+    // Strategy thread only. Returns false if the command queue is full.
+    bool submit(GatewayCommand command);
+    bool submitPlace(const Order& order);
+    bool submitCancel(OrderId order_id);
+
+    // Updated by the I/O thread, readable from any thread
+    size_t inFlightCount() const { return in_flight_count_.load(std::memory_order_relaxed); }
+    uint64_t requestsSent() const { return requests_sent_.load(std::memory_order_relaxed); }
+    uint64_t connectionsOpened() const { return connections_opened_.load(std::memory_order_relaxed); }
+    size_t unknownCount() const { return unknown_count_.load(std::memory_order_relaxed); }
+
+private:
+    using Request = boost::beast::http::request<boost::beast::http::string_body>;
+    using Response = boost::beast::http::response<boost::beast::http::string_body>;
+
+    struct InFlightOrder {
+        InFlightState state = InFlightState::PENDING_NEW;
+        std::string exchange_order_id;
+        bool cancel_requested = false;  // Cancel arrived before the ack
+        GatewayCommand place;           // Kept while UNKNOWN, to find it among the open orders
+    };
+
+    // One entry of GET /data/orders
+    struct RestingOrder {
+        std::string id;
+        TokenId token_id;
+        std::string side;
+        double price;
+        double original_size;
+        double size_matched;
+    };
+
+    enum class RequestType {
+        PLACE,
+        CANCEL,
+        OPEN_ORDERS
+    };
+
+    // One HTTP request of a drain and the local orders it covers
+    struct PendingRequest {
+        RequestType type;
+        std::vector<OrderId> order_ids;
+        std::vector<GatewayCommand> places;  // Kept for matched-on-entry fills
+        Request request;
+    };
+
+    EventQueue& event_queue_;
+    GatewayConfig config_;
+
+    std::unique_ptr<SpscQueue<GatewayCommand, COMMAND_QUEUE_CAPACITY>> commands_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> idle_{false};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::thread io_thread_;
+
+    // I/O thread state
+    boost::asio::io_context ioc_;
+    boost::asio::ssl::context ssl_ctx_;
+    std::unique_ptr<boost::beast::tcp_stream> plain_stream_;
+    std::unique_ptr<boost::beast::ssl_stream<boost::beast::tcp_stream>> tls_stream_;
+    boost::beast::flat_buffer read_buffer_;
+    std::unordered_map<OrderId, InFlightOrder> in_flight_;
+    std::vector<GatewayCommand> drained_;
+    std::vector<PendingRequest> pipeline_;
+    bool reconcile_needed_ = false;
+    std::chrono::steady_clock::time_point reconcile_after_{};  // Backoff after a failed query
+    std::vector<RestingOrder> open_orders_;                     // Pages fetched so far
+
+    std::atomic<size_t> in_flight_count_{0};
+    std::atomic<uint64_t> requests_sent_{0};
+    std::atomic<uint64_t> connections_opened_{0};
+    std::atomic<size_t> unknown_count_{0};
+
+    void run();
+    void waitForCommands();
+    void processBatch();
+    void buildRequests();
+    PendingRequest makeCancelRequest(std::vector<OrderId> order_ids);
+    Request makeRequest(boost::beast::http::verb verb, const std::string& target, const std::string& body) const;
+    bool reconcileDue() const;
+
+    bool isConnected() const;
+    void connect();
+    void disconnect();
+    void sendPipeline();
+
+    void handlePlaceResponse(const PendingRequest& pending, const Response& response);
+    void handleCancelResponse(const PendingRequest& pending, const Response& response);
+    void handleOpenOrdersResponse(const Response& response);
+    void reconcileUnknown();
+    void failRequest(const PendingRequest& pending, const std::string& reason);
+    void markUnknown(const PendingRequest& pending);
+    void rejectPlace(OrderId order_id, const std::string& reason);
+    void queueCancel(OrderId order_id, std::vector<OrderId>& cancel_ids);
+};
+
+} // namespace pmm
@@ -74,6 +74,7 @@ private:
     void parseMessage(const nlohmann::json& json_msg);
     void parseBookMessage(const nlohmann::json& msg);
     void parsePriceChangeMessage(const nlohmann::json& msg);
+    void parseTradeMessage(const nlohmann::json& msg);
 
     void startAsyncRead();
     void startPingTimer();
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pmm {
+
+// A trade produced by the simulated exchange
+struct MatchFill {
+    std::string maker_order_id;  // Empty when background liquidity was hit
+    std::string taker_order_id;  // Empty for scenario market orders
+    TokenId token_id;
+    Side taker_side = Side::BUY;
+    Price price = 0.0;
+    Size size = 0.0;
+};
+
+struct PlaceResult {
+    bool accepted = false;
+    std::string error;
+    std::string order_id;
+    Size filled = 0.0;
+    Size resting = 0.0;
+};
+
+// A price level whose aggregate size changed, for price_change messages
+struct LevelChange {
+    TokenId token_id;
+    Side side = Side::BUY;
+    Price price = 0.0;
+    Size size = 0.0;  // New aggregate size, 0 = level removed
+};
+
+// Price-time priority limit order book for the mock exchange.
+//
+// Each level holds "background" size set by scenarios (the rest of the
+// market) ahead of any orders submitted through order entry, so a new
+// order always queues behind the displayed liquidity it joined.
+// Not thread-safe; the mock exchange drives it from one thread.
+class MatchingEngine {
+public:
+    using Level = std::pair<Price, Size>;
+
+    static constexpr double TICKS_PER_UNIT = 10000.0;  // 0.0001 price resolution
+
+    PlaceResult place(const TokenId& token_id, Side side, Price price, Size size);
+    bool cancel(const std::string& order_id);
+
+    // Scenario liquidity. setBook replaces all background size for the token.
+    void setBook(const TokenId& token_id, const std::vector<Level>& bids, const std::vector<Level>& asks);
+    void setLevel(const TokenId& token_id, Side side, Price price, Size size);
+
+    // Aggressive order from the rest of the market; returns the size traded
+    Size marketOrder(const TokenId& token_id, Side side, Size size);
+
+    // Aggregated depth, best price first
+    std::vector<Level> bids(const TokenId& token_id) const;
+    std::vector<Level> asks(const TokenId& token_id) const;
+    Size levelSize(const TokenId& token_id, Side side, Price price) const;
+
+    size_t restingOrderCount() const { return orders_.size(); }
+    const std::vector<MatchFill>& fills() const { return fills_; }
+
+    // Levels touched since the last call
+    std::vector<LevelChange> takeChanges();
+
+private:
+    using Ticks = int64_t;
+
+    struct RestingOrder {
+        std::string order_id;
+        Size remaining = 0.0;
+    };
+
+    struct PriceLevel {
+        Size background = 0.0;
+        Size resting = 0.0;  // Sum of orders[].remaining
+        std::deque<RestingOrder> orders;
+
+        Size total() const { return background + resting; }
+        bool empty() const { return background <= 0.0 && orders.empty(); }
+    };
+
+    struct Book {
+        std::map<Ticks, PriceLevel, std::greater<Ticks>> bids;  // Best (highest) first
+        std::map<Ticks, PriceLevel> asks;                       // Best (lowest) first
+    };
+
+    struct OrderLocation {
+        TokenId token_id;
+        Side side;
+        Ticks price;
+    };
+
+    std::unordered_map<TokenId, Book> books_;
+    std::unordered_map<std::string, OrderLocation> orders_;
+    std::vector<MatchFill> fills_;
+    std::vector<LevelChange> changes_;
+    uint64_t next_order_id_ = 1;
+
+    static Ticks toTicks(Price price);
+    static Price toPrice(Ticks ticks);
+
+    template <typename Levels>
+    Size match(Levels& levels, const TokenId& token_id, Side taker_side, Ticks limit,
+               Size size, const std::string& taker_order_id);
+
+    void recordChange(const TokenId& token_id, Side side, Ticks price, Size size);
+};
+
+} // namespace pmm
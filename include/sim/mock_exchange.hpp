@@ -0,0 +1,140 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "network/order_gateway.hpp"
+#include "sim/matching_engine.hpp"
+#include "sim/scenario.hpp"
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pmm {
+
+struct MockExchangeConfig {
+    std::string address = "127.0.0.1";
+    unsigned short ws_port = 0;    // 0 = any free port
+    unsigned short http_port = 0;
+
+    // Extra delay before each order-entry response: latency + uniform [0, jitter]
+    std::chrono::microseconds order_latency{0};
+    std::chrono::microseconds order_jitter{0};
+
+    // Same for each market-data message; delivery order is preserved
+    std::chrono::microseconds feed_latency{0};
+    std::chrono::microseconds feed_jitter{0};
+
+    uint32_t seed = 1;
+};
+
+// Localhost stand-in for the Polymarket CLOB.
+//
+// Market data is served over wss:// (self-signed certificate, which the
+// client accepts since it does not verify peers) using the same book and
+// price_change messages as the real market channel. Order entry is plain
+// HTTP/1.1 with keep-alive on POST/DELETE /orders, in the shapes
+// OrderGateway sends and parses. Both share one MatchingEngine and one I/O
+// thread; the public methods hop onto that thread and may be called from
+// anywhere.
+class MockExchange {
+public:
+    explicit MockExchange(MockExchangeConfig config = MockExchangeConfig{});
+    ~MockExchange();
+
+    void start();
+    void stop();
+
+    unsigned short wsPort() const { return ws_port_; }
+    unsigned short httpPort() const { return http_port_; }
+    std::string wsUrl() const;
+    GatewayConfig gatewayConfig() const;
+
+    // Market activity. Each returns the time the resulting messages were queued for subscribers.
+    std::chrono::steady_clock::time_point setBook(const TokenId& token_id,
+                                                  const std::vector<std::pair<Price, Size>>& bids,
+                                                  const std::vector<std::pair<Price, Size>>& asks);
+    std::chrono::steady_clock::time_point setLevel(const TokenId& token_id, Side side, Price price, Size size);
+    std::chrono::steady_clock::time_point marketOrder(const TokenId& token_id, Side side, Size size);
+
+    // Plays the steps at their offsets; blocks until the last one is applied
+    void play(const Scenario& scenario);
+
+    std::vector<MatchFill> fills();
+    size_t restingOrderCount();
+    std::vector<std::pair<Price, Size>> bids(const TokenId& token_id);
+    std::vector<std::pair<Price, Size>> asks(const TokenId& token_id);
+
+    size_t subscriberCount() const { return subscriber_count_.load(); }
+    uint64_t ordersReceived() const { return orders_received_.load(); }
+    uint64_t cancelsReceived() const { return cancels_received_.load(); }
+
+    // Arrival time of the most recent order-entry request
+    std::chrono::steady_clock::time_point lastOrderArrival() const {
+        return std::chrono::steady_clock::time_point(
+            std::chrono::steady_clock::duration(last_order_arrival_.load()));
+    }
+
+private:
+    class WsSession;
+    class HttpSession;
+
+    MockExchangeConfig config_;
+    boost::asio::io_context ioc_;
+    boost::asio::ssl::context ssl_ctx_;
+    boost::asio::ip::tcp::acceptor ws_acceptor_;
+    boost::asio::ip::tcp::acceptor http_acceptor_;
+    unsigned short ws_port_ = 0;
+    unsigned short http_port_ = 0;
+    std::thread io_thread_;
+    std::atomic<bool> running_{false};
+
+    // I/O thread state
+    MatchingEngine engine_;
+    std::vector<std::weak_ptr<WsSession>> sessions_;
+    std::mt19937 rng_;
+
+    std::atomic<size_t> subscriber_count_{0};
+    std::atomic<uint64_t> orders_received_{0};
+    std::atomic<uint64_t> cancels_received_{0};
+    std::atomic<int64_t> last_order_arrival_{0};
+
+    void acceptWs();
+    void acceptHttp();
+
+    std::string handleOrderRequest(int method, const std::string& target, const std::string& body, unsigned& status);
+    std::string placeOrders(const nlohmann::json& request);
+    std::string cancelOrders(const nlohmann::json& request);
+
+    void publishChanges();
+    void publish(const TokenId& token_id, std::string message);
+    void sendSnapshot(WsSession& session, const TokenId& token_id);
+    std::string bookMessage(const TokenId& token_id) const;
+
+    std::chrono::microseconds orderDelay();
+    std::chrono::microseconds feedDelay();
+
+    // Runs f on the I/O thread (or inline when stopped) and returns its result
+    template <typename F>
+    auto onExchange(F&& f) -> decltype(f()) {
+        using Result = decltype(f());
+        if (!running_.load() || std::this_thread::get_id() == io_thread_.get_id()) {
+            return f();
+        }
+        std::packaged_task<Result()> task(std::forward<F>(f));
+        std::future<Result> result = task.get_future();
+        boost::asio::post(ioc_, [&task]() { task(); });
+        return result.get();
+    }
+};
+
+} // namespace pmm
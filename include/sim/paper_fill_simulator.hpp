@@ -0,0 +1,77 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "data/order_book.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace pmm {
+
+// A simulated execution against one of our paper orders
+struct PaperFill {
+    uint32_t ref = 0;  // Caller's handle for the order
+    Price price = 0.0;
+    Size size = 0.0;
+};
+
+// Fill model for paper orders on one token.
+//
+// Paper orders never reach the exchange, so fills are inferred from what
+// the displayed book does around them:
+//  - a new order queues behind the size displayed at its price
+//  - size leaving a level at the touch trades from the front of the queue;
+//    once nothing is left ahead of us the rest of the decrease fills us
+//  - size leaving a level behind the touch is cancels, taken pro rata from
+//    ahead of and behind us
+//  - opposite liquidity arriving at or through our price trades with us,
+//    each size only once
+// Orders are kept sorted by price, so a level update only visits the
+// orders resting at that price.
+class PaperFillSimulator {
+public:
+    void add(uint32_t ref, Side side, Price price, Size size, Size queue_ahead);
+    void remove(uint32_t ref, Side side, Price price);
+
+    // Displayed size at one level changed; book already holds the new size
+    void onLevelChange(Side side, Price price, Size new_size, const OrderBook& book, std::vector<PaperFill>& fills);
+
+    // Re-read every level we rest at, e.g. after a full snapshot
+    void onBook(const OrderBook& book, std::vector<PaperFill>& fills);
+
+    // Fill orders the opposite side has reached
+    void checkCrosses(const OrderBook& book, std::vector<PaperFill>& fills);
+
+    // Estimated size ahead of the order, -1 if it is not tracked
+    Size queueAhead(uint32_t ref) const;
+    size_t size() const { return bids_.size() + asks_.size(); }
+    bool empty() const { return bids_.empty() && asks_.empty(); }
+
+private:
+    using Ticks = int64_t;
+    static constexpr double TICKS_PER_UNIT = 10000.0;
+
+    struct Entry {
+        uint32_t ref = 0;
+        Ticks ticks = 0;
+        Price price = 0.0;
+        Size remaining = 0.0;
+        Size ahead = 0.0;        // Displayed size with time priority over us
+        Size level_size = 0.0;   // Displayed size at our price when last seen
+        Size cross_depth = 0.0;  // Opposite size through our price already traded
+    };
+
+    std::vector<Entry> bids_;  // Highest price first, then time
+    std::vector<Entry> asks_;  // Lowest price first, then time
+    bool bids_crossed_ = false;  // Some entry holds a cross_depth to clear
+    bool asks_crossed_ = false;
+
+    static Ticks toTicks(Price price);
+    std::vector<Entry>& entries(Side side) { return side == Side::BUY ? bids_ : asks_; }
+
+    // [first, last) of the entries resting at ticks
+    std::pair<size_t, size_t> levelRange(Side side, Ticks ticks) const;
+
+    void applyLevelSize(Entry& entry, Size new_size, bool at_touch, std::vector<PaperFill>& fills);
+};
+
+} // namespace pmm
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pmm {
+
+enum class ScenarioAction {
+    SET_BOOK,      // Replace the displayed book for a token
+    SET_LEVEL,     // Set the displayed size at one price level
+    MARKET_ORDER   // Someone else trades aggressively against the book
+};
+
+struct ScenarioStep {
+    std::chrono::microseconds at{0};  // Offset from the start of the scenario
+    ScenarioAction action = ScenarioAction::SET_LEVEL;
+    TokenId token_id;
+    Side side = Side::BUY;
+    Price price = 0.0;
+    Size size = 0.0;
+    std::vector<std::pair<Price, Size>> bids;
+    std::vector<std::pair<Price, Size>> asks;
+};
+
+// Timed script of market activity for the mock exchange, built in code or
+// loaded from JSON:
+//   [{"at_ms": 0, "type": "book", "token": "T", "bids": [[0.45, 100]], "asks": [[0.55, 100]]},
+//    {"at_ms": 50, "type": "level", "token": "T", "side": "BUY", "price": 0.46, "size": 20},
+//    {"at_ms": 80, "type": "trade", "token": "T", "side": "SELL", "size": 30}]
+class Scenario {
+public:
+    Scenario& book(std::chrono::microseconds at, const TokenId& token_id,
+                   std::vector<std::pair<Price, Size>> bids,
+                   std::vector<std::pair<Price, Size>> asks);
+    Scenario& level(std::chrono::microseconds at, const TokenId& token_id, Side side, Price price, Size size);
+    Scenario& marketOrder(std::chrono::microseconds at, const TokenId& token_id, Side side, Size size);
+
+    const std::vector<ScenarioStep>& steps() const { return steps_; }
+    size_t size() const { return steps_.size(); }
+
+    static Scenario fromJson(const nlohmann::json& script);
+    static Scenario loadFile(const std::string& path);
+
+    // Two-sided book whose mid moves one tick up or down every interval
+    static Scenario randomWalk(const TokenId& token_id, Price start_mid, Price spread, size_t steps,
+                               std::chrono::microseconds interval, uint32_t seed = 1);
+
+private:
+    std::vector<ScenarioStep> steps_;
+};
+
+} // namespace pmm
@@ -1,55 +1,80 @@
 #pragma once
 
 #include "core/types.hpp"
-#include <deque>
+#include "core/ring_buffer.hpp"
+#include "strategy/trade_flow.hpp"
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 #include <cmath>
 
 namespace pmm {
 
-// Tracks fill quality for toxic flow detection
-struct FillQualityMetrics {
-    TokenId token_id;
-    OrderId order_id;
-    Side side;
-    Price fill_price;
-    Price mid_at_fill;
-    std::chrono::steady_clock::time_point fill_time;
-    double inventory_before;
-    double inventory_after;
-    
-    // Measured outcomes
-    double price_move_5s = 0.0;
-    double price_move_30s = 0.0;
+// Outcome of one fill once its markout is in
+struct FillOutcome {
+    double price_move = 0.0;  // Relative mid move at the markout horizon; negative = against us
     bool is_toxic = false;
-    bool metrics_captured = false;
 };
 
-// Volume-based time tracking
+// Volume-based time tracking: fill counts in one-second buckets over a
+// sliding window, so the rate is a running total rather than a walk over
+// every fill
 struct VolumeClockTracker {
-    std::deque<std::chrono::steady_clock::time_point> recent_fills;
-    std::chrono::seconds window = std::chrono::seconds(60);
+    static constexpr int64_t WINDOW_SECONDS = 60;
+    static constexpr size_t BUCKETS = 64;  // Power of two covering the window
+    static_assert(BUCKETS >= WINDOW_SECONDS, "Buckets must cover the window");
     
-    void recordFill() {
-        auto now = std::chrono::steady_clock::now();
-        recent_fills.push_back(now);
-        
-        // Remove old fills outside window
-        auto cutoff = now - window;
-        while (!recent_fills.empty() && recent_fills.front() < cutoff) {
-            recent_fills.pop_front();
+    std::array<uint32_t, BUCKETS> fills_per_second{};
+    int64_t newest_second = 0;
+    uint32_t window_fills = 0;
+    
+    void recordFill(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) {
+        int64_t second = toSecond(now);
+        advanceTo(second);
+        if (second <= newest_second - WINDOW_SECONDS) {
+            return;  // Older than the window
+        }
+        fills_per_second[second & (BUCKETS - 1)]++;
+        window_fills++;
+    }
+    
+    // Age the window to now without a fill
+    void advance(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) {
+        advanceTo(toSecond(now));
+    }
+    
+    static int64_t toSecond(std::chrono::steady_clock::time_point now) {
+        return std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    }
+    
+    // Drop the seconds that fall out of the window ending at second
+    void advanceTo(int64_t second) {
+        if (window_fills == 0 || second - newest_second >= WINDOW_SECONDS) {
+            fills_per_second.fill(0);
+            window_fills = 0;
+        } else {
+            for (int64_t s = newest_second + 1; s <= second; s++) {
+                uint32_t& expired = fills_per_second[(s - WINDOW_SECONDS) & (BUCKETS - 1)];
+                window_fills -= expired;
+                expired = 0;
+            }
         }
+        newest_second = std::max(newest_second, second);
     }
     
     double getFillRate() const {
-        if (recent_fills.empty()) return 0.0;
-        return static_cast<double>(recent_fills.size()) / window.count();
+        return static_cast<double>(window_fills) / WINDOW_SECONDS;
     }
     
     double getVolumeClockMultiplier(double baseline_rate = 0.05) const {
         // baseline_rate = expected fills per second in normal conditions
-        double current_rate = getFillRate();
+        return multiplierFor(getFillRate(), baseline_rate);
+    }
+    
+    static double multiplierFor(double current_rate, double baseline_rate) {
         if (current_rate < baseline_rate * 0.1) return 0.8; // Very quiet, lower risk
         
         // More volume = more information = higher risk
@@ -60,18 +85,37 @@ struct VolumeClockTracker {
 
 class AdverseSelectionManager {
 public:
+    using Clock = std::chrono::steady_clock;
+    
+    // Fills are scored on the mid move this long after them
+    static constexpr int MARKOUT_HORIZON_SEC = 30;
+    
     AdverseSelectionManager(double base_spread = 0.02);
     
-    // Called when we get filled
-    void recordFill(const TokenId& token_id, const OrderId& order_id, Side side, 
-                   Price fill_price, Price mid_at_fill, double inventory_before);
+    // Called when we get filled; drives the volume clock
+    void recordFill(const TokenId& token_id, Clock::time_point now = Clock::now());
+    
+    // Mid MARKOUT_HORIZON_SEC after a fill, from the markout engine
+    void recordMarkout(const TokenId& token_id, Side side, Price mid_at_fill, Price mid_later);
+    
+    // A market trade print; once a token has any, its volume clock runs on
+    // market volume against the session average instead of on our fills
+    void recordTrade(const TokenId& token_id, Price price, Size size, Side side,
+                     Clock::time_point now = Clock::now());
+    const TradeFlow* getTradeFlow(const TokenId& token_id) const;
     
-    // Update with current market state (called periodically)
-    void updateMetrics(const TokenId& token_id, Price current_mid);
+    // Age every token's fill and trade windows to now and refresh the cached
+    // volume scores. Fills and trades only move the windows of the token they
+    // hit, so without this a token that goes quiet keeps its last busy score;
+    // the strategy calls it from its once-a-second timer.
+    void advance(Clock::time_point now = Clock::now());
     
     // Get spread adjustment multiplier for a market
     double getSpreadMultiplier(const TokenId& token_id, Side side, double inventory) const;
     
+    // Larger of the bid and ask multipliers, with one lookup
+    double getWorstSpreadMultiplier(const TokenId& token_id, double inventory) const;
+    
     // Get detailed AS scores for monitoring
     struct AdverseSelectionScores {
         double toxic_flow_score;      // Based on recent fill quality
@@ -86,21 +130,44 @@ public:
     void decay();  // Called periodically to reduce adjustments over time
     
 private:
+    // Recent fill outcomes plus running aggregates over them, so the
+    // multiplier is read from a cache instead of rescanning the history
+    struct TokenFlow {
+        FixedRing<FillOutcome, 64> outcomes;
+        VolumeClockTracker volume_clock;
+        TradeFlow market;
+        double base_multiplier = 1.0;  // From toxic fill history, decays toward 1.0
+        
+        int toxic_count = 0;
+        double adverse_move_sum = 0.0;  // Sum of min(0, price_move)
+        
+        // Cached from the above, refreshed whenever one of them changes and
+        // on advance()
+        double toxic_score = 1.0;
+        double volume_score = 1.0;
+        double flow_multiplier = 1.0;  // base_multiplier * toxic_score
+    };
+    
     double base_spread_;
     
-    // Per-token tracking
-    std::unordered_map<TokenId, std::deque<FillQualityMetrics>> fill_history_;
-    std::unordered_map<TokenId, VolumeClockTracker> volume_clocks_;
-    std::unordered_map<TokenId, double> spread_multipliers_;  // Per-token spread adjustment
+    // Per-token tracking, stored contiguously and indexed by token
+    std::unordered_map<TokenId, uint32_t> flow_index_;
+    std::vector<TokenFlow> flows_;
     
     // Analyze recent fill quality
-    double calculateToxicFlowScore(const TokenId& token_id) const;
+    static double calculateToxicFlowScore(const TokenFlow& flow);
+    static void refresh(TokenFlow& flow);
+    static double volumeScore(const TokenFlow& flow);
+    double combine(const TokenFlow* flow, Side side, double inventory) const;
+    const TokenFlow* findFlow(const TokenId& token_id) const;
+    TokenFlow& flowFor(const TokenId& token_id);
     
     // Inventory-based risk assessment
     double calculateInventoryRiskScore(Side side, double inventory, double max_position = 1000.0) const;
     
     // Parameters
     static constexpr size_t MAX_FILL_HISTORY = 50;
+    static_assert(MAX_FILL_HISTORY < decltype(TokenFlow::outcomes)::capacity(), "Outcome ring must hold the history plus one");
     static constexpr double TOXIC_THRESHOLD = -0.005;  // Price moved against us by 0.5%
     static constexpr double DECAY_RATE = 0.95;  // Multiplier decay per period
     static constexpr double MIN_MULTIPLIER = 1.0;
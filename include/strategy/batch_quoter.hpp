@@ -0,0 +1,63 @@
+#pragma once
+
+#include "strategy/quoting_policies.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace pmm {
+
+// DefaultQuoting inputs and results for many tokens, one array per field
+struct QuoteBatch {
+    void clear();
+    size_t size() const { return mid.size(); }
+
+    size_t add(const QuoteInputs& in);
+
+    QuoteInputs inputs(size_t i) const;
+    bool valid(size_t i) const { return quoted[i] != 0; }
+
+    // Everything except created_at
+    Quote quote(size_t i) const;
+
+    // Inputs
+    std::vector<double> best_bid;
+    std::vector<double> best_ask;
+    std::vector<double> mid;
+    std::vector<double> imbalance;
+    std::vector<double> inventory;
+    std::vector<double> avg_cost;
+    std::vector<double> inventory_dollars;
+    std::vector<double> max_position;
+    std::vector<double> spread_pct;
+    std::vector<double> spread_multiplier;
+    std::vector<double> risk_aversion;
+    std::vector<double> volatility;
+    std::vector<double> time_urgency;
+    std::vector<int> ttl_seconds;
+
+    // Outputs
+    std::vector<double> bid;
+    std::vector<double> ask;
+    std::vector<double> quote_size;
+    std::vector<uint8_t> quoted;  // 0 when the token should not be quoted
+};
+
+enum class BatchKernel {
+    SCALAR,
+    AVX2
+};
+
+// AVX2 when this CPU has it
+BatchKernel bestBatchKernel();
+
+// Same results, bit for bit, as DefaultQuoting::quote on each token. The
+// AVX2 kernel is compiled for AVX2 only, without FMA, so no multiply-add
+// is fused that the scalar path rounds twice.
+//
+// Only single-outcome quotes go through here. Outcomes of a condition
+// quoted together are priced by ConditionQuoter, whose fair values depend
+// on every sibling and whose rounding and sizing differ per side, so they
+// stay on its scalar path.
+void quoteBatch(QuoteBatch& batch, BatchKernel kernel = bestBatchKernel());
+
+} // namespace pmm
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "strategy/quoting_policies.hpp"
+#include "strategy/token_slots.hpp"
+#include <vector>
+
+namespace pmm {
+
+// Quotes every outcome of one condition together.
+//
+// Each outcome's inputs are what its MarketMaker would quote from
+// (MarketMaker::prepareQuote): fair value from the market's
+// FairValueModel, the token's estimated volatility, spread and risk
+// settings, time urgency and cost basis. Exactly one outcome pays out, so
+// fair values are shifted equally until they sum to 1 (for a binary
+// market, Yes = 1 - No). Holding the same number of shares in every
+// outcome is riskless, so each outcome is then priced with DefaultQuoting's
+// policies using its position relative to the probability weighted
+// average position in place of the raw position; the skew, cost floor
+// and size limits only see the unhedged part. Bids round down and asks up
+// to the cent, and sizes are set per side. Our bids never sum to 1 or more and
+// our asks never to 1 or less, so the quotes cannot be arbitraged against
+// each other, and no quote crosses its own book.
+//
+// Per-outcome inputs and outputs are kept in parallel arrays and computed
+// in a single pass over all outcomes. A side with size 0 is not quoted.
+class ConditionQuoter {
+public:
+    size_t addOutcome(TokenHandle token);
+    size_t size() const { return tokens_.size(); }
+    TokenHandle token(size_t outcome) const { return tokens_[outcome]; }
+
+    void setInputs(size_t outcome, const QuoteInputs& inputs) { inputs_[outcome] = inputs; }
+
+    // Fills the outputs below; false until every outcome has a two-sided book
+    bool quote();
+
+    Price fairValue(size_t outcome) const { return fair_[outcome]; }
+    Price bidPrice(size_t outcome) const { return bid_[outcome]; }
+    Price askPrice(size_t outcome) const { return ask_[outcome]; }
+    Size bidSize(size_t outcome) const { return bid_size_[outcome]; }
+    Size askSize(size_t outcome) const { return ask_size_[outcome]; }
+    int ttlSeconds(size_t outcome) const { return ttl_seconds_[outcome]; }
+
+    // Standard deviation of the condition's payoff in dollars, at the last quote
+    double inventoryRisk() const { return inventory_risk_; }
+
+private:
+    std::vector<TokenHandle> tokens_;
+    std::vector<QuoteInputs> inputs_;
+
+    // Outputs
+    std::vector<Price> fair_;
+    std::vector<Price> bid_;
+    std::vector<Price> ask_;
+    std::vector<Size> bid_size_;
+    std::vector<Size> ask_size_;
+    std::vector<int> ttl_seconds_;
+    double inventory_risk_ = 0.0;
+
+    void keepBidsAndAsksConsistent();
+    void keepInsideOwnBooks();
+};
+
+} // namespace pmm
@@ -6,6 +6,8 @@
 
 namespace pmm {
 
+struct QuoteInputs;
+
 struct Quote {
     Price bid_price;
     Size bid_size;
@@ -23,6 +25,11 @@ public:
                                       const MarketMetadata* metadata = nullptr,
                                       double spread_multiplier = 1.0);
     
+    // Gathers what generateQuote quotes from, for callers that quote many
+    // tokens at once with quoteBatch
+    void prepareQuote(const OrderBook& book, const MarketMetadata* metadata,
+                      double spread_multiplier, QuoteInputs& in);
+    
     void updateInventory(Side side, Size filled_size, Price fill_price);
     
     void restoreState(double inventory, double avg_cost, double realized_pnl);
@@ -32,7 +39,9 @@ public:
     double getRealizedPnL() const { return realized_pnl_; }
     double getUnrealizedPnL(Price current_mid) const;
     
-    void updateVolatility(Price old_mid, Price new_mid, double time_elapsed_seconds);
+    // From the token's VolatilityEstimator, which samples the book on a fixed grid
+    void setVolatility(double volatility) { volatility_ = volatility; }
+    double getVolatility() const { return volatility_; }
     
     void setMarketCloseTime(std::chrono::system_clock::time_point close_time);
     double getTimeUrgency() const;
@@ -48,14 +57,9 @@ private:
     double inventory_dollars_;
     double realized_pnl_;
     double avg_cost_;
-
-    Price last_mid_;
-    std::chrono::steady_clock::time_point last_update_time_;
     
     std::chrono::system_clock::time_point market_close_time_;
     bool has_close_time_ = false;
-
-    Price roundToCent(Price price);
 };
 
 } // namespace pmm
\ No newline at end of file
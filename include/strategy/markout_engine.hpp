@@ -0,0 +1,126 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "core/ring_buffer.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace pmm {
+
+// A fill awaiting markouts. Plain data so the ring can recycle records
+// without touching the heap.
+struct MarkoutRecord {
+    static constexpr size_t MAX_HORIZONS = 8;
+
+    uint64_t fill_seq = 0;
+    OrderId order_id = INVALID_ORDER_ID;
+    uint32_t token = 0;  // The caller's token handle
+    Side side = Side::BUY;
+    std::chrono::system_clock::time_point fill_time;
+    Price fill_price = 0.0;
+    Price mid_at_fill = 0.0;
+    Price best_bid_at_fill = 0.0;
+    Price best_ask_at_fill = 0.0;
+    double spread_at_fill = 0.0;
+    double imbalance_at_fill = 0.0;
+    double inventory_before = 0.0;
+    double inventory_after = 0.0;
+    std::array<Price, MAX_HORIZONS> mid_later{};  // Per horizon; 0.0 = no valid book at the horizon
+
+    // Mid move since the fill, measured from mid_at_fill like every other
+    // markout consumer, signed so positive is in the fill's favour
+    double priceMove(size_t horizon) const {
+        return (side == Side::BUY) ? (mid_later[horizon] - mid_at_fill) : (mid_at_fill - mid_later[horizon]);
+    }
+};
+
+// Captures the mid a fixed set of horizons after every fill and hands each
+// markout to whoever needs it, so a fill is marked out once rather than by
+// every consumer scanning its own copy of the fill history.
+//
+// Fills are registered in time order, so each horizon keeps a cursor to the
+// first fill it has not captured yet and a capture pass only looks at the
+// fills that just came due.
+class MarkoutEngine {
+public:
+    using Clock = std::chrono::system_clock;
+
+    static constexpr size_t MAX_HORIZONS = MarkoutRecord::MAX_HORIZONS;
+    static constexpr size_t CAPACITY = 1024;
+
+    // Called once per fill and horizon, after mid_later[horizon] is set
+    using MarkoutHandler = std::function<void(const MarkoutRecord&, size_t horizon)>;
+    // Called once per fill as it leaves the engine, either with every
+    // horizon captured or early when the ring is full
+    using CompletionHandler = std::function<void(const MarkoutRecord&)>;
+
+    // Horizons in seconds, ascending; throws std::invalid_argument otherwise
+    explicit MarkoutEngine(std::vector<int> horizons_sec = {1, 5, 30, 60});
+
+    void onMarkout(MarkoutHandler handler) { markout_handlers_.push_back(std::move(handler)); }
+    void onCompletion(CompletionHandler handler) { completion_handlers_.push_back(std::move(handler)); }
+
+    const std::vector<int>& horizons() const { return horizons_sec_; }
+    int horizonIndex(int seconds) const;  // -1 when not configured
+
+    // Mid at a horizon in seconds; 0.0 when not configured or not captured
+    Price midAt(const MarkoutRecord& record, int seconds) const;
+
+    // Returns the stored record so the caller can finish filling it in
+    // before the first capture
+    MarkoutRecord& registerFill(const MarkoutRecord& fill);
+
+    // Capture every horizon that has come due. mid_of(token) returns the
+    // current mid, or 0.0 when the token has no valid book.
+    template <typename MidOf>
+    void capture(Clock::time_point now, MidOf&& mid_of);
+
+    // When the next horizon comes due, so the caller can capture on time
+    // instead of on its next poll; time_point::max() when nothing is pending
+    Clock::time_point nextDue() const;
+
+    size_t pending() const { return fills_.size(); }
+    uint64_t totalFills() const { return total_fills_; }
+
+private:
+    std::vector<int> horizons_sec_;
+    std::vector<MarkoutHandler> markout_handlers_;
+    std::vector<CompletionHandler> completion_handlers_;
+
+    FixedRing<MarkoutRecord, CAPACITY> fills_;
+    std::array<uint64_t, MAX_HORIZONS> cursors_{};  // Absolute ring sequence per horizon
+    uint64_t total_fills_ = 0;
+
+    void completeOldest();
+};
+
+template <typename MidOf>
+void MarkoutEngine::capture(Clock::time_point now, MidOf&& mid_of) {
+    for (size_t h = 0; h < horizons_sec_.size(); h++) {
+        const auto horizon = std::chrono::seconds(horizons_sec_[h]);
+        uint64_t& cursor = cursors_[h];
+
+        for (; cursor < fills_.tailSeq(); cursor++) {
+            MarkoutRecord& record = fills_.atSeq(cursor);
+            if (now - record.fill_time < horizon) break;
+
+            Price mid = mid_of(record.token);
+            if (mid <= 0.0) continue;  // Leave the markout at 0.0
+
+            record.mid_later[h] = mid;
+            for (const MarkoutHandler& handler : markout_handlers_) {
+                handler(record, h);
+            }
+        }
+    }
+
+    // The longest horizon trails the others, so everything before it is complete
+    while (fills_.headSeq() < cursors_[horizons_sec_.size() - 1]) {
+        completeOldest();
+    }
+}
+
+} // namespace pmm
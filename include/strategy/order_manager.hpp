@@ -2,7 +2,15 @@
 
 #include "core/types.hpp"
 #include "core/event_queue.hpp"
+#include "core/flat_id_map.hpp"
 #include "data/order_book.hpp"
+#include "sim/paper_fill_simulator.hpp"
+#include "strategy/risk_gate.hpp"
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <optional>
@@ -16,44 +24,172 @@ enum class TradingMode {
     LIVE
 };
 
-class TradingLogger; 
+class TradingLogger;
+class OrderGateway;
 
 class OrderManager {
+    static constexpr uint32_t NO_ORDER = std::numeric_limits<uint32_t>::max();
+
+    static constexpr size_t sideIndex(Side side) { return side == Side::BUY ? 0 : 1; }
+
+    // Pool entry. A token's working orders on one side form an intrusive
+    // doubly linked list through prev/next, so per-token work never looks
+    // at other tokens' orders.
+    struct OrderNode {
+        Order order;
+        uint32_t prev = NO_ORDER;
+        uint32_t next = NO_ORDER;
+        uint32_t token = NO_ORDER;  // Index into token_orders_
+    };
+
+    // Working orders plus the last top of book seen for one token
+    struct TokenOrders {
+        std::array<uint32_t, 2> head{NO_ORDER, NO_ORDER};  // Indexed by sideIndex()
+        size_t count = 0;
+        Price best_bid = 0.0;
+        Price best_ask = 0.0;
+        Price mid = 0.0;
+        Price spread = 0.0;
+        PaperFillSimulator paper;  // Paper mode only
+        RiskGate::ConditionHandle risk_condition = RiskGate::NO_CONDITION;
+    };
+
 public:
+    // Non-allocating view over one token's working orders, bids first.
+    // Valid until the next order is placed or cancelled.
+    class OrderView {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Order;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Order*;
+            using reference = const Order&;
+
+            iterator() = default;
+            iterator(const std::vector<OrderNode>* nodes, const TokenOrders* token, size_t side, uint32_t node)
+                : nodes_(nodes), token_(token), side_(side), node_(node) {
+                skipEmptySides();
+            }
+
+            reference operator*() const { return (*nodes_)[node_].order; }
+            pointer operator->() const { return &(*nodes_)[node_].order; }
+
+            iterator& operator++() {
+                node_ = (*nodes_)[node_].next;
+                skipEmptySides();
+                return *this;
+            }
+
+            bool operator==(const iterator& other) const { return node_ == other.node_; }
+            bool operator!=(const iterator& other) const { return node_ != other.node_; }
+
+        private:
+            const std::vector<OrderNode>* nodes_ = nullptr;
+            const TokenOrders* token_ = nullptr;
+            size_t side_ = 0;
+            uint32_t node_ = NO_ORDER;
+
+            void skipEmptySides() {
+                while (node_ == NO_ORDER && token_ && side_ + 1 < token_->head.size()) {
+                    node_ = token_->head[++side_];
+                }
+            }
+        };
+
+        OrderView(const std::vector<OrderNode>* nodes, const TokenOrders* token)
+            : nodes_(nodes), token_(token) {}
+
+        iterator begin() const {
+            return token_ ? iterator(nodes_, token_, 0, token_->head[0]) : end();
+        }
+        iterator end() const { return iterator(); }
+        size_t size() const { return token_ ? token_->count : 0; }
+        bool empty() const { return size() == 0; }
+
+    private:
+        const std::vector<OrderNode>* nodes_;
+        const TokenOrders* token_;
+    };
+
     explicit OrderManager(EventQueue& event_queue, TradingMode mode = TradingMode::PAPER, TradingLogger* logger = nullptr);
-    
-    OrderId placeOrder(const TokenId& token_id, Side side, Price price, Size size, const std::string& market_id);
 
-    bool cancelOrder(const OrderId& order_id, const std::string& market_id, CancelReason reason = CancelReason::UNKNOWN);
-    bool cancelAllOrders(const TokenId& token_id, const std::string& market_id, CancelReason reason = CancelReason::UNKNOWN);
+    // In paper mode book seeds the order's queue position; without one it joins at the front
+    OrderId placeOrder(const TokenId& token_id, Side side, Price price, Size size, std::string_view market_name,
+                       const OrderBook* book = nullptr);
+
+    bool cancelOrder(OrderId order_id, std::string_view market_name, CancelReason reason = CancelReason::UNKNOWN);
+    bool cancelAllOrders(const TokenId& token_id, std::string_view market_name, CancelReason reason = CancelReason::UNKNOWN);
     bool cancelAllOrders(CancelReason reason = CancelReason::SHUTDOWN);
 
+    // Full book, e.g. after a snapshot
     void updateOrderBook(const TokenId& token_id, const OrderBook& book);
-    
-    std::vector<Order> getOpenOrders(const TokenId& token_id) const;
-    size_t getOpenOrderCount() const;
+    // Incremental update; book already holds the changed levels
+    void updateOrderBook(const TokenId& token_id, const OrderBook& book,
+                         const std::vector<std::pair<Price, Size>>& bid_changes,
+                         const std::vector<std::pair<Price, Size>>& ask_changes);
+
+    // Paper mode: estimated displayed size ahead of the order, -1 if unknown
+    Size getQueueAhead(OrderId order_id) const;
+
+    OrderView getOpenOrders(const TokenId& token_id) const;
+    size_t getOpenOrderCount() const { return order_index_.size(); }
+    size_t getOpenOrderCount(const TokenId& token_id) const;
     size_t getActiveOrderCount() const { return getOpenOrderCount(); }
-    size_t getBidCount() const;
-    size_t getAskCount() const;
+    size_t getBidCount() const { return side_counts_[sideIndex(Side::BUY)]; }
+    size_t getAskCount() const { return side_counts_[sideIndex(Side::SELL)]; }
 
     void setTradingMode(TradingMode mode);
     TradingMode getTradingMode() const { return trading_mode_; }
     bool isPaperTrading() const { return trading_mode_ == TradingMode::PAPER; }
 
+    // Live orders are handed to the gateway; it must outlive this manager
+    void setOrderGateway(OrderGateway* gateway) { gateway_ = gateway; }
+
+    // Working order notional is reported to the gate; it must outlive this manager
+    void setRiskGate(RiskGate* gate) { risk_gate_ = gate; }
+    void setRiskCondition(const TokenId& token_id, RiskGate::ConditionHandle condition);
+
+    // Live order lifecycle, fed from gateway events on the strategy thread
+    void onOrderAcked(OrderId order_id, const std::string& exchange_order_id);
+    void onOrderCancelled(OrderId order_id);
+    void onOrderRejected(OrderId order_id, RejectedRequest request, const std::string& reason);
+    void onOrderFilled(OrderId order_id, Size filled_size);
+
 private:
+    static constexpr size_t INITIAL_POOL_SIZE = 256;
+    // Fill sizes summed in floating point can land just short of the order size
+    static constexpr Size FILL_EPSILON = 1e-9;
+
     EventQueue& event_queue_;
     TradingMode trading_mode_;
-    TradingLogger* trading_logger_; 
+    TradingLogger* trading_logger_;
+    OrderGateway* gateway_ = nullptr;
+    RiskGate* risk_gate_ = nullptr;
+
+    std::vector<OrderNode> nodes_;
+    std::vector<uint32_t> free_nodes_;
+    FlatIdMap order_index_;  // OrderId -> node
+    std::vector<TokenOrders> token_orders_;
+    std::unordered_map<TokenId, uint32_t> token_index_;
+    std::array<size_t, 2> side_counts_{};
+    std::vector<PaperFill> paper_fills_;  // Scratch, reused across updates
+    OrderId next_order_id_;
 
-    std::unordered_map<OrderId, Order> orders_;
-    uint64_t next_order_id_;
-    std::unordered_map<TokenId, OrderBook> market_books_;
+    const TokenOrders* findTokenOrders(const TokenId& token_id) const;
+    uint32_t tokenOrdersIndex(const TokenId& token_id);
+    uint32_t insertOrder(OrderId order_id, const TokenId& token_id, Side side, Price price, Size size);
+    void removeOrder(uint32_t node);
+    void releaseWorking(uint32_t node, Size size);
+    void cancelNode(uint32_t node, std::string_view market_name, CancelReason reason);
 
-    void checkForFills(const TokenId& token_id, const OrderBook& book);
-    void generateFill(const OrderId& order_id, Price fill_price, Size fill_size);
+    void updateTopOfBook(TokenOrders& token_orders, const OrderBook& book);
+    void applyPaperFills();
+    void generateFill(uint32_t node, Price fill_price, Size fill_size);
 
     void placeOrderLive(const Order& order);
-    void cancelOrderLive(const OrderId& order_id);
+    void cancelOrderLive(OrderId order_id);
 };
 
-} // namespace pmm
\ No newline at end of file
+} // namespace pmm
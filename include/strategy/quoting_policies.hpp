@@ -0,0 +1,190 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "strategy/market_maker.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pmm {
+
+// Everything a quoting kernel reads, gathered up front so the kernel
+// itself does no lookups, logging or clock reads
+struct QuoteInputs {
+    Price best_bid = 0.0;
+    Price best_ask = 0.0;
+    Price mid = 0.0;                 // Fair value: the mid, or the market's FairValueModel
+    double imbalance = 0.0;          // -1 (all asks) to 1 (all bids); 0 when fair value already leans
+
+    double inventory = 0.0;          // Shares, signed
+    double avg_cost = 0.0;
+    double inventory_dollars = 0.0;
+    double max_position = 1000.0;    // Dollars
+
+    double spread_pct = 0.02;
+    double spread_multiplier = 1.0;  // Adverse selection widening
+    double risk_aversion = 0.1;
+    double volatility = 0.05;
+    double time_urgency = 0.0;       // 0 far from close, 1 at close
+
+    int ttl_seconds = 90;            // Recommended by market metadata
+};
+
+struct QuotePrices {
+    Price bid;
+    Price ask;
+};
+
+// Fair value policies
+
+struct MidFair {
+    static Price fair(const QuoteInputs& in) { return in.mid; }
+};
+
+// Spread policies: half the width quoted around the reservation prices
+
+struct ProportionalSpread {
+    static double halfWidth(const QuoteInputs& in, Price fair) {
+        return fair * (in.spread_pct * in.spread_multiplier) / 2.0;
+    }
+};
+
+// Lean policies: a shift applied to both sides after the spread
+
+struct NoLean {
+    static double lean(const QuoteInputs&) { return 0.0; }
+};
+
+struct ImbalanceLean {
+    static constexpr double MAX_ADJUSTMENT = 0.005;
+    static double lean(const QuoteInputs& in) { return in.imbalance * MAX_ADJUSTMENT; }
+};
+
+// Skew policies: unrounded bid and ask around fair value
+
+template <typename Lean = NoLean>
+struct NoSkew {
+    static QuotePrices prices(const QuoteInputs& in, Price fair, double half_width) {
+        double lean = Lean::lean(in);
+        return {fair - half_width + lean, fair + half_width + lean};
+    }
+};
+
+// Avellaneda-Stoikov reservation prices, inventory normalized per 100 shares
+template <typename Lean = NoLean>
+struct InventorySkew {
+    static QuotePrices prices(const QuoteInputs& in, Price fair, double half_width) {
+        double q = in.inventory / 100.0;
+        double gamma = in.risk_aversion;
+        double sigma_sq = in.volatility * in.volatility;
+        double reservation_bid = fair - (q + 1.0) * gamma * sigma_sq;
+        double reservation_ask = fair + (q - 1.0) * gamma * sigma_sq;
+        double lean = Lean::lean(in);
+        return {reservation_bid - half_width + lean, reservation_ask + half_width + lean};
+    }
+};
+
+// Floor policies: the lowest ask allowed for the inventory held
+
+struct NoFloor {
+    static Price minAsk(const QuoteInputs&) { return 0.0; }
+};
+
+// Don't sell a long below cost plus a profit margin that shrinks as the
+// market nears close or the position nears its limit
+struct CostFloor {
+    static constexpr double BASE_MIN_PROFIT = 0.015;
+    static constexpr double EXIT_URGENCY = 0.9;
+    static constexpr double EXIT_MIN_PROFIT = -0.01;  // Accept up to 1% loss
+
+    static Price minAsk(const QuoteInputs& in) {
+        double inventory_risk = std::abs(in.inventory_dollars) / in.max_position;
+        double urgency = std::max(in.time_urgency, inventory_risk);
+        double min_profit = (urgency > EXIT_URGENCY) ? EXIT_MIN_PROFIT : BASE_MIN_PROFIT * (1.0 - urgency);
+        bool long_position = (in.inventory > 0) & (in.avg_cost > 0);
+        return long_position ? in.avg_cost * (1.0 + min_profit) : 0.0;
+    }
+};
+
+// Size policies
+
+struct CapacitySize {
+    static constexpr Size MAX_SIZE = 100.0;
+    static constexpr Size MIN_SIZE = 10.0;
+
+    static Size size(const QuoteInputs& in) {
+        double remaining_capacity = in.max_position - std::abs(in.inventory);
+        return std::min(MAX_SIZE, remaining_capacity / in.mid);
+    }
+};
+
+// TTL policies
+
+struct MetadataTTL {
+    static int seconds(const QuoteInputs& in) { return in.ttl_seconds; }
+};
+
+template <int Seconds>
+struct FixedTTL {
+    static int seconds(const QuoteInputs&) { return Seconds; }
+};
+
+// A quoting strategy assembled from one policy of each kind.
+//
+// Policies are stateless types with static functions, so the whole quote
+// inlines into straight-line arithmetic; the checks that decide whether
+// to quote are folded into one flag at the end instead of early returns.
+// quote() fills every field of out except created_at and returns false
+// when nothing should be quoted.
+template <typename Fair, typename Skew, typename Spread, typename Floor, typename Sizing, typename TTL>
+struct QuotingKernel {
+    // For callers that price from the same policies with their own checks
+    // (ConditionQuoter)
+    using FairPolicy = Fair;
+    using SkewPolicy = Skew;
+    using SpreadPolicy = Spread;
+    using FloorPolicy = Floor;
+    using SizePolicy = Sizing;
+    using TTLPolicy = TTL;
+
+    static constexpr Price MIN_PRICE = 0.01;
+    static constexpr Price MAX_PRICE = 0.99;
+    static constexpr Price MIN_MARKET_SPREAD = 0.01;
+
+    static Price roundToCent(Price price) {
+        return std::round(price * 100.0) / 100.0;
+    }
+
+    static bool quote(const QuoteInputs& in, Quote& out) {
+        Price fair = Fair::fair(in);
+        QuotePrices prices = Skew::prices(in, fair, Spread::halfWidth(in, fair));
+
+        Price bid = roundToCent(prices.bid);
+        Price ask = std::max(roundToCent(prices.ask), Floor::minAsk(in));
+        bid = std::max(MIN_PRICE, std::min(MAX_PRICE, bid));
+        ask = std::max(MIN_PRICE, std::min(MAX_PRICE, ask));
+
+        Size size = Sizing::size(in);
+
+        out.bid_price = bid;
+        out.ask_price = ask;
+        out.bid_size = size;
+        out.ask_size = size;
+        out.ttl_seconds = TTL::seconds(in);
+
+        return (in.best_ask - in.best_bid >= MIN_MARKET_SPREAD)
+             & (ask > bid)
+             & (bid < in.best_ask)
+             & (ask > in.best_bid)
+             & (size >= Sizing::MIN_SIZE);
+    }
+};
+
+// The production strategy used by MarketMaker
+using DefaultQuoting = QuotingKernel<MidFair, InventorySkew<ImbalanceLean>, ProportionalSpread,
+                                     CostFloor, CapacitySize, MetadataTTL>;
+
+// No inventory or imbalance skew and no cost floor, for observation or tests
+using SymmetricQuoting = QuotingKernel<MidFair, NoSkew<NoLean>, ProportionalSpread,
+                                       NoFloor, CapacitySize, FixedTTL<90>>;
+
+} // namespace pmm
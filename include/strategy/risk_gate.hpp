@@ -0,0 +1,156 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace pmm {
+
+// Hard pre-trade limits, in dollars unless noted
+struct RiskLimits {
+    double max_order_notional = 100.0;
+    double max_condition_net = 500.0;      // |net| per condition_id
+    double max_condition_gross = 1000.0;
+    double max_net_exposure = 2000.0;      // |net| across all conditions
+    double max_gross_exposure = 5000.0;
+    double max_orders_per_second = 50.0;
+    double order_burst = 100.0;            // Orders allowed back to back
+};
+
+enum class RiskCheck {
+    OK,
+    KILL_SWITCH,
+    UNREGISTERED,     // Token has no condition and outcome slot in the gate
+    ORDER_NOTIONAL,
+    CONDITION_NET,
+    CONDITION_GROSS,
+    NET_EXPOSURE,
+    GROSS_EXPOSURE,
+    RATE_LIMIT
+};
+
+const char* toString(RiskCheck check);
+
+// Dollar exposure read back from the gate's counters. Complete sets (one
+// share of every outcome of a condition) pay $1 whatever happens, so
+// positions count only beyond them.
+struct RiskExposure {
+    double net = 0.0;           // Signed position notional, buys positive
+    double gross = 0.0;         // Sum of absolute position notional per outcome
+    double working_buy = 0.0;   // Notional of open buy orders
+    double working_sell = 0.0;
+};
+
+// Pre-trade risk checks between the strategy and the order manager.
+//
+// Exposure is kept in atomically updated fixed-point counters per
+// condition and in total. Each condition also keeps its outcomes'
+// positions, so shares held in every outcome are netted out as complete
+// sets; this assumes all of a condition's outcomes are registered. Orders
+// are checked against their worst case: every working order on the same
+// side filling, plus the new one. Tokens the gate couldn't register are
+// rejected. Registration, position updates and checkOrder happen on the
+// strategy thread; kill, the working order updates and the exposure
+// getters are safe from any thread.
+class RiskGate {
+public:
+    using ConditionHandle = uint32_t;
+    static constexpr ConditionHandle NO_CONDITION = std::numeric_limits<ConditionHandle>::max();
+    static constexpr uint32_t MAX_OUTCOMES = 8;
+    static constexpr uint32_t NO_OUTCOME = std::numeric_limits<uint32_t>::max();
+
+    explicit RiskGate(RiskLimits limits = RiskLimits{}, size_t max_conditions = 1024);
+
+    // Returns NO_CONDITION, logged, once max_conditions are registered
+    ConditionHandle registerCondition(const std::string& condition_id);
+    ConditionHandle findCondition(const std::string& condition_id) const;
+
+    // Index of a new outcome of condition; NO_OUTCOME, logged, past MAX_OUTCOMES
+    uint32_t registerOutcome(ConditionHandle condition);
+
+    // Consumes a rate limit token only when every other check passes
+    RiskCheck checkOrder(ConditionHandle condition, uint32_t outcome, Side side, Price price, Size size);
+
+    // Working order notional, from the order manager
+    void onOrderOpened(ConditionHandle condition, Side side, double notional);
+    void onOrderClosed(ConditionHandle condition, Side side, double notional);
+
+    // An outcome's position is now shares at avg_cost
+    void onPositionChanged(ConditionHandle condition, uint32_t outcome, Size shares, Price avg_cost);
+
+    // Position notional of a token not registered with the gate (e.g.
+    // restored before its market); counts towards the portfolio only
+    void onUnregisteredPositionChanged(double old_notional, double new_notional);
+
+    // Blocks every order until reset(); true if this call tripped it
+    bool kill();
+    void reset() { killed_.store(false, std::memory_order_release); }
+    bool killed() const { return killed_.load(std::memory_order_acquire); }
+
+    RiskExposure conditionExposure(ConditionHandle condition) const;
+    RiskExposure totalExposure() const;
+    const RiskLimits& limits() const { return limits_; }
+
+private:
+    using Micros = int64_t;  // Millionths of a dollar
+    static constexpr double MICROS_PER_DOLLAR = 1e6;
+
+    struct alignas(64) Counters {
+        std::atomic<Micros> net{0};
+        std::atomic<Micros> gross{0};
+        std::atomic<Micros> working_buy{0};
+        std::atomic<Micros> working_sell{0};
+    };
+
+    // Strategy thread only, next to each condition's counters
+    struct OutcomePositions {
+        std::array<double, MAX_OUTCOMES> shares{};
+        std::array<double, MAX_OUTCOMES> avg_cost{};
+        uint32_t count = 0;
+        Micros net = 0;    // As last added to the counters
+        Micros gross = 0;
+    };
+
+    struct Limits {
+        Micros order_notional;
+        Micros condition_net;
+        Micros condition_gross;
+        Micros net;
+        Micros gross;
+    };
+
+    RiskLimits limits_;
+    Limits micros_;
+    std::atomic<bool> killed_{false};
+
+    Counters total_;
+    std::unique_ptr<Counters[]> conditions_;
+    std::unique_ptr<OutcomePositions[]> positions_;
+    size_t max_conditions_;
+    std::atomic<size_t> condition_count_{0};  // Published after the slot is indexed
+    std::unordered_map<std::string, ConditionHandle> condition_index_;
+
+    // Rate limit as a GCRA: the theoretical arrival time of the next order
+    alignas(64) std::atomic<int64_t> next_order_ns_{0};
+    int64_t order_interval_ns_;
+    int64_t burst_tolerance_ns_;
+
+    static Micros toMicros(double dollars);
+    static RiskExposure toExposure(const Counters& counters);
+    // With outcome's position replaced by shares at avg_cost
+    static void netExposure(const OutcomePositions& positions, uint32_t outcome, double shares, double avg_cost,
+                            Micros& net, Micros& gross);
+    static RiskCheck checkExposure(const Counters& counters, Side side, Micros net_change, Micros gross_change,
+                                   Micros max_net, Micros max_gross, RiskCheck net_breach, RiskCheck gross_breach);
+    void applyExposure(ConditionHandle condition, Micros net, Micros gross);
+    bool takeRateToken();
+    Counters* counters(ConditionHandle condition);
+};
+
+} // namespace pmm
@@ -2,24 +2,60 @@
 
 #include "core/types.hpp"
 #include "core/event_queue.hpp"
+#include "core/ring_buffer.hpp"
+#include "core/seqlock.hpp"
 #include "data/order_book.hpp"
 #include "strategy/market_maker.hpp"
 #include "strategy/order_manager.hpp"
+#include "strategy/risk_gate.hpp"
 #include "strategy/adverse_selection.hpp"
+#include "strategy/batch_quoter.hpp"
+#include "strategy/condition_quoter.hpp"
+#include "strategy/markout_engine.hpp"
+#include "strategy/token_slots.hpp"
 #include "utils/state_persistence.hpp"
 #include "utils/trading_logger.hpp"
 #include "utils/market_summary_logger.hpp"
 
-#include <map>
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
 
 namespace pmm {
 
+// Point-in-time view of the engine for dashboards and other threads.
+// Published by the strategy thread once per drain cycle.
+struct EngineStats {
+    size_t position_count = 0;
+    size_t active_order_count = 0;
+    size_t bid_count = 0;
+    size_t ask_count = 0;
+    size_t active_market_count = 0;
+    size_t fill_count = 0;
+    double realized_pnl = 0.0;
+    double unrealized_pnl = 0.0;
+    double total_inventory = 0.0;
+    double average_spread = 0.0;
+    uint64_t cycle = 0;  // Drain cycles completed when this snapshot was taken
+};
+
+// Threading contract:
+//  - All engine state (slots, orders, fill history, loggers) is owned by the
+//    strategy thread and is never locked.
+//  - start/stop and the configuration calls below are made from one control
+//    thread. Before start() they apply immediately; while running they are
+//    queued and applied by the strategy thread between events.
+//  - Other threads only read through getStats().
 class StrategyEngine {
 public:
-    explicit StrategyEngine(EventQueue& queue, TradingMode mode);
+    // journal_format picks how session logs are stored; COLUMNAR also
+    // writes market summaries as a columnar table
+    explicit StrategyEngine(EventQueue& queue, TradingMode mode, RiskLimits risk_limits = RiskLimits{},
+                            JournalFormat journal_format = JournalFormat::CSV);
     ~StrategyEngine();
     
     void start();
@@ -44,127 +80,129 @@ public:
     void setEventEndTime(const std::string& condition_id, 
                         const std::chrono::system_clock::time_point& end_time);
 
-    size_t getPositionCount() const;
-    size_t getActiveOrderCount() const;
-    size_t getBidCount() const;
-    size_t getAskCount() const;
-    size_t getActiveMarketCount() const;
-    double getTotalPnL() const;
-    double getUnrealizedPnL() const;
-    double getTotalInventory() const;
-    double getAverageSpread() const;
-    size_t getFillCount() const;
+    // Registered tokens of market_id quote around this fair value from now on
+    void setFairValueModel(const std::string& market_id, FairValueModel model);
+
+    // Live orders go through this gateway; it must outlive the engine
+    void setOrderGateway(OrderGateway* gateway);
+
+    // Blocks all new orders at once and cancels everything working
+    void triggerKillSwitch();
+
+    // Safe from any thread, never blocks the strategy thread. Refreshed at
+    // most every STATS_INTERVAL (50ms) while events are flowing.
+    EngineStats getStats() const { return stats_.load(); }
+    bool isKilled() const { return risk_gate_.killed(); }
+    RiskExposure getRiskExposure() const { return risk_gate_.totalExposure(); }
+
+    size_t getPositionCount() const { return getStats().position_count; }
+    size_t getActiveOrderCount() const { return getStats().active_order_count; }
+    size_t getBidCount() const { return getStats().bid_count; }
+    size_t getAskCount() const { return getStats().ask_count; }
+    size_t getActiveMarketCount() const { return getStats().active_market_count; }
+    double getTotalPnL() const { return getStats().realized_pnl; }
+    double getUnrealizedPnL() const { return getStats().unrealized_pnl; }
+    double getTotalInventory() const { return getStats().total_inventory; }
+    double getAverageSpread() const { return getStats().average_spread; }
+    size_t getFillCount() const { return getStats().fill_count; }
 
     void startLogging(const std::string& event_name);
-    void logInitialPositions();
-    void snapshotPositions();
     
 private:
-    struct Position {
-        double quantity = 0.0;
-        double avg_entry_price = 0.0;
-        double realized_pnl = 0.0;
-        std::chrono::system_clock::time_point opened_at;
-        std::chrono::system_clock::time_point last_updated;
-        Side entry_side = Side::BUY;
-        int num_fills = 0;
-    };
-
-    struct FillMetrics {
-        std::chrono::system_clock::time_point fill_time;
-        TokenId token_id;
-        OrderId order_id;
-        Side side;
-        Price fill_price;
-        Price mid_at_fill;
-        Price best_bid_at_fill;
-        Price best_ask_at_fill;
-        double spread_at_fill;
-        double imbalance_at_fill;
-        double inventory_before;
-        double inventory_after;
-        
-        Price mid_30s_after = 0.0;
-        Price mid_60s_after = 0.0;
-        bool metrics_complete = false;
-    };
-
-    struct QuoteSummary {
-        std::string market_name;
-        Price bid_price;
-        Price ask_price;
-        Price mid;
-        double spread_bps;
-        double inventory;
-        std::chrono::steady_clock::time_point last_update;
-        std::chrono::steady_clock::time_point quote_created_at;
-        int ttl_seconds;
-        
-        bool isExpired() const {
-            auto now = std::chrono::steady_clock::now();
-            auto age = std::chrono::duration_cast<std::chrono::seconds>(now - quote_created_at);
-            return age.count() >= ttl_seconds;
-        }
-        
-        int getSecondsUntilExpiry() const {
-            auto now = std::chrono::steady_clock::now();
-            auto age = std::chrono::duration_cast<std::chrono::seconds>(now - quote_created_at);
-            return std::max(0, ttl_seconds - static_cast<int>(age.count()));
-        }
-    };
-
-    struct PriceUpdateHistory {
-        Price last_mid = 0.0;
-        double last_bid_volume = 0.0;
-        double last_ask_volume = 0.0;
-        std::chrono::steady_clock::time_point last_update_time;
-    };
-
     EventQueue& event_queue_;
     std::unique_ptr<StatePersistence> state_persistence_;
     std::unique_ptr<TradingLogger> trading_logger_;
     std::unique_ptr<MarketSummaryLogger> market_summary_logger_;
+    JournalFormat journal_format_;
     std::unique_ptr<AdverseSelectionManager> as_manager_;
+    RiskGate risk_gate_;
     OrderManager order_manager_;
     std::atomic<bool> running_;
     std::thread strategy_thread_;
     
-    std::map<TokenId, OrderBook> order_books_;
-    std::unordered_map<TokenId, MarketMaker> market_makers_;
-    std::unordered_map<TokenId, MarketMetadata> market_metadata_;
-    
-    std::unordered_map<TokenId, Position> positions_;
-    mutable std::mutex positions_mutex_;
-
-    std::vector<FillMetrics> fill_history_;
-    std::mutex fill_metrics_mutex_;
-    std::atomic<size_t> total_fills_{0};
-    std::atomic<bool> initial_positions_logged_{false};
+    // Per-token state (book, maker, metadata, position, quote, history)
+    TokenSlotTable slots_;
+
+    // Dense market index per registered market_id, used to count active markets
+    std::unordered_map<std::string, uint32_t> market_indices_;
+    std::vector<char> market_active_scratch_;
+
+    // Tradable outcomes grouped by condition_id, quoted together once a
+    // condition has more than one
+    std::unordered_map<std::string, uint32_t> condition_indices_;
+    std::vector<ConditionQuoter> condition_quoters_;
+
+    // Scratch for requoting expired single-outcome quotes together, and for
+    // requoting each condition once however many of its outcomes expired
+    QuoteBatch quote_batch_;
+    std::vector<TokenHandle> batch_handles_;
+    std::vector<char> condition_requoted_scratch_;
+
+    SeqLock<EngineStats> stats_;
+    uint64_t drain_cycles_ = 0;
+
+    // The snapshot walks every slot, so it is rebuilt at most this often
+    // rather than after every drain, and only when something was handled
+    static constexpr std::chrono::milliseconds STATS_INTERVAL{50};
+    bool stats_dirty_ = false;
+
+    // Events handled per drain before stats and timers get a turn, so a
+    // steady feed can't starve quote expiry, markouts and snapshots
+    static constexpr size_t MAX_DRAIN_BATCH = 256;
+
+    // Fills awaiting markouts; each horizon is captured once and handed to
+    // the AS manager and the logs
+    MarkoutEngine markouts_;
+    size_t total_fills_ = 0;
+    bool initial_positions_logged_ = false;
+
+    // Configuration calls made while running, applied on the strategy thread
+    std::mutex commands_mutex_;
+    std::vector<std::function<void()>> pending_commands_;
+    std::atomic<bool> has_pending_commands_{false};
+
+    void post(std::function<void()> command);
+    void applyPendingCommands();
+
+    void applyRegisterMarketMetadata(const TokenId& token_id,
+                                     const std::string& title,
+                                     const std::string& outcome,
+                                     const std::string& market_id,
+                                     const std::string& condition_id);
+    void applyEventEndTime(const std::string& condition_id,
+                           const std::chrono::system_clock::time_point& end_time);
+    void applyStartLogging(const std::string& event_name);
 
-    std::unordered_map<TokenId, QuoteSummary> active_quotes_;
-    std::mutex quotes_mutex_;
-
-    std::unordered_map<TokenId, PriceUpdateHistory> price_history_;
-    std::mutex price_history_mutex_;
+    void logInitialPositions();
+    void snapshotPositions();
 
     void run();
-    void checkPendingFillMetrics();
+    void dispatchEvent(const Event& event);
+    void publishStats();
+    void captureFillMarkouts();
+    void onFillMarkout(const MarkoutRecord& fill, size_t horizon);
+    void onFillMarkoutsComplete(const MarkoutRecord& fill);
     void logQuoteSummary();
     void checkExpiredQuotes();
     
     void handleBookSnapshot(const Event& event);
     void handlePriceUpdate(const Event& event);
+    void handleTrade(const Event& event);
     void handleOrderFill(const Event& event);
     void handleOrderRejected(const Event& event);
     
-    void calculateQuotes(const TokenId& token_id, 
-                         const std::string& market_name,
+    void updateVolatility(TokenHandle handle);  // Feeds the slot's estimator from its book
+    void calculateQuotes(TokenHandle handle, 
                          CancelReason cancel_reason = CancelReason::QUOTE_UPDATE);
+    MarketMaker* quotableMaker(TokenHandle handle);  // Null unless tradable with a BBO
+    bool quotedByCondition(TokenHandle handle) const;
+    double spreadMultiplier(TokenHandle handle, double inventory);
+    bool quoteCondition(uint32_t condition_index, CancelReason cancel_reason);
+    void applyQuote(TokenHandle handle, const Quote& quote, CancelReason cancel_reason);
     
-    OrderBook& getOrCreateOrderBook(const TokenId& token_id, 
-                                   const std::string& market_name);
+    TokenHandle getOrCreateSlot(const TokenId& token_id);
 
-    void updatePosition(const TokenId& token_id, double qty, double price, Side side);
+    void updatePosition(TokenHandle handle, double qty, double price, Side side);
 };
 
 } // namespace pmm
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "data/order_book.hpp"
+#include "data/volatility.hpp"
+#include "strategy/market_maker.hpp"
+#include "strategy/risk_gate.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace pmm {
+
+// Dense index into a TokenSlotTable, assigned the first time a token is seen
+using TokenHandle = uint32_t;
+constexpr TokenHandle INVALID_TOKEN_HANDLE = std::numeric_limits<TokenHandle>::max();
+constexpr uint32_t INVALID_MARKET_INDEX = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t INVALID_CONDITION_INDEX = std::numeric_limits<uint32_t>::max();
+
+struct QuoteSummary {
+    Price bid_price = 0.0;
+    Price ask_price = 0.0;
+    Price mid = 0.0;
+    double spread_bps = 0.0;
+    double inventory = 0.0;
+    std::chrono::steady_clock::time_point last_update;
+    std::chrono::steady_clock::time_point quote_created_at;
+    int ttl_seconds = 0;
+
+    bool isExpired() const {
+        auto now = std::chrono::steady_clock::now();
+        auto age = std::chrono::duration_cast<std::chrono::seconds>(now - quote_created_at);
+        return age.count() >= ttl_seconds;
+    }
+
+    int getSecondsUntilExpiry() const {
+        auto now = std::chrono::steady_clock::now();
+        auto age = std::chrono::duration_cast<std::chrono::seconds>(now - quote_created_at);
+        return std::max(0, ttl_seconds - static_cast<int>(age.count()));
+    }
+};
+
+struct PriceUpdateHistory {
+    Price last_mid = 0.0;
+    double last_bid_volume = 0.0;
+    double last_ask_volume = 0.0;
+    std::chrono::steady_clock::time_point last_update_time;
+};
+
+// Position bookkeeping that is only touched on fills and when logging.
+// Quantity, entry price and realized PnL live in the SoA columns.
+struct PositionDetails {
+    std::chrono::system_clock::time_point opened_at;
+    std::chrono::system_clock::time_point last_updated;
+    Side entry_side = Side::BUY;
+    int num_fills = 0;
+};
+
+// Everything the strategy keeps for one token, reachable with a single lookup
+struct TokenSlot {
+    TokenId token_id;
+    std::string display_name;                 // "title - outcome" once registered, else the token id
+    OrderBook book;
+    std::optional<MarketMaker> maker;         // Only for tradable tokens
+    std::optional<MarketMetadata> metadata;   // Registered tokens (tradable or observation-only)
+    std::optional<PositionDetails> position;  // Set once we hold (or restored) a position
+    std::optional<QuoteSummary> quote;
+    PriceUpdateHistory history;
+    VolatilityEstimator volatility;           // Sampled from the book on a fixed grid
+    uint32_t market_index = INVALID_MARKET_INDEX;  // Assigned when metadata is registered
+    RiskGate::ConditionHandle risk_condition = RiskGate::NO_CONDITION;
+    uint32_t risk_outcome = RiskGate::NO_OUTCOME;  // Index within risk_condition
+    uint32_t condition_index = INVALID_CONDITION_INDEX;  // Condition quoter, tradable tokens only
+    bool inventory_restored = false;
+
+    explicit TokenSlot(const TokenId& id) : token_id(id), display_name(id), book(id) {}
+};
+
+// Hot per-token fields, indexed by TokenHandle, so portfolio-wide scans
+// walk a few contiguous arrays instead of every slot
+struct TokenColumns {
+    std::vector<double> quantity;          // Signed position size
+    std::vector<double> avg_entry_price;
+    std::vector<double> realized_pnl;
+    std::vector<double> mid;               // 0.0 when the book has no valid BBO
+    std::vector<double> spread_pct;        // spread / mid, 0.0 when the book has no valid BBO
+};
+
+class TokenSlotTable {
+public:
+    TokenHandle find(const TokenId& token_id) const;
+    TokenHandle findOrCreate(const TokenId& token_id);
+
+    TokenSlot& operator[](TokenHandle handle) { return slots_[handle]; }
+    const TokenSlot& operator[](TokenHandle handle) const { return slots_[handle]; }
+
+    size_t size() const { return slots_.size(); }
+    bool empty() const { return slots_.empty(); }
+
+    TokenColumns& columns() { return columns_; }
+    const TokenColumns& columns() const { return columns_; }
+
+    // Refresh the mid/spread columns from the slot's order book
+    void refreshBookColumns(TokenHandle handle);
+
+private:
+    std::vector<TokenSlot> slots_;
+    TokenColumns columns_;
+    std::unordered_map<TokenId, TokenHandle> handles_;
+};
+
+} // namespace pmm
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "core/ring_buffer.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace pmm {
+
+// Market trade prints for one token, aggregated two ways:
+//
+// - In clock time: per-second buckets over a sliding 60s window with
+//   running totals of trades, volume, notional and signed volume.
+// - In volume time: consecutive buckets of a fixed traded size, each
+//   recording how one-sided its volume was and how long it took to fill.
+//
+// Windows advance when a trade arrives or advance() is called, so the
+// clock-time figures describe the minute up to whichever came last.
+// Every query is O(1).
+class TradeFlow {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int64_t WINDOW_SECONDS = 60;
+    static constexpr size_t TIME_BUCKETS = 64;     // Power of two covering the window
+    static constexpr size_t VOLUME_BUCKETS = 16;   // Completed volume buckets kept
+
+    explicit TradeFlow(Size volume_bucket_size = 500.0);
+
+    // side is the aggressor; BUY lifted the ask
+    void onTrade(Price price, Size size, Side side, Clock::time_point now = Clock::now());
+
+    // Age the window to now without a trade, so a market that goes quiet
+    // stops reading as busy
+    void advance(Clock::time_point now = Clock::now());
+
+    // Last 60s
+    uint32_t tradeCount() const { return window_.trades; }
+    Size volume() const { return window_.volume; }
+    double signedVolume() const { return window_.signed_volume; }  // Buys minus sells
+    Price vwap() const;                                            // 0.0 with no trades
+    double imbalance() const;                                      // Signed over total volume, -1 to 1
+    double tradeRate() const { return static_cast<double>(window_.trades) / WINDOW_SECONDS; }
+    double volumeRate() const { return window_.volume / WINDOW_SECONDS; }
+
+    // Average volume per second from the first trade to the latest trade or
+    // advance(), over at least a window
+    double sessionVolumeRate() const;
+
+    // Volume time
+    size_t completedVolumeBuckets() const { return volume_buckets_.size(); }
+    double vpin() const;                    // Mean |buys - sells| / bucket size
+    double secondsPerVolumeBucket() const;  // Mean time to trade one bucket
+
+    Price lastPrice() const { return last_price_; }
+    uint64_t totalTrades() const { return total_trades_; }
+
+private:
+    struct Totals {
+        uint32_t trades = 0;
+        double volume = 0.0;
+        double notional = 0.0;
+        double signed_volume = 0.0;
+    };
+
+    struct VolumeBucket {
+        double abs_imbalance;  // |buys - sells|
+        double seconds;
+    };
+
+    // Clock time
+    std::array<Totals, TIME_BUCKETS> seconds_{};
+    Totals window_;
+    int64_t newest_second_ = 0;
+
+    // Volume time
+    Size volume_bucket_size_;
+    double bucket_buys_ = 0.0;
+    double bucket_sells_ = 0.0;
+    Clock::time_point bucket_start_{};
+    FixedRing<VolumeBucket, VOLUME_BUCKETS> volume_buckets_;
+    double volume_imbalance_sum_ = 0.0;
+    double volume_seconds_sum_ = 0.0;
+
+    // Session
+    Clock::time_point first_trade_{};
+    Clock::time_point last_seen_{};
+    double total_volume_ = 0.0;
+    uint64_t total_trades_ = 0;
+    Price last_price_ = 0.0;
+
+    void advanceTo(int64_t second);
+    void addToVolumeBuckets(Size size, Side side, Clock::time_point now);
+};
+
+} // namespace pmm
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace pmm {
+
+// Columnar session tables (.pmmc), for the high-volume logs: price
+// updates and market summaries. Rows are grouped into blocks. Each block
+// stores every column as its own zlib-compressed chunk, with a header
+// that has per-column min/max and, for string columns, the dictionary.
+// A reader can therefore skip blocks that lack a token and only inflate
+// the columns it asks for.
+//
+// Column encodings before compression:
+// - INT64: delta from the previous row, zigzag varint
+// - PRICE: rounded to 1e-6, then as INT64 (prices sit on a tick grid)
+// - DOUBLE: IEEE bits XORed with the previous row's, so slowly moving
+//   values turn into runs of zero bytes
+// - STRING: varint codes into the block's dictionary
+//
+// File: magic, schema, then blocks, each a length-prefixed header
+// followed by its chunks. Blocks are self-describing, so a file cut short
+// by a crash is readable up to its last whole block.
+
+enum class ColumnType : uint8_t {
+    INT64,
+    PRICE,
+    DOUBLE,
+    STRING
+};
+
+struct ColumnSpec {
+    std::string name;
+    ColumnType type;
+};
+
+struct ColumnStats {
+    double min = 0.0;                     // Numeric columns
+    double max = 0.0;
+    std::vector<std::string> dictionary;  // String columns: every value in the block
+};
+
+class ColumnarWriter {
+public:
+    static constexpr size_t DEFAULT_BLOCK_ROWS = 8192;
+
+    // Throws std::runtime_error if the file cannot be created
+    ColumnarWriter(const std::filesystem::path& path, std::vector<ColumnSpec> columns,
+                   size_t block_rows = DEFAULT_BLOCK_ROWS);
+    ~ColumnarWriter();
+
+    // One value per column, then endRow(). The add must match the column's
+    // type (addDouble for PRICE and DOUBLE); throws std::logic_error if not.
+    void addInt64(size_t column, int64_t value);
+    void addDouble(size_t column, double value);
+    void addString(size_t column, std::string_view value);
+    void endRow();
+
+    // Writes the rows of the unfinished block. Each call ends a block, so
+    // call it at the end of a session rather than per row.
+    void flush();
+    void close();
+
+    size_t rows() const { return total_rows_; }
+
+private:
+    struct ColumnBuffer {
+        ColumnSpec spec;
+        std::vector<int64_t> ints;       // INT64, and PRICE in 1e-6 units
+        std::vector<double> doubles;
+        std::vector<uint32_t> codes;     // STRING
+        std::vector<std::string> dictionary;
+        std::unordered_map<std::string, uint32_t> dictionary_index;
+        size_t rows = 0;
+    };
+
+    std::ofstream file_;
+    std::vector<ColumnBuffer> columns_;
+    size_t block_rows_;
+    size_t pending_rows_ = 0;
+    size_t total_rows_ = 0;
+
+    ColumnBuffer& column(size_t column, bool numeric);
+    void writeBlock();
+};
+
+class ColumnarReader {
+public:
+    // Reads the schema and every block header; throws std::runtime_error if
+    // the file cannot be read or is not a columnar table
+    explicit ColumnarReader(const std::filesystem::path& path);
+
+    const std::vector<ColumnSpec>& columns() const { return columns_; }
+    int columnIndex(std::string_view name) const;  // -1 if absent
+
+    size_t blockCount() const { return blocks_.size(); }
+    size_t blockRows(size_t block) const { return blocks_[block].rows; }
+    size_t rowCount() const;
+    const ColumnStats& stats(size_t block, size_t column) const { return blocks_[block].chunks[column].stats; }
+
+    // Decoded values of one column of one block. readDouble also accepts
+    // INT64 columns.
+    std::vector<int64_t> readInt64(size_t block, size_t column);
+    std::vector<double> readDouble(size_t block, size_t column);
+    std::vector<std::string> readString(size_t block, size_t column);
+
+    // Values of column in rows whose key_column equals key, in file order.
+    // Blocks whose dictionary lacks key are skipped unread, and only the two
+    // columns are inflated in the rest.
+    std::vector<double> scan(std::string_view column, std::string_view key_column, std::string_view key);
+
+    // Chunks inflated so far
+    size_t chunksDecompressed() const { return chunks_decompressed_; }
+
+private:
+    struct Chunk {
+        uint64_t offset;
+        uint32_t compressed_size;
+        uint32_t raw_size;
+        ColumnStats stats;
+    };
+    struct Block {
+        uint32_t rows;
+        std::vector<Chunk> chunks;
+    };
+
+    std::ifstream file_;
+    std::vector<ColumnSpec> columns_;
+    std::vector<Block> blocks_;
+    size_t chunks_decompressed_ = 0;
+
+    std::vector<char> inflate(size_t block, size_t column);
+    std::vector<uint32_t> readCodes(size_t block, size_t column);
+};
+
+} // namespace pmm
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "utils/columnar_store.hpp"
+#include "utils/trade_journal.hpp"
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace pmm {
+
+// Turns journal records into the session CSVs (orders, fills, positions,
+// price_updates, fill_markouts). TradingLogger's writer thread runs one in
+// CSV mode, and journal_to_csv replays a journal.bin through one, so both
+// produce the same files.
+//
+// With columnar_price_updates, price updates go to price_updates.pmmc (see
+// columnar_store.hpp) instead of price_updates.csv. Those rows reach the
+// file a block at a time, and the last block when the writer is destroyed.
+class JournalCsvWriter {
+public:
+    // Creates the files with their headers in dir
+    explicit JournalCsvWriter(const std::filesystem::path& dir, bool columnar_price_updates = false);
+
+    void write(const JournalRecordView& record);
+    void flush();
+
+private:
+    std::ofstream orders_file_;
+    std::ofstream fills_file_;
+    std::ofstream positions_file_;
+    std::ofstream price_updates_file_;
+    std::ofstream fill_markouts_file_;
+    std::unique_ptr<ColumnarWriter> price_updates_table_;
+
+    // fills.csv rows whose markout columns are still placeholders, one per
+    // fill: partial fills of an order share its order_id
+    struct FillKey {
+        OrderId order_id;
+        uint64_t fill_seq;
+        bool operator==(const FillKey& other) const {
+            return order_id == other.order_id && fill_seq == other.fill_seq;
+        }
+    };
+    struct FillKeyHash {
+        size_t operator()(const FillKey& key) const {
+            return std::hash<uint64_t>()(key.order_id * 0x9E3779B97F4A7C15ULL ^ key.fill_seq);
+        }
+    };
+    struct FillRow {
+        std::streampos markout_columns;
+        Side side;
+        Price mid_at_fill;
+    };
+    std::unordered_map<FillKey, FillRow, FillKeyHash> fill_rows_;
+
+    // Rows whose markouts haven't arrived well after the longest markout
+    // horizon (60 s) never will; they're dropped oldest first
+    static constexpr int64_t FILL_ROW_LIFETIME_NS = 120'000'000'000;
+    std::deque<std::pair<int64_t, FillKey>> fill_row_times_;
+
+    // Record times are formatted once per second
+    std::string cached_timestamp_;
+    std::time_t cached_timestamp_time_ = -1;
+
+    const std::string& timestamp(int64_t time_ns);
+
+    void writeOrderPlaced(const JournalRecordView& record);
+    void writeOrderCancelled(const JournalRecordView& record);
+    void writeOrderFilled(const JournalRecordView& record);
+    void writeFillMarkout(const JournalRecordView& record);
+    void writeFillAdverseSelection(const JournalRecordView& record);
+    void evictStaleFillRows(int64_t now_ns);
+    void writePosition(const JournalRecordView& record);
+    void writePriceUpdate(const JournalRecordView& record);
+    void writePriceUpdateRow(const JournalRecordView& record);
+};
+
+} // namespace pmm
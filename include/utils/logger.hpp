@@ -3,26 +3,109 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
+#include <atomic>
 #include <memory>
+#include <vector>
+
+// Lowest level compiled in; anything below it expands to nothing. Set with
+// -DPMM_LOG_LEVEL=<TRACE|DEBUG|INFO|WARN|ERROR|CRITICAL|OFF> in CMake.
+#define PMM_LOG_LEVEL_TRACE 0
+#define PMM_LOG_LEVEL_DEBUG 1
+#define PMM_LOG_LEVEL_INFO 2
+#define PMM_LOG_LEVEL_WARN 3
+#define PMM_LOG_LEVEL_ERROR 4
+#define PMM_LOG_LEVEL_CRITICAL 5
+#define PMM_LOG_LEVEL_OFF 6
+
+#ifndef PMM_LOG_ACTIVE_LEVEL
+#define PMM_LOG_ACTIVE_LEVEL PMM_LOG_LEVEL_TRACE
+#endif
 
 namespace pmm {
 
+// Process-wide spdlog logger. It is asynchronous: log calls format the
+// line and queue it, and one worker thread writes the sinks. Set the
+// runtime level with PMM_LOG_LEVEL in the environment (default info).
 class Logger {
 public:
+    static constexpr size_t QUEUE_SIZE = 8192;  // Lines; the oldest are overwritten when full
+
     static void init(const std::string& log_dir = "./logs",
                      const std::string& logger_name = "pmm_logger");
     static void updateSessionDir(const std::string& session_dir, const std::string& session_name);
     static std::shared_ptr<spdlog::logger> get();
-    
+
+    // What the LOG_* macros use: no shared_ptr copy, initialized on first use
+    static spdlog::logger* raw() {
+        spdlog::logger* logger = raw_.load(std::memory_order_acquire);
+        return logger ? logger : get().get();
+    }
+
+    // Writes out queued lines and stops the worker; call before exit
+    static void shutdown();
+
 private:
     static std::shared_ptr<spdlog::logger> logger_;
+    static std::atomic<spdlog::logger*> raw_;
+    // Loggers replaced by updateSessionDir, kept so raw() pointers other
+    // threads already hold stay valid
+    static std::vector<std::shared_ptr<spdlog::logger>> retired_;
+
+    static void install(const std::string& dir, const std::string& session_name);
 };
 
-#define LOG_TRACE(...) pmm::Logger::get()->trace(__VA_ARGS__)
-#define LOG_DEBUG(...) pmm::Logger::get()->debug(__VA_ARGS__)
-#define LOG_INFO(...)  pmm::Logger::get()->info(__VA_ARGS__)
-#define LOG_WARN(...)  pmm::Logger::get()->warn(__VA_ARGS__)
-#define LOG_ERROR(...) pmm::Logger::get()->error(__VA_ARGS__)
-#define LOG_CRITICAL(...) pmm::Logger::get()->critical(__VA_ARGS__)
+// The level check comes before the arguments are evaluated, so a disabled
+// line costs one relaxed load and a branch
+#define PMM_LOG_AT(level, ...)                                  \
+    do {                                                        \
+        spdlog::logger* pmm_log_logger_ = pmm::Logger::raw();   \
+        if (pmm_log_logger_->should_log(level)) {               \
+            pmm_log_logger_->log(level, __VA_ARGS__);           \
+        }                                                       \
+    } while (0)
+
+// Still type-checks the format and arguments, but never runs
+#define PMM_LOG_ELIDED(...)                                                       \
+    do {                                                                          \
+        if (false) {                                                              \
+            pmm::Logger::raw()->log(spdlog::level::trace, __VA_ARGS__);           \
+        }                                                                         \
+    } while (0)
+
+#if PMM_LOG_ACTIVE_LEVEL <= PMM_LOG_LEVEL_TRACE
+#define LOG_TRACE(...) PMM_LOG_AT(spdlog::level::trace, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) PMM_LOG_ELIDED(__VA_ARGS__)
+#endif
+
+#if PMM_LOG_ACTIVE_LEVEL <= PMM_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) PMM_LOG_AT(spdlog::level::debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) PMM_LOG_ELIDED(__VA_ARGS__)
+#endif
+
+#if PMM_LOG_ACTIVE_LEVEL <= PMM_LOG_LEVEL_INFO
+#define LOG_INFO(...) PMM_LOG_AT(spdlog::level::info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) PMM_LOG_ELIDED(__VA_ARGS__)
+#endif
+
+#if PMM_LOG_ACTIVE_LEVEL <= PMM_LOG_LEVEL_WARN
+#define LOG_WARN(...) PMM_LOG_AT(spdlog::level::warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) PMM_LOG_ELIDED(__VA_ARGS__)
+#endif
+
+#if PMM_LOG_ACTIVE_LEVEL <= PMM_LOG_LEVEL_ERROR
+#define LOG_ERROR(...) PMM_LOG_AT(spdlog::level::err, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) PMM_LOG_ELIDED(__VA_ARGS__)
+#endif
+
+#if PMM_LOG_ACTIVE_LEVEL <= PMM_LOG_LEVEL_CRITICAL
+#define LOG_CRITICAL(...) PMM_LOG_AT(spdlog::level::critical, __VA_ARGS__)
+#else
+#define LOG_CRITICAL(...) PMM_LOG_ELIDED(__VA_ARGS__)
+#endif
 
-} // namespace pmm
\ No newline at end of file
+} // namespace pmm
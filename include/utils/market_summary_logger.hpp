@@ -1,18 +1,32 @@
 #pragma once
 
+#include "core/ring_buffer.hpp"
+#include "core/spsc_queue.hpp"
 #include "core/types.hpp"
+#include "data/volatility.hpp"
+#include "utils/columnar_store.hpp"
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <filesystem>
 #include <mutex>
+#include <string_view>
 #include <chrono>
 #include <deque>
+#include <memory>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace pmm {
 
+// Samples from the last window_size seconds, keeping at most MAX_SAMPLES
+// (a busy market's window covers its latest MAX_SAMPLES updates instead).
+// Every statistic is O(1): mean, variance and the trend regression come
+// from running sums, and min/max from monotonic queues.
 struct RollingWindow {
-    std::deque<double> values;
-    std::deque<std::chrono::steady_clock::time_point> timestamps;
+    static constexpr size_t MAX_SAMPLES = 512;
+
     std::chrono::seconds window_size;
     
     explicit RollingWindow(std::chrono::seconds window = std::chrono::seconds(300))
@@ -24,7 +38,41 @@ struct RollingWindow {
     double stddev() const;
     double max() const;
     double min() const;
-    size_t size() const { return values.size(); }
+    // Least-squares slope per sample against the sample's position
+    double slope() const;
+    double front() const { return samples_.empty() ? 0.0 : samples_.front().value; }
+    double back() const { return samples_.empty() ? 0.0 : samples_.back().value; }
+    size_t size() const { return samples_.size(); }
+
+private:
+    struct Sample {
+        double value;
+        std::chrono::steady_clock::time_point timestamp;
+    };
+
+    // Candidate extremes, values decreasing (maxima_) or increasing
+    // (minima_) from front to back, so the front is the answer
+    struct Extreme {
+        double value;
+        uint64_t seq;  // In samples_
+    };
+
+    FixedRing<Sample, MAX_SAMPLES> samples_;
+    FixedRing<Extreme, MAX_SAMPLES> maxima_;
+    FixedRing<Extreme, MAX_SAMPLES> minima_;
+
+    // Sums of (value - origin_), and of position * (value - origin_).
+    // Subtracting a nearby origin keeps the variance from cancelling, and
+    // the sums are rebuilt once per window's worth of evictions so that
+    // rounding from the running updates cannot build up.
+    double origin_ = 0.0;
+    double sum_ = 0.0;
+    double sum_sq_ = 0.0;
+    double sum_xy_ = 0.0;
+    size_t evictions_ = 0;
+
+    void popFront();
+    void rebuildSums();
 };
 
 struct MarketState {
@@ -42,6 +90,7 @@ struct MarketState {
     double current_ask_volume = 0.0;
     int current_bid_levels = 0;
     int current_ask_levels = 0;
+    VolatilityEstimates volatility;  // Latest from the strategy's per-token estimator
     
     RollingWindow mid_prices;
     RollingWindow spreads_bps;
@@ -77,6 +126,9 @@ struct MarketSummary {
     Price best_ask;
     
     double mid_price_volatility;
+    double ewma_volatility;
+    double realized_volatility;
+    double parkinson_volatility;
     double price_trend;          
     double max_price_move;
     
@@ -97,37 +149,110 @@ struct MarketSummary {
     int trading_quality_score;
 };
 
+// Rolling per-market statistics, summarised to market_summary.csv at an
+// interval that shortens as events approach. The strategy thread only
+// queues a compact sample per book update; an analytics thread owns the
+// rolling state and computes and writes the summaries.
+//
+// updateMarket, flush and logSummaries must all be called from the same
+// (producer) thread; setEventEndTime may be called from any thread.
 class MarketSummaryLogger {
 public:
-    explicit MarketSummaryLogger(const std::filesystem::path& session_dir);
+    static constexpr size_t TABLE_BLOCK_ROWS = 1024;
+    static constexpr size_t SAMPLE_QUEUE_CAPACITY = 8192;  // Samples beyond this are dropped
+    static constexpr std::chrono::milliseconds ANALYTICS_INTERVAL{100};
+
+    // columnar writes market_summary.pmmc (see columnar_store.hpp) instead
+    // of market_summary.csv
+    explicit MarketSummaryLogger(const std::filesystem::path& session_dir, bool columnar = false);
     ~MarketSummaryLogger();
     
-    void updateMarket(const std::string& market_name, const std::string& market_id,
-                     const std::string& condition_id, const TokenId& token_id,
+    void updateMarket(std::string_view market_name, std::string_view market_id,
+                     std::string_view condition_id, const TokenId& token_id,
                      Price mid_price, double spread_bps,
                      Price best_bid, Price best_ask,
                      double bid_volume, double ask_volume,
-                     int bid_levels, int ask_levels);
+                     int bid_levels, int ask_levels,
+                     const VolatilityEstimates& volatility = {});
     
     void setEventEndTime(const std::string& condition_id, 
                         std::chrono::system_clock::time_point end_time);
-    bool shouldLogSummary() const;
+
+    // Waits until every sample queued so far is in the rolling state
+    void flush();
+    // Writes a summary of every market now, including samples queued so
+    // far, instead of waiting for the interval
     void logSummaries();
 
-    std::chrono::seconds getUpdateInterval() const;
+    uint64_t droppedSamples() const { return dropped_samples_.load(std::memory_order_relaxed); }
     
 private:
+    // One book update, as the strategy thread queues it. Samples are
+    // timestamped when queued, so the rolling windows see when each update
+    // happened rather than when the analytics thread got to it.
+    struct MarketSample {
+        uint32_t market;  // Index into markets_
+        int32_t bid_levels;
+        int32_t ask_levels;
+        std::chrono::steady_clock::time_point time;
+        Price mid_price;
+        double spread_bps;
+        Price best_bid;
+        Price best_ask;
+        double bid_volume;
+        double ask_volume;
+        VolatilityEstimates volatility;
+    };
+
+    struct MarketInfo {
+        TokenId token_id;
+        std::string market_name;
+        std::string market_id;
+        std::string condition_id;
+    };
+
     std::filesystem::path session_dir_;
+
+    // Producer side
+    std::unique_ptr<SpscQueue<MarketSample, SAMPLE_QUEUE_CAPACITY>> samples_;
+    std::unordered_map<TokenId, uint32_t> market_index_;
+    uint64_t pushed_ = 0;
+    std::atomic<uint64_t> dropped_samples_{0};
+
+    // Rare updates handed over under a lock: markets seen for the first
+    // time (before their first sample is queued) and event end times
+    std::mutex control_mutex_;
+    std::vector<MarketInfo> new_markets_;
+    std::vector<std::pair<std::string, std::chrono::system_clock::time_point>> new_end_times_;
+
+    // Analytics thread and the handshake with flush/logSummaries
+    std::thread analytics_;
+    std::atomic<bool> stopping_{false};
+    std::mutex analytics_mutex_;
+    std::condition_variable analytics_cv_;  // Wakes the analytics thread early
+    std::condition_variable applied_cv_;    // Signals waiters after each pass
+    uint64_t flush_requested_ = 0;          // Samples someone is waiting on
+    uint64_t applied_ = 0;                  // Samples in the rolling state
+    uint64_t summaries_requested_ = 0;
+    uint64_t summaries_written_ = 0;
+
+    // Owned by the analytics thread
     std::ofstream summary_file_;
-    std::mutex mutex_;
-    
-    std::unordered_map<TokenId, MarketState> market_states_;
+    std::unique_ptr<ColumnarWriter> summary_table_;
+    std::deque<MarketState> markets_;  // Deque so states never move
     std::unordered_map<std::string, std::chrono::system_clock::time_point> event_end_times_;
-    
+    uint64_t taken_ = 0;                // Samples popped so far
     std::chrono::steady_clock::time_point last_summary_time_;
     std::chrono::steady_clock::time_point start_time_;
     
-    void initializeFile();
+    void initializeFile(bool columnar);
+    void analyticsLoop();
+    void takeControlUpdates();
+    void applySample(const MarketSample& sample);
+    bool shouldLogSummary() const;
+    std::chrono::seconds getUpdateInterval() const;
+    void writeSummaries();
+    void writeSummaryRow(const MarketSummary& summary, std::chrono::system_clock::time_point time);
     MarketSummary computeSummary(const MarketState& state);
     double computeVolatility(const RollingWindow& window);
     double computeTrend(const RollingWindow& window);
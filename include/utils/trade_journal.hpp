@@ -0,0 +1,259 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+namespace pmm {
+
+// Binary trade journal records: what TradingLogger's hot path writes
+// instead of formatting CSV lines. A record is a header, a fixed-layout
+// payload and then its strings (each a uint16 length and the bytes),
+// padded to 8 bytes. The same bytes go through the in-memory ring and,
+// in binary mode, into journal.bin.
+
+enum class JournalRecordType : uint16_t {
+    PADDING = 0,  // Ring filler up to the end of the buffer, never on disk
+    ORDER_PLACED,
+    ORDER_CANCELLED,
+    ORDER_FILLED,
+    FILL_MARKOUT,
+    FILL_ADVERSE_SELECTION,
+    POSITION,
+    PRICE_UPDATE
+};
+
+struct JournalRecordHeader {
+    uint32_t length;           // Whole record, header and padding included
+    JournalRecordType type;
+    uint16_t string_count;
+    int64_t time_ns;           // Wall clock when the record was logged, to a few ms
+};
+static_assert(sizeof(JournalRecordHeader) == 16, "Journal header layout is part of the file format");
+
+// Payloads. Strings follow in the order noted on each. None may have
+// implicit padding, which would carry stray bytes into journal.bin, so a
+// short tail is padded out with a reserved field the callers leave zero.
+
+struct OrderPlacedRecord {  // market_id, token_id
+    uint64_t order_id;
+    double price;
+    double size;
+    double market_mid;
+    double market_spread;
+    double best_bid;
+    double best_ask;
+    double our_bid;
+    double our_ask;
+    Side side;
+    uint32_t reserved;
+};
+static_assert(sizeof(OrderPlacedRecord) == 80, "Journal payload layout is part of the file format");
+
+struct OrderCancelledRecord {  // market_id, token_id
+    uint64_t order_id;
+    double price;
+    double size;
+    Side side;
+    CancelReason reason;
+};
+static_assert(sizeof(OrderCancelledRecord) == 32, "Journal payload layout is part of the file format");
+
+struct OrderFilledRecord {  // market_id, token_id
+    uint64_t order_id;
+    uint64_t fill_seq;
+    double fill_price;
+    double fill_size;
+    double pnl;
+    double quoted_price;
+    double mid_at_fill;
+    double seconds_to_fill;
+    Side side;
+    uint32_t reserved;
+};
+static_assert(sizeof(OrderFilledRecord) == 72, "Journal payload layout is part of the file format");
+
+struct FillMarkoutRecord {  // market_id, token_id
+    uint64_t order_id;
+    uint64_t fill_seq;
+    int64_t fill_time_ns;
+    double fill_price;
+    double mid_at_fill;
+    double inventory_before;
+    double inventory_after;
+    double mid_30s;
+    double mid_60s;
+    Side side;
+    uint32_t reserved;
+};
+static_assert(sizeof(FillMarkoutRecord) == 80, "Journal payload layout is part of the file format");
+
+struct FillAdverseSelectionRecord {  // No strings
+    uint64_t order_id;
+    uint64_t fill_seq;
+    double mid_1s;
+    double mid_5s;
+    double mid_30s;
+};
+static_assert(sizeof(FillAdverseSelectionRecord) == 40, "Journal payload layout is part of the file format");
+
+struct PositionRecord {  // market_id, token_id
+    double position;
+    double avg_cost;
+    int64_t opened_at_ns;
+    int64_t last_updated_ns;
+    double total_cost;
+    int32_t num_fills;
+    Side entry_side;
+};
+static_assert(sizeof(PositionRecord) == 48, "Journal payload layout is part of the file format");
+
+struct PriceUpdateRecord {  // market_name, market_id, condition_id, token_id
+    double mid_price;
+    double price_change_pct;
+    double price_change_abs;
+    double best_bid;
+    double best_ask;
+    double spread;
+    double spread_bps;
+    double bid_volume;
+    double ask_volume;
+    double total_volume;
+    double volume_imbalance;
+    double our_inventory;
+    double time_to_event_hours;
+    double seconds_since_last_update;
+    int32_t bid_levels;
+    int32_t ask_levels;
+};
+static_assert(sizeof(PriceUpdateRecord) == 120, "Journal payload layout is part of the file format");
+
+// A decoded record pointing into the buffer it was read from
+struct JournalRecordView {
+    static constexpr size_t MAX_STRINGS = 4;
+
+    const JournalRecordHeader* header = nullptr;
+    const char* payload = nullptr;
+    std::array<std::string_view, MAX_STRINGS> strings{};
+
+    // Payloads sit at an 8-byte offset, but the buffer may not be aligned
+    template <typename Payload>
+    Payload as() const {
+        Payload value;
+        std::memcpy(&value, payload, sizeof(Payload));
+        return value;
+    }
+};
+
+namespace journal {
+
+constexpr size_t ALIGNMENT = 8;
+
+constexpr size_t aligned(size_t n) { return (n + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+// Strings longer than a uint16 length can say are cut short
+inline uint16_t stringLength(std::string_view s) {
+    return static_cast<uint16_t>(std::min<size_t>(s.size(), UINT16_MAX));
+}
+
+template <typename Payload, typename... Strings>
+size_t encodedSize(const Payload&, const Strings&... strings) {
+    static_assert(sizeof...(Strings) <= JournalRecordView::MAX_STRINGS, "Too many strings for one record");
+    return aligned(sizeof(JournalRecordHeader) + aligned(sizeof(Payload)) +
+                   (size_t{0} + ... + (sizeof(uint16_t) + stringLength(strings))));
+}
+
+// Writes a record of exactly encodedSize() bytes to dst. The gaps between
+// its parts are zeroed, so the same record always encodes to the same bytes.
+template <typename Payload, typename... Strings>
+void encode(char* dst, JournalRecordType type, int64_t time_ns, const Payload& payload,
+            const Strings&... strings) {
+    static_assert(std::is_trivially_copyable_v<Payload>, "Journal payloads are copied byte-wise");
+    size_t length = encodedSize(payload, strings...);
+    std::memset(dst, 0, length);
+
+    JournalRecordHeader header{static_cast<uint32_t>(length), type,
+                               static_cast<uint16_t>(sizeof...(Strings)), time_ns};
+    std::memcpy(dst, &header, sizeof(header));
+    char* out = dst + sizeof(header);
+    std::memcpy(out, &payload, sizeof(Payload));
+    out += aligned(sizeof(Payload));
+    [[maybe_unused]] auto put = [&out](std::string_view s) {
+        uint16_t n = stringLength(s);
+        std::memcpy(out, &n, sizeof(n));
+        std::memcpy(out + sizeof(n), s.data(), n);
+        out += sizeof(n) + n;
+    };
+    (put(std::string_view(strings)), ...);
+}
+
+// Size of the payload each record type carries
+size_t payloadSize(JournalRecordType type);
+
+// Parses the record at data. Returns false if the bytes do not hold a
+// complete, well-formed record.
+bool decode(const char* data, size_t available, JournalRecordView& out);
+
+// First bytes of a journal.bin file
+constexpr std::string_view FILE_MAGIC = "PMMJRNL1";
+
+// Calls handler for each record of a journal.bin file and returns how many
+// there were. A record cut short at the end (the process died mid-write)
+// ends the read. Throws std::runtime_error if the file cannot be read or
+// is not a journal.
+size_t readFile(const std::filesystem::path& path,
+                const std::function<void(const JournalRecordView&)>& handler);
+
+} // namespace journal
+
+// Single-producer, single-consumer byte ring for journal records. A
+// record never wraps: if it does not fit before the end of the buffer the
+// producer fills the rest with a PADDING record and starts again at zero.
+class JournalRing {
+public:
+    // capacity_bytes must be a power of two
+    explicit JournalRing(size_t capacity_bytes);
+
+    size_t capacity() const { return capacity_; }
+
+    // Producer side. Returns null when there is no room; otherwise write
+    // exactly length bytes there and call commit(length).
+    char* tryReserve(size_t length);
+    void commit(size_t length);
+
+    // Consumer side. The next record, or null when the ring is empty;
+    // call release() once done with it.
+    const char* peek();
+    void release();
+
+    // Bytes committed so far; the consumer has everything up to
+    // releasedBytes()
+    uint64_t committedBytes() const { return tail_.load(std::memory_order_acquire); }
+    uint64_t releasedBytes() const { return head_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    size_t capacity_;
+    uint64_t mask_;
+    std::unique_ptr<char[]> buffer_;
+
+    alignas(CACHE_LINE) std::atomic<uint64_t> head_{0};
+    uint64_t cached_tail_ = 0;   // Consumer's view of tail_
+    uint32_t peeked_length_ = 0;
+
+    alignas(CACHE_LINE) std::atomic<uint64_t> tail_{0};
+    uint64_t cached_head_ = 0;   // Producer's view of head_
+    uint64_t reserved_at_ = 0;   // Where the reserved record starts, after any padding
+};
+
+} // namespace pmm
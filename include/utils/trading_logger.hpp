@@ -1,42 +1,79 @@
 #pragma once
 
 #include "core/types.hpp"
-#include <fstream>
+#include "utils/trade_journal.hpp"
+#include "utils/journal_csv_writer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
 #include <filesystem>
+#include <memory>
 #include <mutex>
+#include <string_view>
 #include <chrono>
-#include <unordered_map>
+#include <thread>
+#include <vector>
 
 namespace pmm {
 
+// What the writer thread produces from the journal
+enum class JournalFormat {
+    CSV,       // The session CSVs, written as records arrive
+    BINARY,    // journal.bin; journal_to_csv turns it into the same CSVs
+    COLUMNAR   // The CSVs, but price updates go to price_updates.pmmc
+};
+
+// Session trade logs. Log calls only encode a binary record into a ring;
+// a writer thread drains it in batches and flushes once per batch, so
+// the strategy thread never formats text, takes a lock or touches disk.
+//
+// The log* calls have a single producer: call them from one thread at a
+// time (the strategy thread). When the ring is full price updates are
+// dropped and counted; everything else waits for room.
 class TradingLogger {
 public:
-    TradingLogger(const std::filesystem::path& log_dir);
+    static constexpr size_t RING_BYTES = 4 << 20;
+    static constexpr std::chrono::milliseconds COMMIT_INTERVAL{50};
+
+    TradingLogger(const std::filesystem::path& log_dir, JournalFormat format = JournalFormat::CSV);
     ~TradingLogger();
-    
+
     void startSession(const std::string& event_name);
     void endSession();
     std::string getSessionId() const { return session_id_; }
+    std::filesystem::path getSessionDir() const { return session_dir_; }
+
+    // Blocks until everything logged so far is written out
+    void flush();
+
+    uint64_t droppedPriceUpdates() const { return dropped_price_updates_.load(std::memory_order_relaxed); }
 
-    void logOrderPlaced(const Order& order, const std::string& market_id,
-                       Price market_mid = 0.0, Price market_spread = 0.0, 
+    void logOrderPlaced(const Order& order, std::string_view market_id,
+                       Price market_mid = 0.0, Price market_spread = 0.0,
                        Price best_bid = 0.0, Price best_ask = 0.0,
                        Price our_bid = 0.0, Price our_ask = 0.0);
-    void logOrderCancelled(const OrderId& order_id, const Order& order, const std::string& market_id, CancelReason reason = CancelReason::UNKNOWN);
-    void logOrderFilled(const std::string& market_id, const OrderId& order_id, const TokenId& token_id, 
-                       Price fill_price, Size fill_size, Side side, double pnl = 0.0,
-                       Price quoted_price = 0.0, Price mid_at_fill = 0.0, 
-                       double seconds_to_fill = 0.0);
-    void updateFillAdverseSelection(const OrderId& order_id, Price mid_1s = 0.0, 
-                                   Price mid_5s = 0.0, Price mid_30s = 0.0);
-
-    void logPosition(const std::string& market_id, const TokenId& token_id, Size position, Price avg_cost, 
-                    const std::chrono::system_clock::time_point& opened_at, 
+    void logOrderCancelled(OrderId order_id, const Order& order, std::string_view market_id, CancelReason reason = CancelReason::UNKNOWN);
+    void logOrderFilled(std::string_view market_id, OrderId order_id, uint64_t fill_seq, const TokenId& token_id,
+                        Price fill_price, Size fill_size, Side side, double pnl = 0.0,
+                        Price quoted_price = 0.0, Price mid_at_fill = 0.0,
+                        double seconds_to_fill = 0.0);
+    // One row per fill once all of its markout horizons have been captured
+    void logFillMarkout(std::string_view market_id, const TokenId& token_id, OrderId order_id, uint64_t fill_seq,
+                       const std::chrono::system_clock::time_point& fill_time, Side side,
+                       Price fill_price, Price mid_at_fill, double inventory_before,
+                       double inventory_after, Price mid_30s, Price mid_60s);
+    // Fills in the mid_*_later and adverse_selection_* columns of the fill's
+    // fills.csv row, once; 0.0 leaves a mid unknown
+    void updateFillAdverseSelection(OrderId order_id, uint64_t fill_seq, Price mid_1s = 0.0,
+                                    Price mid_5s = 0.0, Price mid_30s = 0.0);
+
+    void logPosition(std::string_view market_id, const TokenId& token_id, Size position, Price avg_cost,
+                    const std::chrono::system_clock::time_point& opened_at,
                     const std::chrono::system_clock::time_point& last_updated,
                     Side entry_side, int num_fills, double total_cost);
 
-    void logPriceUpdate(const std::string& market_name, const std::string& market_id, 
-                       const std::string& condition_id, const TokenId& token_id,
+    void logPriceUpdate(std::string_view market_name, std::string_view market_id,
+                       std::string_view condition_id, const TokenId& token_id,
                        Price mid_price, double price_change_pct, double price_change_abs,
                        Price best_bid, Price best_ask, Price spread, double spread_bps,
                        double bid_volume, double ask_volume, double total_volume, double volume_imbalance,
@@ -45,24 +82,36 @@ public:
 
 private:
     std::filesystem::path log_dir_;
+    JournalFormat format_;
     std::filesystem::path session_dir_;
     std::string session_id_;
     std::string event_name_;
     std::chrono::system_clock::time_point session_start_;
-    
-    std::ofstream orders_file_;
-    std::ofstream fills_file_;
-    std::ofstream positions_file_;
-    std::ofstream price_updates_file_;
-    
-    std::unordered_map<OrderId, std::streampos> fill_positions_;
-    
-    std::mutex mutex_;
-    
+    bool active_ = false;
+
+    JournalRing ring_;
+    std::atomic<uint64_t> dropped_price_updates_{0};
+
+    // Writer thread and what it writes to
+    std::unique_ptr<JournalCsvWriter> csv_writer_;
+    std::FILE* binary_file_ = nullptr;
+    std::vector<char> batch_;             // Binary records gathered for one write
+    std::thread writer_;
+    std::atomic<bool> stopping_{false};
+    std::mutex writer_mutex_;
+    std::condition_variable writer_cv_;   // Wakes the writer early
+    std::condition_variable written_cv_;  // Signals flush() waiters after each batch
+    uint64_t flush_requested_ = 0;        // Ring bytes someone is waiting on
+    uint64_t written_ = 0;                // Ring bytes written out so far
+
     void ensureLogDir();
-    void initializeFiles();
-    void closeFiles();
-    std::string getCurrentTimestamp() const;
+    void writerLoop();
+    // Wakes the writer without waiting for COMMIT_INTERVAL
+    void requestWrite(uint64_t ring_bytes);
+    void writeBatch();
+
+    template <typename Payload, typename... Strings>
+    void append(JournalRecordType type, const Payload& payload, const Strings&... strings);
 };
 
 } // namespace pmm
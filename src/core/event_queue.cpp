@@ -18,6 +18,26 @@ namespace pmm {
         return event;
     }
 
+    bool EventQueue::tryPop(Event& event) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) {
+            return false;
+        }
+        event = std::move(queue_.front());
+        queue_.pop();
+        return true;
+    }
+
+    bool EventQueue::popUntil(Event& event, std::chrono::steady_clock::time_point deadline) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!cv_.wait_until(lock, deadline, [this]() { return !queue_.empty(); })) {
+            return false;
+        }
+        event = std::move(queue_.front());
+        queue_.pop();
+        return true;
+    }
+
     bool EventQueue::empty() const {
         std::lock_guard<std::mutex> lock(mutex_);
         return queue_.empty();
@@ -1,8 +1,15 @@
 #include "data/order_book.hpp"
+#include <algorithm>
 
 namespace pmm {
 
+    namespace {
+        // Quoted prices and feed prices may differ in the last bits
+        constexpr Price PRICE_EPSILON = 1e-9;
+    }
+
     void OrderBook::updateBid(Price price, Size size) {
+        top_dirty_ = true;
         if (size == 0) {
             bids_.erase(price);
         } else {
@@ -11,6 +18,7 @@ namespace pmm {
     }
 
     void OrderBook::updateAsk(Price price, Size size) {
+        top_dirty_ = true;
         if (size == 0) {
             asks_.erase(price);
         } else {
@@ -19,6 +27,7 @@ namespace pmm {
     }
 
     void OrderBook::clear() {
+        top_dirty_ = true;
         bids_.clear();
         asks_.clear();
     }
@@ -56,6 +65,9 @@ namespace pmm {
     }
 
     Size OrderBook::getTotalBidVolume(int levels) const {
+        if (levels == DEPTH_LEVELS) {
+            return top().bid_volume;
+        }
         Size total = 0;
         int count = 0;
         for (const auto& [price, size] : bids_) {
@@ -66,6 +78,9 @@ namespace pmm {
     }
 
     Size OrderBook::getTotalAskVolume(int levels) const {
+        if (levels == DEPTH_LEVELS) {
+            return top().ask_volume;
+        }
         Size total = 0;
         int count = 0;
         for (const auto& [price, size] : asks_) {
@@ -75,9 +90,74 @@ namespace pmm {
         return total;
     }
 
+    Size OrderBook::getBidSize(Price price) const {
+        auto it = bids_.lower_bound(price + PRICE_EPSILON);
+        return (it != bids_.end() && it->first >= price - PRICE_EPSILON) ? it->second : 0.0;
+    }
+
+    Size OrderBook::getAskSize(Price price) const {
+        auto it = asks_.lower_bound(price - PRICE_EPSILON);
+        return (it != asks_.end() && it->first <= price + PRICE_EPSILON) ? it->second : 0.0;
+    }
+
+    Size OrderBook::getAskDepthThrough(Price price) const {
+        Size total = 0;
+        for (auto it = asks_.begin(); it != asks_.end() && it->first <= price + PRICE_EPSILON; ++it) {
+            total += it->second;
+        }
+        return total;
+    }
+
+    Size OrderBook::getBidDepthThrough(Price price) const {
+        Size total = 0;
+        for (auto it = bids_.begin(); it != bids_.end() && it->first >= price - PRICE_EPSILON; ++it) {
+            total += it->second;
+        }
+        return total;
+    }
+
+    const OrderBook::TopOfBook& OrderBook::top() const {
+        if (!top_dirty_) {
+            return top_;
+        }
+        top_ = TopOfBook{};
+        
+        int count = 0;
+        for (const auto& [price, size] : bids_) {
+            top_.bid_volume += size;
+            top_.bid_notional += price * size;
+            if (++count >= DEPTH_LEVELS) break;
+        }
+        count = 0;
+        for (const auto& [price, size] : asks_) {
+            top_.ask_volume += size;
+            top_.ask_notional += price * size;
+            if (++count >= DEPTH_LEVELS) break;
+        }
+        
+        double total = top_.bid_volume + top_.ask_volume;
+        if (total != 0.0) {
+            top_.imbalance = (top_.bid_volume - top_.ask_volume) / total;
+        }
+        
+        if (hasValidBBO()) {
+            auto [bid, bid_size] = *bids_.begin();
+            auto [ask, ask_size] = *asks_.begin();
+            top_.microprice = (bid * ask_size + ask * bid_size) / (bid_size + ask_size);
+            top_.depth_weighted_mid = (top_.bid_notional / top_.bid_volume + top_.ask_notional / top_.ask_volume) / 2.0;
+        }
+        
+        top_dirty_ = false;
+        return top_;
+    }
+
     double OrderBook::getImbalance() const {
-        double bid_vol = getTotalBidVolume();
-        double ask_vol = getTotalAskVolume();
+        return top().imbalance;
+    }
+
+    double OrderBook::getImbalance(int levels) const {
+        double bid_vol = getTotalBidVolume(levels);
+        double ask_vol = getTotalAskVolume(levels);
         double total = bid_vol + ask_vol;
         
         if (total == 0.0) {
@@ -87,6 +167,42 @@ namespace pmm {
         return (bid_vol - ask_vol) / total;
     }
 
+    Price OrderBook::getMicroprice() const {
+        return top().microprice;
+    }
+
+    Price OrderBook::getDepthWeightedMid() const {
+        return top().depth_weighted_mid;
+    }
+
+    namespace {
+        template <typename Levels>
+        Price vwapFor(const Levels& levels, Size size) {
+            if (size <= 0.0) {
+                return 0.0;
+            }
+            Size remaining = size;
+            double notional = 0.0;
+            for (const auto& [price, level_size] : levels) {
+                Size taken = std::min(remaining, level_size);
+                notional += price * taken;
+                remaining -= taken;
+                if (remaining <= 0.0) {
+                    return notional / size;
+                }
+            }
+            return 0.0;
+        }
+    }
+
+    Price OrderBook::getBuyVwap(Size size) const {
+        return vwapFor(asks_, size);
+    }
+
+    Price OrderBook::getSellVwap(Size size) const {
+        return vwapFor(bids_, size);
+    }
+
     int OrderBook::getBidLevelCount() const {
         return static_cast<int>(bids_.size());
     }
@@ -0,0 +1,77 @@
+#include "data/volatility.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pmm {
+
+namespace {
+
+constexpr double FOUR_LN_2 = 2.772588722239781;
+
+} // namespace
+
+VolatilityEstimator::VolatilityEstimator()
+    : ewma_variance_(INITIAL_VOLATILITY * INITIAL_VOLATILITY / ANNUALIZE) {
+    estimates_.ewma = INITIAL_VOLATILITY;
+}
+
+void VolatilityEstimator::onMid(Price mid, Clock::time_point now) {
+    if (mid <= 0.0) {
+        return;
+    }
+    int64_t interval = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() / INTERVAL_MS;
+
+    if (!started_) {
+        started_ = true;
+        interval_ = interval;
+        previous_close_ = close_ = high_ = low_ = mid;
+        return;
+    }
+
+    if (interval > interval_) {
+        // ln(H/L) to third order, without the log
+        double range = 2.0 * (high_ - low_) / (high_ + low_);
+        double ret = (close_ - previous_close_) / previous_close_;
+        addSample(ret * ret, range * range / FOUR_LN_2);
+
+        // Quiet intervals in between; past a full window they are all alike
+        int64_t quiet = std::min<int64_t>(interval - interval_ - 1, WINDOW);
+        for (int64_t i = 0; i < quiet; i++) {
+            addSample(0.0, 0.0);
+        }
+        refresh();
+
+        interval_ = interval;
+        previous_close_ = close_;
+        high_ = low_ = close_;
+    }
+
+    close_ = mid;
+    high_ = std::max(high_, mid);
+    low_ = std::min(low_, mid);
+}
+
+void VolatilityEstimator::addSample(double squared_return, double squared_range) {
+    ewma_variance_ = EWMA_LAMBDA * ewma_variance_ + (1.0 - EWMA_LAMBDA) * squared_return;
+
+    if (samples_.size() == WINDOW) {
+        const Sample& oldest = samples_.front();
+        sum_squared_returns_ -= oldest.squared_return;
+        sum_squared_ranges_ -= oldest.squared_range;
+        samples_.pop_front();
+    }
+    samples_.push_back(Sample{squared_return, squared_range});
+    sum_squared_returns_ += squared_return;
+    sum_squared_ranges_ += squared_range;
+}
+
+void VolatilityEstimator::refresh() {
+    double n = static_cast<double>(samples_.size());
+    estimates_.ewma = std::sqrt(ewma_variance_ * ANNUALIZE);
+    // Running sums can drift a hair below zero once only quiet intervals remain
+    estimates_.realized = std::sqrt(std::max(0.0, sum_squared_returns_) / n * ANNUALIZE);
+    estimates_.parkinson = std::sqrt(std::max(0.0, sum_squared_ranges_) / n * ANNUALIZE);
+    quote_volatility_ = std::max(MIN_QUOTE_VOLATILITY, std::min(MAX_QUOTE_VOLATILITY, estimates_.ewma));
+}
+
+} // namespace pmm
@@ -0,0 +1,41 @@
+#include "utils/journal_csv_writer.hpp"
+#include "utils/trade_journal.hpp"
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+
+using namespace pmm;
+
+// Turns a session's journal.bin into the usual session CSVs:
+//   journal_to_csv [--columnar] <journal.bin> [output_dir]
+// The CSVs go next to the journal unless output_dir is given. --columnar
+// writes price updates to price_updates.pmmc instead of a CSV.
+int main(int argc, char** argv) {
+    bool columnar = argc > 1 && std::string_view(argv[1]) == "--columnar";
+    int first = columnar ? 2 : 1;
+    if (argc - first < 1 || argc - first > 2) {
+        std::cerr << "Usage: " << argv[0] << " [--columnar] <journal.bin> [output_dir]\n";
+        return 1;
+    }
+
+    std::filesystem::path journal_path = argv[first];
+    std::filesystem::path output_dir = argc - first == 2 ? std::filesystem::path(argv[first + 1]) : journal_path.parent_path();
+    if (output_dir.empty()) {
+        output_dir = ".";
+    }
+
+    try {
+        std::filesystem::create_directories(output_dir);
+        JournalCsvWriter writer(output_dir, columnar);
+        size_t records = journal::readFile(journal_path, [&](const JournalRecordView& record) {
+            writer.write(record);
+        });
+        writer.flush();
+        std::cout << "Wrote " << records << " records to " << output_dir.string() << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include "core/event_queue.hpp"
 #include "strategy/strategy_engine.hpp"
 #include "network/http_client.hpp"
+#include "network/order_gateway.hpp"
 #include "network/websocket_client.hpp"
 #include "strategy/order_manager.hpp"
 #include "utils/logger.hpp"
@@ -17,15 +18,26 @@
 using namespace pmm;
 
 std::atomic<bool> keep_running{true};
+std::atomic<bool> kill_requested{false};
 
 void signalHandler(int signal) {
     std::cout << "\n\nReceived signal " << signal << ", shutting down...\n";
     keep_running = false;
 }
 
+// SIGUSR1: stop quoting and pull every order, but keep the process up
+void killSwitchHandler(int) {
+    kill_requested = true;
+}
+
 int main() {
     std::signal(SIGINT, signalHandler);
+    std::signal(SIGUSR1, killSwitchHandler);
     Logger::init("./logs", "polymarket_mm");
+    // Declared first so it runs last, after everything below has logged
+    struct LoggerShutdown {
+        ~LoggerShutdown() { Logger::shutdown(); }
+    } logger_shutdown;
 
     std::cout << "Trading mode:\n";
     std::cout << "  1. Paper Trading\n";
@@ -50,7 +62,15 @@ int main() {
     }
 
     EventQueue queue;
+    
+    // Declared before the engine so it outlives it
+    std::unique_ptr<OrderGateway> gateway;
     StrategyEngine strategy(queue, mode);
+    if (mode == TradingMode::LIVE) {
+        gateway = std::make_unique<OrderGateway>(queue);
+        gateway->start();
+        strategy.setOrderGateway(gateway.get());
+    }
     PolymarketHttpClient http_client;
 
     std::cout << "What would you like to trade?\n";
@@ -360,49 +380,16 @@ int main() {
                 LOG_DEBUG("    [{}] {} -> Token: {}", i, market.outcomes[i], market.tokens[i]);
             }
             
-            // For binary markets, only trade the Yes side
-            if (market.tokens.size() == 2 && market.outcomes.size() == 2) {
-                // Find the Yes and No indices
-                size_t yes_idx = 0;
-                size_t no_idx = 1;
-                for (size_t i = 0; i < market.outcomes.size(); i++) {
-                    if (market.outcomes[i] == "Yes") {
-                        yes_idx = i;
-                        no_idx = 1 - i;  // The other outcome
-                        break;
-                    }
-                }
-                
-                // Register Yes side for trading
+            // Trade every outcome; the strategy quotes outcomes of one condition together
+            for (size_t i = 0; i < market.tokens.size(); i++) {
                 strategy.registerMarket(
-                    market.tokens[yes_idx],
+                    market.tokens[i],
                     market.question,
-                    market.outcomes[yes_idx],
+                    market.outcomes[i],
                     market.market_id,       // Specific market ID
                     market.condition_id     // Groups related outcomes
                 );
-                all_tokens.push_back(market.tokens[yes_idx]);
-                
-                // Register No side metadata only (for logging, not trading)
-                strategy.registerMarketMetadata(
-                    market.tokens[no_idx],
-                    market.question,
-                    market.outcomes[no_idx],
-                    market.market_id,
-                    market.condition_id
-                );
-            } else {
-                // For non-binary markets, trade all outcomes
-                for (size_t i = 0; i < market.tokens.size(); i++) {
-                    strategy.registerMarket(
-                        market.tokens[i],
-                        market.question,
-                        market.outcomes[i],
-                        market.market_id,       // Specific market ID
-                        market.condition_id     // Groups related outcomes
-                    );
-                    all_tokens.push_back(market.tokens[i]);
-                }
+                all_tokens.push_back(market.tokens[i]);
             }
             total_markets++;
         }
@@ -483,17 +470,19 @@ int main() {
             std::this_thread::sleep_for(std::chrono::seconds(5));
             if (keep_running) {
                 seconds += 5;
-                auto positions = strategy.getPositionCount();
-                auto active_orders = strategy.getActiveOrderCount();
-                auto bid_count = strategy.getBidCount();
-                auto ask_count = strategy.getAskCount();
-                auto active_markets = strategy.getActiveMarketCount();
-                auto realized_pnl = strategy.getTotalPnL();
-                auto unrealized_pnl = strategy.getUnrealizedPnL();
+                // One consistent snapshot per tick
+                EngineStats stats = strategy.getStats();
+                auto positions = stats.position_count;
+                auto active_orders = stats.active_order_count;
+                auto bid_count = stats.bid_count;
+                auto ask_count = stats.ask_count;
+                auto active_markets = stats.active_market_count;
+                auto realized_pnl = stats.realized_pnl;
+                auto unrealized_pnl = stats.unrealized_pnl;
                 auto total_pnl = realized_pnl + unrealized_pnl;
-                auto total_inventory = strategy.getTotalInventory();
-                auto avg_spread = strategy.getAverageSpread();
-                auto fill_count = strategy.getFillCount();
+                auto total_inventory = stats.total_inventory;
+                auto avg_spread = stats.average_spread;
+                auto fill_count = stats.fill_count;
                 
                 // Format runtime nicely
                 int minutes = seconds / 60;
@@ -567,6 +556,10 @@ int main() {
 
     while (keep_running) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (kill_requested && !strategy.isKilled()) {
+            LOG_WARN("Kill switch requested, cancelling all orders");
+            strategy.triggerKillSwitch();
+        }
     }
     
     // Wait for status thread to complete and print final newline for dashboard mode
@@ -582,6 +575,9 @@ int main() {
     LOG_INFO("Shutting down...");
     ws_client.disconnect();
     strategy.stop();
+    if (gateway) {
+        gateway->stop();
+    }
     
     std::this_thread::sleep_for(std::chrono::seconds(1));
 
@@ -0,0 +1,630 @@
+#include "network/order_gateway.hpp"
+#include "utils/logger.hpp"
+#include <boost/asio/connect.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <unordered_set>
+
+namespace pmm {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace ssl = boost::asio::ssl;
+using tcp = boost::asio::ip::tcp;
+using json = nlohmann::json;
+
+OrderGateway::OrderGateway(EventQueue& event_queue, GatewayConfig config)
+    : event_queue_(event_queue),
+      config_(std::move(config)),
+      commands_(std::make_unique<SpscQueue<GatewayCommand, COMMAND_QUEUE_CAPACITY>>()),
+      ssl_ctx_(ssl::context::tlsv12_client) {
+    ssl_ctx_.set_default_verify_paths();
+    ssl_ctx_.set_verify_mode(ssl::verify_peer);
+    drained_.reserve(COMMAND_QUEUE_CAPACITY);
+
+    LOG_INFO("OrderGateway initialized for {}://{}:{} (batch size {})",
+             config_.use_tls ? "https" : "http", config_.host, config_.port, config_.max_batch);
+}
+
+OrderGateway::~OrderGateway() {
+    stop();
+}
+
+void OrderGateway::start() {
+    if (running_.load()) {
+        return;
+    }
+    running_ = true;
+    io_thread_ = std::thread(&OrderGateway::run, this);
+    LOG_INFO("OrderGateway started");
+}
+
+void OrderGateway::stop() {
+    if (!running_.load()) {
+        return;
+    }
+
+    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_cv_.notify_one();
+    }
+    if (io_thread_.joinable()) {
+        io_thread_.join();
+    }
+    LOG_INFO("OrderGateway stopped ({} requests on {} connections)", requestsSent(), connectionsOpened());
+}
+
+bool OrderGateway::submit(GatewayCommand command) {
+    OrderId order_id = command.order_id;
+    if (!commands_->tryPush(std::move(command))) {
+        LOG_ERROR("OrderGateway command queue full, dropping ORD_{}", order_id);
+        return false;
+    }
+
+    // Only pay for a notify when the I/O thread is parked
+    if (idle_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_cv_.notify_one();
+    }
+    return true;
+}
+
+bool OrderGateway::submitPlace(const Order& order) {
+    GatewayCommand command;
+    command.type = GatewayCommandType::PLACE;
+    command.order_id = order.order_id;
+    command.token_id = order.token_id;
+    command.side = order.side;
+    command.price = order.price;
+    command.size = order.size - order.filled_size;
+    return submit(std::move(command));
+}
+
+bool OrderGateway::submitCancel(OrderId order_id) {
+    GatewayCommand command;
+    command.type = GatewayCommandType::CANCEL;
+    command.order_id = order_id;
+    return submit(std::move(command));
+}
+
+void OrderGateway::run() {
+    LOG_DEBUG("OrderGateway I/O thread started");
+
+    while (running_.load()) {
+        waitForCommands();
+        processBatch();
+    }
+
+    // Flush whatever was submitted before stop (e.g. shutdown cancels)
+    processBatch();
+    disconnect();
+
+    LOG_DEBUG("OrderGateway I/O thread exited");
+}
+
+void OrderGateway::waitForCommands() {
+    if (!commands_->empty()) {
+        return;
+    }
+
+    // A push racing with the idle flag is picked up by the timed wait at worst
+    idle_.store(true, std::memory_order_release);
+    {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait_for(lock, config_.idle_wait, [this] {
+            return !commands_->empty() || !running_.load();
+        });
+    }
+    idle_.store(false, std::memory_order_release);
+}
+
+void OrderGateway::processBatch() {
+    drained_.clear();
+    GatewayCommand command;
+    while (commands_->tryPop(command)) {
+        drained_.push_back(std::move(command));
+    }
+    if (drained_.empty() && !reconcileDue()) {
+        return;
+    }
+
+    buildRequests();
+
+    // Acks can release cancels that were requested while the order was
+    // pending-new, so keep going until a round produces no new requests
+    while (!pipeline_.empty()) {
+        sendPipeline();
+    }
+
+    in_flight_count_.store(in_flight_.size(), std::memory_order_relaxed);
+}
+
+void OrderGateway::buildRequests() {
+    pipeline_.clear();
+    std::vector<OrderId> cancel_ids;
+
+    // Ahead of new placements, so none of them can be taken for an unknown one
+    if (reconcileDue()) {
+        reconcile_needed_ = false;
+        open_orders_.clear();
+        pipeline_.push_back(PendingRequest{RequestType::OPEN_ORDERS, {}, {},
+                                           makeRequest(http::verb::get, "/data/orders", "")});
+    }
+
+    json orders = json::array();
+    PendingRequest place_request{RequestType::PLACE, {}, {}, {}};
+
+    auto flushPlaces = [&]() {
+        if (place_request.order_ids.empty()) {
+            return;
+        }
+        place_request.request = makeRequest(http::verb::post, "/orders", orders.dump());
+        pipeline_.push_back(std::move(place_request));
+        place_request = PendingRequest{RequestType::PLACE, {}, {}, {}};
+        orders = json::array();
+    };
+
+    for (GatewayCommand& command : drained_) {
+        if (command.type == GatewayCommandType::PLACE) {
+            in_flight_[command.order_id] = InFlightOrder{};
+
+            // Signing is not implemented; the exchange expects a signed order here
+            orders.push_back({
+                {"order", {
+                    {"tokenID", command.token_id},
+                    {"side", command.side == Side::BUY ? "BUY" : "SELL"},
+                    {"price", command.price},
+                    {"size", command.size}
+                }},
+                {"orderType", "GTC"},
+                {"clientOrderId", orderIdToString(command.order_id)}
+            });
+            place_request.order_ids.push_back(command.order_id);
+            place_request.places.push_back(std::move(command));
+
+            if (place_request.order_ids.size() >= config_.max_batch) {
+                flushPlaces();
+            }
+        } else {
+            queueCancel(command.order_id, cancel_ids);
+        }
+    }
+    flushPlaces();
+
+    if (!cancel_ids.empty()) {
+        pipeline_.push_back(makeCancelRequest(std::move(cancel_ids)));
+    }
+}
+
+void OrderGateway::queueCancel(OrderId order_id, std::vector<OrderId>& cancel_ids) {
+    auto it = in_flight_.find(order_id);
+    if (it == in_flight_.end()) {
+        // Already rejected, matched or cancelled; either way it isn't working
+        LOG_WARN("OrderGateway cancel for unknown order ORD_{}", order_id);
+        event_queue_.push(Event::orderCancelled(order_id));
+        return;
+    }
+
+    InFlightOrder& order = it->second;
+    switch (order.state) {
+        case InFlightState::PENDING_NEW:
+        case InFlightState::UNKNOWN:
+            order.cancel_requested = true;  // Sent once the exchange id is known
+            break;
+        case InFlightState::ACKED:
+            order.state = InFlightState::PENDING_CANCEL;
+            cancel_ids.push_back(order_id);
+            break;
+        case InFlightState::PENDING_CANCEL:
+            break;
+    }
+}
+
+OrderGateway::PendingRequest OrderGateway::makeCancelRequest(std::vector<OrderId> order_ids) {
+    json exchange_ids = json::array();
+    for (OrderId order_id : order_ids) {
+        exchange_ids.push_back(in_flight_[order_id].exchange_order_id);
+    }
+    PendingRequest pending{RequestType::CANCEL, std::move(order_ids), {}, {}};
+    pending.request = makeRequest(http::verb::delete_, "/orders", json{{"orderIDs", exchange_ids}}.dump());
+    return pending;
+}
+
+OrderGateway::Request OrderGateway::makeRequest(http::verb verb, const std::string& target, const std::string& body) const {
+    Request request{verb, target, 11};
+    request.set(http::field::host, config_.host);
+    request.set(http::field::user_agent, "polymarket-mm");
+    request.set(http::field::content_type, "application/json");
+    request.keep_alive(true);
+    request.body() = body;
+    request.prepare_payload();
+    return request;
+}
+
+bool OrderGateway::reconcileDue() const {
+    return reconcile_needed_ && std::chrono::steady_clock::now() >= reconcile_after_;
+}
+
+bool OrderGateway::isConnected() const {
+    return plain_stream_ != nullptr || tls_stream_ != nullptr;
+}
+
+void OrderGateway::connect() {
+    tcp::resolver resolver(ioc_);
+    auto endpoints = resolver.resolve(config_.host, config_.port);
+
+    if (config_.use_tls) {
+        tls_stream_ = std::make_unique<beast::ssl_stream<beast::tcp_stream>>(ioc_, ssl_ctx_);
+        if (!SSL_set_tlsext_host_name(tls_stream_->native_handle(), config_.host.c_str())) {
+            tls_stream_.reset();
+            throw std::runtime_error("Failed to set SNI hostname");
+        }
+        beast::get_lowest_layer(*tls_stream_).connect(endpoints);
+        beast::get_lowest_layer(*tls_stream_).socket().set_option(tcp::no_delay(true));
+        tls_stream_->handshake(ssl::stream_base::client);
+    } else {
+        plain_stream_ = std::make_unique<beast::tcp_stream>(ioc_);
+        plain_stream_->connect(endpoints);
+        plain_stream_->socket().set_option(tcp::no_delay(true));
+    }
+
+    read_buffer_.clear();
+    connections_opened_.fetch_add(1, std::memory_order_relaxed);
+    LOG_INFO("OrderGateway connected to {}:{}", config_.host, config_.port);
+}
+
+void OrderGateway::disconnect() {
+    beast::error_code ec;
+    if (tls_stream_) {
+        tls_stream_->shutdown(ec);
+        tls_stream_.reset();
+    }
+    if (plain_stream_) {
+        plain_stream_->socket().shutdown(tcp::socket::shutdown_both, ec);
+        plain_stream_.reset();
+    }
+}
+
+void OrderGateway::sendPipeline() {
+    // Bounded so neither side can fill its socket buffers while the other is still writing
+    size_t depth = std::min(std::max<size_t>(config_.max_pipeline_depth, 1), pipeline_.size());
+    std::vector<PendingRequest> requests(std::make_move_iterator(pipeline_.begin()),
+                                         std::make_move_iterator(pipeline_.begin() + depth));
+    pipeline_.erase(pipeline_.begin(), pipeline_.begin() + depth);
+    size_t written = 0;
+    size_t answered = 0;
+
+    try {
+        if (!isConnected()) {
+            connect();
+        }
+
+        auto exchange = [&](auto& stream) {
+            // Write every request first, then read the responses in order
+            for (; written < requests.size(); written++) {
+                http::write(stream, requests[written].request);
+                requests_sent_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            bool close_after = false;
+            for (; answered < requests.size(); ) {
+                Response response;
+                http::read(stream, read_buffer_, response);
+                close_after = close_after || response.need_eof();
+
+                const PendingRequest& pending = requests[answered++];
+                switch (pending.type) {
+                    case RequestType::PLACE: handlePlaceResponse(pending, response); break;
+                    case RequestType::CANCEL: handleCancelResponse(pending, response); break;
+                    case RequestType::OPEN_ORDERS: handleOpenOrdersResponse(response); break;
+                }
+            }
+
+            if (close_after) {
+                disconnect();
+            }
+        };
+
+        if (tls_stream_) {
+            exchange(*tls_stream_);
+        } else {
+            exchange(*plain_stream_);
+        }
+    } catch (const std::exception& e) {
+        // Placements written but unanswered may be resting on the exchange,
+        // so they wait for the open orders; anything never written failed
+        LOG_ERROR("OrderGateway request failed: {}", e.what());
+        disconnect();
+        for (size_t i = answered; i < requests.size(); i++) {
+            if (requests[i].type == RequestType::OPEN_ORDERS) {
+                reconcile_needed_ = true;
+            } else if (requests[i].type == RequestType::PLACE && i < written) {
+                markUnknown(requests[i]);
+            } else {
+                failRequest(requests[i], e.what());
+            }
+        }
+        if (running_.load()) {
+            std::this_thread::sleep_for(config_.reconnect_backoff);
+        }
+    }
+}
+
+void OrderGateway::handlePlaceResponse(const PendingRequest& pending, const Response& response) {
+    if (response.result_int() / 100 != 2) {
+        failRequest(pending, "HTTP " + std::to_string(response.result_int()) + ": " + response.body());
+        return;
+    }
+
+    json results = json::parse(response.body(), nullptr, false);
+    if (!results.is_array() || results.size() != pending.order_ids.size()) {
+        failRequest(pending, "Malformed order response");
+        return;
+    }
+
+    std::vector<OrderId> cancel_ids;
+    for (size_t i = 0; i < results.size(); i++) {
+        const json& result = results[i];
+        const GatewayCommand& place = pending.places[i];
+        auto it = in_flight_.find(place.order_id);
+        if (it == in_flight_.end()) {
+            continue;
+        }
+
+        if (!result.value("success", false)) {
+            std::string reason = result.value("errorMsg", std::string("rejected"));
+            LOG_WARN("OrderGateway ORD_{} rejected: {}", place.order_id, reason);
+            rejectPlace(place.order_id, reason);
+            continue;
+        }
+
+        InFlightOrder& order = it->second;
+        order.state = InFlightState::ACKED;
+        order.exchange_order_id = result.value("orderID", std::string());
+        event_queue_.push(Event::orderAcked(place.order_id, order.exchange_order_id));
+
+        // Crossed on entry - the whole order traded immediately
+        if (result.value("status", std::string()) == "matched") {
+            event_queue_.push(Event::orderFill(place.order_id, place.token_id, place.price, place.size, place.side));
+            in_flight_.erase(it);
+            continue;
+        }
+
+        if (order.cancel_requested) {
+            order.cancel_requested = false;
+            queueCancel(place.order_id, cancel_ids);
+        }
+    }
+
+    if (!cancel_ids.empty()) {
+        pipeline_.push_back(makeCancelRequest(std::move(cancel_ids)));
+    }
+}
+
+void OrderGateway::handleCancelResponse(const PendingRequest& pending, const Response& response) {
+    if (response.result_int() / 100 != 2) {
+        failRequest(pending, "HTTP " + std::to_string(response.result_int()) + ": " + response.body());
+        return;
+    }
+
+    json result = json::parse(response.body(), nullptr, false);
+    if (!result.is_object()) {
+        failRequest(pending, "Malformed cancel response");
+        return;
+    }
+
+    const json canceled = result.value("canceled", json::array());
+    const json not_canceled = result.value("not_canceled", json::object());
+
+    for (OrderId order_id : pending.order_ids) {
+        auto it = in_flight_.find(order_id);
+        if (it == in_flight_.end()) {
+            continue;
+        }
+
+        const std::string& exchange_id = it->second.exchange_order_id;
+        bool was_canceled = std::find(canceled.begin(), canceled.end(), exchange_id) != canceled.end();
+        if (was_canceled) {
+            event_queue_.push(Event::orderCancelled(order_id));
+            in_flight_.erase(it);
+            continue;
+        }
+
+        // Listed as not cancelable: already matched or cancelled on the exchange
+        if (not_canceled.contains(exchange_id)) {
+            LOG_WARN("OrderGateway ORD_{} already closed on the exchange: {}", order_id,
+                     not_canceled[exchange_id].is_string() ? not_canceled[exchange_id].get<std::string>() : std::string());
+            event_queue_.push(Event::orderCancelled(order_id));
+            in_flight_.erase(it);
+            continue;
+        }
+
+        // No answer for this order - assume it is still working
+        LOG_WARN("OrderGateway cancel of ORD_{} not confirmed", order_id);
+        it->second.state = InFlightState::ACKED;
+        event_queue_.push(Event::orderRejected(order_id, RejectedRequest::CANCEL, "Cancel failed: no cancel confirmation"));
+    }
+}
+
+namespace {
+// The CLOB sends prices and sizes as strings; -1 if missing
+double numberField(const json& object, const char* key) {
+    auto it = object.find(key);
+    if (it == object.end()) {
+        return -1.0;
+    }
+    if (it->is_number()) {
+        return it->get<double>();
+    }
+    if (it->is_string()) {
+        return std::strtod(it->get_ref<const std::string&>().c_str(), nullptr);
+    }
+    return -1.0;
+}
+
+// next_cursor of the last page
+constexpr const char* LAST_PAGE_CURSOR = "LTE=";
+
+// Cursors are base64, so '+', '/' and '=' need escaping in the query
+std::string urlEncode(const std::string& value) {
+    static const char* hex = "0123456789ABCDEF";
+    std::string encoded;
+    for (unsigned char c : value) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            encoded += static_cast<char>(c);
+        } else {
+            encoded += '%';
+            encoded += hex[c >> 4];
+            encoded += hex[c & 0xF];
+        }
+    }
+    return encoded;
+}
+} // namespace
+
+void OrderGateway::handleOpenOrdersResponse(const Response& response) {
+    json body = json::parse(response.body(), nullptr, false);
+    json page = body.is_object() ? body.value("data", json()) : body;  // Paginated form, or a plain list
+    if (response.result_int() / 100 != 2 || !page.is_array()) {
+        LOG_WARN("OrderGateway open orders query failed (HTTP {}), retrying in {}ms",
+                 response.result_int(), config_.reconnect_backoff.count());
+        reconcile_needed_ = true;
+        reconcile_after_ = std::chrono::steady_clock::now() + config_.reconnect_backoff;
+        return;
+    }
+
+    for (const json& resting : page) {
+        if (!resting.is_object()) {
+            continue;
+        }
+        open_orders_.push_back(RestingOrder{resting.value("id", std::string()),
+                                            resting.value("asset_id", std::string()),
+                                            resting.value("side", std::string()),
+                                            numberField(resting, "price"),
+                                            numberField(resting, "original_size"),
+                                            numberField(resting, "size_matched")});
+    }
+
+    // An unknown placement can only be rejected once every page is in. The
+    // next page goes ahead of any new placements, which must not be listed
+    // before they are acked.
+    std::string cursor = body.is_object() ? body.value("next_cursor", std::string()) : std::string();
+    if (!cursor.empty() && cursor != LAST_PAGE_CURSOR) {
+        pipeline_.insert(pipeline_.begin(),
+                         PendingRequest{RequestType::OPEN_ORDERS, {}, {},
+                                        makeRequest(http::verb::get, "/data/orders?next_cursor=" + urlEncode(cursor), "")});
+        return;
+    }
+
+    // A placement that went unanswered while the pages were coming in may
+    // be missing from the earlier ones; the query that follows covers it
+    if (!reconcile_needed_) {
+        reconcileUnknown();
+    }
+    open_orders_.clear();
+}
+
+void OrderGateway::reconcileUnknown() {
+    // Resting orders we already know can't be an unknown placement
+    std::unordered_set<std::string> known_ids;
+    std::vector<OrderId> unknown_ids;
+    for (const auto& [order_id, order] : in_flight_) {
+        if (order.state == InFlightState::UNKNOWN) {
+            unknown_ids.push_back(order_id);
+        } else if (!order.exchange_order_id.empty()) {
+            known_ids.insert(order.exchange_order_id);
+        }
+    }
+
+    std::sort(unknown_ids.begin(), unknown_ids.end());
+
+    std::vector<OrderId> cancel_ids;
+    for (OrderId order_id : unknown_ids) {
+        InFlightOrder& order = in_flight_[order_id];
+        const GatewayCommand& place = order.place;
+        auto match = std::find_if(open_orders_.begin(), open_orders_.end(), [&](const RestingOrder& resting) {
+            return !resting.id.empty() && known_ids.count(resting.id) == 0 &&
+                   resting.token_id == place.token_id &&
+                   resting.side == (place.side == Side::BUY ? "BUY" : "SELL") &&
+                   std::abs(resting.price - place.price) < 1e-9 &&
+                   std::abs(resting.original_size - place.size) < 1e-9;
+        });
+        unknown_count_.fetch_sub(1, std::memory_order_relaxed);
+
+        // An order that matched in full on entry isn't listed either; its
+        // fill is not recovered here
+        if (match == open_orders_.end()) {
+            LOG_WARN("OrderGateway ORD_{} is not among the open orders, placement failed", order_id);
+            rejectPlace(order_id, "Placement unconfirmed: not among open orders");
+            continue;
+        }
+
+        order.state = InFlightState::ACKED;
+        order.exchange_order_id = match->id;
+        known_ids.insert(order.exchange_order_id);
+        LOG_INFO("OrderGateway ORD_{} found resting as {}", order_id, order.exchange_order_id);
+        event_queue_.push(Event::orderAcked(order_id, order.exchange_order_id));
+
+        if (match->size_matched > 0.0) {
+            event_queue_.push(Event::orderFill(order_id, place.token_id, place.price, match->size_matched, place.side));
+        }
+        if (order.cancel_requested) {
+            order.cancel_requested = false;
+            queueCancel(order_id, cancel_ids);
+        }
+    }
+
+    if (!cancel_ids.empty()) {
+        pipeline_.push_back(makeCancelRequest(std::move(cancel_ids)));
+    }
+}
+
+void OrderGateway::failRequest(const PendingRequest& pending, const std::string& reason) {
+    for (OrderId order_id : pending.order_ids) {
+        auto it = in_flight_.find(order_id);
+        if (it == in_flight_.end()) {
+            continue;
+        }
+
+        if (pending.type == RequestType::PLACE) {
+            rejectPlace(order_id, reason);
+        } else {
+            it->second.state = InFlightState::ACKED;
+            event_queue_.push(Event::orderRejected(order_id, RejectedRequest::CANCEL, "Cancel failed: " + reason));
+        }
+    }
+}
+
+void OrderGateway::markUnknown(const PendingRequest& pending) {
+    for (const GatewayCommand& place : pending.places) {
+        auto it = in_flight_.find(place.order_id);
+        if (it == in_flight_.end()) {
+            continue;
+        }
+        LOG_WARN("OrderGateway ORD_{} placement unanswered, checking the open orders", place.order_id);
+        it->second.state = InFlightState::UNKNOWN;
+        it->second.place = place;
+        unknown_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    reconcile_needed_ = true;
+}
+
+void OrderGateway::rejectPlace(OrderId order_id, const std::string& reason) {
+    auto it = in_flight_.find(order_id);
+    if (it == in_flight_.end()) {
+        return;
+    }
+
+    // A cancel was already requested, so from the strategy's side the order is simply gone
+    if (it->second.cancel_requested) {
+        event_queue_.push(Event::orderCancelled(order_id));
+    } else {
+        event_queue_.push(Event::orderRejected(order_id, RejectedRequest::PLACE, reason));
+    }
+    in_flight_.erase(it);
+}
+
+} // namespace pmm
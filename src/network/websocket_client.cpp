@@ -42,6 +42,13 @@ void PolymarketWebSocketClient::parseUrl(const std::string& url) {
         host_ = url.substr(protocol_len, path_start - protocol_len);
         path_ = url.substr(path_start);
     }
+    
+    // Explicit port, e.g. a local mock exchange
+    size_t port_sep = host_.find(':');
+    if (port_sep != std::string::npos) {
+        port_ = host_.substr(port_sep + 1);
+        host_ = host_.substr(0, port_sep);
+    }
 }
 
 void PolymarketWebSocketClient::connect() {
@@ -299,6 +306,8 @@ void PolymarketWebSocketClient::parseMessage(const nlohmann::json& json_msg) {
         parseBookMessage(json_msg);
     } else if (event_type == "price_change") {
         parsePriceChangeMessage(json_msg);
+    } else if (event_type == "last_trade_price") {
+        parseTradeMessage(json_msg);
     } else {
         LOG_DEBUG("Received {} message", event_type);
     }
@@ -382,6 +391,23 @@ void PolymarketWebSocketClient::parsePriceChangeMessage(const nlohmann::json& ms
     }   
 }
 
+void PolymarketWebSocketClient::parseTradeMessage(const nlohmann::json& msg) {
+    std::string asset_id = msg["asset_id"];
+    Price price = std::stod(msg["price"].get<std::string>());
+    Size size = std::stod(msg["size"].get<std::string>());
+    Side side = (msg["side"] == "BUY") ? Side::BUY : Side::SELL;
+    
+    // Milliseconds since the epoch, sent as a string
+    int64_t exchange_time_ms = 0;
+    auto ts = msg.find("timestamp");
+    if (ts != msg.end()) {
+        exchange_time_ms = ts->is_string() ? std::stoll(ts->get<std::string>()) : ts->get<int64_t>();
+    }
+    
+    LOG_DEBUG("[WS RECV] Trade {} x {} ({}) for {}...", price, size, side == Side::BUY ? "BUY" : "SELL", asset_id.substr(0, 8));
+    event_queue_.push(Event::trade(std::move(asset_id), price, size, side, exchange_time_ms));
+}
+
 void PolymarketWebSocketClient::setReconnectConfig(int max_attempts, std::chrono::seconds backoff) {
     max_reconnect_attempts_ = max_attempts;
     reconnect_backoff_ = backoff;
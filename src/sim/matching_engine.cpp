@@ -0,0 +1,243 @@
+#include "sim/matching_engine.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pmm {
+
+namespace {
+constexpr Size SIZE_EPSILON = 1e-9;
+
+Side opposite(Side side) {
+    return side == Side::BUY ? Side::SELL : Side::BUY;
+}
+} // namespace
+
+MatchingEngine::Ticks MatchingEngine::toTicks(Price price) {
+    return static_cast<Ticks>(std::llround(price * TICKS_PER_UNIT));
+}
+
+Price MatchingEngine::toPrice(Ticks ticks) {
+    return static_cast<Price>(ticks) / TICKS_PER_UNIT;
+}
+
+PlaceResult MatchingEngine::place(const TokenId& token_id, Side side, Price price, Size size) {
+    PlaceResult result;
+    if (!(price > 0.0 && price < 1.0)) {
+        result.error = "invalid price";
+        return result;
+    }
+    if (!(size > 0.0)) {
+        result.error = "invalid size";
+        return result;
+    }
+
+    result.accepted = true;
+    result.order_id = "MOCK-" + std::to_string(next_order_id_++);
+
+    Book& book = books_[token_id];
+    Ticks limit = toTicks(price);
+    result.filled = (side == Side::BUY)
+        ? match(book.asks, token_id, side, limit, size, result.order_id)
+        : match(book.bids, token_id, side, limit, size, result.order_id);
+
+    result.resting = size - result.filled;
+    if (result.resting > SIZE_EPSILON) {
+        PriceLevel& level = (side == Side::BUY) ? book.bids[limit] : book.asks[limit];
+        level.orders.push_back(RestingOrder{result.order_id, result.resting});
+        level.resting += result.resting;
+        orders_.emplace(result.order_id, OrderLocation{token_id, side, limit});
+        recordChange(token_id, side, limit, level.total());
+    } else {
+        result.resting = 0.0;
+    }
+    return result;
+}
+
+bool MatchingEngine::cancel(const std::string& order_id) {
+    auto it = orders_.find(order_id);
+    if (it == orders_.end()) {
+        return false;
+    }
+    OrderLocation location = it->second;
+    orders_.erase(it);
+
+    Book& book = books_[location.token_id];
+    auto removeFrom = [&](auto& levels) {
+        auto level_it = levels.find(location.price);
+        if (level_it == levels.end()) {
+            return;
+        }
+        PriceLevel& level = level_it->second;
+        auto order_it = std::find_if(level.orders.begin(), level.orders.end(),
+                                     [&](const RestingOrder& order) { return order.order_id == order_id; });
+        if (order_it != level.orders.end()) {
+            level.resting -= order_it->remaining;
+            level.orders.erase(order_it);
+        }
+        if (level.orders.empty()) {
+            level.resting = 0.0;  // Drop accumulated rounding
+        }
+        recordChange(location.token_id, location.side, location.price, level.total());
+        if (level.empty()) {
+            levels.erase(level_it);
+        }
+    };
+
+    if (location.side == Side::BUY) {
+        removeFrom(book.bids);
+    } else {
+        removeFrom(book.asks);
+    }
+    return true;
+}
+
+void MatchingEngine::setBook(const TokenId& token_id, const std::vector<Level>& bids, const std::vector<Level>& asks) {
+    Book& book = books_[token_id];
+
+    auto replace = [&](auto& levels, Side side, const std::vector<Level>& target) {
+        // Drop background size everywhere, keeping submitted orders in place
+        for (auto it = levels.begin(); it != levels.end();) {
+            if (it->second.background > 0.0) {
+                it->second.background = 0.0;
+                recordChange(token_id, side, it->first, it->second.total());
+            }
+            it = it->second.empty() ? levels.erase(it) : std::next(it);
+        }
+        for (const auto& [price, size] : target) {
+            if (size <= 0.0) {
+                continue;
+            }
+            PriceLevel& level = levels[toTicks(price)];
+            level.background = size;
+            recordChange(token_id, side, toTicks(price), level.total());
+        }
+    };
+
+    replace(book.bids, Side::BUY, bids);
+    replace(book.asks, Side::SELL, asks);
+}
+
+void MatchingEngine::setLevel(const TokenId& token_id, Side side, Price price, Size size) {
+    Book& book = books_[token_id];
+    Ticks ticks = toTicks(price);
+
+    auto update = [&](auto& levels) {
+        PriceLevel& level = levels[ticks];
+        level.background = std::max(size, 0.0);
+        recordChange(token_id, side, ticks, level.total());
+        if (level.empty()) {
+            levels.erase(ticks);
+        }
+    };
+
+    if (side == Side::BUY) {
+        update(book.bids);
+    } else {
+        update(book.asks);
+    }
+}
+
+Size MatchingEngine::marketOrder(const TokenId& token_id, Side side, Size size) {
+    Book& book = books_[token_id];
+    if (side == Side::BUY) {
+        return match(book.asks, token_id, side, std::numeric_limits<Ticks>::max(), size, std::string());
+    }
+    return match(book.bids, token_id, side, std::numeric_limits<Ticks>::min(), size, std::string());
+}
+
+template <typename Levels>
+Size MatchingEngine::match(Levels& levels, const TokenId& token_id, Side taker_side, Ticks limit,
+                           Size size, const std::string& taker_order_id) {
+    Side maker_side = opposite(taker_side);
+    Size traded = 0.0;
+
+    while (size - traded > SIZE_EPSILON && !levels.empty()) {
+        auto level_it = levels.begin();
+        bool crosses = (taker_side == Side::BUY) ? level_it->first <= limit : level_it->first >= limit;
+        if (!crosses) {
+            break;
+        }
+
+        PriceLevel& level = level_it->second;
+        Price price = toPrice(level_it->first);
+
+        // Displayed background liquidity is ahead of submitted orders
+        if (level.background > 0.0) {
+            Size qty = std::min(level.background, size - traded);
+            level.background -= qty;
+            traded += qty;
+            fills_.push_back(MatchFill{std::string(), taker_order_id, token_id, taker_side, price, qty});
+        }
+
+        while (size - traded > SIZE_EPSILON && !level.orders.empty()) {
+            RestingOrder& maker = level.orders.front();
+            Size qty = std::min(maker.remaining, size - traded);
+            maker.remaining -= qty;
+            level.resting -= qty;
+            traded += qty;
+            fills_.push_back(MatchFill{maker.order_id, taker_order_id, token_id, taker_side, price, qty});
+            if (maker.remaining <= SIZE_EPSILON) {
+                orders_.erase(maker.order_id);
+                level.orders.pop_front();
+                if (level.orders.empty()) {
+                    level.resting = 0.0;
+                }
+            }
+        }
+
+        recordChange(token_id, maker_side, level_it->first, level.total());
+        if (level.empty()) {
+            levels.erase(level_it);
+        }
+    }
+    return traded;
+}
+
+std::vector<MatchingEngine::Level> MatchingEngine::bids(const TokenId& token_id) const {
+    std::vector<Level> levels;
+    auto it = books_.find(token_id);
+    if (it != books_.end()) {
+        for (const auto& [ticks, level] : it->second.bids) {
+            levels.emplace_back(toPrice(ticks), level.total());
+        }
+    }
+    return levels;
+}
+
+std::vector<MatchingEngine::Level> MatchingEngine::asks(const TokenId& token_id) const {
+    std::vector<Level> levels;
+    auto it = books_.find(token_id);
+    if (it != books_.end()) {
+        for (const auto& [ticks, level] : it->second.asks) {
+            levels.emplace_back(toPrice(ticks), level.total());
+        }
+    }
+    return levels;
+}
+
+Size MatchingEngine::levelSize(const TokenId& token_id, Side side, Price price) const {
+    auto it = books_.find(token_id);
+    if (it == books_.end()) {
+        return 0.0;
+    }
+    Ticks ticks = toTicks(price);
+    if (side == Side::BUY) {
+        auto level = it->second.bids.find(ticks);
+        return level != it->second.bids.end() ? level->second.total() : 0.0;
+    }
+    auto level = it->second.asks.find(ticks);
+    return level != it->second.asks.end() ? level->second.total() : 0.0;
+}
+
+std::vector<LevelChange> MatchingEngine::takeChanges() {
+    std::vector<LevelChange> changes;
+    changes.swap(changes_);
+    return changes;
+}
+
+void MatchingEngine::recordChange(const TokenId& token_id, Side side, Ticks price, Size size) {
+    changes_.push_back(LevelChange{token_id, side, toPrice(price), std::max(size, 0.0)});
+}
+
+} // namespace pmm
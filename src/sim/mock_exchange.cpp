@@ -0,0 +1,559 @@
+#include "sim/mock_exchange.hpp"
+#include "utils/logger.hpp"
+#include <boost/asio/steady_timer.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <nlohmann/json.hpp>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+namespace pmm {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+using tcp = boost::asio::ip::tcp;
+using json = nlohmann::json;
+
+namespace {
+
+// Throwaway certificate so the wss:// listener needs no files on disk
+void useSelfSignedCertificate(ssl::context& ctx) {
+    EVP_PKEY* key = EVP_EC_gen("P-256");
+    X509* cert = X509_new();
+    if (!key || !cert) {
+        EVP_PKEY_free(key);
+        X509_free(cert);
+        throw std::runtime_error("Failed to create mock exchange certificate");
+    }
+
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                               reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    X509_sign(cert, key, EVP_sha256());
+
+    int ok = SSL_CTX_use_certificate(ctx.native_handle(), cert) == 1 &&
+             SSL_CTX_use_PrivateKey(ctx.native_handle(), key) == 1;
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    if (!ok) {
+        throw std::runtime_error("Failed to install mock exchange certificate");
+    }
+}
+
+// Same textual form the real feed uses ("0.45", "100")
+std::string formatNumber(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+    return buffer;
+}
+
+json levelsJson(const std::vector<std::pair<Price, Size>>& levels) {
+    json out = json::array();
+    for (const auto& [price, size] : levels) {
+        out.push_back({{"price", formatNumber(price)}, {"size", formatNumber(size)}});
+    }
+    return out;
+}
+
+std::string timestampMs() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+}
+
+} // namespace
+
+// Market channel subscriber. Messages queue with a due time so configured
+// feed latency delays delivery without reordering it.
+class MockExchange::WsSession : public std::enable_shared_from_this<MockExchange::WsSession> {
+public:
+    WsSession(MockExchange& exchange, tcp::socket socket)
+        : exchange_(exchange),
+          ws_(std::move(socket), exchange.ssl_ctx_),
+          timer_(exchange.ioc_) {}
+
+    void start() {
+        auto self = shared_from_this();
+        ws_.next_layer().async_handshake(ssl::stream_base::server, [self](beast::error_code ec) {
+            if (ec) return;
+            self->ws_.async_accept([self](beast::error_code ec) {
+                if (ec) return;
+                self->exchange_.sessions_.push_back(self);
+                self->exchange_.subscriber_count_++;
+                self->open_ = true;
+                self->doRead();
+            });
+        });
+    }
+
+    bool isSubscribed(const TokenId& token_id) const {
+        return assets_.count(token_id) > 0;
+    }
+
+    void send(std::string message, std::chrono::steady_clock::time_point due) {
+        if (!open_) return;
+        outbox_.push_back(Outgoing{due, std::move(message)});
+        if (outbox_.size() == 1) {
+            doWrite();
+        }
+    }
+
+private:
+    struct Outgoing {
+        std::chrono::steady_clock::time_point due;
+        std::string message;
+    };
+
+    MockExchange& exchange_;
+    websocket::stream<beast::ssl_stream<beast::tcp_stream>> ws_;
+    net::steady_timer timer_;
+    beast::flat_buffer buffer_;
+    std::deque<Outgoing> outbox_;
+    std::set<TokenId> assets_;
+    bool open_ = false;
+
+    void doRead() {
+        auto self = shared_from_this();
+        ws_.async_read(buffer_, [self](beast::error_code ec, size_t) {
+            if (ec) {
+                self->close();
+                return;
+            }
+            std::string message = beast::buffers_to_string(self->buffer_.data());
+            self->buffer_.consume(self->buffer_.size());
+            self->handleSubscription(message);
+            self->doRead();
+        });
+    }
+
+    void handleSubscription(const std::string& message) {
+        json request = json::parse(message, nullptr, false);
+        if (!request.is_object() || !request.contains("assets_ids")) {
+            return;
+        }
+        for (const auto& asset : request["assets_ids"]) {
+            TokenId token_id = asset.get<std::string>();
+            if (assets_.insert(token_id).second) {
+                exchange_.sendSnapshot(*this, token_id);
+            }
+        }
+    }
+
+    void doWrite() {
+        auto self = shared_from_this();
+        if (outbox_.front().due > std::chrono::steady_clock::now()) {
+            timer_.expires_at(outbox_.front().due);
+            timer_.async_wait([self](beast::error_code ec) {
+                if (ec || !self->open_) return;
+                self->writeFront();
+            });
+            return;
+        }
+        writeFront();
+    }
+
+    void writeFront() {
+        auto self = shared_from_this();
+        ws_.text(true);
+        ws_.async_write(net::buffer(outbox_.front().message), [self](beast::error_code ec, size_t) {
+            if (ec) {
+                self->close();
+                return;
+            }
+            self->outbox_.pop_front();
+            if (!self->outbox_.empty()) {
+                self->doWrite();
+            }
+        });
+    }
+
+    void close() {
+        if (!open_) return;
+        open_ = false;
+        outbox_.clear();
+        timer_.cancel();
+        exchange_.subscriber_count_--;
+    }
+};
+
+// One order-entry connection. Requests are answered strictly in order, so
+// pipelined requests from the gateway get their responses in sequence.
+class MockExchange::HttpSession : public std::enable_shared_from_this<MockExchange::HttpSession> {
+public:
+    HttpSession(MockExchange& exchange, tcp::socket socket)
+        : exchange_(exchange),
+          stream_(std::move(socket)),
+          timer_(exchange.ioc_) {}
+
+    void start() { doRead(); }
+
+private:
+    MockExchange& exchange_;
+    beast::tcp_stream stream_;
+    net::steady_timer timer_;
+    beast::flat_buffer buffer_;
+    http::request<http::string_body> request_;
+    http::response<http::string_body> response_;
+
+    void doRead() {
+        request_ = {};
+        auto self = shared_from_this();
+        http::async_read(stream_, buffer_, request_, [self](beast::error_code ec, size_t) {
+            if (ec) {
+                beast::error_code ignored;
+                self->stream_.socket().shutdown(tcp::socket::shutdown_both, ignored);
+                return;
+            }
+            self->handleRequest();
+        });
+    }
+
+    void handleRequest() {
+        unsigned status = 200;
+        std::string body = exchange_.handleOrderRequest(static_cast<int>(request_.method()),
+                                                        std::string(request_.target()), request_.body(), status);
+
+        response_ = http::response<http::string_body>{static_cast<http::status>(status), request_.version()};
+        response_.set(http::field::server, "pmm-mock-exchange");
+        response_.set(http::field::content_type, "application/json");
+        response_.keep_alive(request_.keep_alive());
+        response_.body() = std::move(body);
+        response_.prepare_payload();
+
+        auto self = shared_from_this();
+        auto delay = exchange_.orderDelay();
+        if (delay.count() > 0) {
+            timer_.expires_after(delay);
+            timer_.async_wait([self](beast::error_code) { self->doWrite(); });
+        } else {
+            doWrite();
+        }
+    }
+
+    void doWrite() {
+        auto self = shared_from_this();
+        http::async_write(stream_, response_, [self](beast::error_code ec, size_t) {
+            if (ec) return;
+            if (!self->response_.keep_alive()) {
+                beast::error_code ignored;
+                self->stream_.socket().shutdown(tcp::socket::shutdown_send, ignored);
+                return;
+            }
+            self->doRead();
+        });
+    }
+};
+
+MockExchange::MockExchange(MockExchangeConfig config)
+    : config_(std::move(config)),
+      ssl_ctx_(ssl::context::tlsv12_server),
+      ws_acceptor_(ioc_, tcp::endpoint(net::ip::make_address(config_.address), config_.ws_port)),
+      http_acceptor_(ioc_, tcp::endpoint(net::ip::make_address(config_.address), config_.http_port)),
+      rng_(config_.seed) {
+    useSelfSignedCertificate(ssl_ctx_);
+    ws_port_ = ws_acceptor_.local_endpoint().port();
+    http_port_ = http_acceptor_.local_endpoint().port();
+    LOG_INFO("MockExchange listening: market data {}, order entry http://{}:{}", wsUrl(), config_.address, http_port_);
+}
+
+MockExchange::~MockExchange() {
+    stop();
+}
+
+void MockExchange::start() {
+    if (running_.load()) {
+        return;
+    }
+    acceptWs();
+    acceptHttp();
+    running_ = true;
+    io_thread_ = std::thread([this]() { ioc_.run(); });
+}
+
+void MockExchange::stop() {
+    if (!running_.load()) {
+        return;
+    }
+    ioc_.stop();
+    if (io_thread_.joinable()) {
+        io_thread_.join();
+    }
+    running_ = false;
+}
+
+std::string MockExchange::wsUrl() const {
+    return "wss://" + config_.address + ":" + std::to_string(ws_port_) + "/ws/market";
+}
+
+GatewayConfig MockExchange::gatewayConfig() const {
+    GatewayConfig config;
+    config.host = config_.address;
+    config.port = std::to_string(http_port_);
+    config.use_tls = false;
+    return config;
+}
+
+void MockExchange::acceptWs() {
+    ws_acceptor_.async_accept([this](beast::error_code ec, tcp::socket socket) {
+        if (ec) return;
+        socket.set_option(tcp::no_delay(true));
+        std::make_shared<WsSession>(*this, std::move(socket))->start();
+        acceptWs();
+    });
+}
+
+void MockExchange::acceptHttp() {
+    http_acceptor_.async_accept([this](beast::error_code ec, tcp::socket socket) {
+        if (ec) return;
+        socket.set_option(tcp::no_delay(true));
+        std::make_shared<HttpSession>(*this, std::move(socket))->start();
+        acceptHttp();
+    });
+}
+
+std::chrono::steady_clock::time_point MockExchange::setBook(const TokenId& token_id,
+                                                           const std::vector<std::pair<Price, Size>>& bids,
+                                                           const std::vector<std::pair<Price, Size>>& asks) {
+    return onExchange([&]() {
+        engine_.setBook(token_id, bids, asks);
+        engine_.takeChanges();  // Subscribers get a full snapshot instead
+
+        auto now = std::chrono::steady_clock::now();
+        publish(token_id, bookMessage(token_id));
+        return now;
+    });
+}
+
+std::chrono::steady_clock::time_point MockExchange::setLevel(const TokenId& token_id, Side side, Price price, Size size) {
+    return onExchange([&]() {
+        engine_.setLevel(token_id, side, price, size);
+        auto now = std::chrono::steady_clock::now();
+        publishChanges();
+        return now;
+    });
+}
+
+std::chrono::steady_clock::time_point MockExchange::marketOrder(const TokenId& token_id, Side side, Size size) {
+    return onExchange([&]() {
+        size_t first_fill = engine_.fills().size();
+        engine_.marketOrder(token_id, side, size);
+        auto now = std::chrono::steady_clock::now();
+        publishChanges();
+
+        const auto& fills = engine_.fills();
+        for (size_t i = first_fill; i < fills.size(); i++) {
+            json trade = {
+                {"event_type", "last_trade_price"},
+                {"asset_id", token_id},
+                {"market", ""},
+                {"price", formatNumber(fills[i].price)},
+                {"size", formatNumber(fills[i].size)},
+                {"side", side == Side::BUY ? "BUY" : "SELL"},
+                {"timestamp", timestampMs()}
+            };
+            publish(token_id, trade.dump());
+        }
+        return now;
+    });
+}
+
+void MockExchange::play(const Scenario& scenario) {
+    auto start = std::chrono::steady_clock::now();
+    for (const ScenarioStep& step : scenario.steps()) {
+        std::this_thread::sleep_until(start + step.at);
+        switch (step.action) {
+            case ScenarioAction::SET_BOOK:
+                setBook(step.token_id, step.bids, step.asks);
+                break;
+            case ScenarioAction::SET_LEVEL:
+                setLevel(step.token_id, step.side, step.price, step.size);
+                break;
+            case ScenarioAction::MARKET_ORDER:
+                marketOrder(step.token_id, step.side, step.size);
+                break;
+        }
+    }
+}
+
+std::vector<MatchFill> MockExchange::fills() {
+    return onExchange([this]() { return engine_.fills(); });
+}
+
+size_t MockExchange::restingOrderCount() {
+    return onExchange([this]() { return engine_.restingOrderCount(); });
+}
+
+std::vector<std::pair<Price, Size>> MockExchange::bids(const TokenId& token_id) {
+    return onExchange([&]() { return engine_.bids(token_id); });
+}
+
+std::vector<std::pair<Price, Size>> MockExchange::asks(const TokenId& token_id) {
+    return onExchange([&]() { return engine_.asks(token_id); });
+}
+
+std::string MockExchange::handleOrderRequest(int method, const std::string& target, const std::string& body,
+                                             unsigned& status) {
+    auto verb = static_cast<http::verb>(method);
+    if (target != "/orders" || (verb != http::verb::post && verb != http::verb::delete_)) {
+        status = 404;
+        return json{{"error", "not found"}}.dump();
+    }
+
+    auto arrival = std::chrono::steady_clock::now().time_since_epoch().count();
+    last_order_arrival_.store(arrival);
+
+    json parsed = json::parse(body, nullptr, false);
+    if (parsed.is_discarded()) {
+        status = 400;
+        return json{{"error", "invalid json"}}.dump();
+    }
+
+    std::string response = (verb == http::verb::post) ? placeOrders(parsed) : cancelOrders(parsed);
+    publishChanges();
+    return response;
+}
+
+std::string MockExchange::placeOrders(const json& request) {
+    json orders = request;
+    if (!orders.is_array()) {
+        orders = json::array({orders});
+    }
+
+    json results = json::array();
+    for (const auto& entry : orders) {
+        orders_received_++;
+        const json& order = entry.contains("order") ? entry["order"] : entry;
+
+        TokenId token_id = order.value("tokenID", std::string());
+        Side side = order.value("side", std::string("BUY")) == "BUY" ? Side::BUY : Side::SELL;
+        PlaceResult result = engine_.place(token_id, side, order.value("price", 0.0), order.value("size", 0.0));
+
+        if (!result.accepted) {
+            results.push_back({{"success", false}, {"errorMsg", result.error}, {"orderID", ""}, {"status", ""}});
+            continue;
+        }
+        results.push_back({
+            {"success", true},
+            {"errorMsg", ""},
+            {"orderID", result.order_id},
+            {"status", result.resting > 0.0 ? "live" : "matched"}
+        });
+    }
+    return results.dump();
+}
+
+std::string MockExchange::cancelOrders(const json& request) {
+    json canceled = json::array();
+    json not_canceled = json::object();
+
+    for (const auto& id : request.value("orderIDs", json::array())) {
+        cancels_received_++;
+        std::string order_id = id.get<std::string>();
+        if (engine_.cancel(order_id)) {
+            canceled.push_back(order_id);
+        } else {
+            not_canceled[order_id] = "order not found or already closed";
+        }
+    }
+    return json{{"canceled", canceled}, {"not_canceled", not_canceled}}.dump();
+}
+
+void MockExchange::publishChanges() {
+    std::vector<LevelChange> changes = engine_.takeChanges();
+    if (changes.empty()) {
+        return;
+    }
+
+    // One price_change per token, in the order the levels changed
+    std::map<TokenId, json> by_token;
+    for (const LevelChange& change : changes) {
+        json& list = by_token[change.token_id];
+        if (list.is_null()) {
+            list = json::array();
+        }
+        list.push_back({
+            {"asset_id", change.token_id},
+            {"price", formatNumber(change.price)},
+            {"size", formatNumber(change.size)},
+            {"side", change.side == Side::BUY ? "BUY" : "SELL"}
+        });
+    }
+
+    for (auto& [token_id, list] : by_token) {
+        json message = {
+            {"event_type", "price_change"},
+            {"market", ""},
+            {"price_changes", std::move(list)},
+            {"timestamp", timestampMs()}
+        };
+        publish(token_id, message.dump());
+    }
+}
+
+void MockExchange::publish(const TokenId& token_id, std::string message) {
+    auto due = std::chrono::steady_clock::now() + feedDelay();
+
+    size_t live = 0;
+    for (auto& weak : sessions_) {
+        if (auto session = weak.lock()) {
+            sessions_[live++] = weak;
+            if (session->isSubscribed(token_id)) {
+                session->send(message, due);
+            }
+        }
+    }
+    sessions_.resize(live);
+}
+
+void MockExchange::sendSnapshot(WsSession& session, const TokenId& token_id) {
+    if (engine_.bids(token_id).empty() && engine_.asks(token_id).empty()) {
+        return;
+    }
+    session.send(bookMessage(token_id), std::chrono::steady_clock::now() + feedDelay());
+}
+
+std::string MockExchange::bookMessage(const TokenId& token_id) const {
+    json message = {
+        {"event_type", "book"},
+        {"asset_id", token_id},
+        {"market", ""},
+        {"bids", levelsJson(engine_.bids(token_id))},
+        {"asks", levelsJson(engine_.asks(token_id))},
+        {"timestamp", timestampMs()},
+        {"hash", ""}
+    };
+    return message.dump();
+}
+
+std::chrono::microseconds MockExchange::orderDelay() {
+    if (config_.order_jitter.count() <= 0) {
+        return config_.order_latency;
+    }
+    std::uniform_int_distribution<int64_t> jitter(0, config_.order_jitter.count());
+    return config_.order_latency + std::chrono::microseconds(jitter(rng_));
+}
+
+std::chrono::microseconds MockExchange::feedDelay() {
+    if (config_.feed_jitter.count() <= 0) {
+        return config_.feed_latency;
+    }
+    std::uniform_int_distribution<int64_t> jitter(0, config_.feed_jitter.count());
+    return config_.feed_latency + std::chrono::microseconds(jitter(rng_));
+}
+
+} // namespace pmm
@@ -0,0 +1,162 @@
+#include "sim/paper_fill_simulator.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pmm {
+
+namespace {
+constexpr Size SIZE_EPSILON = 1e-9;
+constexpr Price PRICE_EPSILON = 1e-9;
+
+bool atTouch(Side side, Price price, const OrderBook& book) {
+    if (side == Side::BUY) {
+        Price best_bid = book.getBestBid();
+        return best_bid <= 0.0 || price >= best_bid - PRICE_EPSILON;
+    }
+    Price best_ask = book.getBestAsk();
+    return best_ask <= 0.0 || price <= best_ask + PRICE_EPSILON;
+}
+} // namespace
+
+PaperFillSimulator::Ticks PaperFillSimulator::toTicks(Price price) {
+    return static_cast<Ticks>(std::llround(price * TICKS_PER_UNIT));
+}
+
+std::pair<size_t, size_t> PaperFillSimulator::levelRange(Side side, Ticks ticks) const {
+    const std::vector<Entry>& list = (side == Side::BUY) ? bids_ : asks_;
+    auto better = [side](Ticks a, Ticks b) { return side == Side::BUY ? a > b : a < b; };
+
+    auto first = std::partition_point(list.begin(), list.end(),
+                                      [&](const Entry& e) { return better(e.ticks, ticks); });
+    auto last = std::partition_point(first, list.end(),
+                                     [&](const Entry& e) { return e.ticks == ticks; });
+    return {static_cast<size_t>(first - list.begin()), static_cast<size_t>(last - list.begin())};
+}
+
+void PaperFillSimulator::add(uint32_t ref, Side side, Price price, Size size, Size queue_ahead) {
+    Entry entry;
+    entry.ref = ref;
+    entry.ticks = toTicks(price);
+    entry.price = price;
+    entry.remaining = size;
+    entry.ahead = std::max(queue_ahead, 0.0);
+    entry.level_size = entry.ahead;
+
+    // Behind our own earlier orders at the same price
+    std::vector<Entry>& list = entries(side);
+    size_t pos = levelRange(side, entry.ticks).second;
+    list.insert(list.begin() + static_cast<std::ptrdiff_t>(pos), entry);
+}
+
+void PaperFillSimulator::remove(uint32_t ref, Side side, Price price) {
+    std::vector<Entry>& list = entries(side);
+    auto [first, last] = levelRange(side, toTicks(price));
+    for (size_t i = first; i < last; i++) {
+        if (list[i].ref == ref) {
+            list.erase(list.begin() + static_cast<std::ptrdiff_t>(i));
+            return;
+        }
+    }
+}
+
+void PaperFillSimulator::onLevelChange(Side side, Price price, Size new_size, const OrderBook& book,
+                                       std::vector<PaperFill>& fills) {
+    std::vector<Entry>& list = entries(side);
+    auto [first, last] = levelRange(side, toTicks(price));
+    if (first == last) {
+        return;
+    }
+
+    bool at_touch = atTouch(side, price, book);
+    for (size_t i = first; i < last; i++) {
+        applyLevelSize(list[i], new_size, at_touch, fills);
+    }
+}
+
+void PaperFillSimulator::onBook(const OrderBook& book, std::vector<PaperFill>& fills) {
+    for (Entry& entry : bids_) {
+        applyLevelSize(entry, book.getBidSize(entry.price), atTouch(Side::BUY, entry.price, book), fills);
+    }
+    for (Entry& entry : asks_) {
+        applyLevelSize(entry, book.getAskSize(entry.price), atTouch(Side::SELL, entry.price, book), fills);
+    }
+}
+
+void PaperFillSimulator::applyLevelSize(Entry& entry, Size new_size, bool at_touch, std::vector<PaperFill>& fills) {
+    Size old_size = entry.level_size;
+    entry.level_size = new_size;
+    if (new_size >= old_size) {
+        return;  // New size joins behind us
+    }
+
+    Size removed = old_size - new_size;
+    if (at_touch) {
+        // Trades take the front of the queue first
+        Size traded_ahead = std::min(entry.ahead, removed);
+        entry.ahead -= traded_ahead;
+        Size qty = std::min(entry.remaining, removed - traded_ahead);
+        if (qty > SIZE_EPSILON) {
+            entry.remaining -= qty;
+            fills.push_back(PaperFill{entry.ref, entry.price, qty});
+        }
+    } else if (old_size > 0.0) {
+        entry.ahead -= removed * entry.ahead / old_size;
+    }
+    entry.ahead = std::clamp(entry.ahead, 0.0, new_size);
+}
+
+void PaperFillSimulator::checkCrosses(const OrderBook& book, std::vector<PaperFill>& fills) {
+    auto sweep = [&](std::vector<Entry>& list, Side side, bool& was_crossed) {
+        Price opposite = (side == Side::BUY) ? book.getBestAsk() : book.getBestBid();
+        auto crossed = [&](const Entry& e) {
+            if (opposite <= 0.0) {
+                return false;
+            }
+            return side == Side::BUY ? e.price >= opposite - PRICE_EPSILON : e.price <= opposite + PRICE_EPSILON;
+        };
+
+        // Common case: nothing crossed now or on the last check
+        if (!was_crossed && (list.empty() || !crossed(list.front()))) {
+            return;
+        }
+
+        was_crossed = false;
+        Size taken = 0.0;  // By our better-priced orders this pass
+        for (Entry& entry : list) {
+            if (!crossed(entry)) {
+                entry.cross_depth = 0.0;
+                continue;
+            }
+            was_crossed = true;
+
+            Size depth = (side == Side::BUY) ? book.getAskDepthThrough(entry.price)
+                                             : book.getBidDepthThrough(entry.price);
+            Size fresh = depth - entry.cross_depth - taken;
+            entry.cross_depth = depth;
+            entry.ahead = 0.0;
+
+            Size qty = std::min(entry.remaining, fresh);
+            if (qty > SIZE_EPSILON) {
+                entry.remaining -= qty;
+                taken += qty;
+                fills.push_back(PaperFill{entry.ref, entry.price, qty});
+            }
+        }
+    };
+
+    sweep(bids_, Side::BUY, bids_crossed_);
+    sweep(asks_, Side::SELL, asks_crossed_);
+}
+
+Size PaperFillSimulator::queueAhead(uint32_t ref) const {
+    for (const std::vector<Entry>* list : {&bids_, &asks_}) {
+        for (const Entry& entry : *list) {
+            if (entry.ref == ref) {
+                return entry.ahead;
+            }
+        }
+    }
+    return -1.0;
+}
+
+} // namespace pmm
@@ -0,0 +1,115 @@
+#include "sim/scenario.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace pmm {
+
+namespace {
+constexpr Price TICK = 0.01;
+
+Side parseSide(const std::string& side) {
+    return side == "BUY" ? Side::BUY : Side::SELL;
+}
+
+std::vector<std::pair<Price, Size>> parseLevels(const nlohmann::json& levels) {
+    std::vector<std::pair<Price, Size>> parsed;
+    for (const auto& level : levels) {
+        parsed.emplace_back(level.at(0).get<Price>(), level.at(1).get<Size>());
+    }
+    return parsed;
+}
+} // namespace
+
+Scenario& Scenario::book(std::chrono::microseconds at, const TokenId& token_id,
+                         std::vector<std::pair<Price, Size>> bids,
+                         std::vector<std::pair<Price, Size>> asks) {
+    ScenarioStep step;
+    step.at = at;
+    step.action = ScenarioAction::SET_BOOK;
+    step.token_id = token_id;
+    step.bids = std::move(bids);
+    step.asks = std::move(asks);
+    steps_.push_back(std::move(step));
+    return *this;
+}
+
+Scenario& Scenario::level(std::chrono::microseconds at, const TokenId& token_id, Side side, Price price, Size size) {
+    ScenarioStep step;
+    step.at = at;
+    step.action = ScenarioAction::SET_LEVEL;
+    step.token_id = token_id;
+    step.side = side;
+    step.price = price;
+    step.size = size;
+    steps_.push_back(std::move(step));
+    return *this;
+}
+
+Scenario& Scenario::marketOrder(std::chrono::microseconds at, const TokenId& token_id, Side side, Size size) {
+    ScenarioStep step;
+    step.at = at;
+    step.action = ScenarioAction::MARKET_ORDER;
+    step.token_id = token_id;
+    step.side = side;
+    step.size = size;
+    steps_.push_back(std::move(step));
+    return *this;
+}
+
+Scenario Scenario::fromJson(const nlohmann::json& script) {
+    Scenario scenario;
+    for (const auto& entry : script) {
+        auto at = std::chrono::microseconds(static_cast<int64_t>(entry.value("at_ms", 0.0) * 1000.0));
+        std::string type = entry.at("type");
+        TokenId token = entry.at("token");
+
+        if (type == "book") {
+            scenario.book(at, token, parseLevels(entry.value("bids", nlohmann::json::array())),
+                          parseLevels(entry.value("asks", nlohmann::json::array())));
+        } else if (type == "level") {
+            scenario.level(at, token, parseSide(entry.at("side")), entry.at("price"), entry.at("size"));
+        } else if (type == "trade") {
+            scenario.marketOrder(at, token, parseSide(entry.at("side")), entry.at("size"));
+        } else {
+            throw std::runtime_error("Unknown scenario step type: " + type);
+        }
+    }
+
+    std::stable_sort(scenario.steps_.begin(), scenario.steps_.end(),
+                     [](const ScenarioStep& a, const ScenarioStep& b) { return a.at < b.at; });
+    return scenario;
+}
+
+Scenario Scenario::loadFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open scenario file: " + path);
+    }
+    return fromJson(nlohmann::json::parse(file));
+}
+
+Scenario Scenario::randomWalk(const TokenId& token_id, Price start_mid, Price spread, size_t steps,
+                              std::chrono::microseconds interval, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution up(0.5);
+
+    Scenario scenario;
+    Price mid = start_mid;
+    for (size_t i = 0; i < steps; i++) {
+        if (i > 0) {
+            mid += up(rng) ? TICK : -TICK;
+            mid = std::clamp(mid, spread / 2 + TICK, 1.0 - spread / 2 - TICK);
+        }
+        Price bid = std::round((mid - spread / 2) / TICK) * TICK;
+        Price ask = std::round((mid + spread / 2) / TICK) * TICK;
+        scenario.book(interval * static_cast<int64_t>(i), token_id,
+                      {{bid, 100.0}, {bid - TICK, 200.0}},
+                      {{ask, 100.0}, {ask + TICK, 200.0}});
+    }
+    return scenario;
+}
+
+} // namespace pmm
@@ -0,0 +1,211 @@
+#include "strategy/batch_quoter.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PMM_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace pmm {
+
+void QuoteBatch::clear() {
+    for (auto* column : {&best_bid, &best_ask, &mid, &imbalance, &inventory, &avg_cost, &inventory_dollars,
+                         &max_position, &spread_pct, &spread_multiplier, &risk_aversion, &volatility,
+                         &time_urgency, &bid, &ask, &quote_size}) {
+        column->clear();
+    }
+    ttl_seconds.clear();
+    quoted.clear();
+}
+
+size_t QuoteBatch::add(const QuoteInputs& in) {
+    best_bid.push_back(in.best_bid);
+    best_ask.push_back(in.best_ask);
+    mid.push_back(in.mid);
+    imbalance.push_back(in.imbalance);
+    inventory.push_back(in.inventory);
+    avg_cost.push_back(in.avg_cost);
+    inventory_dollars.push_back(in.inventory_dollars);
+    max_position.push_back(in.max_position);
+    spread_pct.push_back(in.spread_pct);
+    spread_multiplier.push_back(in.spread_multiplier);
+    risk_aversion.push_back(in.risk_aversion);
+    volatility.push_back(in.volatility);
+    time_urgency.push_back(in.time_urgency);
+    ttl_seconds.push_back(in.ttl_seconds);
+    bid.push_back(0.0);
+    ask.push_back(0.0);
+    quote_size.push_back(0.0);
+    quoted.push_back(0);
+    return mid.size() - 1;
+}
+
+QuoteInputs QuoteBatch::inputs(size_t i) const {
+    QuoteInputs in;
+    in.best_bid = best_bid[i];
+    in.best_ask = best_ask[i];
+    in.mid = mid[i];
+    in.imbalance = imbalance[i];
+    in.inventory = inventory[i];
+    in.avg_cost = avg_cost[i];
+    in.inventory_dollars = inventory_dollars[i];
+    in.max_position = max_position[i];
+    in.spread_pct = spread_pct[i];
+    in.spread_multiplier = spread_multiplier[i];
+    in.risk_aversion = risk_aversion[i];
+    in.volatility = volatility[i];
+    in.time_urgency = time_urgency[i];
+    in.ttl_seconds = ttl_seconds[i];
+    return in;
+}
+
+Quote QuoteBatch::quote(size_t i) const {
+    return Quote{bid[i], quote_size[i], ask[i], quote_size[i], ttl_seconds[i], {}};
+}
+
+namespace {
+
+void quoteScalar(QuoteBatch& batch, size_t begin) {
+    for (size_t i = begin; i < batch.size(); i++) {
+        Quote quote;
+        batch.quoted[i] = DefaultQuoting::quote(batch.inputs(i), quote);
+        batch.bid[i] = quote.bid_price;
+        batch.ask[i] = quote.ask_price;
+        batch.quote_size[i] = quote.bid_size;
+    }
+}
+
+#ifdef PMM_HAVE_AVX2_KERNEL
+
+// The std:: functions the scalar kernel calls, with the same operand order
+// so ties and signed zeros come out the same
+
+// std::max(a, b): a < b ? b : a
+__attribute__((target("avx2"))) inline __m256d maxOf(__m256d a, __m256d b) {
+    return _mm256_blendv_pd(a, b, _mm256_cmp_pd(a, b, _CMP_LT_OQ));
+}
+
+// std::min(a, b): b < a ? b : a
+__attribute__((target("avx2"))) inline __m256d minOf(__m256d a, __m256d b) {
+    return _mm256_blendv_pd(a, b, _mm256_cmp_pd(b, a, _CMP_LT_OQ));
+}
+
+__attribute__((target("avx2"))) inline __m256d absOf(__m256d x) {
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+}
+
+// std::round, halves away from zero; x - trunc(x) is exact
+__attribute__((target("avx2"))) inline __m256d roundAway(__m256d x) {
+    __m256d truncated = _mm256_round_pd(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    __m256d fraction = absOf(_mm256_sub_pd(x, truncated));
+    __m256d away = _mm256_or_pd(_mm256_set1_pd(1.0), _mm256_and_pd(x, _mm256_set1_pd(-0.0)));
+    __m256d round_up = _mm256_cmp_pd(fraction, _mm256_set1_pd(0.5), _CMP_GE_OQ);
+    return _mm256_add_pd(truncated, _mm256_and_pd(round_up, away));
+}
+
+__attribute__((target("avx2"))) inline __m256d roundToCent(__m256d price) {
+    __m256d hundred = _mm256_set1_pd(100.0);
+    return _mm256_div_pd(roundAway(_mm256_mul_pd(price, hundred)), hundred);
+}
+
+// DefaultQuoting::quote, four tokens at a time
+__attribute__((target("avx2"))) size_t quoteAvx2(QuoteBatch& batch) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d hundred = _mm256_set1_pd(100.0);
+    const __m256d lean_scale = _mm256_set1_pd(ImbalanceLean::MAX_ADJUSTMENT);
+    const __m256d base_min_profit = _mm256_set1_pd(CostFloor::BASE_MIN_PROFIT);
+    const __m256d exit_urgency = _mm256_set1_pd(CostFloor::EXIT_URGENCY);
+    const __m256d exit_min_profit = _mm256_set1_pd(CostFloor::EXIT_MIN_PROFIT);
+    const __m256d min_price = _mm256_set1_pd(DefaultQuoting::MIN_PRICE);
+    const __m256d max_price = _mm256_set1_pd(DefaultQuoting::MAX_PRICE);
+    const __m256d min_market_spread = _mm256_set1_pd(DefaultQuoting::MIN_MARKET_SPREAD);
+    const __m256d max_size = _mm256_set1_pd(CapacitySize::MAX_SIZE);
+    const __m256d min_size = _mm256_set1_pd(CapacitySize::MIN_SIZE);
+
+    const size_t n = batch.size() & ~size_t{3};
+    for (size_t i = 0; i < n; i += 4) {
+        __m256d best_bid = _mm256_loadu_pd(&batch.best_bid[i]);
+        __m256d best_ask = _mm256_loadu_pd(&batch.best_ask[i]);
+        __m256d fair = _mm256_loadu_pd(&batch.mid[i]);
+        __m256d inventory = _mm256_loadu_pd(&batch.inventory[i]);
+        __m256d avg_cost = _mm256_loadu_pd(&batch.avg_cost[i]);
+        __m256d max_position = _mm256_loadu_pd(&batch.max_position[i]);
+
+        // ProportionalSpread
+        __m256d spread_pct = _mm256_mul_pd(_mm256_loadu_pd(&batch.spread_pct[i]),
+                                           _mm256_loadu_pd(&batch.spread_multiplier[i]));
+        __m256d half_width = _mm256_div_pd(_mm256_mul_pd(fair, spread_pct), two);
+
+        // InventorySkew<ImbalanceLean>
+        __m256d q = _mm256_div_pd(inventory, hundred);
+        __m256d gamma = _mm256_loadu_pd(&batch.risk_aversion[i]);
+        __m256d sigma = _mm256_loadu_pd(&batch.volatility[i]);
+        __m256d sigma_sq = _mm256_mul_pd(sigma, sigma);
+        __m256d reservation_bid = _mm256_sub_pd(fair, _mm256_mul_pd(_mm256_mul_pd(_mm256_add_pd(q, one), gamma), sigma_sq));
+        __m256d reservation_ask = _mm256_add_pd(fair, _mm256_mul_pd(_mm256_mul_pd(_mm256_sub_pd(q, one), gamma), sigma_sq));
+        __m256d lean = _mm256_mul_pd(_mm256_loadu_pd(&batch.imbalance[i]), lean_scale);
+        __m256d bid = _mm256_add_pd(_mm256_sub_pd(reservation_bid, half_width), lean);
+        __m256d ask = _mm256_add_pd(_mm256_add_pd(reservation_ask, half_width), lean);
+
+        // CostFloor
+        __m256d inventory_risk = _mm256_div_pd(absOf(_mm256_loadu_pd(&batch.inventory_dollars[i])), max_position);
+        __m256d urgency = maxOf(_mm256_loadu_pd(&batch.time_urgency[i]), inventory_risk);
+        __m256d min_profit = _mm256_blendv_pd(_mm256_mul_pd(base_min_profit, _mm256_sub_pd(one, urgency)),
+                                              exit_min_profit, _mm256_cmp_pd(urgency, exit_urgency, _CMP_GT_OQ));
+        __m256d long_position = _mm256_and_pd(_mm256_cmp_pd(inventory, zero, _CMP_GT_OQ),
+                                              _mm256_cmp_pd(avg_cost, zero, _CMP_GT_OQ));
+        __m256d min_ask = _mm256_and_pd(long_position, _mm256_mul_pd(avg_cost, _mm256_add_pd(one, min_profit)));
+
+        bid = roundToCent(bid);
+        ask = maxOf(roundToCent(ask), min_ask);
+        bid = maxOf(min_price, minOf(max_price, bid));
+        ask = maxOf(min_price, minOf(max_price, ask));
+
+        // CapacitySize
+        __m256d remaining = _mm256_sub_pd(max_position, absOf(inventory));
+        __m256d size = minOf(max_size, _mm256_div_pd(remaining, fair));
+
+        __m256d ok = _mm256_cmp_pd(_mm256_sub_pd(best_ask, best_bid), min_market_spread, _CMP_GE_OQ);
+        ok = _mm256_and_pd(ok, _mm256_cmp_pd(ask, bid, _CMP_GT_OQ));
+        ok = _mm256_and_pd(ok, _mm256_cmp_pd(bid, best_ask, _CMP_LT_OQ));
+        ok = _mm256_and_pd(ok, _mm256_cmp_pd(ask, best_bid, _CMP_GT_OQ));
+        ok = _mm256_and_pd(ok, _mm256_cmp_pd(size, min_size, _CMP_GE_OQ));
+
+        _mm256_storeu_pd(&batch.bid[i], bid);
+        _mm256_storeu_pd(&batch.ask[i], ask);
+        _mm256_storeu_pd(&batch.quote_size[i], size);
+        int mask = _mm256_movemask_pd(ok);
+        for (int lane = 0; lane < 4; lane++) {
+            batch.quoted[i + lane] = (mask >> lane) & 1;
+        }
+    }
+    return n;
+}
+
+#endif
+
+} // namespace
+
+BatchKernel bestBatchKernel() {
+#ifdef PMM_HAVE_AVX2_KERNEL
+    static const BatchKernel kernel = __builtin_cpu_supports("avx2") ? BatchKernel::AVX2 : BatchKernel::SCALAR;
+    return kernel;
+#else
+    return BatchKernel::SCALAR;
+#endif
+}
+
+void quoteBatch(QuoteBatch& batch, BatchKernel kernel) {
+    size_t done = 0;
+#ifdef PMM_HAVE_AVX2_KERNEL
+    if (kernel == BatchKernel::AVX2) {
+        done = quoteAvx2(batch);
+    }
+#else
+    (void)kernel;
+#endif
+    quoteScalar(batch, done);  // Whatever is left over
+}
+
+} // namespace pmm
@@ -0,0 +1,148 @@
+#include "strategy/condition_quoter.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pmm {
+
+namespace {
+// Same skew, spread, cost floor, sizes and TTL as MarketMaker
+using Policy = DefaultQuoting;
+
+constexpr Price MIN_PRICE = 0.01;
+constexpr Price MAX_PRICE = 0.99;
+constexpr Price TICK = 0.01;
+constexpr Price MIN_MARKET_SPREAD = 0.01;
+
+// Bids round down and asks up, so cheap outcomes keep at least a tick of spread
+Price roundDownToCent(Price price) {
+    return std::floor(price / TICK + 1e-9) * TICK;
+}
+
+Price roundUpToCent(Price price) {
+    return std::ceil(price / TICK - 1e-9) * TICK;
+}
+} // namespace
+
+size_t ConditionQuoter::addOutcome(TokenHandle token) {
+    tokens_.push_back(token);
+    inputs_.emplace_back();
+    fair_.push_back(0.0);
+    bid_.push_back(0.0);
+    ask_.push_back(0.0);
+    bid_size_.push_back(0.0);
+    ask_size_.push_back(0.0);
+    ttl_seconds_.push_back(0);
+    return tokens_.size() - 1;
+}
+
+bool ConditionQuoter::quote() {
+    const size_t n = tokens_.size();
+    if (n == 0) {
+        return false;
+    }
+
+    double fair_sum = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        if (inputs_[i].best_bid <= 0.0 || inputs_[i].best_ask <= 0.0) {
+            return false;
+        }
+        fair_sum += inputs_[i].mid;
+    }
+
+    // Project the fair values onto prices that sum to 1
+    double shift = (1.0 - fair_sum) / static_cast<double>(n);
+    double weight_sum = 0.0;
+    double weighted_inventory = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        fair_[i] = std::clamp(inputs_[i].mid + shift, MIN_PRICE, MAX_PRICE);
+        weight_sum += fair_[i];
+        weighted_inventory += fair_[i] * inputs_[i].inventory;
+    }
+
+    // Only the part of each position not covered by complete sets is at risk
+    double hedged = weighted_inventory / weight_sum;
+    double variance = 0.0;
+
+    for (size_t i = 0; i < n; i++) {
+        QuoteInputs in = inputs_[i];
+        double excess = in.inventory - hedged;
+        double exposure = excess * fair_[i];  // Dollars
+        variance += fair_[i] * excess * excess;
+
+        in.mid = fair_[i];
+        in.inventory = excess;
+        in.inventory_dollars = exposure;
+        Price fair = Policy::FairPolicy::fair(in);
+        QuotePrices prices = Policy::SkewPolicy::prices(in, fair, Policy::SpreadPolicy::halfWidth(in, fair));
+        Price bid = std::clamp(roundDownToCent(prices.bid), MIN_PRICE, MAX_PRICE);
+        Price ask = std::clamp(std::max(roundUpToCent(prices.ask), Policy::FloorPolicy::minAsk(in)),
+                               MIN_PRICE, MAX_PRICE);
+
+        // Sized per side: the side that reduces the unhedged position keeps quoting
+        Size bid_size = std::min(Policy::SizePolicy::MAX_SIZE, (in.max_position - exposure) / fair_[i]);
+        Size ask_size = std::min(Policy::SizePolicy::MAX_SIZE, (in.max_position + exposure) / fair_[i]);
+
+        // Never quote a collapsed or locked book
+        bool tradable = (ask > bid) && (in.best_ask - in.best_bid >= MIN_MARKET_SPREAD - 1e-9);
+
+        bid_[i] = bid;
+        ask_[i] = ask;
+        bid_size_[i] = (tradable && bid_size >= Policy::SizePolicy::MIN_SIZE) ? bid_size : 0.0;
+        ask_size_[i] = (tradable && ask_size >= Policy::SizePolicy::MIN_SIZE) ? ask_size : 0.0;
+        ttl_seconds_[i] = Policy::TTLPolicy::seconds(in);
+    }
+    inventory_risk_ = std::sqrt(variance / weight_sum);
+
+    keepBidsAndAsksConsistent();
+    keepInsideOwnBooks();
+    return true;
+}
+
+void ConditionQuoter::keepBidsAndAsksConsistent() {
+    const size_t n = tokens_.size();
+    double bid_sum = 0.0;
+    double ask_sum = 0.0;
+    size_t bids = 0;
+    size_t asks = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (bid_size_[i] > 0.0) {
+            bid_sum += bid_[i];
+            bids++;
+        }
+        if (ask_size_[i] > 0.0) {
+            ask_sum += ask_[i];
+            asks++;
+        }
+    }
+
+    // A full set of bids at 1 or more would buy a $1 payout for at least $1
+    if (bids == n && bid_sum > 1.0 - TICK / 2) {
+        double cut = (bid_sum - (1.0 - TICK)) / static_cast<double>(n);
+        for (size_t i = 0; i < n; i++) {
+            bid_[i] = std::max(MIN_PRICE, roundDownToCent(bid_[i] - cut));
+        }
+    }
+    if (asks == n && ask_sum < 1.0 + TICK / 2) {
+        double lift = ((1.0 + TICK) - ask_sum) / static_cast<double>(n);
+        for (size_t i = 0; i < n; i++) {
+            ask_[i] = std::min(MAX_PRICE, roundUpToCent(ask_[i] + lift));
+        }
+    }
+}
+
+// Runs last: the consistency shifts above can push a quote through its book
+void ConditionQuoter::keepInsideOwnBooks() {
+    for (size_t i = 0; i < tokens_.size(); i++) {
+        const QuoteInputs& in = inputs_[i];
+        bid_[i] = std::min(bid_[i], roundDownToCent(in.best_ask - TICK));
+        ask_[i] = std::max(ask_[i], roundUpToCent(in.best_bid + TICK));
+        if (bid_[i] < MIN_PRICE || bid_[i] >= ask_[i]) {
+            bid_size_[i] = 0.0;
+        }
+        if (ask_[i] > MAX_PRICE || ask_[i] <= bid_[i]) {
+            ask_size_[i] = 0.0;
+        }
+    }
+}
+
+} // namespace pmm
@@ -1,4 +1,5 @@
 #include "strategy/market_maker.hpp"
+#include "strategy/quoting_policies.hpp"
 #include "utils/logger.hpp"
 #include <iostream>
 #include <algorithm>
@@ -12,125 +13,73 @@ MarketMaker::MarketMaker(double spread_pct, double max_position)
       inventory_(0.0),
       inventory_dollars_(0.0),
       avg_cost_(0.0),
-      realized_pnl_(0.0),
-      last_mid_(0.0),
-      last_update_time_(std::chrono::steady_clock::now()) {
+      realized_pnl_(0.0) {
     
     LOG_DEBUG("MarketMaker initialized: spread={}, max_pos={}, gamma={}, sigma={}", spread_pct, max_position, risk_aversion_, volatility_);
 }
 
-std::optional<Quote> MarketMaker::generateQuote(const OrderBook& book, 
-                                               const MarketMetadata* metadata,
-                                               double spread_multiplier) {
-    Price mid = book.getMid();
-    Price market_spread = book.getSpread();
-    
-    // Update volatility estimate
-    if (last_mid_ > 0) {
-        auto now = std::chrono::steady_clock::now();
-        double elapsed = std::chrono::duration<double>(now - last_update_time_).count();
-        if (elapsed > 0.1) {  // Update if > 0.1 seconds elapsed
-            updateVolatility(last_mid_, mid, elapsed);
-        }
-    }
-    last_mid_ = mid;
-    last_update_time_ = std::chrono::steady_clock::now();
-    
-    if (market_spread < 0.01) {
-        LOG_DEBUG("Market spread too tight ({}), not quoting", market_spread);
-        return std::nullopt;
-    }
-    
-    // Apply adverse selection adjustment to spread
-    double adjusted_spread_pct = spread_pct_ * spread_multiplier;
-    double target_spread_dollars = mid * adjusted_spread_pct;
-    
+void MarketMaker::prepareQuote(const OrderBook& book,
+                               const MarketMetadata* metadata,
+                               double spread_multiplier,
+                               QuoteInputs& in) {
     if (spread_multiplier > 1.1) {
         LOG_DEBUG("AS-adjusted spread: {:.1f}bps (base: {:.1f}bps, mult: {:.2f}x)", 
-                 adjusted_spread_pct * 10000, spread_pct_ * 10000, spread_multiplier);
-    }
-
-    double q = inventory_ / 100.0; // Normalize inventory
-    double gamma = risk_aversion_;
-    double sigma_sq = volatility_ * volatility_; // Assume some volatility estimate
-    
-    double reservation_bid = mid - (q + 1.0) * gamma * sigma_sq;
-    double reservation_ask = mid + (q - 1.0) * gamma * sigma_sq;
-
-    LOG_DEBUG("AV calculation:");
-    LOG_DEBUG("q (normalized inventory): {}", q);
-    LOG_DEBUG("gamma: {}, sigma: {}", gamma, volatility_);
-    LOG_DEBUG("reservation_bid: {}", reservation_bid);
-    LOG_DEBUG("reservation_ask: {}", reservation_ask);
-    LOG_DEBUG("target_spread: {}", target_spread_dollars);
-    Price our_bid = reservation_bid - target_spread_dollars / 2.0;
-    Price our_ask = reservation_ask + target_spread_dollars / 2.0;
-        
-    double imbalance = book.getImbalance();
-    double imbalance_adjustment = imbalance * 0.005;  // Max 0.5% adjustment
-    
-    our_bid += imbalance_adjustment;
-    our_ask += imbalance_adjustment;
-    
-    LOG_DEBUG("imbalance: {}  adjustment: {}", imbalance, imbalance_adjustment);
-    
-    our_bid = roundToCent(our_bid);
-    our_ask = roundToCent(our_ask);
-    
-    // Time-aware risk-adjusted cost floor
-    if (inventory_ > 0 && avg_cost_ > 0) {
-        double inventory_risk = std::abs(inventory_dollars_) / max_position_;
-        double time_urgency = getTimeUrgency();
-        
-        // Base profit requirement: 1.5% when no urgency
-        double base_min_profit = 0.015;
-        
-        // Reduce profit requirement based on time urgency and inventory risk
-        double urgency_factor = std::max(time_urgency, inventory_risk);
-        double min_profit_pct = base_min_profit * (1.0 - urgency_factor);
-        
-        // At very high urgency (>90%), accept small losses to exit
-        if (urgency_factor > 0.9) {
-            min_profit_pct = -0.01;  // Accept up to 1% loss
-        }
-        
-        double min_ask = avg_cost_ * (1.0 + min_profit_pct);
-        
-        if (our_ask < min_ask) {
-            LOG_DEBUG("Adjusting ask from {} to {} (avg_cost: {}, urgency: {:.1f}%, inv_risk: {:.1f}%, min_profit: {:.2f}%)", 
-                     our_ask, min_ask, avg_cost_, time_urgency * 100, inventory_risk * 100, min_profit_pct * 100);
-            our_ask = min_ask;
-        }
+                 spread_pct_ * spread_multiplier * 10000, spread_pct_ * 10000, spread_multiplier);
     }
     
-    // Clip to valid price range [0.01, 0.99] for binary markets
-    our_bid = std::max(0.01, std::min(0.99, our_bid));
-    our_ask = std::max(0.01, std::min(0.99, our_ask));
-    
-
-    if (our_ask <= our_bid) {
-        LOG_DEBUG("Quotes collapsed after clipping (bid={}, ask={}), not quoting", our_bid, our_ask);
-        return std::nullopt;
+    in.best_bid = book.getBestBid();
+    in.best_ask = book.getBestAsk();
+    
+    // Microprice and depth-weighted mid already lean toward the heavier
+    // side of the book, so only the plain mid gets the imbalance lean
+    switch ((metadata != nullptr) ? metadata->fair_value_model : FairValueModel::MID) {
+        case FairValueModel::MID:
+            in.mid = book.getMid();
+            in.imbalance = book.getImbalance();
+            break;
+        case FairValueModel::MICROPRICE:
+            in.mid = book.getMicroprice();
+            in.imbalance = 0.0;
+            break;
+        case FairValueModel::DEPTH_WEIGHTED:
+            in.mid = book.getDepthWeightedMid();
+            in.imbalance = 0.0;
+            break;
     }
+    in.inventory = inventory_;
+    in.avg_cost = avg_cost_;
+    in.inventory_dollars = inventory_dollars_;
+    in.max_position = max_position_;
+    in.spread_pct = spread_pct_;
+    in.spread_multiplier = spread_multiplier;
+    in.risk_aversion = risk_aversion_;
+    in.volatility = volatility_;
+    in.time_urgency = (inventory_ > 0) ? getTimeUrgency() : 0.0;  // Only the cost floor reads it
+    in.ttl_seconds = (metadata != nullptr) ? metadata->getRecommendedTTL() : 90;
+}
 
-    if (our_bid >= book.getBestAsk() || our_ask <= book.getBestBid()) {
-        LOG_DEBUG("Our quotes would cross the market, not quoting");
+std::optional<Quote> MarketMaker::generateQuote(const OrderBook& book, 
+                                               const MarketMetadata* metadata,
+                                               double spread_multiplier) {
+    QuoteInputs in;
+    prepareQuote(book, metadata, spread_multiplier, in);
+    
+    Quote quote;
+    quote.created_at = std::chrono::steady_clock::now();
+    if (!DefaultQuoting::quote(in, quote)) {
+        Price market_spread = in.best_ask - in.best_bid;
+        if (market_spread < 0.01) {
+            LOG_DEBUG("Market spread too tight ({}), not quoting", market_spread);
+        } else if (quote.bid_size < CapacitySize::MIN_SIZE) {
+            LOG_WARN("Near max position (remaining: ${}), not quoting", max_position_ - std::abs(inventory_));
+        } else {
+            LOG_DEBUG("Quotes collapsed or would cross the market (bid={}, ask={}), not quoting",
+                     quote.bid_price, quote.ask_price);
+        }
         return std::nullopt;
     }
     
-    // Size based on remaining capacity
-    double remaining_capacity = max_position_ - std::abs(inventory_);
-    Size quote_size = std::min(100.0, remaining_capacity / mid);
-
-    if (quote_size < 10.0) {
-        LOG_WARN("Near max position (remaining: ${}), not quoting", remaining_capacity);
-        return std::nullopt;
-    }
-
-    // Calculate TTL based on market phase
-    int ttl_seconds = 90;  // Default: 90 seconds
     if (metadata != nullptr) {
-        ttl_seconds = metadata->getRecommendedTTL();
         MarketPhase phase = metadata->getMarketPhase();
         
         static MarketPhase last_logged_phase = MarketPhase::PRE_MATCH_EARLY;
@@ -143,18 +92,9 @@ std::optional<Quote> MarketMaker::generateQuote(const OrderBook& book,
             last_logged_phase = phase;
         }
     }
-
-    Quote quote{
-        our_bid, 
-        quote_size, 
-        our_ask, 
-        quote_size,
-        ttl_seconds,
-        std::chrono::steady_clock::now()
-    };
     
     LOG_DEBUG("Generated quote: Bid {} x {} / Ask {} x {} (inventory: {}, TTL: {}s)", 
-             our_bid, quote_size, our_ask, quote_size, inventory_, ttl_seconds);
+             quote.bid_price, quote.bid_size, quote.ask_price, quote.ask_size, inventory_, quote.ttl_seconds);
     
     return quote;
 }
@@ -229,28 +169,6 @@ void MarketMaker::updateInventory(Side side, Size filled_size, Price fill_price)
     LOG_INFO("  Inventory: {} shares (${:.2f}), Realized PnL: ${:.2f}", inventory_, inventory_dollars_, realized_pnl_);
 }
 
-void MarketMaker::updateVolatility(Price old_mid, Price new_mid, double time_elapsed_seconds) {
-    double return_pct = std::abs(new_mid - old_mid) / old_mid;
-    
-    // Annualize (assuming 252 trading days, 24 hours per day)
-    double annual_factor = std::sqrt(252.0 * 24.0 * 3600.0 / time_elapsed_seconds);
-    double observed_vol = return_pct * annual_factor;
-    
-    // EWMA with lambda = 0.94
-    double lambda = 0.94;
-    volatility_ = lambda * volatility_ + (1.0 - lambda) * observed_vol;
-    
-    // Clip to reasonable range
-    volatility_ = std::max(0.01, std::min(0.50, volatility_));
-    
-    // Only log if significant change
-    static double last_logged_vol = 0.0;
-    if (std::abs(volatility_ - last_logged_vol) > 0.01) {
-        LOG_DEBUG("  Volatility updated: {}", volatility_);
-        last_logged_vol = volatility_;
-    }
-}
-
 double MarketMaker::getUnrealizedPnL(Price current_mid) const {
     if (std::abs(inventory_) < 0.001) {
         return 0.0;
@@ -259,10 +177,6 @@ double MarketMaker::getUnrealizedPnL(Price current_mid) const {
     return inventory_ * (current_mid - avg_cost_);
 }
 
-Price MarketMaker::roundToCent(Price price) {
-    return std::round(price * 100.0) / 100.0;
-}
-
 void MarketMaker::setMarketCloseTime(std::chrono::system_clock::time_point close_time) {
     market_close_time_ = close_time;
     has_close_time_ = true;
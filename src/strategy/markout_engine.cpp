@@ -0,0 +1,61 @@
+#include "strategy/markout_engine.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace pmm {
+
+MarkoutEngine::MarkoutEngine(std::vector<int> horizons_sec)
+    : horizons_sec_(std::move(horizons_sec)) {
+    if (horizons_sec_.empty() || horizons_sec_.size() > MAX_HORIZONS) {
+        throw std::invalid_argument("MarkoutEngine needs between 1 and 8 horizons");
+    }
+    if (horizons_sec_.front() <= 0 ||
+        std::adjacent_find(horizons_sec_.begin(), horizons_sec_.end(), std::greater_equal<int>()) != horizons_sec_.end()) {
+        throw std::invalid_argument("MarkoutEngine horizons must be positive and ascending");
+    }
+}
+
+int MarkoutEngine::horizonIndex(int seconds) const {
+    auto it = std::find(horizons_sec_.begin(), horizons_sec_.end(), seconds);
+    return (it != horizons_sec_.end()) ? static_cast<int>(it - horizons_sec_.begin()) : -1;
+}
+
+Price MarkoutEngine::midAt(const MarkoutRecord& record, int seconds) const {
+    int h = horizonIndex(seconds);
+    return (h >= 0) ? record.mid_later[h] : 0.0;
+}
+
+MarkoutRecord& MarkoutEngine::registerFill(const MarkoutRecord& fill) {
+    // Keep memory flat: a full ring flushes its oldest fill with whatever markouts it has
+    if (fills_.full()) {
+        completeOldest();
+    }
+    total_fills_++;
+    return fills_.push_back(fill);
+}
+
+MarkoutEngine::Clock::time_point MarkoutEngine::nextDue() const {
+    // Each cursor points at its horizon's oldest uncaptured fill, which is due first
+    Clock::time_point due = Clock::time_point::max();
+    for (size_t h = 0; h < horizons_sec_.size(); h++) {
+        if (cursors_[h] < fills_.tailSeq()) {
+            due = std::min(due, fills_.atSeq(cursors_[h]).fill_time + std::chrono::seconds(horizons_sec_[h]));
+        }
+    }
+    return due;
+}
+
+void MarkoutEngine::completeOldest() {
+    const MarkoutRecord& record = fills_.front();
+    for (const CompletionHandler& handler : completion_handlers_) {
+        handler(record);
+    }
+    fills_.pop_front();
+
+    // A fill flushed early skips any horizons it had not reached yet
+    for (size_t h = 0; h < horizons_sec_.size(); h++) {
+        cursors_[h] = std::max(cursors_[h], fills_.headSeq());
+    }
+}
+
+} // namespace pmm
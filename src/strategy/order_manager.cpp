@@ -1,4 +1,5 @@
 #include "strategy/order_manager.hpp"
+#include "network/order_gateway.hpp"
 #include "utils/trading_logger.hpp"
 #include "utils/logger.hpp"
 #include <iostream>
@@ -8,8 +9,14 @@ namespace pmm {
 OrderManager::OrderManager(EventQueue& event_queue, TradingMode mode, TradingLogger* trading_logger)
     : event_queue_(event_queue),
       trading_mode_(mode),
-      next_order_id_(1),
-      trading_logger_(trading_logger) {
+      trading_logger_(trading_logger),
+      order_index_(INITIAL_POOL_SIZE * 2),
+      next_order_id_(1) {
+    
+    // Preallocate the pool so steady-state requoting never touches the heap
+    nodes_.reserve(INITIAL_POOL_SIZE);
+    free_nodes_.reserve(INITIAL_POOL_SIZE);
+    paper_fills_.reserve(16);
     
     std::string mode_str = (mode == TradingMode::PAPER) ? "PAPER TRADING" : "LIVE";
     LOG_INFO("OrderManager initialized ({})", mode_str);
@@ -24,196 +31,188 @@ void OrderManager::setTradingMode(TradingMode mode) {
     }
 }
 
-OrderId OrderManager::placeOrder(const TokenId& token_id, Side side, Price price, Size size, const std::string& market_id) {
-    OrderId order_id = "ORD_" + std::to_string(next_order_id_++);
-    
-    Order order{
-        order_id,
-        token_id,
-        side,
-        price,
-        size,
-        0.0,  // filled_size
-        OrderStatus::OPEN,
-        std::chrono::steady_clock::now()
-    };
-    
-    orders_[order_id] = order;
+OrderId OrderManager::placeOrder(const TokenId& token_id, Side side, Price price, Size size, std::string_view market_name,
+                                 const OrderBook* book) {
+    OrderId order_id = next_order_id_++;
+    uint32_t node = insertOrder(order_id, token_id, side, price, size);
+    const Order& order = nodes_[node].order;
 
     if (trading_logger_) {
-        // Get market context if available
-        Price market_mid = 0.0;
-        Price market_spread = 0.0;
-        Price best_bid = 0.0;
-        Price best_ask = 0.0;
+        const TokenOrders& token_orders = token_orders_[nodes_[node].token];
         Price our_bid = 0.0;
         Price our_ask = 0.0;
         
-        auto book_it = market_books_.find(token_id);
-        if (book_it != market_books_.end()) {
-            const auto& book = book_it->second;
-            market_mid = book.getMid();
-            market_spread = book.getSpread();
-            best_bid = book.getBestBid();
-            best_ask = book.getBestAsk();
-        }
-        
-        // Find our paired orders for this token to calculate our spread
-        for (const auto& [oid, o] : orders_) {
-            if (o.token_id == token_id && o.status == OrderStatus::OPEN) {
-                if (o.side == Side::BUY) {
-                    our_bid = std::max(our_bid, o.price);
-                } else {
-                    our_ask = (our_ask == 0.0) ? o.price : std::min(our_ask, o.price);
-                }
+        // Find our paired orders for this token to calculate our spread (includes this order)
+        for (uint32_t i = token_orders.head[sideIndex(Side::BUY)]; i != NO_ORDER; i = nodes_[i].next) {
+            if (nodes_[i].order.status == OrderStatus::OPEN) {
+                our_bid = std::max(our_bid, nodes_[i].order.price);
             }
         }
-        // Include the current order being placed
-        if (order.side == Side::BUY) {
-            our_bid = std::max(our_bid, order.price);
-        } else {
-            our_ask = (our_ask == 0.0) ? order.price : std::min(our_ask, order.price);
+        for (uint32_t i = token_orders.head[sideIndex(Side::SELL)]; i != NO_ORDER; i = nodes_[i].next) {
+            const Order& o = nodes_[i].order;
+            if (o.status == OrderStatus::OPEN) {
+                our_ask = (our_ask == 0.0) ? o.price : std::min(our_ask, o.price);
+            }
         }
         
-        trading_logger_->logOrderPlaced(order, market_id, market_mid, market_spread, best_bid, best_ask, our_bid, our_ask);
+        trading_logger_->logOrderPlaced(order, market_name, token_orders.mid, token_orders.spread,
+                                        token_orders.best_bid, token_orders.best_ask, our_bid, our_ask);
     }
 
     if (trading_mode_ == TradingMode::PAPER) {
-        LOG_DEBUG("[PAPER] Order placed: {} - {} {} @ {}", order_id, (side == Side::BUY ? "BUY" : "SELL"), size, price);
+        Size queue_ahead = 0.0;
+        if (book) {
+            queue_ahead = (side == Side::BUY) ? book->getBidSize(price) : book->getAskSize(price);
+        }
+        token_orders_[nodes_[node].token].paper.add(node, side, price, size, queue_ahead);
+        LOG_DEBUG("[PAPER] Order placed: ORD_{} - {} {} @ {} ({} ahead)", order_id, (side == Side::BUY ? "BUY" : "SELL"), size, price, queue_ahead);
     } else {
-        LOG_INFO("[LIVE] Placing order: {} - {} {} @ {}", order_id, (side == Side::BUY ? "BUY" : "SELL"), size, price);
+        LOG_INFO("[LIVE] Placing order: ORD_{} - {} {} @ {}", order_id, (side == Side::BUY ? "BUY" : "SELL"), size, price);
         placeOrderLive(order);
     }
     
     return order_id;
 }
 
-bool OrderManager::cancelOrder(const OrderId& order_id, const std::string& market_id, CancelReason reason) {
-    auto it = orders_.find(order_id);
-    if (it == orders_.end()) {
-        LOG_ERROR("Order not found: {}", order_id);
+bool OrderManager::cancelOrder(OrderId order_id, std::string_view market_name, CancelReason reason) {
+    uint32_t node = order_index_.find(order_id);
+    if (node == FlatIdMap::NOT_FOUND) {
+        LOG_ERROR("Order not found: ORD_{}", order_id);
         return false;
     }
+    
+    cancelNode(node, market_name, reason);
+    return true;
+}
 
-    Order& order = it->second;
+void OrderManager::cancelNode(uint32_t node, std::string_view market_name, CancelReason reason) {
+    Order& order = nodes_[node].order;
+    if (order.status == OrderStatus::CANCELLED) {
+        return;  // Live cancel already in flight
+    }
     order.status = OrderStatus::CANCELLED;
     
     if (trading_logger_) {
-        trading_logger_->logOrderCancelled(order_id, order, market_id, reason);
+        trading_logger_->logOrderCancelled(order.order_id, order, market_name, reason);
     }
 
     if (trading_mode_ == TradingMode::PAPER) {
-        LOG_DEBUG("[PAPER] Order cancelled: {}", order_id);
-        orders_.erase(it);
+        LOG_DEBUG("[PAPER] Order cancelled: ORD_{}", order.order_id);
+        removeOrder(node);
     } else {
-        LOG_INFO("[LIVE] Cancelling order: {}", order_id);
-        cancelOrderLive(order_id);
+        LOG_INFO("[LIVE] Cancelling order: ORD_{}", order.order_id);
+        cancelOrderLive(order.order_id);
     }
-    return true;
 }
 
-bool OrderManager::cancelAllOrders(const TokenId& token_id, const std::string& market_id, CancelReason reason) {
-    std::vector<OrderId> to_cancel;
-    
-    for (const auto& [order_id, order] : orders_) {
-        if (order.token_id == token_id) {
-            to_cancel.push_back(order_id);
-        }
+bool OrderManager::cancelAllOrders(const TokenId& token_id, std::string_view market_name, CancelReason reason) {
+    auto it = token_index_.find(token_id);
+    if (it == token_index_.end()) {
+        return true;
     }
     
-    for (const auto& order_id : to_cancel) {
-        if (!cancelOrder(order_id, market_id, reason)) {
-            LOG_ERROR("Failed to cancel order: {}", order_id);
-            return false;
+    // Walk the lists directly; grab next before the node is released
+    const TokenOrders& token_orders = token_orders_[it->second];
+    for (size_t side = 0; side < token_orders.head.size(); side++) {
+        uint32_t i = token_orders.head[side];
+        while (i != NO_ORDER) {
+            uint32_t next = nodes_[i].next;
+            cancelNode(i, market_name, reason);
+            i = next;
         }
     }
     return true;
 }
 
 bool OrderManager::cancelAllOrders(CancelReason reason) {
-    std::vector<OrderId> to_cancel;
-    
-    for (const auto& [order_id, _] : orders_) {
-        to_cancel.push_back(order_id);
-    }
-    
-    for (const auto& order_id : to_cancel) {
-        if (!cancelOrder(order_id, "cancel_all", reason)) {
-            LOG_ERROR("Failed to cancel order: {}", order_id);
-            return false;
+    for (const TokenOrders& token_orders : token_orders_) {
+        for (size_t side = 0; side < token_orders.head.size(); side++) {
+            uint32_t i = token_orders.head[side];
+            while (i != NO_ORDER) {
+                uint32_t next = nodes_[i].next;
+                cancelNode(i, "cancel_all", reason);
+                i = next;
+            }
         }
     }
     return true;
 }
 
 void OrderManager::updateOrderBook(const TokenId& token_id, const OrderBook& book) {
-    market_books_.insert_or_assign(token_id, book);
+    TokenOrders& token_orders = token_orders_[tokenOrdersIndex(token_id)];
+    updateTopOfBook(token_orders, book);
     
-    // Only check for fills in paper trading mode
-    if (trading_mode_ == TradingMode::PAPER) {
-        checkForFills(token_id, book);
+    // Only simulate fills in paper trading mode
+    if (trading_mode_ == TradingMode::PAPER && !token_orders.paper.empty()) {
+        token_orders.paper.onBook(book, paper_fills_);
+        token_orders.paper.checkCrosses(book, paper_fills_);
+        applyPaperFills();
     }
 }
 
-void OrderManager::checkForFills(const TokenId& token_id, const OrderBook& book) {
-    if (!isPaperTrading()) return;
+void OrderManager::updateOrderBook(const TokenId& token_id, const OrderBook& book,
+                                   const std::vector<std::pair<Price, Size>>& bid_changes,
+                                   const std::vector<std::pair<Price, Size>>& ask_changes) {
+    TokenOrders& token_orders = token_orders_[tokenOrdersIndex(token_id)];
+    updateTopOfBook(token_orders, book);
     
-    std::vector<OrderId> fills_to_process;
+    if (trading_mode_ != TradingMode::PAPER || token_orders.paper.empty()) {
+        return;
+    }
     
-    for (auto& [order_id, order] : orders_) {
-        if (order.token_id != token_id || order.status != OrderStatus::OPEN) {
+    // Only levels in the update can move a queue position
+    for (const auto& [price, size] : bid_changes) {
+        token_orders.paper.onLevelChange(Side::BUY, price, size, book, paper_fills_);
+    }
+    for (const auto& [price, size] : ask_changes) {
+        token_orders.paper.onLevelChange(Side::SELL, price, size, book, paper_fills_);
+    }
+    token_orders.paper.checkCrosses(book, paper_fills_);
+    applyPaperFills();
+}
+
+void OrderManager::updateTopOfBook(TokenOrders& token_orders, const OrderBook& book) {
+    // Only the top of book is needed for order logging
+    token_orders.best_bid = book.getBestBid();
+    token_orders.best_ask = book.getBestAsk();
+    token_orders.mid = book.getMid();
+    token_orders.spread = book.getSpread();
+}
+
+void OrderManager::applyPaperFills() {
+    for (const PaperFill& fill : paper_fills_) {
+        // An earlier fill in this batch may have completed the order
+        if (nodes_[fill.ref].token == NO_ORDER) {
             continue;
         }
-        
-        bool should_fill = false;
-        Price fill_price = order.price;
-        
-        if (order.side == Side::BUY) {
-            // Buy order fills if best ask <= our bid price
-            if (book.getBestAsk() > 0 && book.getBestAsk() <= order.price) {
-                should_fill = true;
-                fill_price = order.price; // We pay our bid price
-                LOG_INFO("[PAPER] BUY order {} crossed! Market ask {} <= our bid {}", order_id, book.getBestAsk(), order.price);
-            }
-        } else { // SELL
-            // Sell order fills if best bid >= our ask price
-            if (book.getBestBid() > 0 && book.getBestBid() >= order.price) {
-                should_fill = true;
-                fill_price = order.price; // We receive our ask price
-                LOG_INFO("[PAPER] SELL order {} crossed! Market bid {} >= our ask {}", order_id, book.getBestBid(), order.price);
-            }
-        }
-        
-        if (should_fill) {
-            fills_to_process.push_back(order_id);
-        }
+        generateFill(fill.ref, fill.price, fill.size);
     }
-    
-    for (const auto& order_id : fills_to_process) {
-        auto it = orders_.find(order_id);
-        if (it != orders_.end()) {
-            generateFill(order_id, it->second.price, it->second.size);
-        }
+    paper_fills_.clear();
+}
+
+Size OrderManager::getQueueAhead(OrderId order_id) const {
+    uint32_t node = order_index_.find(order_id);
+    if (node == FlatIdMap::NOT_FOUND) {
+        return -1.0;
     }
+    return token_orders_[nodes_[node].token].paper.queueAhead(node);
 }
 
-void OrderManager::generateFill(const OrderId& order_id, Price fill_price, Size fill_size) {
-    auto it = orders_.find(order_id);
-    if (it == orders_.end()) return;
-    
-    Order& order = it->second;
+void OrderManager::generateFill(uint32_t node, Price fill_price, Size fill_size) {
+    Order& order = nodes_[node].order;
     
+    releaseWorking(node, fill_size);
     order.filled_size += fill_size;
-    if (order.filled_size >= order.size) {
+    if (order.filled_size >= order.size - FILL_EPSILON) {
         order.status = OrderStatus::FILLED;
     }
     
     std::string side_str = (order.side == Side::BUY) ? "BOUGHT" : "SOLD";
-    LOG_INFO("[PAPER FILL] {} {} @ {} (order: {})", side_str, fill_size, fill_price, order_id);
+    LOG_INFO("[PAPER FILL] {} {} @ {} (order: ORD_{})", side_str, fill_size, fill_price, order.order_id);
     
     // Generate fill event
     auto fill_event = Event::orderFill(
-        order_id,
+        order.order_id,
         order.token_id,
         fill_price,
         fill_size,
@@ -221,51 +220,190 @@ void OrderManager::generateFill(const OrderId& order_id, Price fill_price, Size
     );
     
     event_queue_.push(std::move(fill_event));
+    
+    // Fully filled orders are no longer working
+    if (order.status == OrderStatus::FILLED) {
+        removeOrder(node);
+    }
 }
 
-std::vector<Order> OrderManager::getOpenOrders(const TokenId& token_id) const {
-    std::vector<Order> open_orders;
-    for (const auto& [_, order] : orders_) {
-        if (order.token_id == token_id) {
-            open_orders.push_back(order);
-        }
+OrderManager::OrderView OrderManager::getOpenOrders(const TokenId& token_id) const {
+    return OrderView(&nodes_, findTokenOrders(token_id));
+}
+
+size_t OrderManager::getOpenOrderCount(const TokenId& token_id) const {
+    const TokenOrders* token_orders = findTokenOrders(token_id);
+    return token_orders ? token_orders->count : 0;
+}
+
+const OrderManager::TokenOrders* OrderManager::findTokenOrders(const TokenId& token_id) const {
+    auto it = token_index_.find(token_id);
+    return (it != token_index_.end()) ? &token_orders_[it->second] : nullptr;
+}
+
+uint32_t OrderManager::tokenOrdersIndex(const TokenId& token_id) {
+    auto it = token_index_.find(token_id);
+    if (it != token_index_.end()) {
+        return it->second;
     }
-    return open_orders;
+    
+    uint32_t index = static_cast<uint32_t>(token_orders_.size());
+    token_orders_.emplace_back();
+    token_index_.emplace(token_id, index);
+    return index;
 }
 
-size_t OrderManager::getOpenOrderCount() const {
-    return orders_.size();
+uint32_t OrderManager::insertOrder(OrderId order_id, const TokenId& token_id, Side side, Price price, Size size) {
+    uint32_t node;
+    if (!free_nodes_.empty()) {
+        node = free_nodes_.back();
+        free_nodes_.pop_back();
+    } else {
+        node = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+        free_nodes_.reserve(nodes_.capacity());  // Releases must never allocate
+    }
+    
+    uint32_t token = tokenOrdersIndex(token_id);
+    
+    // Fill the recycled node in place; the token string reuses its capacity
+    OrderNode& entry = nodes_[node];
+    Order& order = entry.order;
+    order.order_id = order_id;
+    order.token_id = token_id;
+    order.side = side;
+    order.price = price;
+    order.size = size;
+    order.filled_size = 0.0;
+    order.status = OrderStatus::OPEN;
+    order.created_at = std::chrono::steady_clock::now();
+    
+    // Push onto the front of the token's list for this side
+    TokenOrders& token_orders = token_orders_[token];
+    uint32_t& head = token_orders.head[sideIndex(side)];
+    entry.token = token;
+    entry.prev = NO_ORDER;
+    entry.next = head;
+    if (head != NO_ORDER) {
+        nodes_[head].prev = node;
+    }
+    head = node;
+    
+    token_orders.count++;
+    side_counts_[sideIndex(side)]++;
+    order_index_.insert(order_id, node);
+    if (risk_gate_) {
+        risk_gate_->onOrderOpened(token_orders.risk_condition, side, price * size);
+    }
+    return node;
 }
 
-size_t OrderManager::getBidCount() const {
-    size_t count = 0;
-    for (const auto& [_, order] : orders_) {
-        if (order.side == Side::BUY) {
-            count++;
-        }
+void OrderManager::removeOrder(uint32_t node) {
+    OrderNode& entry = nodes_[node];
+    releaseWorking(node, std::max(entry.order.size - entry.order.filled_size, 0.0));
+    TokenOrders& token_orders = token_orders_[entry.token];
+    size_t side = sideIndex(entry.order.side);
+    
+    if (entry.prev != NO_ORDER) {
+        nodes_[entry.prev].next = entry.next;
+    } else {
+        token_orders.head[side] = entry.next;
+    }
+    if (entry.next != NO_ORDER) {
+        nodes_[entry.next].prev = entry.prev;
     }
-    return count;
+    
+    token_orders.count--;
+    side_counts_[side]--;
+    order_index_.erase(entry.order.order_id);
+    if (trading_mode_ == TradingMode::PAPER) {
+        token_orders.paper.remove(node, entry.order.side, entry.order.price);
+    }
+    
+    entry.prev = NO_ORDER;
+    entry.next = NO_ORDER;
+    entry.token = NO_ORDER;
+    free_nodes_.push_back(node);
 }
 
-size_t OrderManager::getAskCount() const {
-    size_t count = 0;
-    for (const auto& [_, order] : orders_) {
-        if (order.side == Side::SELL) {
-            count++;
-        }
+void OrderManager::releaseWorking(uint32_t node, Size size) {
+    if (risk_gate_) {
+        const Order& order = nodes_[node].order;
+        risk_gate_->onOrderClosed(token_orders_[nodes_[node].token].risk_condition, order.side, order.price * size);
     }
-    return count;
 }
 
-// Stubs for live trading (to be implemented)
+void OrderManager::setRiskCondition(const TokenId& token_id, RiskGate::ConditionHandle condition) {
+    token_orders_[tokenOrdersIndex(token_id)].risk_condition = condition;
+}
+
 void OrderManager::placeOrderLive(const Order& order) {
-    // TODO: Implement Polymarket API order placement
-    LOG_ERROR("Live order placement not yet implemented");
+    if (!gateway_) {
+        LOG_ERROR("No order gateway configured, rejecting ORD_{}", order.order_id);
+        event_queue_.push(Event::orderRejected(order.order_id, RejectedRequest::PLACE, "No order gateway"));
+        return;
+    }
+    if (!gateway_->submitPlace(order)) {
+        event_queue_.push(Event::orderRejected(order.order_id, RejectedRequest::PLACE, "Order gateway queue full"));
+    }
+}
+
+void OrderManager::cancelOrderLive(OrderId order_id) {
+    if (!gateway_) {
+        LOG_ERROR("No order gateway configured, cannot cancel ORD_{}", order_id);
+        return;
+    }
+    if (!gateway_->submitCancel(order_id)) {
+        event_queue_.push(Event::orderRejected(order_id, RejectedRequest::CANCEL,
+                                                    "Cancel failed: order gateway queue full"));
+    }
+}
+
+void OrderManager::onOrderAcked(OrderId order_id, const std::string& exchange_order_id) {
+    LOG_DEBUG("[LIVE] Order acked: ORD_{} ({})", order_id, exchange_order_id);
+}
+
+void OrderManager::onOrderCancelled(OrderId order_id) {
+    uint32_t node = order_index_.find(order_id);
+    if (node == FlatIdMap::NOT_FOUND) {
+        return;
+    }
+    LOG_DEBUG("[LIVE] Cancel confirmed: ORD_{}", order_id);
+    removeOrder(node);
 }
 
-void OrderManager::cancelOrderLive(const OrderId& order_id) {
-    // TODO: Implement Polymarket API order cancellation
-    LOG_ERROR("Live order cancellation not yet implemented");
+void OrderManager::onOrderRejected(OrderId order_id, RejectedRequest request, const std::string& reason) {
+    uint32_t node = order_index_.find(order_id);
+    if (node == FlatIdMap::NOT_FOUND) {
+        return;
+    }
+
+    // A rejected placement never existed, whatever happened to the order
+    // locally since; a rejected cancel leaves it working
+    if (request == RejectedRequest::PLACE) {
+        removeOrder(node);
+        return;
+    }
+    Order& order = nodes_[node].order;
+    if (order.status == OrderStatus::CANCELLED) {
+        LOG_WARN("[LIVE] Cancel of ORD_{} rejected ({}), order still working", order_id, reason);
+        order.status = OrderStatus::OPEN;
+    }
+}
+
+void OrderManager::onOrderFilled(OrderId order_id, Size filled_size) {
+    uint32_t node = order_index_.find(order_id);
+    if (node == FlatIdMap::NOT_FOUND) {
+        return;
+    }
+
+    Order& order = nodes_[node].order;
+    releaseWorking(node, filled_size);
+    order.filled_size += filled_size;
+    if (order.filled_size >= order.size - FILL_EPSILON) {
+        order.status = OrderStatus::FILLED;
+        removeOrder(node);
+    }
 }
 
-} // namespace pmm
\ No newline at end of file
+} // namespace pmm
@@ -0,0 +1,288 @@
+#include "strategy/risk_gate.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pmm {
+
+const char* toString(RiskCheck check) {
+    switch (check) {
+        case RiskCheck::OK: return "OK";
+        case RiskCheck::KILL_SWITCH: return "KILL_SWITCH";
+        case RiskCheck::UNREGISTERED: return "UNREGISTERED";
+        case RiskCheck::ORDER_NOTIONAL: return "ORDER_NOTIONAL";
+        case RiskCheck::CONDITION_NET: return "CONDITION_NET";
+        case RiskCheck::CONDITION_GROSS: return "CONDITION_GROSS";
+        case RiskCheck::NET_EXPOSURE: return "NET_EXPOSURE";
+        case RiskCheck::GROSS_EXPOSURE: return "GROSS_EXPOSURE";
+        case RiskCheck::RATE_LIMIT: return "RATE_LIMIT";
+    }
+    return "UNKNOWN";
+}
+
+namespace {
+// Same average cost rules as the strategy's positions
+void applyFill(double& shares, double& avg_cost, double signed_size, Price price) {
+    if ((shares > 0 && signed_size > 0) || (shares < 0 && signed_size < 0)) {
+        avg_cost = (shares * avg_cost + signed_size * price) / (shares + signed_size);
+    } else if (std::abs(signed_size) >= std::abs(shares)) {
+        avg_cost = price;
+    }
+    shares += signed_size;
+}
+} // namespace
+
+RiskGate::RiskGate(RiskLimits limits, size_t max_conditions)
+    : limits_(limits),
+      conditions_(std::make_unique<Counters[]>(max_conditions)),
+      positions_(std::make_unique<OutcomePositions[]>(max_conditions)),
+      max_conditions_(max_conditions) {
+    micros_.order_notional = toMicros(limits.max_order_notional);
+    micros_.condition_net = toMicros(limits.max_condition_net);
+    micros_.condition_gross = toMicros(limits.max_condition_gross);
+    micros_.net = toMicros(limits.max_net_exposure);
+    micros_.gross = toMicros(limits.max_gross_exposure);
+
+    double rate = std::max(limits.max_orders_per_second, 1e-9);
+    order_interval_ns_ = static_cast<int64_t>(1e9 / rate);
+    burst_tolerance_ns_ = static_cast<int64_t>(std::max(limits.order_burst - 1.0, 0.0) * order_interval_ns_);
+}
+
+RiskGate::Micros RiskGate::toMicros(double dollars) {
+    return static_cast<Micros>(std::llround(dollars * MICROS_PER_DOLLAR));
+}
+
+RiskGate::ConditionHandle RiskGate::registerCondition(const std::string& condition_id) {
+    auto it = condition_index_.find(condition_id);
+    if (it != condition_index_.end()) {
+        return it->second;
+    }
+    size_t count = condition_count_.load(std::memory_order_relaxed);
+    if (count >= max_conditions_) {
+        LOG_ERROR("Risk gate full ({} conditions), orders on {} will be rejected", max_conditions_, condition_id);
+        return NO_CONDITION;
+    }
+
+    auto handle = static_cast<ConditionHandle>(count);
+    condition_index_.emplace(condition_id, handle);
+    condition_count_.store(count + 1, std::memory_order_release);
+    return handle;
+}
+
+RiskGate::ConditionHandle RiskGate::findCondition(const std::string& condition_id) const {
+    auto it = condition_index_.find(condition_id);
+    return (it != condition_index_.end()) ? it->second : NO_CONDITION;
+}
+
+uint32_t RiskGate::registerOutcome(ConditionHandle condition) {
+    if (!counters(condition)) {
+        return NO_OUTCOME;
+    }
+    OutcomePositions& positions = positions_[condition];
+    if (positions.count >= MAX_OUTCOMES) {
+        LOG_ERROR("Risk gate condition {} already has {} outcomes, orders on another will be rejected",
+                  condition, MAX_OUTCOMES);
+        return NO_OUTCOME;
+    }
+    uint32_t outcome = positions.count++;
+
+    // A new, empty outcome breaks any complete sets held so far
+    Micros net;
+    Micros gross;
+    netExposure(positions, outcome, 0.0, 0.0, net, gross);
+    applyExposure(condition, net, gross);
+    return outcome;
+}
+
+RiskGate::Counters* RiskGate::counters(ConditionHandle condition) {
+    return (condition < condition_count_.load(std::memory_order_acquire)) ? &conditions_[condition] : nullptr;
+}
+
+void RiskGate::netExposure(const OutcomePositions& positions, uint32_t outcome, double shares, double avg_cost,
+                           Micros& net, Micros& gross) {
+    auto sharesOf = [&](uint32_t i) { return (i == outcome) ? shares : positions.shares[i]; };
+    auto costOf = [&](uint32_t i) { return (i == outcome) ? avg_cost : positions.avg_cost[i]; };
+
+    // Shares held in every outcome form complete sets and carry no risk
+    double sets = 0.0;
+    if (positions.count >= 2) {
+        double lowest = sharesOf(0);
+        double highest = lowest;
+        for (uint32_t i = 1; i < positions.count; i++) {
+            lowest = std::min(lowest, sharesOf(i));
+            highest = std::max(highest, sharesOf(i));
+        }
+        sets = (lowest > 0.0) ? lowest : (highest < 0.0) ? highest : 0.0;
+    }
+
+    double net_dollars = 0.0;
+    double gross_dollars = 0.0;
+    for (uint32_t i = 0; i < positions.count; i++) {
+        double notional = (sharesOf(i) - sets) * costOf(i);
+        net_dollars += notional;
+        gross_dollars += std::abs(notional);
+    }
+    net = toMicros(net_dollars);
+    gross = toMicros(gross_dollars);
+}
+
+void RiskGate::applyExposure(ConditionHandle condition, Micros net, Micros gross) {
+    OutcomePositions& positions = positions_[condition];
+    Micros net_delta = net - positions.net;
+    Micros gross_delta = gross - positions.gross;
+    positions.net = net;
+    positions.gross = gross;
+    for (Counters* c : {&conditions_[condition], &total_}) {
+        c->net.fetch_add(net_delta, std::memory_order_relaxed);
+        c->gross.fetch_add(gross_delta, std::memory_order_relaxed);
+    }
+}
+
+RiskCheck RiskGate::checkExposure(const Counters& counters, Side side, Micros net_change, Micros gross_change,
+                                  Micros max_net, Micros max_gross, RiskCheck net_breach, RiskCheck gross_breach) {
+    Micros net = counters.net.load(std::memory_order_relaxed);
+    Micros working_buy = counters.working_buy.load(std::memory_order_relaxed);
+    Micros working_sell = counters.working_sell.load(std::memory_order_relaxed);
+
+    // Worst case: every working order on this side fills along with the new one
+    Micros projected = net + net_change + ((side == Side::BUY) ? working_buy : -working_sell);
+    if (std::llabs(projected) <= std::llabs(net)) {
+        return RiskCheck::OK;  // Reduces exposure
+    }
+    if (std::llabs(projected) > max_net) {
+        return net_breach;
+    }
+
+    Micros gross = counters.gross.load(std::memory_order_relaxed);
+    if (gross + working_buy + working_sell + gross_change > max_gross) {
+        return gross_breach;
+    }
+    return RiskCheck::OK;
+}
+
+RiskCheck RiskGate::checkOrder(ConditionHandle condition, uint32_t outcome, Side side, Price price, Size size) {
+    if (killed()) {
+        return RiskCheck::KILL_SWITCH;
+    }
+
+    const Counters* per_condition = counters(condition);
+    if (!per_condition || outcome >= positions_[condition].count) {
+        return RiskCheck::UNREGISTERED;
+    }
+
+    Micros notional = toMicros(price * size);
+    if (notional > micros_.order_notional) {
+        return RiskCheck::ORDER_NOTIONAL;
+    }
+
+    // How the condition's netted exposure moves if this order fills
+    const OutcomePositions& current = positions_[condition];
+    double shares = current.shares[outcome];
+    double avg_cost = current.avg_cost[outcome];
+    applyFill(shares, avg_cost, (side == Side::BUY) ? size : -size, price);
+    Micros net;
+    Micros gross;
+    netExposure(current, outcome, shares, avg_cost, net, gross);
+    Micros net_change = net - current.net;
+    Micros gross_change = gross - current.gross;
+
+    RiskCheck check = checkExposure(*per_condition, side, net_change, gross_change, micros_.condition_net,
+                                    micros_.condition_gross, RiskCheck::CONDITION_NET, RiskCheck::CONDITION_GROSS);
+    if (check != RiskCheck::OK) {
+        return check;
+    }
+
+    check = checkExposure(total_, side, net_change, gross_change, micros_.net, micros_.gross,
+                          RiskCheck::NET_EXPOSURE, RiskCheck::GROSS_EXPOSURE);
+    if (check != RiskCheck::OK) {
+        return check;
+    }
+
+    return takeRateToken() ? RiskCheck::OK : RiskCheck::RATE_LIMIT;
+}
+
+bool RiskGate::takeRateToken() {
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    int64_t next = next_order_ns_.load(std::memory_order_relaxed);
+    while (true) {
+        int64_t base = std::max(next, now);
+        if (base - now > burst_tolerance_ns_) {
+            return false;
+        }
+        if (next_order_ns_.compare_exchange_weak(next, base + order_interval_ns_, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+void RiskGate::onOrderOpened(ConditionHandle condition, Side side, double notional) {
+    Micros micros = toMicros(notional);
+    auto add = [&](Counters& c) {
+        (side == Side::BUY ? c.working_buy : c.working_sell).fetch_add(micros, std::memory_order_relaxed);
+    };
+    add(total_);
+    if (Counters* per_condition = counters(condition)) {
+        add(*per_condition);
+    }
+}
+
+void RiskGate::onOrderClosed(ConditionHandle condition, Side side, double notional) {
+    Micros micros = toMicros(notional);
+    auto release = [&](Counters& c) {
+        (side == Side::BUY ? c.working_buy : c.working_sell).fetch_sub(micros, std::memory_order_relaxed);
+    };
+    release(total_);
+    if (Counters* per_condition = counters(condition)) {
+        release(*per_condition);
+    }
+}
+
+void RiskGate::onPositionChanged(ConditionHandle condition, uint32_t outcome, Size shares, Price avg_cost) {
+    if (!counters(condition) || outcome >= positions_[condition].count) {
+        return;
+    }
+    OutcomePositions& positions = positions_[condition];
+    positions.shares[outcome] = shares;
+    positions.avg_cost[outcome] = avg_cost;
+
+    Micros net;
+    Micros gross;
+    netExposure(positions, outcome, shares, avg_cost, net, gross);
+    applyExposure(condition, net, gross);
+}
+
+void RiskGate::onUnregisteredPositionChanged(double old_notional, double new_notional) {
+    total_.net.fetch_add(toMicros(new_notional) - toMicros(old_notional), std::memory_order_relaxed);
+    total_.gross.fetch_add(toMicros(std::abs(new_notional)) - toMicros(std::abs(old_notional)),
+                           std::memory_order_relaxed);
+}
+
+bool RiskGate::kill() {
+    bool was_killed = killed_.exchange(true, std::memory_order_acq_rel);
+    if (!was_killed) {
+        LOG_WARN("Risk gate kill switch triggered, blocking all orders");
+    }
+    return !was_killed;
+}
+
+RiskExposure RiskGate::toExposure(const Counters& counters) {
+    RiskExposure exposure;
+    exposure.net = counters.net.load(std::memory_order_relaxed) / MICROS_PER_DOLLAR;
+    exposure.gross = counters.gross.load(std::memory_order_relaxed) / MICROS_PER_DOLLAR;
+    exposure.working_buy = counters.working_buy.load(std::memory_order_relaxed) / MICROS_PER_DOLLAR;
+    exposure.working_sell = counters.working_sell.load(std::memory_order_relaxed) / MICROS_PER_DOLLAR;
+    return exposure;
+}
+
+RiskExposure RiskGate::conditionExposure(ConditionHandle condition) const {
+    return (condition < condition_count_.load(std::memory_order_acquire)) ? toExposure(conditions_[condition])
+                                                                          : RiskExposure{};
+}
+
+RiskExposure RiskGate::totalExposure() const {
+    return toExposure(total_);
+}
+
+} // namespace pmm
@@ -1,20 +1,25 @@
 #include "strategy/strategy_engine.hpp"
 #include "utils/logger.hpp"
 #include <iostream>
-#include <unordered_set>
 #include <algorithm>
 
 namespace pmm {
 
-StrategyEngine::StrategyEngine(EventQueue& queue, TradingMode mode)
+StrategyEngine::StrategyEngine(EventQueue& queue, TradingMode mode, RiskLimits risk_limits,
+                               JournalFormat journal_format)
     : event_queue_(queue),
     state_persistence_(std::make_unique<StatePersistence>("./state.json")),
-    trading_logger_(std::make_unique<TradingLogger>("./logs")),
+    trading_logger_(std::make_unique<TradingLogger>("./logs", journal_format)),
     market_summary_logger_(nullptr),  // Initialized in startLogging
+    journal_format_(journal_format),
     as_manager_(std::make_unique<AdverseSelectionManager>(0.02)),
+    risk_gate_(risk_limits),
     order_manager_(queue, mode, trading_logger_.get()),
     running_(false) {
     LOG_INFO("StrategyEngine initialized");
+    order_manager_.setRiskGate(&risk_gate_);
+    markouts_.onMarkout([this](const MarkoutRecord& fill, size_t horizon) { onFillMarkout(fill, horizon); });
+    markouts_.onCompletion([this](const MarkoutRecord& fill) { onFillMarkoutsComplete(fill); });
     
     // Load previous state if available
     LOG_INFO("Attempting to load previous trading state...");
@@ -22,30 +27,38 @@ StrategyEngine::StrategyEngine(EventQueue& queue, TradingMode mode)
     
     if (!loaded_state.positions.empty()) {
         LOG_INFO("Restoring {} positions from previous session", loaded_state.positions.size());
-        std::lock_guard<std::mutex> lock(positions_mutex_);
         
         auto now = std::chrono::system_clock::now();
         
+        auto& cols = slots_.columns();
+        
         for (const auto& [token_id, pos_state] : loaded_state.positions) {
-            Position pos;
-            pos.quantity = pos_state.quantity;
-            pos.avg_entry_price = pos_state.avg_cost;
-            pos.realized_pnl = pos_state.realized_pnl;
+            TokenHandle handle = slots_.findOrCreate(token_id);
+            cols.quantity[handle] = pos_state.quantity;
+            cols.avg_entry_price[handle] = pos_state.avg_cost;
+            cols.realized_pnl[handle] = pos_state.realized_pnl;
+            
+            PositionDetails pos;
             // Initialize timestamps for restored positions (we don't persist these)
             pos.opened_at = now;
             pos.last_updated = now;
             pos.entry_side = (pos_state.quantity > 0) ? Side::BUY : Side::SELL;
             pos.num_fills = 0;  // Reset for restored positions
-            positions_[token_id] = pos;
+            slots_[handle].position = pos;
+            
+            // Counted in the portfolio now, moved to its condition once registered
+            risk_gate_.onUnregisteredPositionChanged(0.0, pos_state.quantity * pos_state.avg_cost);
             
             LOG_INFO("  Restored position: {} | Qty: {:.2f} @ {:.3f} | Realized PnL: ${:.2f}",
-                     token_id, pos.quantity, pos.avg_entry_price, pos.realized_pnl);
+                     token_id, cols.quantity[handle], cols.avg_entry_price[handle], cols.realized_pnl[handle]);
         }
         
         LOG_INFO("Total realized PnL from previous sessions: ${:.2f}", loaded_state.total_realized_pnl);
     } else {
         LOG_INFO("No previous positions to restore - starting fresh");
     }
+    
+    publishStats();
 }
 
 StrategyEngine::~StrategyEngine() {
@@ -53,7 +66,7 @@ StrategyEngine::~StrategyEngine() {
 }
 
 void StrategyEngine::start() {
-    if (running_.load()) {
+    if (strategy_thread_.joinable()) {
         LOG_INFO("StrategyEngine already running");
         return;
     }
@@ -64,7 +77,7 @@ void StrategyEngine::start() {
 }
 
 void StrategyEngine::stop() {
-    if (!running_.load()) {
+    if (!strategy_thread_.joinable()) {
         return;
     }
     
@@ -72,75 +85,107 @@ void StrategyEngine::stop() {
     running_.store(false);
     
     event_queue_.push(Event::shutdown("Strategy shutdown"));
+    strategy_thread_.join();
     
-    if (strategy_thread_.joinable()) {
-        strategy_thread_.join();
-    }
+    // Nothing else touches engine state now - apply anything posted during shutdown
+    applyPendingCommands();
     
     LOG_INFO("StrategyEngine stopped");
 }
 
+void StrategyEngine::post(std::function<void()> command) {
+    // Not running: the caller is the only thread touching engine state
+    if (!strategy_thread_.joinable()) {
+        command();
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(commands_mutex_);
+        pending_commands_.push_back(std::move(command));
+    }
+    has_pending_commands_.store(true, std::memory_order_release);
+    
+    // Wake the strategy thread so the command is applied promptly
+    event_queue_.push(Event::timerTick());
+}
+
+void StrategyEngine::applyPendingCommands() {
+    if (!has_pending_commands_.load(std::memory_order_acquire)) {
+        return;
+    }
+    
+    std::vector<std::function<void()>> commands;
+    {
+        std::lock_guard<std::mutex> lock(commands_mutex_);
+        commands.swap(pending_commands_);
+        has_pending_commands_.store(false, std::memory_order_relaxed);
+    }
+    
+    for (auto& command : commands) {
+        command();
+    }
+}
+
 void StrategyEngine::run() {
     LOG_DEBUG("StrategyEngine event loop started");
     
     auto last_snapshot = std::chrono::steady_clock::now();
     auto last_quote_check = std::chrono::steady_clock::now();
-    auto last_summary_check = std::chrono::steady_clock::now();
+    auto last_stats = std::chrono::steady_clock::now();
+    Event event = Event::timerTick();
 
     while (running_.load()) {
-        Event event = event_queue_.pop();
-  
-        switch (event.type) {
-            case EventType::BOOK_SNAPSHOT:
-                handleBookSnapshot(event);
-                break;
-                
-            case EventType::PRICE_LEVEL_UPDATE:
-                handlePriceUpdate(event);
-                break;
-                
-            case EventType::ORDER_FILL:
-                handleOrderFill(event);
-                break;
-                
-            case EventType::ORDER_REJECTED:
-                handleOrderRejected(event);
-                break;
-                
-            case EventType::TIMER_TICK:
-                // Check for expired quotes on timer tick
-                checkExpiredQuotes();
-                break;
-                
-            case EventType::SHUTDOWN:
-                LOG_DEBUG("Received shutdown event");
-                running_.store(false);
-                break;
-                
-            default:
-                LOG_WARN("Unknown event type");
-                break;
+        // Wait no longer than the next markout, the once-a-second checks or
+        // a pending stats snapshot, so a quiet queue doesn't delay any of them
+        auto now = std::chrono::steady_clock::now();
+        auto deadline = last_quote_check + std::chrono::seconds(1);
+        if (stats_dirty_) {
+            deadline = std::min(deadline, last_stats + STATS_INTERVAL);
+        }
+        auto markout_due = markouts_.nextDue();
+        if (markout_due != std::chrono::system_clock::time_point::max()) {
+            auto until_due = markout_due - std::chrono::system_clock::now();
+            deadline = std::min(deadline, now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(until_due));
+        }
+        
+        if (event_queue_.popUntil(event, deadline)) {
+            applyPendingCommands();
+            dispatchEvent(event);
+            
+            // Drain what else is queued, up to a batch, before the timers get a
+            // turn; anything left is picked up on the next pass
+            size_t drained = 1;
+            while (drained < MAX_DRAIN_BATCH && running_.load() && event_queue_.tryPop(event)) {
+                applyPendingCommands();
+                dispatchEvent(event);
+                drained++;
+            }
+            
+            drain_cycles_++;
+            stats_dirty_ = true;
         }
+        
+        // Markouts are captured as they come due, not on the 1s check
+        captureFillMarkouts();
 
-        auto now = std::chrono::steady_clock::now();
+        now = std::chrono::steady_clock::now();
         
-        // Check expired quotes every second
-        if (now - last_quote_check > std::chrono::seconds(1)) {
-            checkExpiredQuotes();
-            last_quote_check = now;
+        if (stats_dirty_ && now - last_stats >= STATS_INTERVAL) {
+            publishStats();
+            stats_dirty_ = false;
+            last_stats = now;
         }
         
-        // Check if we should log market summaries (adaptive interval)
-        if (market_summary_logger_ && (now - last_summary_check > std::chrono::seconds(5))) {
-            if (market_summary_logger_->shouldLogSummary()) {
-                market_summary_logger_->logSummaries();
-            }
-            last_summary_check = now;
+        if (now - last_quote_check >= std::chrono::seconds(1)) {
+            as_manager_->advance(now);  // Before requoting, so quiet tokens narrow
+            checkExpiredQuotes();
+            stats_dirty_ = true;
+            last_quote_check = now;
         }
         
         if (now - last_snapshot > std::chrono::seconds(60)) {
             snapshotPositions();
-            checkPendingFillMetrics();
             logQuoteSummary();
             as_manager_->decay();  // Decay adverse selection adjustments
             last_snapshot = now;
@@ -150,23 +195,117 @@ void StrategyEngine::run() {
     LOG_INFO("StrategyEngine event loop exited");
 }
 
+void StrategyEngine::dispatchEvent(const Event& event) {
+    switch (event.type) {
+        case EventType::BOOK_SNAPSHOT:
+            handleBookSnapshot(event);
+            break;
+            
+        case EventType::PRICE_LEVEL_UPDATE:
+            handlePriceUpdate(event);
+            break;
+            
+        case EventType::TRADE:
+            handleTrade(event);
+            break;
+            
+        case EventType::ORDER_FILL:
+            handleOrderFill(event);
+            break;
+            
+        case EventType::ORDER_REJECTED:
+            handleOrderRejected(event);
+            break;
+            
+        case EventType::ORDER_ACKED: {
+            auto& payload = std::get<OrderAckedPayload>(event.payload);
+            order_manager_.onOrderAcked(payload.order_id, payload.exchange_order_id);
+            break;
+        }
+            
+        case EventType::ORDER_CANCELLED:
+            order_manager_.onOrderCancelled(std::get<OrderCancelledPayload>(event.payload).order_id);
+            break;
+            
+        case EventType::TIMER_TICK:
+            // Check for expired quotes on timer tick
+            checkExpiredQuotes();
+            break;
+            
+        case EventType::SHUTDOWN:
+            LOG_DEBUG("Received shutdown event");
+            running_.store(false);
+            break;
+            
+        default:
+            LOG_WARN("Unknown event type");
+            break;
+    }
+}
+
+void StrategyEngine::publishStats() {
+    const auto& cols = slots_.columns();
+    EngineStats stats;
+    
+    int spread_count = 0;
+    for (size_t h = 0; h < cols.quantity.size(); h++) {
+        double quantity = cols.quantity[h];
+        stats.realized_pnl += cols.realized_pnl[h];
+        stats.total_inventory += std::abs(quantity);
+        
+        if (cols.mid[h] > 0) {
+            stats.average_spread += cols.spread_pct[h];
+            spread_count++;
+        }
+        
+        if (std::abs(quantity) < 0.001) continue;
+        stats.position_count++;
+        if (cols.mid[h] > 0) {
+            stats.unrealized_pnl += quantity * (cols.mid[h] - cols.avg_entry_price[h]);
+        }
+    }
+    if (spread_count > 0) {
+        stats.average_spread /= spread_count;
+    }
+    
+    // Count unique markets (by market_id) that have orders on any token
+    market_active_scratch_.assign(market_indices_.size(), 0);
+    for (TokenHandle h = 0; h < slots_.size(); h++) {
+        const TokenSlot& slot = slots_[h];
+        if (slot.market_index == INVALID_MARKET_INDEX) continue;
+        if (market_active_scratch_[slot.market_index]) continue;
+        if (order_manager_.getOpenOrderCount(slot.token_id) > 0) {
+            market_active_scratch_[slot.market_index] = 1;
+            stats.active_market_count++;
+        }
+    }
+    
+    stats.active_order_count = order_manager_.getActiveOrderCount();
+    stats.bid_count = order_manager_.getBidCount();
+    stats.ask_count = order_manager_.getAskCount();
+    stats.fill_count = total_fills_;
+    stats.cycle = drain_cycles_;
+    
+    stats_.store(stats);
+}
+
 void StrategyEngine::handleBookSnapshot(const Event& event) {
     auto& payload = std::get<BookSnapshotPayload>(event.payload);
+    TokenHandle handle = getOrCreateSlot(payload.token_id);
+    TokenSlot& slot = slots_[handle];
 
     // Check if this is a token we registered
-    auto it = market_metadata_.find(payload.token_id);
-    bool is_registered = (it != market_metadata_.end());
+    bool is_registered = slot.metadata.has_value();
+    const std::string& market_name = slot.display_name;
     
-    std::string market_name = payload.token_id;
     if (is_registered) {
-        market_name = it->second.title + " - " + it->second.outcome;
         LOG_DEBUG("[REGISTERED] Book snapshot for {}: {} bids, {} asks", market_name, payload.bids.size(), payload.asks.size());
     } else {
         LOG_DEBUG("[UNREGISTERED] Book snapshot for token {}: {} bids, {} asks", payload.token_id.substr(0, 16), payload.bids.size(), payload.asks.size());
     }
     LOG_DEBUG("Book snapshot for {}: {} bids, {} asks", market_name, payload.bids.size(), payload.asks.size());
         
-    OrderBook& book = getOrCreateOrderBook(payload.token_id, market_name);
+    OrderBook& book = slot.book;
     book.clear();
     
     for (const auto& [price, size] : payload.bids) {
@@ -175,6 +314,8 @@ void StrategyEngine::handleBookSnapshot(const Event& event) {
     for (const auto& [price, size] : payload.asks) {
         book.updateAsk(price, size);
     }
+    slots_.refreshBookColumns(handle);
+    updateVolatility(handle);
     
     LOG_DEBUG("Order book updated: {} - Best bid: {}, Best ask: {}, Spread: {}", market_name,
               book.getBestBid(),
@@ -182,21 +323,17 @@ void StrategyEngine::handleBookSnapshot(const Event& event) {
               book.getSpread());
     
     // Log initial positions once we have market data for at least one position
-    if (!initial_positions_logged_.load() && !positions_.empty()) {
+    if (!initial_positions_logged_) {
         bool has_position_with_book = false;
-        {
-            std::lock_guard<std::mutex> lock(positions_mutex_);
-            for (const auto& [token_id, pos] : positions_) {
-                auto ob_it = order_books_.find(token_id);
-                if (ob_it != order_books_.end() && ob_it->second.hasValidBBO()) {
-                    has_position_with_book = true;
-                    break;
-                }
+        for (TokenHandle h = 0; h < slots_.size(); h++) {
+            if (slots_[h].position && slots_[h].book.hasValidBBO()) {
+                has_position_with_book = true;
+                break;
             }
         }
         
         if (has_position_with_book) {
-            initial_positions_logged_.store(true);
+            initial_positions_logged_ = true;
             logInitialPositions();
         }
     }
@@ -204,8 +341,8 @@ void StrategyEngine::handleBookSnapshot(const Event& event) {
     order_manager_.updateOrderBook(payload.token_id, book);
     
     // Only calculate quotes for registered (tradable) tokens
-    if (it != market_metadata_.end()) {
-        calculateQuotes(payload.token_id, market_name);
+    if (is_registered) {
+        calculateQuotes(handle);
     } else {
         LOG_DEBUG("Skipping quote calculation for unregistered token");
     }
@@ -213,32 +350,26 @@ void StrategyEngine::handleBookSnapshot(const Event& event) {
 
 void StrategyEngine::handlePriceUpdate(const Event& event) {
     auto& payload = std::get<PriceLevelUpdatePayload>(event.payload);
-    auto token_id = payload.token_id;
+    const TokenId& token_id = payload.token_id;
+    TokenHandle handle = getOrCreateSlot(token_id);
+    TokenSlot& slot = slots_[handle];
     
     // Check if this is a token we registered
-    auto metadata_it = market_metadata_.find(token_id);
-    bool is_registered = (metadata_it != market_metadata_.end());
+    const MarketMetadata* metadata = slot.metadata ? &*slot.metadata : nullptr;
+    bool is_registered = (metadata != nullptr);
+    const std::string& market_name = slot.display_name;
     
-    std::string market_name = token_id;
     if (is_registered) {
-        market_name = metadata_it->second.title + " - " + metadata_it->second.outcome;
         LOG_DEBUG("[REGISTERED] Price update for {}: {} bids, {} asks", market_name, payload.bids.size(), payload.asks.size());
     } else {
         LOG_DEBUG("[UNREGISTERED] Price update for token {}: {} bids, {} asks", token_id.substr(0, 16), payload.bids.size(), payload.asks.size());
     }
     LOG_DEBUG("Price update for {}: {} bids, {} asks", market_name, payload.bids.size(), payload.asks.size());
 
-    OrderBook& book = getOrCreateOrderBook(token_id, market_name);
+    OrderBook& book = slot.book;
     
     // Get previous state before updating
-    PriceUpdateHistory prev_state;
-    {
-        std::lock_guard<std::mutex> lock(price_history_mutex_);
-        auto it = price_history_.find(token_id);
-        if (it != price_history_.end()) {
-            prev_state = it->second;
-        }
-    }
+    PriceUpdateHistory prev_state = slot.history;
     
     for (const auto& [price, size] : payload.bids) {
         book.updateBid(price, size);
@@ -246,13 +377,14 @@ void StrategyEngine::handlePriceUpdate(const Event& event) {
     for (const auto& [price, size] : payload.asks) {
         book.updateAsk(price, size);
     }
+    slots_.refreshBookColumns(handle);
+    updateVolatility(handle);
     
     LOG_DEBUG("Price levels updated: {} - Best bid: {}, Best ask: {}", market_name,
               book.getBestBid(),
               book.getBestAsk());
-
-    // Update adverse selection metrics with current price
-    as_manager_->updateMetrics(token_id, book.getMid());
+    
+    order_manager_.updateOrderBook(token_id, book, payload.bids, payload.asks);
 
     // Calculate and log price update metrics
     if (book.hasValidBBO() && trading_logger_) {
@@ -284,26 +416,21 @@ void StrategyEngine::handlePriceUpdate(const Event& event) {
         int ask_levels = book.getAskLevelCount();
         
         // Get our inventory
-        double our_inventory = 0.0;
-        auto mm_it = market_makers_.find(token_id);
-        if (mm_it != market_makers_.end()) {
-            our_inventory = mm_it->second.getInventory();
-        }
+        double our_inventory = slot.maker ? slot.maker->getInventory() : 0.0;
         
         // Calculate time to event from stored event end time
         double time_to_event_hours = -1.0;  // -1 indicates unknown
-        auto metadata_it = market_metadata_.find(token_id);
-        if (metadata_it != market_metadata_.end() && metadata_it->second.has_end_time) {
-            auto time_remaining = metadata_it->second.event_end_time - std::chrono::system_clock::now();
+        if (metadata && metadata->has_end_time) {
+            auto time_remaining = metadata->event_end_time - std::chrono::system_clock::now();
             time_to_event_hours = std::chrono::duration<double, std::ratio<3600>>(time_remaining).count();
         }
         
         // Get market_id and condition_id from metadata, or "UNKNOWN" for unregistered tokens
-        std::string market_id = "UNKNOWN";
-        std::string condition_id = "UNKNOWN";
-        if (metadata_it != market_metadata_.end()) {
-            market_id = metadata_it->second.market_id;
-            condition_id = metadata_it->second.condition_id;
+        std::string_view market_id = "UNKNOWN";
+        std::string_view condition_id = "UNKNOWN";
+        if (metadata) {
+            market_id = metadata->market_id;
+            condition_id = metadata->condition_id;
         }
         
         // Log the price update
@@ -331,7 +458,7 @@ void StrategyEngine::handlePriceUpdate(const Event& event) {
         );
         
         // Update market summary logger if available
-        if (market_summary_logger_ && metadata_it != market_metadata_.end()) {
+        if (market_summary_logger_ && metadata) {
             market_summary_logger_->updateMarket(
                 market_name,
                 market_id,
@@ -344,44 +471,58 @@ void StrategyEngine::handlePriceUpdate(const Event& event) {
                 bid_volume,
                 ask_volume,
                 bid_levels,
-                ask_levels
+                ask_levels,
+                slot.volatility.estimates()
             );
         }
         
         // Update price history for next comparison
-        {
-            std::lock_guard<std::mutex> lock(price_history_mutex_);
-            PriceUpdateHistory& history = price_history_[token_id];
-            history.last_mid = current_mid;
-            history.last_bid_volume = bid_volume;
-            history.last_ask_volume = ask_volume;
-            history.last_update_time = now;
-        }
+        PriceUpdateHistory& history = slot.history;
+        history.last_mid = current_mid;
+        history.last_bid_volume = bid_volume;
+        history.last_ask_volume = ask_volume;
+        history.last_update_time = now;
     }
 
     // Only calculate quotes for registered (tradable) tokens
     if (is_registered) {
-        calculateQuotes(token_id, market_name);
+        calculateQuotes(handle);
     } else {
         LOG_DEBUG("Skipping quote calculation for unregistered token");
     }
 }
 
+void StrategyEngine::handleTrade(const Event& event) {
+    const auto& payload = std::get<TradePayload>(event.payload);
+    
+    // Only tokens we keep a book for
+    if (slots_.find(payload.token_id) == INVALID_TOKEN_HANDLE) {
+        return;
+    }
+    as_manager_->recordTrade(payload.token_id, payload.price, payload.size, payload.side);
+}
+
 void StrategyEngine::handleOrderFill(const Event& event) {
     auto& payload = std::get<OrderFillPayload>(event.payload);
-    auto market_name = market_metadata_.find(payload.token_id) != market_metadata_.end() ?
-                    market_metadata_[payload.token_id].title + " - " + market_metadata_[payload.token_id].outcome :
-                    payload.token_id;
+    TokenHandle handle = getOrCreateSlot(payload.token_id);
+    TokenSlot& slot = slots_[handle];
+    const std::string& market_name = slot.display_name;
     
-    LOG_INFO("FILL EVENT: {}", payload.order_id);
+    LOG_INFO("FILL EVENT: ORD_{}", payload.order_id);
     LOG_INFO("Market: {}", market_name);
     LOG_INFO("Side: {}", (payload.side == Side::BUY ? "BUY" : "SELL"));
     LOG_INFO("Size: {} @ {}", payload.filled_size, payload.fill_price);
     
+    // Paper fills already left the working set when they were generated
+    if (!order_manager_.isPaperTrading()) {
+        order_manager_.onOrderFilled(payload.order_id, payload.filled_size);
+    }
+    
     // Capture market context at fill time
-    auto ob_it = order_books_.find(payload.token_id);
-    if (ob_it != order_books_.end()) {
-        const auto& book = ob_it->second;
+    const OrderBook& book = slot.book;
+    bool has_book = book.hasValidBBO();
+    MarkoutRecord* record = nullptr;
+    if (has_book) {
         double spread_bps = (book.getSpread() / book.getMid()) * 10000;
         double imbalance = book.getImbalance();
         
@@ -389,14 +530,14 @@ void StrategyEngine::handleOrderFill(const Event& event) {
                  spread_bps, imbalance, book.getMid());
         
         // Store fill metrics for adverse selection analysis
-        auto mm_it = market_makers_.find(payload.token_id);
-        double inventory_before = mm_it != market_makers_.end() ? mm_it->second.getInventory() : 0.0;
+        double inventory_before = slot.maker ? slot.maker->getInventory() : 0.0;
         
-        FillMetrics metrics;
-        metrics.fill_time = std::chrono::system_clock::now();
-        metrics.token_id = payload.token_id;
+        MarkoutRecord metrics;
+        metrics.fill_seq = total_fills_ + 1;
         metrics.order_id = payload.order_id;
+        metrics.token = handle;
         metrics.side = payload.side;
+        metrics.fill_time = std::chrono::system_clock::now();
         metrics.fill_price = payload.fill_price;
         metrics.mid_at_fill = book.getMid();
         metrics.best_bid_at_fill = book.getBestBid();
@@ -404,262 +545,347 @@ void StrategyEngine::handleOrderFill(const Event& event) {
         metrics.spread_at_fill = book.getSpread();
         metrics.imbalance_at_fill = imbalance;
         metrics.inventory_before = inventory_before;
-        
-        std::lock_guard<std::mutex> lock(fill_metrics_mutex_);
-        fill_history_.push_back(metrics);
+        metrics.inventory_after = inventory_before;
+        record = &markouts_.registerFill(metrics);
     }
 
-    total_fills_.fetch_add(1, std::memory_order_relaxed);
+    total_fills_++;
     
-    updatePosition(payload.token_id, payload.filled_size, payload.fill_price, payload.side);
+    updatePosition(handle, payload.filled_size, payload.fill_price, payload.side);
     
-    {
-        std::lock_guard<std::mutex> lock(positions_mutex_);
-        auto& pos = positions_[payload.token_id];
-        LOG_INFO("New position: {} @ avg {} | Realized PnL: ${}", pos.quantity, pos.avg_entry_price, pos.realized_pnl);
-    }
+    const auto& cols = slots_.columns();
+    LOG_INFO("New position: {} @ avg {} | Realized PnL: ${}", 
+             cols.quantity[handle], cols.avg_entry_price[handle], cols.realized_pnl[handle]);
     
-    auto mm_it = market_makers_.find(payload.token_id);
-    if (mm_it != market_makers_.end()) {
-        mm_it->second.updateInventory(
+    if (slot.maker) {
+        MarketMaker& mm = *slot.maker;
+        mm.updateInventory(
             payload.side,
             payload.filled_size,
             payload.fill_price
         );
         
         // Log PnL breakdown
-        auto ob_it = order_books_.find(payload.token_id);
-        if (ob_it != order_books_.end() && ob_it->second.getMid() > 0) {
-            double realized = mm_it->second.getRealizedPnL();
-            double unrealized = mm_it->second.getUnrealizedPnL(ob_it->second.getMid());
+        if (book.getMid() > 0) {
+            double realized = mm.getRealizedPnL();
+            double unrealized = mm.getUnrealizedPnL(book.getMid());
             LOG_INFO("  PnL: Realized: ${:.2f}, Unrealized: ${:.2f}, Total: ${:.2f}", 
                      realized, unrealized, realized + unrealized);
         }
         
         // Update fill metrics with inventory after
-        std::lock_guard<std::mutex> lock(fill_metrics_mutex_);
-        if (!fill_history_.empty()) {
-            fill_history_.back().inventory_after = mm_it->second.getInventory();
-        }
-        
-        // Record fill for adverse selection tracking
-        auto book_it = order_books_.find(payload.token_id);
-        if (book_it != order_books_.end()) {
-            as_manager_->recordFill(
-                payload.token_id,
-                payload.order_id,
-                payload.side,
-                payload.fill_price,
-                book_it->second.getMid(),
-                fill_history_.back().inventory_before
-            );
+        if (record) {
+            record->inventory_after = mm.getInventory();
+            
+            // Record fill for adverse selection tracking; its markout follows
+            as_manager_->recordFill(payload.token_id);
         }
     }
     
     if (trading_logger_) {
-        // Get quoted price from active_quotes if available
+        // Get quoted price from the active quote if available
         Price quoted_price = payload.fill_price;  // Default to fill price
         double seconds_to_fill = 0.0;
         
-        {
-            std::lock_guard<std::mutex> lock(quotes_mutex_);
-            auto quote_it = active_quotes_.find(payload.token_id);
-            if (quote_it != active_quotes_.end()) {
-                // Determine quoted price based on side
-                quoted_price = (payload.side == Side::BUY) ? 
-                              quote_it->second.bid_price : quote_it->second.ask_price;
-                
-                // Calculate time to fill
-                auto now = std::chrono::steady_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(
-                    now - quote_it->second.quote_created_at);
-                seconds_to_fill = duration.count();
-            }
+        if (slot.quote) {
+            // Determine quoted price based on side
+            quoted_price = (payload.side == Side::BUY) ? 
+                          slot.quote->bid_price : slot.quote->ask_price;
+            
+            // Calculate time to fill
+            auto now = std::chrono::steady_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(
+                now - slot.quote->quote_created_at);
+            seconds_to_fill = duration.count();
         }
         
         // Get mid price at fill from order book
-        Price mid_at_fill = 0.0;
-        auto book_it = order_books_.find(payload.token_id);
-        if (book_it != order_books_.end()) {
-            mid_at_fill = book_it->second.getMid();
-        }
+        Price mid_at_fill = book.getMid();
         
         trading_logger_->logOrderFilled(
             market_name,
             payload.order_id,
+            total_fills_,
             payload.token_id,
             payload.fill_price,
             payload.filled_size,
             payload.side,
-            mm_it->second.getRealizedPnL(),
+            slot.maker ? slot.maker->getRealizedPnL() : 0.0,
             quoted_price,
             mid_at_fill,
             seconds_to_fill
         );
         
         // Log position change after fill
-        std::lock_guard<std::mutex> lock(positions_mutex_);
-        auto& pos = positions_[payload.token_id];
-        double total_cost = pos.quantity * pos.avg_entry_price;
+        const PositionDetails& pos = *slot.position;
+        double total_cost = cols.quantity[handle] * cols.avg_entry_price[handle];
         
-        trading_logger_->logPosition(market_name, payload.token_id, pos.quantity,
-                                    pos.avg_entry_price, pos.opened_at, pos.last_updated,
+        trading_logger_->logPosition(market_name, payload.token_id, cols.quantity[handle],
+                                    cols.avg_entry_price[handle], pos.opened_at, pos.last_updated,
                                     pos.entry_side, pos.num_fills, total_cost);
     }
 
-    calculateQuotes(payload.token_id, market_name);
+    calculateQuotes(handle);
 }
 
 void StrategyEngine::handleOrderRejected(const Event& event) {
     auto& payload = std::get<OrderRejectedPayload>(event.payload);
-    LOG_ERROR("Order rejected: {} - Reason: {}", payload.order_id, payload.reason);
+    LOG_ERROR("Order rejected: ORD_{} - Reason: {}", payload.order_id, payload.reason);
     
-    // TODO: Handle rejection logic
+    // The next book update requotes the token if a placement was lost
+    order_manager_.onOrderRejected(payload.order_id, payload.request, payload.reason);
 }
 
-void StrategyEngine::calculateQuotes(const TokenId& token_id, 
-                                   const std::string& market_name,
-                                   CancelReason cancel_reason) {
-    auto it = order_books_.find(token_id);
-    if (it == order_books_.end()) {
-        LOG_ERROR("No order book found for token: {} , market: {}", token_id, market_name);
-        return;
-    }
+void StrategyEngine::updateVolatility(TokenHandle handle) {
+    TokenSlot& slot = slots_[handle];
+    if (!slot.book.hasValidBBO()) return;
     
-    const OrderBook& book = it->second;
+    slot.volatility.onMid(slot.book.getMid());
+    if (slot.maker) {
+        slot.maker->setVolatility(slot.volatility.quoteVolatility());
+    }
+}
+
+MarketMaker* StrategyEngine::quotableMaker(TokenHandle handle) {
+    TokenSlot& slot = slots_[handle];
+    const TokenId& token_id = slot.token_id;
+    const std::string& market_name = slot.display_name;
     
     // Check if this token has a market maker (i.e., it's tradable)
     // Don't auto-create market makers - only trade explicitly registered markets
-    auto mm_it = market_makers_.find(token_id);
-    bool is_tradable = (mm_it != market_makers_.end());
+    bool is_tradable = slot.maker.has_value();
     
-    if (!book.hasValidBBO()) {
+    if (!slot.book.hasValidBBO()) {
         // Only warn for tradable tokens - observation-only tokens (No side) may have incomplete books
         if (is_tradable) {
             LOG_WARN("No valid BBO for {}, skipping quote calculation", token_id);
         } else {
             LOG_DEBUG("Incomplete BBO for observation-only token {} ({})", market_name, token_id);
         }
-        return;
+        return nullptr;
     }
     
     // Skip quoting if this is an observation-only token (no market maker registered)
     if (!is_tradable) {
         LOG_DEBUG("Skipping quotes for observation-only token {} ({})", market_name, token_id);
-        return;
+        return nullptr;
     }
+    
+    MarketMaker& mm = *slot.maker;
 
     // Restore inventory from persisted state if available (only on first quote)
-    static std::unordered_set<TokenId> restored_markets;
-    if (restored_markets.find(token_id) == restored_markets.end()) {
-        std::lock_guard<std::mutex> lock(positions_mutex_);
-        auto pos_it = positions_.find(token_id);
-        if (pos_it != positions_.end() && std::abs(pos_it->second.quantity) > 0.001) {
-            mm_it->second.restoreState(
-                pos_it->second.quantity,
-                pos_it->second.avg_entry_price,
-                pos_it->second.realized_pnl
+    if (!slot.inventory_restored) {
+        const auto& cols = slots_.columns();
+        if (slot.position && std::abs(cols.quantity[handle]) > 0.001) {
+            mm.restoreState(
+                cols.quantity[handle],
+                cols.avg_entry_price[handle],
+                cols.realized_pnl[handle]
             );
             LOG_DEBUG("Restored MarketMaker inventory for token: {}", token_id);
         }
-        restored_markets.insert(token_id);
+        slot.inventory_restored = true;
+    }
+    return &mm;
+}
+
+bool StrategyEngine::quotedByCondition(TokenHandle handle) const {
+    const TokenSlot& slot = slots_[handle];
+    return slot.condition_index != INVALID_CONDITION_INDEX && condition_quoters_[slot.condition_index].size() > 1;
+}
+
+double StrategyEngine::spreadMultiplier(TokenHandle handle, double inventory) {
+    return as_manager_->getWorstSpreadMultiplier(slots_[handle].token_id, inventory);
+}
+
+void StrategyEngine::calculateQuotes(TokenHandle handle, CancelReason cancel_reason) {
+    MarketMaker* mm = quotableMaker(handle);
+    if (!mm) {
+        return;
+    }
+    TokenSlot& slot = slots_[handle];
+    
+    // Outcomes of a condition we trade more than one side of are quoted together
+    if (quotedByCondition(handle)) {
+        if (quoteCondition(slot.condition_index, cancel_reason)) {
+            return;
+        }
+        LOG_DEBUG("[{}] Sibling books incomplete, quoting outcome alone", slot.display_name);
     }
     
     // Get adverse selection spread multiplier
-    double inventory = mm_it->second.getInventory();
-    double bid_multiplier = as_manager_->getSpreadMultiplier(token_id, Side::BUY, inventory);
-    double ask_multiplier = as_manager_->getSpreadMultiplier(token_id, Side::SELL, inventory);
-    double spread_multiplier = std::max(bid_multiplier, ask_multiplier);  // Use worst case
+    double spread_multiplier = spreadMultiplier(handle, mm->getInventory());
     
     // Get market metadata for TTL calculation
-    const MarketMetadata* metadata = nullptr;
-    auto metadata_it = market_metadata_.find(token_id);
-    if (metadata_it != market_metadata_.end()) {
-        metadata = &metadata_it->second;
-    }
+    const MarketMetadata* metadata = slot.metadata ? &*slot.metadata : nullptr;
     
-    auto quote_opt = mm_it->second.generateQuote(book, metadata, spread_multiplier);
+    auto quote_opt = mm->generateQuote(slot.book, metadata, spread_multiplier);
     
     if (quote_opt.has_value()) {
-        const Quote& quote = quote_opt.value();
-        auto existing_orders = order_manager_.getOpenOrders(token_id);
-        
-        bool has_matching_bid = false;
-        bool has_matching_ask = false;
-        
-        for (const auto& order : existing_orders) {
-            if (order.side == Side::BUY && std::abs(order.price - quote.bid_price) < 0.001) {
-                has_matching_bid = true;
-            }
-            if (order.side == Side::SELL && std::abs(order.price - quote.ask_price) < 0.001) {
-                has_matching_ask = true;
-            }
+        applyQuote(handle, quote_opt.value(), cancel_reason);
+    }
+}
+
+bool StrategyEngine::quoteCondition(uint32_t condition_index, CancelReason cancel_reason) {
+    ConditionQuoter& quoter = condition_quoters_[condition_index];
+    
+    // Each outcome starts from what its own MarketMaker would quote from
+    QuoteInputs inputs;
+    for (size_t i = 0; i < quoter.size(); i++) {
+        TokenHandle h = quoter.token(i);
+        if (!slots_[h].book.hasValidBBO()) {
+            return false;
         }
-        
-        // Always update active_quotes_ with current state (prices, inventory, and TTL)
-        {
-            std::lock_guard<std::mutex> lock(quotes_mutex_);
-            QuoteSummary summary;
-            summary.market_name = market_name;
-            summary.bid_price = quote.bid_price;
-            summary.ask_price = quote.ask_price;
-            summary.mid = book.getMid();
-            summary.spread_bps = (quote.ask_price - quote.bid_price) / book.getMid() * 10000;
-            summary.inventory = mm_it->second.getInventory();
-            summary.last_update = std::chrono::steady_clock::now();
-            summary.quote_created_at = quote.created_at;
-            summary.ttl_seconds = quote.ttl_seconds;
-            active_quotes_[token_id] = summary;
+        MarketMaker* mm = quotableMaker(h);
+        if (!mm) {
+            return false;
         }
-        
-        if (has_matching_bid && has_matching_ask) {
-            return;
+        const TokenSlot& outcome = slots_[h];
+        const MarketMetadata* metadata = outcome.metadata ? &*outcome.metadata : nullptr;
+        mm->prepareQuote(outcome.book, metadata, spreadMultiplier(h, mm->getInventory()), inputs);
+        quoter.setInputs(i, inputs);
+    }
+    
+    if (!quoter.quote()) {
+        return false;
+    }
+    LOG_DEBUG("Condition quote: {} outcomes, inventory risk ${:.2f}", quoter.size(), quoter.inventoryRisk());
+    
+    auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < quoter.size(); i++) {
+        Quote quote{quoter.bidPrice(i), quoter.bidSize(i), quoter.askPrice(i), quoter.askSize(i),
+                    quoter.ttlSeconds(i), now};
+        applyQuote(quoter.token(i), quote, cancel_reason);
+    }
+    return true;
+}
+
+void StrategyEngine::applyQuote(TokenHandle handle, const Quote& quote, CancelReason cancel_reason) {
+    TokenSlot& slot = slots_[handle];
+    const TokenId& token_id = slot.token_id;
+    const std::string& market_name = slot.display_name;
+    const OrderBook& book = slot.book;
+    
+    // A side with size 0 should have no order at all
+    bool has_bid_order = false;
+    bool has_ask_order = false;
+    bool has_matching_bid = false;
+    bool has_matching_ask = false;
+    
+    for (const auto& order : order_manager_.getOpenOrders(token_id)) {
+        if (order.status != OrderStatus::OPEN) {
+            continue;  // Live cancel in flight
+        }
+        if (order.side == Side::BUY) {
+            has_bid_order = true;
+            has_matching_bid |= std::abs(order.price - quote.bid_price) < 0.001;
+        } else {
+            has_ask_order = true;
+            has_matching_ask |= std::abs(order.price - quote.ask_price) < 0.001;
+        }
+    }
+    bool bid_current = (quote.bid_size > 0.0) ? has_matching_bid : !has_bid_order;
+    bool ask_current = (quote.ask_size > 0.0) ? has_matching_ask : !has_ask_order;
+    
+    // Always update the active quote with current state (prices, inventory, and TTL)
+    QuoteSummary summary;
+    summary.bid_price = quote.bid_price;
+    summary.ask_price = quote.ask_price;
+    summary.mid = book.getMid();
+    summary.spread_bps = (quote.ask_price - quote.bid_price) / book.getMid() * 10000;
+    summary.inventory = slot.maker ? slot.maker->getInventory() : slots_.columns().quantity[handle];
+    summary.last_update = std::chrono::steady_clock::now();
+    summary.quote_created_at = quote.created_at;
+    summary.ttl_seconds = quote.ttl_seconds;
+    slot.quote = summary;
+    
+    if (bid_current && ask_current) {
+        return;
+    }
+    LOG_DEBUG("[{}] Bid {} x {} / Ask {} x {}", market_name, quote.bid_price, quote.bid_size, quote.ask_price, quote.ask_size);
+    
+    order_manager_.cancelAllOrders(token_id, market_name, cancel_reason);
+    
+    // Checked after the cancels so the replaced orders no longer count as working
+    if (quote.bid_size > 0.0) {
+        RiskCheck bid_check = risk_gate_.checkOrder(slot.risk_condition, slot.risk_outcome, Side::BUY,
+                                                    quote.bid_price, quote.bid_size);
+        if (bid_check == RiskCheck::OK) {
+            order_manager_.placeOrder(token_id, Side::BUY, quote.bid_price, quote.bid_size, market_name, &book);
+        } else {
+            LOG_WARN("[{}] Bid blocked by risk gate: {}", market_name, toString(bid_check));
+        }
+    }
+    if (quote.ask_size > 0.0) {
+        RiskCheck ask_check = risk_gate_.checkOrder(slot.risk_condition, slot.risk_outcome, Side::SELL,
+                                                    quote.ask_price, quote.ask_size);
+        if (ask_check == RiskCheck::OK) {
+            order_manager_.placeOrder(token_id, Side::SELL, quote.ask_price, quote.ask_size, market_name, &book);
+        } else {
+            LOG_WARN("[{}] Ask blocked by risk gate: {}", market_name, toString(ask_check));
         }
-        LOG_DEBUG("[{}] Bid {} x {} / Ask {} x {}", market_name, quote.bid_price, quote.bid_size, quote.ask_price, quote.ask_size);
-        
-        order_manager_.cancelAllOrders(token_id, market_name, cancel_reason);
-        
-        order_manager_.placeOrder(token_id, Side::BUY, quote.bid_price, quote.bid_size, market_name);
-        order_manager_.placeOrder(token_id, Side::SELL, quote.ask_price, quote.ask_size, market_name);
     }
 }
 
 void StrategyEngine::checkExpiredQuotes() {
-    std::vector<TokenId> expired_tokens;
-    
-    {
-        std::lock_guard<std::mutex> lock(quotes_mutex_);
-        for (const auto& [token_id, quote_summary] : active_quotes_) {
-            if (quote_summary.isExpired()) {
-                expired_tokens.push_back(token_id);
+    // Requote expired markets, single outcomes in one batch; conditions go
+    // through ConditionQuoter, which the batch kernel doesn't cover
+    quote_batch_.clear();
+    batch_handles_.clear();
+    condition_requoted_scratch_.assign(condition_quoters_.size(), 0);
+    for (TokenHandle handle = 0; handle < slots_.size(); handle++) {
+        TokenSlot& slot = slots_[handle];
+        if (!slot.quote || !slot.quote->isExpired() || !slot.book.hasValidBBO()) {
+            continue;
+        }
+        
+        MarketMaker* mm = quotableMaker(handle);
+        if (!mm) {
+            continue;
+        }
+        if (quotedByCondition(handle)) {
+            // One requote covers every outcome of the condition
+            char& requoted = condition_requoted_scratch_[slot.condition_index];
+            if (requoted) {
+                continue;
+            }
+            LOG_DEBUG("Quote expired for {}, requoting its condition...", slot.display_name);
+            if (quoteCondition(slot.condition_index, CancelReason::TTL_EXPIRED)) {
+                requoted = 1;
+                continue;
             }
+            // Sibling books incomplete: requote this outcome alone below
         }
+        LOG_DEBUG("Quote expired for {}, requoting...", slot.display_name);
+        
+        QuoteInputs inputs;
+        const MarketMetadata* metadata = slot.metadata ? &*slot.metadata : nullptr;
+        mm->prepareQuote(slot.book, metadata, spreadMultiplier(handle, mm->getInventory()), inputs);
+        quote_batch_.add(inputs);
+        batch_handles_.push_back(handle);
+    }
+    if (batch_handles_.empty()) {
+        return;
     }
     
-    // Requote expired markets
-    for (const auto& token_id : expired_tokens) {
-        auto it = order_books_.find(token_id);
-        if (it != order_books_.end() && it->second.hasValidBBO()) {
-            std::string market_name = token_id;
-            auto metadata_it = market_metadata_.find(token_id);
-            if (metadata_it != market_metadata_.end()) {
-                market_name = metadata_it->second.title + " - " + metadata_it->second.outcome;
-            }
-            
-            LOG_DEBUG("Quote expired for {}, requoting...", market_name);
-            calculateQuotes(token_id, market_name, CancelReason::TTL_EXPIRED);
+    quoteBatch(quote_batch_);
+    auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < batch_handles_.size(); i++) {
+        if (quote_batch_.valid(i)) {
+            Quote quote = quote_batch_.quote(i);
+            quote.created_at = now;
+            applyQuote(batch_handles_[i], quote, CancelReason::TTL_EXPIRED);
         }
     }
 }
 
-OrderBook& StrategyEngine::getOrCreateOrderBook(const TokenId& token_id, const std::string& market_name) {
-    auto it = order_books_.find(token_id);
-    if (it == order_books_.end()) {
-        LOG_DEBUG("Creating new order book for token: {}", market_name);
-        auto result = order_books_.emplace(token_id, OrderBook(token_id));
-        return result.first->second;
-    }
-    return it->second;
+TokenHandle StrategyEngine::getOrCreateSlot(const TokenId& token_id) {
+    TokenHandle handle = slots_.find(token_id);
+    if (handle == INVALID_TOKEN_HANDLE) {
+        LOG_DEBUG("Creating new order book for token: {}", token_id);
+        handle = slots_.findOrCreate(token_id);
+    }
+    return handle;
 }
 
 void StrategyEngine::registerMarket(const TokenId& token_id, 
@@ -667,15 +893,29 @@ void StrategyEngine::registerMarket(const TokenId& token_id,
                                     const std::string& outcome,
                                     const std::string& market_id,
                                     const std::string& condition_id) {
-    // Store metadata
-    registerMarketMetadata(token_id, title, outcome, market_id, condition_id);
-    
-    // Create market maker for this token (makes it tradable)
-    auto it = market_makers_.find(token_id);
-    if (it == market_makers_.end()) {
-        market_makers_.emplace(token_id, MarketMaker());
-        LOG_DEBUG("Created market maker for: {} - {}", title, outcome);
-    }
+    post([this, token_id, title, outcome, market_id, condition_id]() {
+        // Store metadata
+        applyRegisterMarketMetadata(token_id, title, outcome, market_id, condition_id);
+        
+        // Create market maker for this token (makes it tradable)
+        TokenHandle handle = getOrCreateSlot(token_id);
+        TokenSlot& slot = slots_[handle];
+        if (!slot.maker) {
+            slot.maker.emplace();
+            LOG_DEBUG("Created market maker for: {} - {}", title, outcome);
+        }
+        
+        // Group tradable outcomes of the same condition
+        if (slot.condition_index == INVALID_CONDITION_INDEX) {
+            auto index = static_cast<uint32_t>(condition_quoters_.size());
+            auto it = condition_indices_.try_emplace(condition_id, index).first;
+            if (it->second == index) {
+                condition_quoters_.emplace_back();
+            }
+            slot.condition_index = it->second;
+            condition_quoters_[it->second].addOutcome(handle);
+        }
+    });
 }
 
 void StrategyEngine::registerMarketMetadata(const TokenId& token_id,
@@ -683,28 +923,106 @@ void StrategyEngine::registerMarketMetadata(const TokenId& token_id,
                                            const std::string& outcome,
                                            const std::string& market_id,
                                            const std::string& condition_id) {
+    post([this, token_id, title, outcome, market_id, condition_id]() {
+        applyRegisterMarketMetadata(token_id, title, outcome, market_id, condition_id);
+    });
+}
+
+void StrategyEngine::setEventEndTime(const std::string& condition_id, 
+                                    const std::chrono::system_clock::time_point& end_time) {
+    post([this, condition_id, end_time]() {
+        applyEventEndTime(condition_id, end_time);
+    });
+}
+
+void StrategyEngine::setFairValueModel(const std::string& market_id, FairValueModel model) {
+    post([this, market_id, model]() {
+        for (TokenHandle h = 0; h < slots_.size(); h++) {
+            TokenSlot& slot = slots_[h];
+            if (slot.metadata && slot.metadata->market_id == market_id) {
+                slot.metadata->fair_value_model = model;
+            }
+        }
+    });
+}
+
+void StrategyEngine::setOrderGateway(OrderGateway* gateway) {
+    post([this, gateway]() {
+        order_manager_.setOrderGateway(gateway);
+    });
+}
+
+void StrategyEngine::triggerKillSwitch() {
+    // The gate blocks new orders immediately; working ones are cancelled on the strategy thread
+    if (risk_gate_.kill()) {
+        post([this]() {
+            order_manager_.cancelAllOrders(CancelReason::SHUTDOWN);
+        });
+    }
+}
+
+void StrategyEngine::startLogging(const std::string& event_name) {
+    post([this, event_name]() {
+        applyStartLogging(event_name);
+    });
+}
+
+void StrategyEngine::applyRegisterMarketMetadata(const TokenId& token_id,
+                                                 const std::string& title,
+                                                 const std::string& outcome,
+                                                 const std::string& market_id,
+                                                 const std::string& condition_id) {
     MarketMetadata metadata;
     metadata.title = title;
     metadata.outcome = outcome;
     metadata.market_id = market_id;
     metadata.condition_id = condition_id;
     metadata.has_end_time = false;
-    market_metadata_[token_id] = metadata;
+    
+    // Display name is built once here and referenced by every handler and logger
+    TokenSlot& slot = slots_[getOrCreateSlot(token_id)];
+    slot.metadata = metadata;
+    slot.display_name = title + " - " + outcome;
+    
+    auto market_it = market_indices_.try_emplace(market_id, static_cast<uint32_t>(market_indices_.size())).first;
+    slot.market_index = market_it->second;
+    
+    if (slot.risk_outcome == RiskGate::NO_OUTCOME) {
+        slot.risk_condition = risk_gate_.registerCondition(condition_id);
+        slot.risk_outcome = risk_gate_.registerOutcome(slot.risk_condition);
+        if (slot.risk_outcome == RiskGate::NO_OUTCOME) {
+            LOG_ERROR("[{}] Not registered with the risk gate, its orders will be rejected", slot.display_name);
+            slot.risk_condition = RiskGate::NO_CONDITION;
+        }
+        order_manager_.setRiskCondition(token_id, slot.risk_condition);
+        
+        // A restored position so far only counted towards the portfolio
+        const auto& cols = slots_.columns();
+        TokenHandle handle = slots_.find(token_id);
+        double notional = cols.quantity[handle] * cols.avg_entry_price[handle];
+        if (notional != 0.0 && slot.risk_outcome != RiskGate::NO_OUTCOME) {
+            risk_gate_.onUnregisteredPositionChanged(notional, 0.0);
+            risk_gate_.onPositionChanged(slot.risk_condition, slot.risk_outcome,
+                                         cols.quantity[handle], cols.avg_entry_price[handle]);
+        }
+    }
     LOG_DEBUG("Registered metadata: {} - {}", title, outcome);
-}void StrategyEngine::setEventEndTime(const std::string& condition_id, 
-                                    const std::chrono::system_clock::time_point& end_time) {
+}
+
+void StrategyEngine::applyEventEndTime(const std::string& condition_id, 
+                                       const std::chrono::system_clock::time_point& end_time) {
     // Update all tokens associated with this condition_id
     int updated_count = 0;
-    for (auto& [token_id, metadata] : market_metadata_) {
-        if (metadata.condition_id == condition_id) {
-            metadata.event_end_time = end_time;
-            metadata.has_end_time = true;
+    for (TokenHandle h = 0; h < slots_.size(); h++) {
+        TokenSlot& slot = slots_[h];
+        if (slot.metadata && slot.metadata->condition_id == condition_id) {
+            slot.metadata->event_end_time = end_time;
+            slot.metadata->has_end_time = true;
             updated_count++;
             
             // Also set it on the market maker for time-aware risk management
-            auto mm_it = market_makers_.find(token_id);
-            if (mm_it != market_makers_.end()) {
-                mm_it->second.setMarketCloseTime(end_time);
+            if (slot.maker) {
+                slot.maker->setMarketCloseTime(end_time);
             }
         }
     }
@@ -719,136 +1037,56 @@ void StrategyEngine::registerMarketMetadata(const TokenId& token_id,
     }
 }
 
-size_t StrategyEngine::getPositionCount() const {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
-    size_t count = 0;
-    for (const auto& [token_id, position] : positions_) {
-        if (std::abs(position.quantity) > 0.001) {
-            count++;
-        }
-    }
-    return count;
-}
-
-size_t StrategyEngine::getActiveOrderCount() const {
-    return order_manager_.getActiveOrderCount();
-}
-
-size_t StrategyEngine::getBidCount() const {
-    return order_manager_.getBidCount();
-}
-
-size_t StrategyEngine::getAskCount() const {
-    return order_manager_.getAskCount();
-}
-
-size_t StrategyEngine::getActiveMarketCount() const {
-    // Count unique markets (by market_id) that have orders on any token
-    std::unordered_set<std::string> active_market_ids;
-    
-    for (const auto& [token_id, metadata] : market_metadata_) {
-        auto orders = order_manager_.getOpenOrders(token_id);
-        if (!orders.empty()) {
-            active_market_ids.insert(metadata.market_id);
-        }
-    }
-    
-    return active_market_ids.size();
-}
-
-double StrategyEngine::getTotalInventory() const {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
-    double total = 0.0;
-    for (const auto& [token_id, position] : positions_) {
-        total += std::abs(position.quantity);
-    }
-    return total;
-}
-
-double StrategyEngine::getAverageSpread() const {
-    double total_spread_pct = 0.0;
-    int count = 0;
-    
-    for (const auto& [token_id, book] : order_books_) {
-        if (book.hasValidBBO()) {
-            double spread = book.getSpread();
-            double mid = book.getMid();
-            if (mid > 0) {
-                total_spread_pct += (spread / mid);
-                count++;
-            }
-        }
+void StrategyEngine::updatePosition(TokenHandle handle, double qty, double price, Side side) {
+    auto& cols = slots_.columns();
+    double& quantity = cols.quantity[handle];
+    double& avg_entry_price = cols.avg_entry_price[handle];
+    double& realized_pnl = cols.realized_pnl[handle];
+    
+    TokenSlot& slot = slots_[handle];
+    if (!slot.position) {
+        slot.position.emplace();
     }
+    PositionDetails& pos = *slot.position;
     
-    return (count > 0) ? (total_spread_pct / count) : 0.0;
-}
-
-size_t StrategyEngine::getFillCount() const {
-    return total_fills_.load(std::memory_order_relaxed);
-}
-
-double StrategyEngine::getTotalPnL() const {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
-    double total = 0.0;
-    for (const auto& [token_id, position] : positions_) {
-        total += position.realized_pnl;
-    }
-    return total;
-}
-
-double StrategyEngine::getUnrealizedPnL() const {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
-    double unrealized = 0.0;
-    
-    for (const auto& [token_id, position] : positions_) {
-        if (std::abs(position.quantity) < 0.001) continue;
-        
-        auto ob_it = order_books_.find(token_id);
-        if (ob_it != order_books_.end() && ob_it->second.getMid() > 0) {
-            double current_price = ob_it->second.getMid();
-            unrealized += position.quantity * (current_price - position.avg_entry_price);
-        }
-    }
-    
-    return unrealized;
-}
-
-void StrategyEngine::updatePosition(const TokenId& token_id, double qty, double price, Side side) {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
-    
-    auto& pos = positions_[token_id];
     double signed_qty = (side == Side::BUY) ? qty : -qty;
-    bool was_flat = (pos.quantity == 0.0);
+    bool was_flat = (quantity == 0.0);
+    double old_notional = quantity * avg_entry_price;
     
     // Update position and average entry price
-    if ((pos.quantity > 0 && signed_qty > 0) || (pos.quantity < 0 && signed_qty < 0)) {
+    if ((quantity > 0 && signed_qty > 0) || (quantity < 0 && signed_qty < 0)) {
         // Adding to position - update average price
-        double total_cost = (pos.quantity * pos.avg_entry_price) + (signed_qty * price);
-        pos.quantity += signed_qty;
-        pos.avg_entry_price = total_cost / pos.quantity;
-    } else if (std::abs(signed_qty) >= std::abs(pos.quantity)) {
+        double total_cost = (quantity * avg_entry_price) + (signed_qty * price);
+        quantity += signed_qty;
+        avg_entry_price = total_cost / quantity;
+    } else if (std::abs(signed_qty) >= std::abs(quantity)) {
         // Closing or flipping position - realize PnL
-        double pnl = pos.quantity * (price - pos.avg_entry_price);
-        pos.realized_pnl += pnl;
+        double pnl = quantity * (price - avg_entry_price);
+        realized_pnl += pnl;
         
-        pos.quantity += signed_qty;
-        pos.avg_entry_price = price;
+        quantity += signed_qty;
+        avg_entry_price = price;
         
         // If we went from flat to a new position, record the opened_at time and entry side
-        if (was_flat && pos.quantity != 0.0) {
+        if (was_flat && quantity != 0.0) {
             pos.opened_at = std::chrono::system_clock::now();
             pos.entry_side = side;
             pos.num_fills = 0;  // Reset fill count for new position
         }
     } else {
         // Partial close - realize proportional PnL
-        double pnl = -signed_qty * (price - pos.avg_entry_price);
-        pos.realized_pnl += pnl;
-        pos.quantity += signed_qty;
+        double pnl = -signed_qty * (price - avg_entry_price);
+        realized_pnl += pnl;
+        quantity += signed_qty;
+    }
+    if (slot.risk_outcome != RiskGate::NO_OUTCOME) {
+        risk_gate_.onPositionChanged(slot.risk_condition, slot.risk_outcome, quantity, avg_entry_price);
+    } else {
+        risk_gate_.onUnregisteredPositionChanged(old_notional, quantity * avg_entry_price);
     }
     
     // If this is a brand new position (opening from flat), set opened_at and entry_side
-    if (was_flat && pos.quantity != 0.0 && pos.opened_at.time_since_epoch().count() == 0) {
+    if (was_flat && quantity != 0.0 && pos.opened_at.time_since_epoch().count() == 0) {
         pos.opened_at = std::chrono::system_clock::now();
         pos.entry_side = side;
         pos.num_fills = 0;  // Reset fill count
@@ -859,14 +1097,14 @@ void StrategyEngine::updatePosition(const TokenId& token_id, double qty, double
     pos.num_fills++;
 }
 
-void StrategyEngine::startLogging(const std::string& event_name) {
+void StrategyEngine::applyStartLogging(const std::string& event_name) {
     if (trading_logger_) {
         trading_logger_->startSession(event_name);
         
         // Initialize market summary logger with the session directory
         std::string session_id = trading_logger_->getSessionId();
         std::filesystem::path session_dir = std::filesystem::path("./logs") / session_id;
-        market_summary_logger_ = std::make_unique<MarketSummaryLogger>(session_dir);
+        market_summary_logger_ = std::make_unique<MarketSummaryLogger>(session_dir, journal_format_ == JournalFormat::COLUMNAR);
         
         LOG_INFO("Market summary logger initialized");
         
@@ -877,25 +1115,28 @@ void StrategyEngine::startLogging(const std::string& event_name) {
 void StrategyEngine::logInitialPositions() {
     if (!trading_logger_) return;
     
-    std::lock_guard<std::mutex> lock(positions_mutex_);
+    const auto& cols = slots_.columns();
     
-    if (positions_.empty()) {
+    size_t position_count = 0;
+    for (TokenHandle h = 0; h < slots_.size(); h++) {
+        if (slots_[h].position) position_count++;
+    }
+    
+    if (position_count == 0) {
         return;
     }
     
-    LOG_INFO("Logging {} initial positions to session", positions_.size());
+    LOG_INFO("Logging {} initial positions to session", position_count);
     
-    for (const auto& [token_id, pos] : positions_) {
-        double total_cost = pos.quantity * pos.avg_entry_price;
+    for (TokenHandle h = 0; h < slots_.size(); h++) {
+        const TokenSlot& slot = slots_[h];
+        if (!slot.position) continue;
         
-        std::string market_name = token_id;
-        auto meta_it = market_metadata_.find(token_id);
-        if (meta_it != market_metadata_.end()) {
-            market_name = meta_it->second.title + " - " + meta_it->second.outcome;
-        }
+        const PositionDetails& pos = *slot.position;
+        double total_cost = cols.quantity[h] * cols.avg_entry_price[h];
         
-        trading_logger_->logPosition(market_name, token_id, pos.quantity,
-                                    pos.avg_entry_price, pos.opened_at, pos.last_updated,
+        trading_logger_->logPosition(slot.display_name, slot.token_id, cols.quantity[h],
+                                    cols.avg_entry_price[h], pos.opened_at, pos.last_updated,
                                     pos.entry_side, pos.num_fills, total_cost);
     }
 }
@@ -903,21 +1144,22 @@ void StrategyEngine::logInitialPositions() {
 void StrategyEngine::snapshotPositions() {
     if (!state_persistence_ && !trading_logger_) return;
     
-    std::lock_guard<std::mutex> lock(positions_mutex_);
-    
     // Save state for recovery
     if (state_persistence_) {
+        const auto& cols = slots_.columns();
         TradingState state;
         state.last_session_id = trading_logger_ ? trading_logger_->getSessionId() : "";
         state.last_updated = std::chrono::system_clock::now();
         
-        for (const auto& [token_id, pos] : positions_) {
+        for (TokenHandle h = 0; h < slots_.size(); h++) {
+            if (!slots_[h].position) continue;
+            
             PositionState ps;
-            ps.quantity = pos.quantity;
-            ps.avg_cost = pos.avg_entry_price;
-            ps.realized_pnl = pos.realized_pnl;
-            state.positions[token_id] = ps;
-            state.total_realized_pnl += pos.realized_pnl;
+            ps.quantity = cols.quantity[h];
+            ps.avg_cost = cols.avg_entry_price[h];
+            ps.realized_pnl = cols.realized_pnl[h];
+            state.positions[slots_[h].token_id] = ps;
+            state.total_realized_pnl += ps.realized_pnl;
         }
         
         // Would need to track these properly
@@ -928,120 +1170,88 @@ void StrategyEngine::snapshotPositions() {
     }
 }
 
-void StrategyEngine::checkPendingFillMetrics() {
-    std::lock_guard<std::mutex> lock(fill_metrics_mutex_);
-    
-    auto now = std::chrono::system_clock::now();
-    
-    for (auto& metrics : fill_history_) {
-        if (metrics.metrics_complete) continue;
-        
-        auto time_since_fill = std::chrono::duration_cast<std::chrono::seconds>(now - metrics.fill_time).count();
-        
-        // Get current mid price
-        auto ob_it = order_books_.find(metrics.token_id);
-        if (ob_it == order_books_.end() || !ob_it->second.hasValidBBO()) continue;
-        
-        Price current_mid = ob_it->second.getMid();
-        
-        // Capture at 30s
-        if (time_since_fill >= 30 && metrics.mid_30s_after == 0.0) {
-            metrics.mid_30s_after = current_mid;
-            
-            double price_change_30s = (current_mid - metrics.mid_at_fill) / metrics.mid_at_fill * 100;
-            double adverse_metric_30s = (metrics.side == Side::BUY) 
-                ? (current_mid - metrics.fill_price)  // Positive = good, negative = adverse
-                : (metrics.fill_price - current_mid); // Positive = good, negative = adverse
-            
-            LOG_INFO("[FILL ANALYSIS 30s] Order: {} | Side: {} | Fill: {:.3f} | Mid@Fill: {:.3f} | Mid@30s: {:.3f} | Change: {:.2f}% | Metric: {:.4f}",
-                     metrics.order_id,
-                     metrics.side == Side::BUY ? "BUY" : "SELL",
-                     metrics.fill_price,
-                     metrics.mid_at_fill,
-                     current_mid,
-                     price_change_30s,
-                     adverse_metric_30s);
-        }
-        
-        // Capture at 60s and mark complete
-        if (time_since_fill >= 60 && metrics.mid_60s_after == 0.0) {
-            metrics.mid_60s_after = current_mid;
-            metrics.metrics_complete = true;
-            
-            double price_change_60s = (current_mid - metrics.mid_at_fill) / metrics.mid_at_fill * 100;
-            double adverse_metric_60s = (metrics.side == Side::BUY) 
-                ? (current_mid - metrics.fill_price)
-                : (metrics.fill_price - current_mid);
-            
-            bool is_adverse = adverse_metric_60s < -0.01; // Lost more than 1 cent
-            
-            LOG_INFO("[FILL ANALYSIS 60s] Order: {} | Side: {} | Fill: {:.3f} | Mid@Fill: {:.3f} | Mid@60s: {:.3f} | Change: {:.2f}% | Metric: {:.4f} | Adverse: {}",
-                     metrics.order_id,
-                     metrics.side == Side::BUY ? "BUY" : "SELL",
-                     metrics.fill_price,
-                     metrics.mid_at_fill,
-                     current_mid,
-                     price_change_60s,
-                     adverse_metric_60s,
-                     is_adverse ? "YES" : "NO");
-            
-            // Log detailed context for adverse fills
-            if (is_adverse) {
-                LOG_WARN("ADVERSE SELECTION DETECTED!");
-                LOG_WARN("Spread@Fill: {:.4f} ({:.1f}bps)", metrics.spread_at_fill, 
-                         (metrics.spread_at_fill / metrics.mid_at_fill) * 10000);
-                LOG_WARN("Imbalance@Fill: {:.2f}", metrics.imbalance_at_fill);
-                LOG_WARN("Inventory: {:.1f} -> {:.1f}", metrics.inventory_before, metrics.inventory_after);
-            }
-        }
+void StrategyEngine::captureFillMarkouts() {
+    markouts_.capture(std::chrono::system_clock::now(), [this](uint32_t token) {
+        const OrderBook& book = slots_[token].book;
+        return book.hasValidBBO() ? book.getMid() : 0.0;
+    });
+}
+
+void StrategyEngine::onFillMarkout(const MarkoutRecord& metrics, size_t horizon) {
+    const TokenSlot& slot = slots_[metrics.token];
+    int horizon_sec = markouts_.horizons()[horizon];
+    Price current_mid = metrics.mid_later[horizon];
+    
+    double price_change = (current_mid - metrics.mid_at_fill) / metrics.mid_at_fill * 100;
+    double adverse_metric = metrics.priceMove(horizon);  // Positive = good, negative = adverse
+    
+    LOG_INFO("[FILL ANALYSIS {}s] Fill #{} (ORD_{}) | {} | Side: {} | Fill: {:.3f} | Mid@Fill: {:.3f} | Mid@{}s: {:.3f} | Change: {:.2f}% | Metric: {:.4f}",
+             horizon_sec,
+             metrics.fill_seq,
+             metrics.order_id,
+             slot.display_name,
+             metrics.side == Side::BUY ? "BUY" : "SELL",
+             metrics.fill_price,
+             metrics.mid_at_fill,
+             horizon_sec,
+             current_mid,
+             price_change,
+             adverse_metric);
+    
+    if (horizon_sec == AdverseSelectionManager::MARKOUT_HORIZON_SEC) {
+        as_manager_->recordMarkout(slot.token_id, metrics.side, metrics.mid_at_fill, current_mid);
     }
     
-    // Clean up old completed metrics (keep last 100)
-    if (fill_history_.size() > 100) {
-        auto first_incomplete = std::find_if(fill_history_.begin(), fill_history_.end(),
-                                            [](const FillMetrics& m) { return !m.metrics_complete; });
-        
-        if (first_incomplete != fill_history_.begin() && 
-            std::distance(fill_history_.begin(), first_incomplete) > 50) {
-            fill_history_.erase(fill_history_.begin(), first_incomplete - 50);
-        }
+    // Log detailed context for adverse fills at the final horizon
+    if (horizon == markouts_.horizons().size() - 1 && adverse_metric < -0.01) {  // Lost more than 1 cent
+        LOG_WARN("ADVERSE SELECTION DETECTED!");
+        LOG_WARN("Spread@Fill: {:.4f} ({:.1f}bps)", metrics.spread_at_fill, 
+                 (metrics.spread_at_fill / metrics.mid_at_fill) * 10000);
+        LOG_WARN("Imbalance@Fill: {:.2f}", metrics.imbalance_at_fill);
+        LOG_WARN("Inventory: {:.1f} -> {:.1f}", metrics.inventory_before, metrics.inventory_after);
     }
 }
 
+void StrategyEngine::onFillMarkoutsComplete(const MarkoutRecord& metrics) {
+    if (!trading_logger_) return;
+    
+    const TokenSlot& slot = slots_[metrics.token];
+    trading_logger_->logFillMarkout(slot.display_name, slot.token_id, metrics.order_id, metrics.fill_seq,
+                                    metrics.fill_time, metrics.side, metrics.fill_price,
+                                    metrics.mid_at_fill, metrics.inventory_before,
+                                    metrics.inventory_after, markouts_.midAt(metrics, 30),
+                                    markouts_.midAt(metrics, 60));
+    trading_logger_->updateFillAdverseSelection(metrics.order_id, metrics.fill_seq, markouts_.midAt(metrics, 1),
+                                                markouts_.midAt(metrics, 5), markouts_.midAt(metrics, 30));
+}
+
 void StrategyEngine::logQuoteSummary() {
-    std::lock_guard<std::mutex> lock(quotes_mutex_);
-        
     // Build list including both active quotes and markets with positions
-    std::vector<std::pair<TokenId, QuoteSummary>> sorted_quotes;
-    for (const auto& [token_id, summary] : active_quotes_) {
-        sorted_quotes.push_back({token_id, summary});
-    }
+    std::vector<std::pair<TokenHandle, QuoteSummary>> sorted_quotes;
+    sorted_quotes.reserve(slots_.size());
+    size_t active_quote_count = 0;
+    double avg_spread_bps = 0.0;
     
-    // Add markets with positions that aren't actively quoting
-    for (const auto& [token_id, mm] : market_makers_) {
-        double inventory = mm.getInventory();
-        if (std::abs(inventory) > 0.1 && active_quotes_.find(token_id) == active_quotes_.end()) {
-            // This market has a position but isn't quoting - add it
+    for (TokenHandle h = 0; h < slots_.size(); h++) {
+        const TokenSlot& slot = slots_[h];
+        if (slot.quote) {
+            sorted_quotes.push_back({h, *slot.quote});
+            avg_spread_bps += slot.quote->spread_bps;
+            active_quote_count++;
+            continue;
+        }
+        
+        // Add markets with positions that aren't actively quoting
+        if (!slot.maker) continue;
+        double inventory = slot.maker->getInventory();
+        if (std::abs(inventory) > 0.1) {
             QuoteSummary summary;
-            auto meta_it = market_metadata_.find(token_id);
-            summary.market_name = (meta_it != market_metadata_.end()) ? 
-                                  meta_it->second.title + " - " + meta_it->second.outcome : 
-                                  token_id;
-            
-            auto ob_it = order_books_.find(token_id);
-            if (ob_it != order_books_.end()) {
-                summary.mid = ob_it->second.getMid();
-                summary.bid_price = 0.0;
-                summary.ask_price = 0.0;
-                summary.spread_bps = 0.0;
-            } else {
-                summary.mid = 0.0;
-                summary.bid_price = 0.0;
-                summary.ask_price = 0.0;
-                summary.spread_bps = 0.0;
-            }
+            summary.mid = slot.book.getMid();
+            summary.bid_price = 0.0;
+            summary.ask_price = 0.0;
+            summary.spread_bps = 0.0;
             summary.inventory = inventory;
-            sorted_quotes.push_back({token_id, summary});
+            sorted_quotes.push_back({h, summary});
         }
     }
     
@@ -1057,36 +1267,34 @@ void StrategyEngine::logQuoteSummary() {
     // Show top 5 by inventory risk
     LOG_INFO("\nTop markets by inventory:");
     size_t count = 0;
-    for (const auto& [token_id, summary] : sorted_quotes) {
+    for (const auto& [handle, summary] : sorted_quotes) {
         if (count++ >= 5) break;
         if (summary.bid_price > 0 && summary.ask_price > 0) {
             int seconds_left = summary.getSecondsUntilExpiry();
             LOG_INFO("  {} | Mid: {:.3f} | Bid: {:.3f} / Ask: {:.3f} | Spread: {:.1f}bps | Inv: {:.1f} | TTL: {}s",
-                     summary.market_name, summary.mid, summary.bid_price, summary.ask_price,
+                     slots_[handle].display_name, summary.mid, summary.bid_price, summary.ask_price,
                      summary.spread_bps, summary.inventory, seconds_left);
         } else {
             LOG_INFO("  {} | Mid: {:.3f} | NOT QUOTING | Inv: {:.1f}",
-                     summary.market_name, summary.mid, summary.inventory);
+                     slots_[handle].display_name, summary.mid, summary.inventory);
         }
     }
     
     // Calculate aggregate stats (only from active quotes)
-    double avg_spread_bps = 0.0;
-    if (!active_quotes_.empty()) {
-        for (const auto& [token_id, summary] : active_quotes_) {
-            avg_spread_bps += summary.spread_bps;
-        }
-        avg_spread_bps /= active_quotes_.size();
+    if (active_quote_count > 0) {
+        avg_spread_bps /= active_quote_count;
     }
 
     double total_short_inv = 0.0;
     double total_long_inv = 0.0;
     double total_inv = 0.0; 
     
-    for (const auto& [token_id, mm] : market_makers_) {
-        total_short_inv += std::min(0.0, mm.getInventory());
-        total_long_inv += std::max(0.0, mm.getInventory());
-        total_inv += std::abs(mm.getInventory());
+    for (TokenHandle h = 0; h < slots_.size(); h++) {
+        if (!slots_[h].maker) continue;
+        double inventory = slots_[h].maker->getInventory();
+        total_short_inv += std::min(0.0, inventory);
+        total_long_inv += std::max(0.0, inventory);
+        total_inv += std::abs(inventory);
     }
     
     LOG_INFO("Avg spread: {:.1f}bps | Total absolute inventory: {:.1f} | Total short inventory: {:.1f} | Total long inventory: {:.1f}",
@@ -0,0 +1,42 @@
+#include "strategy/token_slots.hpp"
+
+namespace pmm {
+
+TokenHandle TokenSlotTable::find(const TokenId& token_id) const {
+    auto it = handles_.find(token_id);
+    if (it == handles_.end()) {
+        return INVALID_TOKEN_HANDLE;
+    }
+    return it->second;
+}
+
+TokenHandle TokenSlotTable::findOrCreate(const TokenId& token_id) {
+    auto it = handles_.find(token_id);
+    if (it != handles_.end()) {
+        return it->second;
+    }
+
+    TokenHandle handle = static_cast<TokenHandle>(slots_.size());
+    slots_.emplace_back(token_id);
+    columns_.quantity.push_back(0.0);
+    columns_.avg_entry_price.push_back(0.0);
+    columns_.realized_pnl.push_back(0.0);
+    columns_.mid.push_back(0.0);
+    columns_.spread_pct.push_back(0.0);
+    handles_.emplace(token_id, handle);
+    return handle;
+}
+
+void TokenSlotTable::refreshBookColumns(TokenHandle handle) {
+    const OrderBook& book = slots_[handle].book;
+    if (book.hasValidBBO()) {
+        Price mid = book.getMid();
+        columns_.mid[handle] = mid;
+        columns_.spread_pct[handle] = (mid > 0) ? book.getSpread() / mid : 0.0;
+    } else {
+        columns_.mid[handle] = 0.0;
+        columns_.spread_pct[handle] = 0.0;
+    }
+}
+
+} // namespace pmm
@@ -0,0 +1,120 @@
+#include "strategy/trade_flow.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pmm {
+
+TradeFlow::TradeFlow(Size volume_bucket_size)
+    : volume_bucket_size_(volume_bucket_size) {}
+
+void TradeFlow::onTrade(Price price, Size size, Side side, Clock::time_point now) {
+    if (size <= 0.0) {
+        return;
+    }
+    if (total_trades_ == 0) {
+        first_trade_ = now;
+        bucket_start_ = now;
+    }
+    last_seen_ = std::max(last_seen_, now);
+    last_price_ = price;
+    total_volume_ += size;
+    total_trades_++;
+
+    int64_t second = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    advanceTo(second);
+    if (second > newest_second_ - WINDOW_SECONDS) {
+        double signed_size = (side == Side::BUY) ? size : -size;
+        Totals& bucket = seconds_[second & (TIME_BUCKETS - 1)];
+        for (Totals* totals : {&bucket, &window_}) {
+            totals->trades++;
+            totals->volume += size;
+            totals->notional += price * size;
+            totals->signed_volume += signed_size;
+        }
+    }
+
+    addToVolumeBuckets(size, side, now);
+}
+
+void TradeFlow::advance(Clock::time_point now) {
+    if (total_trades_ == 0) {
+        return;
+    }
+    last_seen_ = std::max(last_seen_, now);
+    advanceTo(std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count());
+}
+
+void TradeFlow::advanceTo(int64_t second) {
+    if (window_.trades == 0 || second - newest_second_ >= WINDOW_SECONDS) {
+        seconds_.fill(Totals{});
+        window_ = Totals{};  // Also drops rounding drift in the running sums
+    } else {
+        for (int64_t s = newest_second_ + 1; s <= second; s++) {
+            Totals& expired = seconds_[(s - WINDOW_SECONDS) & (TIME_BUCKETS - 1)];
+            window_.trades -= expired.trades;
+            window_.volume -= expired.volume;
+            window_.notional -= expired.notional;
+            window_.signed_volume -= expired.signed_volume;
+            expired = Totals{};
+        }
+    }
+    newest_second_ = std::max(newest_second_, second);
+}
+
+void TradeFlow::addToVolumeBuckets(Size size, Side side, Clock::time_point now) {
+    // A large trade can complete several buckets
+    while (size > 0.0) {
+        double room = volume_bucket_size_ - (bucket_buys_ + bucket_sells_);
+        double taken = std::min(size, room);
+        (side == Side::BUY ? bucket_buys_ : bucket_sells_) += taken;
+        size -= taken;
+
+        if (bucket_buys_ + bucket_sells_ < volume_bucket_size_ - 1e-9) {
+            break;
+        }
+        if (volume_buckets_.full()) {
+            const VolumeBucket& oldest = volume_buckets_.front();
+            volume_imbalance_sum_ -= oldest.abs_imbalance;
+            volume_seconds_sum_ -= oldest.seconds;
+            volume_buckets_.pop_front();
+        }
+        VolumeBucket completed{std::abs(bucket_buys_ - bucket_sells_),
+                               std::chrono::duration<double>(now - bucket_start_).count()};
+        volume_buckets_.push_back(completed);
+        volume_imbalance_sum_ += completed.abs_imbalance;
+        volume_seconds_sum_ += completed.seconds;
+
+        bucket_buys_ = 0.0;
+        bucket_sells_ = 0.0;
+        bucket_start_ = now;
+    }
+}
+
+Price TradeFlow::vwap() const {
+    return (window_.volume > 0.0) ? window_.notional / window_.volume : 0.0;
+}
+
+double TradeFlow::imbalance() const {
+    return (window_.volume > 0.0) ? window_.signed_volume / window_.volume : 0.0;
+}
+
+double TradeFlow::sessionVolumeRate() const {
+    if (total_trades_ == 0) {
+        return 0.0;
+    }
+    double elapsed = std::chrono::duration<double>(last_seen_ - first_trade_).count();
+    return total_volume_ / std::max(elapsed, static_cast<double>(WINDOW_SECONDS));
+}
+
+double TradeFlow::vpin() const {
+    if (volume_buckets_.empty()) {
+        return 0.0;
+    }
+    return volume_imbalance_sum_ / (volume_buckets_.size() * volume_bucket_size_);
+}
+
+double TradeFlow::secondsPerVolumeBucket() const {
+    return volume_buckets_.empty() ? 0.0 : volume_seconds_sum_ / volume_buckets_.size();
+}
+
+} // namespace pmm
@@ -0,0 +1,455 @@
+#include "utils/columnar_store.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace pmm {
+
+namespace {
+
+constexpr std::string_view FILE_MAGIC = "PMMCOL01";
+constexpr double PRICE_SCALE = 1e6;
+
+void putU16(std::string& out, uint16_t v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+void putU32(std::string& out, uint32_t v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+void putF64(std::string& out, double v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+void putString(std::string& out, std::string_view s) {
+    uint16_t length = static_cast<uint16_t>(std::min<size_t>(s.size(), UINT16_MAX));
+    putU16(out, length);
+    out.append(s.data(), length);
+}
+
+void putVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+// Bounds-checked reads over a header or an inflated chunk
+class Cursor {
+public:
+    Cursor(const char* data, size_t size) : in_(data), end_(data + size) {}
+
+    template <typename T>
+    T get() {
+        need(sizeof(T));
+        T v;
+        std::memcpy(&v, in_, sizeof(T));
+        in_ += sizeof(T);
+        return v;
+    }
+
+    std::string getString() {
+        uint16_t length = get<uint16_t>();
+        need(length);
+        std::string s(in_, length);
+        in_ += length;
+        return s;
+    }
+
+    uint64_t getVarint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(get<char>());
+            v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return v;
+        }
+        throw std::runtime_error("Corrupt varint in columnar table");
+    }
+
+private:
+    const char* in_;
+    const char* end_;
+
+    void need(size_t n) {
+        if (static_cast<size_t>(end_ - in_) < n) {
+            throw std::runtime_error("Truncated columnar table");
+        }
+    }
+};
+
+bool isNumeric(ColumnType type) { return type != ColumnType::STRING; }
+
+} // namespace
+
+ColumnarWriter::ColumnarWriter(const std::filesystem::path& path, std::vector<ColumnSpec> columns,
+                               size_t block_rows)
+    : file_(path, std::ios::binary | std::ios::trunc), block_rows_(std::max<size_t>(1, block_rows)) {
+    if (!file_) {
+        throw std::runtime_error("Cannot create columnar table " + path.string());
+    }
+    std::string schema;
+    putU16(schema, static_cast<uint16_t>(columns.size()));
+    for (auto& spec : columns) {
+        schema.push_back(static_cast<char>(spec.type));
+        putString(schema, spec.name);
+        ColumnBuffer buffer;
+        buffer.spec = std::move(spec);
+        columns_.push_back(std::move(buffer));
+    }
+    file_.write(FILE_MAGIC.data(), FILE_MAGIC.size());
+    uint32_t schema_length = static_cast<uint32_t>(schema.size());
+    file_.write(reinterpret_cast<const char*>(&schema_length), sizeof(schema_length));
+    file_.write(schema.data(), schema.size());
+}
+
+ColumnarWriter::~ColumnarWriter() {
+    close();
+}
+
+ColumnarWriter::ColumnBuffer& ColumnarWriter::column(size_t index, bool numeric) {
+    if (index >= columns_.size() || isNumeric(columns_[index].spec.type) != numeric) {
+        throw std::logic_error("Value does not match the column type");
+    }
+    return columns_[index];
+}
+
+void ColumnarWriter::addInt64(size_t index, int64_t value) {
+    ColumnBuffer& c = column(index, true);
+    if (c.spec.type != ColumnType::INT64) {
+        throw std::logic_error("addInt64 on a non-INT64 column: " + c.spec.name);
+    }
+    c.ints.push_back(value);
+    c.rows++;
+}
+
+void ColumnarWriter::addDouble(size_t index, double value) {
+    ColumnBuffer& c = column(index, true);
+    if (c.spec.type == ColumnType::PRICE) {
+        c.ints.push_back(std::llround(value * PRICE_SCALE));
+    } else if (c.spec.type == ColumnType::DOUBLE) {
+        c.doubles.push_back(value);
+    } else {
+        throw std::logic_error("addDouble on an INT64 column: " + c.spec.name);
+    }
+    c.rows++;
+}
+
+void ColumnarWriter::addString(size_t index, std::string_view value) {
+    ColumnBuffer& c = column(index, false);
+    // Consecutive rows often repeat a token, so check the last code first
+    if (!c.codes.empty() && c.dictionary[c.codes.back()] == value) {
+        c.codes.push_back(c.codes.back());
+    } else {
+        auto [it, inserted] = c.dictionary_index.try_emplace(std::string(value),
+                                                             static_cast<uint32_t>(c.dictionary.size()));
+        if (inserted) {
+            c.dictionary.emplace_back(value);
+        }
+        c.codes.push_back(it->second);
+    }
+    c.rows++;
+}
+
+void ColumnarWriter::endRow() {
+    for (const auto& c : columns_) {
+        if (c.rows != pending_rows_ + 1) {
+            throw std::logic_error("Row needs exactly one value for column " + c.spec.name);
+        }
+    }
+    pending_rows_++;
+    total_rows_++;
+    if (pending_rows_ >= block_rows_) {
+        writeBlock();
+    }
+}
+
+void ColumnarWriter::flush() {
+    if (pending_rows_ > 0) {
+        writeBlock();
+    }
+    file_.flush();
+}
+
+void ColumnarWriter::close() {
+    if (!file_.is_open()) return;
+    flush();
+    file_.close();
+}
+
+void ColumnarWriter::writeBlock() {
+    std::string header;
+    putU32(header, static_cast<uint32_t>(pending_rows_));
+    std::vector<std::vector<Bytef>> chunks;
+
+    for (auto& c : columns_) {
+        // Values of a row that was never ended are dropped
+        if (c.rows > pending_rows_) {
+            c.ints.resize(std::min(c.ints.size(), pending_rows_));
+            c.doubles.resize(std::min(c.doubles.size(), pending_rows_));
+            c.codes.resize(std::min(c.codes.size(), pending_rows_));
+        }
+
+        std::string raw;
+        double min = 0.0;
+        double max = 0.0;
+
+        switch (c.spec.type) {
+            case ColumnType::INT64:
+            case ColumnType::PRICE: {
+                double scale = (c.spec.type == ColumnType::PRICE) ? PRICE_SCALE : 1.0;
+                int64_t previous = 0;
+                for (int64_t v : c.ints) {
+                    putVarint(raw, zigzag(v - previous));
+                    previous = v;
+                }
+                auto [lo, hi] = std::minmax_element(c.ints.begin(), c.ints.end());
+                min = *lo / scale;
+                max = *hi / scale;
+                break;
+            }
+            case ColumnType::DOUBLE: {
+                uint64_t previous = 0;
+                for (double v : c.doubles) {
+                    uint64_t bits;
+                    std::memcpy(&bits, &v, sizeof(bits));
+                    uint64_t x = bits ^ previous;
+                    raw.append(reinterpret_cast<const char*>(&x), sizeof(x));
+                    previous = bits;
+                }
+                auto [lo, hi] = std::minmax_element(c.doubles.begin(), c.doubles.end());
+                min = *lo;
+                max = *hi;
+                break;
+            }
+            case ColumnType::STRING:
+                for (uint32_t code : c.codes) {
+                    putVarint(raw, code);
+                }
+                break;
+        }
+
+        uLongf compressed_size = compressBound(raw.size());
+        std::vector<Bytef> compressed(compressed_size);
+        if (compress2(compressed.data(), &compressed_size, reinterpret_cast<const Bytef*>(raw.data()),
+                      raw.size(), Z_DEFAULT_COMPRESSION) != Z_OK) {
+            throw std::runtime_error("Failed to compress column " + c.spec.name);
+        }
+        compressed.resize(compressed_size);
+
+        putU32(header, static_cast<uint32_t>(compressed_size));
+        putU32(header, static_cast<uint32_t>(raw.size()));
+        putF64(header, min);
+        putF64(header, max);
+        if (c.spec.type == ColumnType::STRING) {
+            putU32(header, static_cast<uint32_t>(c.dictionary.size()));
+            for (const auto& s : c.dictionary) {
+                putString(header, s);
+            }
+        }
+        chunks.push_back(std::move(compressed));
+
+        c.ints.clear();
+        c.doubles.clear();
+        c.codes.clear();
+        c.dictionary.clear();
+        c.dictionary_index.clear();
+        c.rows = 0;
+    }
+
+    uint32_t header_length = static_cast<uint32_t>(header.size());
+    file_.write(reinterpret_cast<const char*>(&header_length), sizeof(header_length));
+    file_.write(header.data(), header.size());
+    for (const auto& chunk : chunks) {
+        file_.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+    }
+    pending_rows_ = 0;
+}
+
+ColumnarReader::ColumnarReader(const std::filesystem::path& path)
+    : file_(path, std::ios::binary) {
+    if (!file_) {
+        throw std::runtime_error("Cannot open columnar table " + path.string());
+    }
+    uint64_t file_size = std::filesystem::file_size(path);
+
+    auto readExactly = [this](size_t n) {
+        std::string bytes(n, '\0');
+        if (!file_.read(bytes.data(), n)) {
+            throw std::runtime_error("Truncated columnar table");
+        }
+        return bytes;
+    };
+
+    if (file_size < FILE_MAGIC.size() + sizeof(uint32_t) || readExactly(FILE_MAGIC.size()) != FILE_MAGIC) {
+        throw std::runtime_error(path.string() + " is not a columnar table");
+    }
+    std::string length_bytes = readExactly(sizeof(uint32_t));
+    std::string schema = readExactly(Cursor(length_bytes.data(), length_bytes.size()).get<uint32_t>());
+    Cursor schema_in(schema.data(), schema.size());
+    uint16_t column_count = schema_in.get<uint16_t>();
+    for (uint16_t i = 0; i < column_count; i++) {
+        auto type = static_cast<ColumnType>(schema_in.get<uint8_t>());
+        columns_.push_back(ColumnSpec{schema_in.getString(), type});
+    }
+
+    // Block headers; a block cut short at the end of the file is left out
+    uint64_t offset = file_.tellg();
+    while (offset + sizeof(uint32_t) <= file_size) {
+        uint32_t header_length;
+        file_.seekg(offset);
+        file_.read(reinterpret_cast<char*>(&header_length), sizeof(header_length));
+        offset += sizeof(header_length);
+        if (offset + header_length > file_size) break;
+
+        std::string header = readExactly(header_length);
+        offset += header_length;
+        Cursor in(header.data(), header.size());
+        Block block;
+        block.rows = in.get<uint32_t>();
+        for (const auto& spec : columns_) {
+            Chunk chunk;
+            chunk.compressed_size = in.get<uint32_t>();
+            chunk.raw_size = in.get<uint32_t>();
+            chunk.stats.min = in.get<double>();
+            chunk.stats.max = in.get<double>();
+            if (spec.type == ColumnType::STRING) {
+                uint32_t dictionary_size = in.get<uint32_t>();
+                for (uint32_t i = 0; i < dictionary_size; i++) {
+                    chunk.stats.dictionary.push_back(in.getString());
+                }
+            }
+            chunk.offset = offset;
+            offset += chunk.compressed_size;
+            block.chunks.push_back(std::move(chunk));
+        }
+        if (offset > file_size) break;
+        blocks_.push_back(std::move(block));
+    }
+    file_.clear();
+}
+
+int ColumnarReader::columnIndex(std::string_view name) const {
+    for (size_t i = 0; i < columns_.size(); i++) {
+        if (columns_[i].name == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+size_t ColumnarReader::rowCount() const {
+    size_t rows = 0;
+    for (const auto& block : blocks_) {
+        rows += block.rows;
+    }
+    return rows;
+}
+
+std::vector<char> ColumnarReader::inflate(size_t block, size_t column) {
+    const Chunk& chunk = blocks_.at(block).chunks.at(column);
+    std::vector<Bytef> compressed(chunk.compressed_size);
+    file_.seekg(chunk.offset);
+    if (!file_.read(reinterpret_cast<char*>(compressed.data()), compressed.size())) {
+        throw std::runtime_error("Truncated columnar table");
+    }
+    std::vector<char> raw(chunk.raw_size);
+    uLongf raw_size = chunk.raw_size;
+    if (uncompress(reinterpret_cast<Bytef*>(raw.data()), &raw_size, compressed.data(), compressed.size()) != Z_OK ||
+        raw_size != chunk.raw_size) {
+        throw std::runtime_error("Corrupt chunk for column " + columns_[column].name);
+    }
+    chunks_decompressed_++;
+    return raw;
+}
+
+std::vector<int64_t> ColumnarReader::readInt64(size_t block, size_t column) {
+    if (columns_.at(column).type != ColumnType::INT64) {
+        throw std::logic_error(columns_[column].name + " is not an INT64 column");
+    }
+    std::vector<char> raw = inflate(block, column);
+    Cursor in(raw.data(), raw.size());
+    std::vector<int64_t> values(blocks_[block].rows);
+    int64_t previous = 0;
+    for (auto& v : values) {
+        v = previous + unzigzag(in.getVarint());
+        previous = v;
+    }
+    return values;
+}
+
+std::vector<double> ColumnarReader::readDouble(size_t block, size_t column) {
+    ColumnType type = columns_.at(column).type;
+    std::vector<double> values(blocks_.at(block).rows);
+    if (type == ColumnType::INT64) {
+        std::vector<int64_t> ints = readInt64(block, column);
+        std::copy(ints.begin(), ints.end(), values.begin());
+        return values;
+    }
+
+    std::vector<char> raw = inflate(block, column);
+    Cursor in(raw.data(), raw.size());
+    if (type == ColumnType::PRICE) {
+        int64_t previous = 0;
+        for (auto& v : values) {
+            previous += unzigzag(in.getVarint());
+            v = previous / PRICE_SCALE;
+        }
+    } else if (type == ColumnType::DOUBLE) {
+        uint64_t previous = 0;
+        for (auto& v : values) {
+            previous ^= in.get<uint64_t>();
+            std::memcpy(&v, &previous, sizeof(v));
+        }
+    } else {
+        throw std::logic_error(columns_[column].name + " is not a numeric column");
+    }
+    return values;
+}
+
+std::vector<uint32_t> ColumnarReader::readCodes(size_t block, size_t column) {
+    if (columns_.at(column).type != ColumnType::STRING) {
+        throw std::logic_error(columns_[column].name + " is not a STRING column");
+    }
+    std::vector<char> raw = inflate(block, column);
+    Cursor in(raw.data(), raw.size());
+    std::vector<uint32_t> codes(blocks_[block].rows);
+    for (auto& code : codes) {
+        code = static_cast<uint32_t>(in.getVarint());
+    }
+    return codes;
+}
+
+std::vector<std::string> ColumnarReader::readString(size_t block, size_t column) {
+    std::vector<uint32_t> codes = readCodes(block, column);
+    const auto& dictionary = stats(block, column).dictionary;
+    std::vector<std::string> values;
+    values.reserve(codes.size());
+    for (uint32_t code : codes) {
+        values.push_back(code < dictionary.size() ? dictionary[code] : std::string());
+    }
+    return values;
+}
+
+std::vector<double> ColumnarReader::scan(std::string_view column, std::string_view key_column, std::string_view key) {
+    int value_index = columnIndex(column);
+    int key_index = columnIndex(key_column);
+    if (value_index < 0 || key_index < 0) {
+        throw std::invalid_argument("Unknown column");
+    }
+
+    std::vector<double> out;
+    for (size_t b = 0; b < blocks_.size(); b++) {
+        const auto& dictionary = stats(b, key_index).dictionary;
+        auto it = std::find(dictionary.begin(), dictionary.end(), key);
+        if (it == dictionary.end()) continue;
+        uint32_t wanted = static_cast<uint32_t>(it - dictionary.begin());
+
+        std::vector<uint32_t> codes = readCodes(b, key_index);
+        std::vector<double> values = readDouble(b, value_index);
+        for (size_t row = 0; row < codes.size(); row++) {
+            if (codes[row] == wanted) {
+                out.push_back(values[row]);
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace pmm
@@ -0,0 +1,361 @@
+#include "utils/journal_csv_writer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace pmm {
+
+namespace {
+
+// The markout columns of a fills.csv row are fixed width, so a later
+// FILL_ADVERSE_SELECTION record can overwrite them in place
+constexpr size_t MARKOUT_COLUMNS_WIDTH = 3 * 8 + 3 * 11 + 5;  // Three mids, three bps, commas
+
+void formatMarkoutColumns(char (&buf)[MARKOUT_COLUMNS_WIDTH + 1], Side side, Price mid_at_fill,
+                          Price mid_1s, Price mid_5s, Price mid_30s) {
+    // Positive = the mid moved in our favour after the fill; 0 when the mid was unknown
+    auto markout_bps = [&](Price mid_later) {
+        if (mid_later <= 0 || mid_at_fill <= 0) return 0.0;
+        double move = (side == Side::BUY) ? (mid_later - mid_at_fill) : (mid_at_fill - mid_later);
+        return std::max(-9999999.99, std::min(9999999.99, move / mid_at_fill * 10000.0));
+    };
+    std::snprintf(buf, sizeof(buf), "%.6f,%.6f,%.6f,%+011.2f,%+011.2f,%+011.2f",
+                  mid_1s, mid_5s, mid_30s, markout_bps(mid_1s), markout_bps(mid_5s), markout_bps(mid_30s));
+}
+
+void formatTime(char (&buf)[32], std::time_t time) {
+    std::tm tm{};
+    gmtime_r(&time, &tm);
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+}
+
+std::time_t toTimeT(int64_t time_ns) {
+    return static_cast<std::time_t>(time_ns / 1'000'000'000);
+}
+
+const char* sideToString(Side side) {
+    return side == Side::BUY ? "BUY" : "SELL";
+}
+
+const char* cancelReasonToString(CancelReason reason) {
+    switch (reason) {
+        case CancelReason::QUOTE_UPDATE: return "QUOTE_UPDATE";
+        case CancelReason::TTL_EXPIRED: return "TTL_EXPIRED";
+        case CancelReason::INVENTORY_LIMIT: return "INVENTORY_LIMIT";
+        case CancelReason::SHUTDOWN: return "SHUTDOWN";
+        case CancelReason::MANUAL: return "MANUAL";
+        case CancelReason::UNKNOWN: return "UNKNOWN";
+        default: return "UNKNOWN";
+    }
+}
+
+// price_updates.pmmc; same columns as price_updates.csv, time in ms
+std::vector<ColumnSpec> priceUpdateColumns() {
+    return {
+        {"timestamp_ms", ColumnType::INT64},
+        {"market_name", ColumnType::STRING},
+        {"market_id", ColumnType::STRING},
+        {"condition_id", ColumnType::STRING},
+        {"token_id", ColumnType::STRING},
+        {"mid_price", ColumnType::PRICE},
+        {"price_change_pct", ColumnType::DOUBLE},
+        {"price_change_abs", ColumnType::PRICE},
+        {"best_bid", ColumnType::PRICE},
+        {"best_ask", ColumnType::PRICE},
+        {"spread", ColumnType::PRICE},
+        {"spread_bps", ColumnType::DOUBLE},
+        {"bid_volume_5levels", ColumnType::DOUBLE},
+        {"ask_volume_5levels", ColumnType::DOUBLE},
+        {"total_volume", ColumnType::DOUBLE},
+        {"volume_imbalance", ColumnType::DOUBLE},
+        {"bid_levels_count", ColumnType::INT64},
+        {"ask_levels_count", ColumnType::INT64},
+        {"our_inventory", ColumnType::DOUBLE},
+        {"time_to_event_hours", ColumnType::DOUBLE},
+        {"seconds_since_last_update", ColumnType::DOUBLE},
+    };
+}
+
+} // namespace
+
+JournalCsvWriter::JournalCsvWriter(const std::filesystem::path& dir, bool columnar_price_updates) {
+    orders_file_.open(dir / "orders.csv");
+    orders_file_ << "timestamp,market_id,order_id,token_id,side,price,size,status,"
+                 << "market_mid_price,our_spread_bps,distance_from_mid_bps,market_spread_bps,"
+                 << "best_bid,best_ask,cancel_reason\n";
+
+    fills_file_.open(dir / "fills.csv");
+    fills_file_ << "timestamp,market_id,order_id,token_id,side,fill_price,fill_size,pnl,"
+                << "quoted_price,slippage_bps,mid_price_at_fill,effective_spread_bps,"
+                << "seconds_to_fill,mid_1s_later,mid_5s_later,mid_30s_later,"
+                << "adverse_selection_1s_bps,adverse_selection_5s_bps,adverse_selection_30s_bps\n";
+
+    positions_file_.open(dir / "positions.csv");
+    positions_file_ << "timestamp,market_id,token_id,position,avg_cost,opened_at,last_updated,entry_side,num_fills,total_cost\n";
+
+    if (columnar_price_updates) {
+        price_updates_table_ = std::make_unique<ColumnarWriter>(dir / "price_updates.pmmc", priceUpdateColumns());
+    } else {
+        price_updates_file_.open(dir / "price_updates.csv");
+        price_updates_file_ << "timestamp,market_name,market_id,condition_id,token_id,mid_price,price_change_pct,price_change_abs,"
+                            << "best_bid,best_ask,spread,spread_bps,bid_volume_5levels,ask_volume_5levels,"
+                            << "total_volume,volume_imbalance,bid_levels_count,ask_levels_count,"
+                            << "our_inventory,time_to_event_hours,seconds_since_last_update\n";
+    }
+
+    fill_markouts_file_.open(dir / "fill_markouts.csv");
+    fill_markouts_file_ << "timestamp,fill_time,market_id,token_id,order_id,fill_seq,side,fill_price,mid_at_fill,"
+                        << "inventory_before,inventory_after,mid_30s_later,mid_60s_later,"
+                        << "markout_30s_bps,markout_60s_bps\n";
+}
+
+const std::string& JournalCsvWriter::timestamp(int64_t time_ns) {
+    std::time_t time = toTimeT(time_ns);
+    if (time != cached_timestamp_time_) {
+        char buf[32];
+        formatTime(buf, time);
+        cached_timestamp_.assign(buf);
+        cached_timestamp_time_ = time;
+    }
+    return cached_timestamp_;
+}
+
+void JournalCsvWriter::write(const JournalRecordView& record) {
+    switch (record.header->type) {
+        case JournalRecordType::ORDER_PLACED: writeOrderPlaced(record); break;
+        case JournalRecordType::ORDER_CANCELLED: writeOrderCancelled(record); break;
+        case JournalRecordType::ORDER_FILLED: writeOrderFilled(record); break;
+        case JournalRecordType::FILL_MARKOUT: writeFillMarkout(record); break;
+        case JournalRecordType::FILL_ADVERSE_SELECTION: writeFillAdverseSelection(record); break;
+        case JournalRecordType::POSITION: writePosition(record); break;
+        case JournalRecordType::PRICE_UPDATE: writePriceUpdate(record); break;
+        case JournalRecordType::PADDING: break;
+    }
+}
+
+void JournalCsvWriter::flush() {
+    orders_file_.flush();
+    fills_file_.flush();
+    positions_file_.flush();
+    price_updates_file_.flush();
+    fill_markouts_file_.flush();
+}
+
+void JournalCsvWriter::writeOrderPlaced(const JournalRecordView& record) {
+    auto order = record.as<OrderPlacedRecord>();
+
+    double our_spread_bps = 0.0;
+    double distance_from_mid_bps = 0.0;
+    double market_spread_bps = 0.0;
+
+    if (order.market_mid > 0) {
+        distance_from_mid_bps = std::abs(order.price - order.market_mid) / order.market_mid * 10000.0;
+        market_spread_bps = order.market_spread / order.market_mid * 10000.0;
+
+        if (order.our_bid > 0 && order.our_ask > 0) {
+            our_spread_bps = (order.our_ask - order.our_bid) / order.market_mid * 10000.0;
+        }
+    }
+
+    orders_file_ << timestamp(record.header->time_ns) << ","
+                 << record.strings[0] << ","
+                 << "ORD_" << order.order_id << ","
+                 << record.strings[1] << ","
+                 << sideToString(order.side) << ","
+                 << order.price << ","
+                 << order.size << ","
+                 << "OPEN" << ","
+                 << order.market_mid << ","
+                 << our_spread_bps << ","
+                 << distance_from_mid_bps << ","
+                 << market_spread_bps << ","
+                 << order.best_bid << ","
+                 << order.best_ask << ",\n";
+}
+
+void JournalCsvWriter::writeOrderCancelled(const JournalRecordView& record) {
+    auto order = record.as<OrderCancelledRecord>();
+
+    orders_file_ << timestamp(record.header->time_ns) << ","
+                 << record.strings[0] << ","
+                 << "ORD_" << order.order_id << ","
+                 << record.strings[1] << ","
+                 << sideToString(order.side) << ","
+                 << order.price << ","
+                 << order.size << ","
+                 << "CANCELLED,,,,,,,"
+                 << cancelReasonToString(order.reason) << "\n";
+}
+
+void JournalCsvWriter::writeOrderFilled(const JournalRecordView& record) {
+    auto fill = record.as<OrderFilledRecord>();
+
+    double slippage_bps = 0.0;
+    double effective_spread_bps = 0.0;
+
+    if (fill.quoted_price > 0 && fill.mid_at_fill > 0) {
+        slippage_bps = std::abs(fill.fill_price - fill.quoted_price) / fill.mid_at_fill * 10000.0;
+        effective_spread_bps = 2.0 * std::abs(fill.fill_price - fill.mid_at_fill) / fill.mid_at_fill * 10000.0;
+    }
+
+    fills_file_ << timestamp(record.header->time_ns) << ","
+                << record.strings[0] << ","
+                << "ORD_" << fill.order_id << ","
+                << record.strings[1] << ","
+                << sideToString(fill.side) << ","
+                << fill.fill_price << ","
+                << fill.fill_size << ","
+                << fill.pnl << ","
+                << fill.quoted_price << ","
+                << slippage_bps << ","
+                << fill.mid_at_fill << ","
+                << effective_spread_bps << ","
+                << fill.seconds_to_fill << ",";
+
+    // Zeros until the markouts come in
+    char markouts[MARKOUT_COLUMNS_WIDTH + 1];
+    formatMarkoutColumns(markouts, fill.side, fill.mid_at_fill, 0.0, 0.0, 0.0);
+    evictStaleFillRows(record.header->time_ns);
+    FillKey key{fill.order_id, fill.fill_seq};
+    fill_rows_[key] = FillRow{fills_file_.tellp(), fill.side, fill.mid_at_fill};
+    fill_row_times_.emplace_back(record.header->time_ns, key);
+    fills_file_ << markouts << "\n";
+}
+
+void JournalCsvWriter::writeFillMarkout(const JournalRecordView& record) {
+    auto fill = record.as<FillMarkoutRecord>();
+
+    // Positive markout = the mid moved in our favour after the fill; 0 when the mid was unknown
+    auto markout_bps = [&](Price mid_later) {
+        if (mid_later <= 0 || fill.mid_at_fill <= 0) return 0.0;
+        double move = (fill.side == Side::BUY) ? (mid_later - fill.mid_at_fill) : (fill.mid_at_fill - mid_later);
+        return move / fill.mid_at_fill * 10000.0;
+    };
+
+    char fill_time[32];
+    formatTime(fill_time, toTimeT(fill.fill_time_ns));
+
+    fill_markouts_file_ << timestamp(record.header->time_ns) << ","
+                        << fill_time << ","
+                        << record.strings[0] << ","
+                        << record.strings[1] << ","
+                        << "ORD_" << fill.order_id << ","
+                        << fill.fill_seq << ","
+                        << sideToString(fill.side) << ","
+                        << fill.fill_price << ","
+                        << fill.mid_at_fill << ","
+                        << fill.inventory_before << ","
+                        << fill.inventory_after << ","
+                        << fill.mid_30s << ","
+                        << fill.mid_60s << ","
+                        << markout_bps(fill.mid_30s) << ","
+                        << markout_bps(fill.mid_60s) << "\n";
+}
+
+void JournalCsvWriter::writeFillAdverseSelection(const JournalRecordView& record) {
+    auto update = record.as<FillAdverseSelectionRecord>();
+
+    auto it = fill_rows_.find(FillKey{update.order_id, update.fill_seq});
+    if (it == fill_rows_.end()) return;
+    const FillRow& row = it->second;
+
+    char markouts[MARKOUT_COLUMNS_WIDTH + 1];
+    formatMarkoutColumns(markouts, row.side, row.mid_at_fill, update.mid_1s, update.mid_5s, update.mid_30s);
+
+    // Same width as the placeholders, so the rest of the file is untouched
+    std::streampos end = fills_file_.tellp();
+    fills_file_.seekp(row.markout_columns);
+    fills_file_ << markouts;
+    fills_file_.seekp(end);
+
+    fill_rows_.erase(it);
+}
+
+void JournalCsvWriter::evictStaleFillRows(int64_t now_ns) {
+    // Keys already filled in are gone from fill_rows_, so erasing them is a no-op
+    while (!fill_row_times_.empty() && now_ns - fill_row_times_.front().first > FILL_ROW_LIFETIME_NS) {
+        fill_rows_.erase(fill_row_times_.front().second);
+        fill_row_times_.pop_front();
+    }
+}
+
+void JournalCsvWriter::writePosition(const JournalRecordView& record) {
+    auto position = record.as<PositionRecord>();
+
+    char opened_at[32];
+    char last_updated[32];
+    formatTime(opened_at, toTimeT(position.opened_at_ns));
+    formatTime(last_updated, toTimeT(position.last_updated_ns));
+
+    positions_file_ << timestamp(record.header->time_ns) << ","
+                    << record.strings[0] << ","
+                    << record.strings[1] << ","
+                    << position.position << ","
+                    << position.avg_cost << ","
+                    << opened_at << ","
+                    << last_updated << ","
+                    << sideToString(position.entry_side) << ","
+                    << position.num_fills << ","
+                    << position.total_cost << "\n";
+}
+
+void JournalCsvWriter::writePriceUpdate(const JournalRecordView& record) {
+    if (price_updates_table_) {
+        writePriceUpdateRow(record);
+        return;
+    }
+    auto update = record.as<PriceUpdateRecord>();
+
+    price_updates_file_ << timestamp(record.header->time_ns) << ","
+                        << record.strings[0] << ","
+                        << record.strings[1] << ","
+                        << record.strings[2] << ","
+                        << record.strings[3] << ","
+                        << update.mid_price << ","
+                        << update.price_change_pct << ","
+                        << update.price_change_abs << ","
+                        << update.best_bid << ","
+                        << update.best_ask << ","
+                        << update.spread << ","
+                        << update.spread_bps << ","
+                        << update.bid_volume << ","
+                        << update.ask_volume << ","
+                        << update.total_volume << ","
+                        << update.volume_imbalance << ","
+                        << update.bid_levels << ","
+                        << update.ask_levels << ","
+                        << update.our_inventory << ","
+                        << update.time_to_event_hours << ","
+                        << update.seconds_since_last_update << "\n";
+}
+
+void JournalCsvWriter::writePriceUpdateRow(const JournalRecordView& record) {
+    auto update = record.as<PriceUpdateRecord>();
+    ColumnarWriter& table = *price_updates_table_;
+
+    size_t c = 0;
+    table.addInt64(c++, record.header->time_ns / 1'000'000);
+    for (size_t i = 0; i < 4; i++) {
+        table.addString(c++, record.strings[i]);
+    }
+    table.addDouble(c++, update.mid_price);
+    table.addDouble(c++, update.price_change_pct);
+    table.addDouble(c++, update.price_change_abs);
+    table.addDouble(c++, update.best_bid);
+    table.addDouble(c++, update.best_ask);
+    table.addDouble(c++, update.spread);
+    table.addDouble(c++, update.spread_bps);
+    table.addDouble(c++, update.bid_volume);
+    table.addDouble(c++, update.ask_volume);
+    table.addDouble(c++, update.total_volume);
+    table.addDouble(c++, update.volume_imbalance);
+    table.addInt64(c++, update.bid_levels);
+    table.addInt64(c++, update.ask_levels);
+    table.addDouble(c++, update.our_inventory);
+    table.addDouble(c++, update.time_to_event_hours);
+    table.addDouble(c++, update.seconds_since_last_update);
+    table.endRow();
+}
+
+} // namespace pmm
@@ -1,106 +1,124 @@
 #include "utils/logger.hpp"
+#include <spdlog/async.h>
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/rotating_file_sink.h>
+#include <cstdlib>
+#include <mutex>
 #include <vector>
 #include <filesystem>
 
 namespace pmm {
 
 std::shared_ptr<spdlog::logger> Logger::logger_;
+std::atomic<spdlog::logger*> Logger::raw_{nullptr};
+std::vector<std::shared_ptr<spdlog::logger>> Logger::retired_;
+
+namespace {
+
+std::recursive_mutex& installMutex() {
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+spdlog::level::level_enum levelFromEnvironment() {
+    const char* level = std::getenv("PMM_LOG_LEVEL");
+    return level ? spdlog::level::from_str(level) : spdlog::level::info;
+}
+
+} // namespace
+
+void Logger::install(const std::string& dir, const std::string& session_name) {
+    std::filesystem::create_directories(dir);
 
-void Logger::init(const std::string& log_dir, const std::string& session_name) {
-    std::filesystem::create_directories(log_dir);
-    
     std::vector<spdlog::sink_ptr> sinks;
-    
+
     auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
     console_sink->set_level(spdlog::level::info);
     console_sink->set_pattern("[%H:%M:%S.%e] [%^%l%$] %v");
     sinks.push_back(console_sink);
-    
+
     auto file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
-        log_dir + "/" + session_name + "_all.log", 
+        dir + "/" + session_name + "_all.log",
         1024 * 1024 * 10,
         5
     );
     file_sink->set_level(spdlog::level::trace);
     file_sink->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%l] [%t] %v");
     sinks.push_back(file_sink);
-    
+
     auto error_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
-        log_dir + "/" + session_name + "_errors.log",
+        dir + "/" + session_name + "_errors.log",
         1024 * 1024 * 10,
         3
     );
     error_sink->set_level(spdlog::level::err);
     error_sink->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%l] [%t] %v");
     sinks.push_back(error_sink);
-    
-    logger_ = std::make_shared<spdlog::logger>("pmm", sinks.begin(), sinks.end());
-    logger_->set_level(spdlog::level::trace);
+
+    // One worker for the whole process, shared by every logger we install
+    auto pool = spdlog::thread_pool();
+    if (!pool) {
+        spdlog::init_thread_pool(QUEUE_SIZE, 1);
+        pool = spdlog::thread_pool();
+    }
+
+    // A replacement keeps whatever level was set on the logger it replaces
+    spdlog::level::level_enum level = logger_ ? logger_->level() : levelFromEnvironment();
+    if (logger_) {
+        spdlog::drop("pmm");
+        retired_.push_back(logger_);
+    }
+
+    logger_ = std::make_shared<spdlog::async_logger>("pmm", sinks.begin(), sinks.end(), pool,
+                                                     spdlog::async_overflow_policy::overrun_oldest);
+    logger_->set_level(level);
     logger_->flush_on(spdlog::level::warn);
-    
+
     spdlog::register_logger(logger_);
     spdlog::set_default_logger(logger_);
+    raw_.store(logger_.get(), std::memory_order_release);
+}
 
+void Logger::init(const std::string& log_dir, const std::string& session_name) {
+    {
+        std::lock_guard<std::recursive_mutex> lock(installMutex());
+        install(log_dir, session_name);
+    }
     LOG_INFO("Logger initialized - session: {}, log_dir: {}", session_name, log_dir);
 }
 
 void Logger::updateSessionDir(const std::string& session_dir, const std::string& session_name) {
-    if (!logger_) {
+    if (!raw_.load(std::memory_order_acquire)) {
         LOG_WARN("Logger not initialized, cannot update session directory");
         return;
     }
-    
-    std::filesystem::create_directories(session_dir);
-    
-    // Drop existing logger and recreate with new session directory
-    spdlog::drop("pmm");
-    
-    std::vector<spdlog::sink_ptr> sinks;
-    
-    // Console sink (unchanged)
-    auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-    console_sink->set_level(spdlog::level::info);
-    console_sink->set_pattern("[%H:%M:%S.%e] [%^%l%$] %v");
-    sinks.push_back(console_sink);
-    
-    // File sink - now in session directory
-    auto file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
-        session_dir + "/" + session_name + "_all.log", 
-        1024 * 1024 * 10,
-        5
-    );
-    file_sink->set_level(spdlog::level::trace);
-    file_sink->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%l] [%t] %v");
-    sinks.push_back(file_sink);
-    
-    // Error sink - now in session directory
-    auto error_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
-        session_dir + "/" + session_name + "_errors.log",
-        1024 * 1024 * 10,
-        3
-    );
-    error_sink->set_level(spdlog::level::err);
-    error_sink->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%l] [%t] %v");
-    sinks.push_back(error_sink);
-    
-    logger_ = std::make_shared<spdlog::logger>("pmm", sinks.begin(), sinks.end());
-    logger_->set_level(spdlog::level::trace);
-    logger_->flush_on(spdlog::level::warn);
-    
-    spdlog::register_logger(logger_);
-    spdlog::set_default_logger(logger_);
-    
+    {
+        std::lock_guard<std::recursive_mutex> lock(installMutex());
+        install(session_dir, session_name);
+    }
     LOG_INFO("Logger updated - session logs now in: {}", session_dir);
 }
 
 std::shared_ptr<spdlog::logger> Logger::get() {
+    std::lock_guard<std::recursive_mutex> lock(installMutex());
     if (!logger_) {
         init("./logs", "pmm_logger");
     }
     return logger_;
 }
 
-} // namespace pmm
\ No newline at end of file
+void Logger::shutdown() {
+    std::lock_guard<std::recursive_mutex> lock(installMutex());
+    if (auto pool = spdlog::thread_pool()) {
+        if (size_t overrun = pool->overrun_counter(); overrun > 0 && logger_) {
+            logger_->warn("Log queue overwrote {} lines", overrun);
+        }
+    }
+    raw_.store(nullptr, std::memory_order_release);
+    logger_.reset();
+    retired_.clear();
+    spdlog::shutdown();
+}
+
+} // namespace pmm
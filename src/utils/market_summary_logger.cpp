@@ -2,144 +2,346 @@
 #include "utils/logger.hpp"
 #include <cmath>
 #include <algorithm>
-#include <numeric>
 #include <iomanip>
 #include <sstream>
 
 namespace pmm {
 
 void RollingWindow::add(double value, std::chrono::steady_clock::time_point timestamp) {
-    values.push_back(value);
-    timestamps.push_back(timestamp);
+    if (samples_.full()) {
+        popFront();
+    }
+    if (samples_.empty()) {
+        origin_ = value;
+    }
+
+    double x = static_cast<double>(samples_.size());
+    double d = value - origin_;
+    sum_ += d;
+    sum_sq_ += d * d;
+    sum_xy_ += x * d;
+
+    uint64_t seq = samples_.tailSeq();
+    samples_.push_back({value, timestamp});
+    while (!maxima_.empty() && maxima_.back().value <= value) {
+        maxima_.pop_back();
+    }
+    maxima_.push_back({value, seq});
+    while (!minima_.empty() && minima_.back().value >= value) {
+        minima_.pop_back();
+    }
+    minima_.push_back({value, seq});
+
     cleanup(timestamp);
 }
 
 void RollingWindow::cleanup(std::chrono::steady_clock::time_point now) {
-    while (!timestamps.empty() && (now - timestamps.front()) > window_size) {
-        values.pop_front();
-        timestamps.pop_front();
+    while (!samples_.empty() && (now - samples_.front().timestamp) > window_size) {
+        popFront();
+    }
+}
+
+void RollingWindow::popFront() {
+    uint64_t seq = samples_.headSeq();
+    double d = samples_.front().value - origin_;
+    samples_.pop_front();
+    if (maxima_.front().seq == seq) maxima_.pop_front();
+    if (minima_.front().seq == seq) minima_.pop_front();
+
+    if (samples_.empty()) {
+        sum_ = sum_sq_ = sum_xy_ = 0.0;
+        evictions_ = 0;
+        return;
+    }
+    // The evicted sample sat at position 0; everything else moves down one
+    sum_ -= d;
+    sum_sq_ -= d * d;
+    sum_xy_ -= sum_;
+
+    if (++evictions_ >= samples_.size()) {
+        rebuildSums();
+    }
+}
+
+void RollingWindow::rebuildSums() {
+    origin_ = samples_.front().value;
+    sum_ = sum_sq_ = sum_xy_ = 0.0;
+    for (size_t i = 0; i < samples_.size(); i++) {
+        double d = samples_[i].value - origin_;
+        sum_ += d;
+        sum_sq_ += d * d;
+        sum_xy_ += static_cast<double>(i) * d;
     }
+    evictions_ = 0;
 }
 
 double RollingWindow::mean() const {
-    if (values.empty()) return 0.0;
-    return std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+    if (samples_.empty()) return 0.0;
+    return origin_ + sum_ / samples_.size();
 }
 
 double RollingWindow::stddev() const {
-    if (values.size() < 2) return 0.0;
-    double m = mean();
-    double sq_sum = 0.0;
-    for (double v : values) {
-        sq_sum += (v - m) * (v - m);
-    }
-    return std::sqrt(sq_sum / values.size());
+    if (samples_.size() < 2) return 0.0;
+    double n = static_cast<double>(samples_.size());
+    double m = sum_ / n;
+    return std::sqrt(std::max(0.0, sum_sq_ / n - m * m));
 }
 
 double RollingWindow::max() const {
-    if (values.empty()) return 0.0;
-    return *std::max_element(values.begin(), values.end());
+    if (samples_.empty()) return 0.0;
+    return maxima_.front().value;
 }
 
 double RollingWindow::min() const {
-    if (values.empty()) return 0.0;
-    return *std::min_element(values.begin(), values.end());
+    if (samples_.empty()) return 0.0;
+    return minima_.front().value;
+}
+
+double RollingWindow::slope() const {
+    if (samples_.size() < 2) return 0.0;
+    // Positions 0..n-1 have closed-form sums; the origin shift cancels out
+    double n = static_cast<double>(samples_.size());
+    double sum_x = n * (n - 1) / 2.0;
+    double sum_x2 = (n - 1) * n * (2 * n - 1) / 6.0;
+    double denominator = n * sum_x2 - sum_x * sum_x;
+    if (std::abs(denominator) < 1e-10) return 0.0;
+    return (n * sum_xy_ - sum_x * sum_) / denominator;
 }
 
-MarketSummaryLogger::MarketSummaryLogger(const std::filesystem::path& session_dir)
+MarketSummaryLogger::MarketSummaryLogger(const std::filesystem::path& session_dir, bool columnar)
     : session_dir_(session_dir),
-      start_time_(std::chrono::steady_clock::now()),
-      last_summary_time_(std::chrono::steady_clock::now() - std::chrono::seconds(9999)) {
-    initializeFile();
+      samples_(std::make_unique<SpscQueue<MarketSample, SAMPLE_QUEUE_CAPACITY>>()),
+      last_summary_time_(std::chrono::steady_clock::now() - std::chrono::seconds(9999)),
+      start_time_(std::chrono::steady_clock::now()) {
+    initializeFile(columnar);
+    analytics_ = std::thread([this] { analyticsLoop(); });
 }
 
 MarketSummaryLogger::~MarketSummaryLogger() {
+    {
+        std::lock_guard<std::mutex> lock(analytics_mutex_);
+        stopping_.store(true);
+    }
+    analytics_cv_.notify_one();
+    analytics_.join();
+
     if (summary_file_.is_open()) {
         summary_file_.close();
     }
+    uint64_t dropped = droppedSamples();
+    if (dropped > 0) {
+        LOG_WARN("Market summary dropped {} samples while its queue was full", dropped);
+    }
 }
 
-void MarketSummaryLogger::initializeFile() {
+void MarketSummaryLogger::initializeFile(bool columnar) {
+    if (columnar) {
+        // Same columns as market_summary.csv, time in ms
+        std::vector<ColumnSpec> columns = {
+            {"timestamp_ms", ColumnType::INT64},
+            {"market_name", ColumnType::STRING},
+            {"market_id", ColumnType::STRING},
+            {"token_id", ColumnType::STRING},
+            {"mid_price", ColumnType::PRICE},
+            {"spread_bps", ColumnType::DOUBLE},
+            {"best_bid", ColumnType::PRICE},
+            {"best_ask", ColumnType::PRICE},
+        };
+        for (const char* name : {"mid_price_volatility", "ewma_volatility", "realized_volatility",
+                                 "parkinson_volatility", "price_trend", "max_price_move",
+                                 "quote_change_rate", "bid_stability_score", "ask_stability_score",
+                                 "avg_spread_bps", "liquidity_score", "depth_score",
+                                 "update_frequency", "volume_trend", "hours_to_event"}) {
+            columns.push_back({name, ColumnType::DOUBLE});
+        }
+        columns.push_back({"is_tradeable", ColumnType::INT64});
+        columns.push_back({"trading_quality_score", ColumnType::INT64});
+        summary_table_ = std::make_unique<ColumnarWriter>(session_dir_ / "market_summary.pmmc",
+                                                          std::move(columns), TABLE_BLOCK_ROWS);
+        return;
+    }
+
     summary_file_.open(session_dir_ / "market_summary.csv");
     summary_file_ << "timestamp,market_name,market_id,token_id,"
                   << "mid_price,spread_bps,best_bid,best_ask,"
-                  << "mid_price_volatility,price_trend,max_price_move,"
+                  << "mid_price_volatility,ewma_volatility,realized_volatility,parkinson_volatility,"
+                  << "price_trend,max_price_move,"
                   << "quote_change_rate,bid_stability_score,ask_stability_score,"
                   << "avg_spread_bps,liquidity_score,depth_score,"
                   << "update_frequency,volume_trend,"
                   << "hours_to_event,is_tradeable,trading_quality_score\n";
 }
 
-void MarketSummaryLogger::updateMarket(const std::string& market_name, const std::string& market_id,
-                                       const std::string& condition_id, const TokenId& token_id,
+void MarketSummaryLogger::updateMarket(std::string_view market_name, std::string_view market_id,
+                                       std::string_view condition_id, const TokenId& token_id,
                                        Price mid_price, double spread_bps,
                                        Price best_bid, Price best_ask,
                                        double bid_volume, double ask_volume,
-                                       int bid_levels, int ask_levels) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto now = std::chrono::steady_clock::now();
-    auto& state = market_states_[token_id];
+                                       int bid_levels, int ask_levels,
+                                       const VolatilityEstimates& volatility) {
+    auto [it, inserted] = market_index_.try_emplace(token_id, static_cast<uint32_t>(market_index_.size()));
+    if (inserted) {
+        // Names cross over once, ahead of the market's first sample
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        new_markets_.push_back({token_id, std::string(market_name), std::string(market_id),
+                                std::string(condition_id)});
+    }
 
-    if (state.update_count == 0) {
-        state.token_id = token_id;
-        state.market_name = market_name;
-        state.market_id = market_id;
-        state.condition_id = condition_id;
-        state.first_update = now;
-        state.last_best_bid = best_bid;
-        state.last_best_ask = best_ask;
+    MarketSample sample{it->second, bid_levels, ask_levels, std::chrono::steady_clock::now(),
+                        mid_price, spread_bps, best_bid, best_ask, bid_volume, ask_volume, volatility};
+    if (!samples_->tryPush(std::move(sample))) {
+        dropped_samples_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // The analytics thread wakes on its own every ANALYTICS_INTERVAL; only
+    // hurry it along when a burst is filling the queue
+    if (++pushed_ % (SAMPLE_QUEUE_CAPACITY / 2) == 0 && samples_->size() >= SAMPLE_QUEUE_CAPACITY / 2) {
+        analytics_cv_.notify_one();
+    }
+}
+
+void MarketSummaryLogger::setEventEndTime(const std::string& condition_id,
+                                          std::chrono::system_clock::time_point end_time) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    new_end_times_.emplace_back(condition_id, end_time);
+}
+
+void MarketSummaryLogger::flush() {
+    uint64_t target = pushed_;
+    std::unique_lock<std::mutex> lock(analytics_mutex_);
+    flush_requested_ = std::max(flush_requested_, target);
+    analytics_cv_.notify_one();
+    applied_cv_.wait(lock, [&] { return applied_ >= target; });
+}
+
+void MarketSummaryLogger::logSummaries() {
+    uint64_t target = pushed_;
+    std::unique_lock<std::mutex> lock(analytics_mutex_);
+    flush_requested_ = std::max(flush_requested_, target);
+    uint64_t request = ++summaries_requested_;
+    analytics_cv_.notify_one();
+    applied_cv_.wait(lock, [&] { return summaries_written_ >= request; });
+}
+
+void MarketSummaryLogger::analyticsLoop() {
+    while (true) {
+        // Checked before draining: once set, no more samples are coming
+        bool stopping = stopping_.load(std::memory_order_acquire);
+
+        takeControlUpdates();
+        MarketSample sample;
+        while (samples_->tryPop(sample)) {
+            if (sample.market >= markets_.size()) {
+                takeControlUpdates();  // Registered before the sample was queued
+            }
+            applySample(sample);
+            taken_++;
+        }
 
-        auto end_it = event_end_times_.find(condition_id);
+        // A requested summary waits until it covers the samples queued
+        // before the request
+        uint64_t requested;
+        {
+            std::lock_guard<std::mutex> lock(analytics_mutex_);
+            applied_ = taken_;
+            requested = (applied_ >= flush_requested_) ? summaries_requested_ : summaries_written_;
+        }
+        bool forced = requested > summaries_written_;
+        if (forced || shouldLogSummary()) {
+            writeSummaries();
+        }
+        {
+            std::lock_guard<std::mutex> lock(analytics_mutex_);
+            summaries_written_ = requested;
+        }
+        applied_cv_.notify_all();
+        if (stopping) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(analytics_mutex_);
+        analytics_cv_.wait_for(lock, ANALYTICS_INTERVAL, [this] {
+            return stopping_.load(std::memory_order_relaxed) || flush_requested_ > applied_ ||
+                   summaries_requested_ > summaries_written_;
+        });
+    }
+}
+
+void MarketSummaryLogger::takeControlUpdates() {
+    std::vector<MarketInfo> markets;
+    std::vector<std::pair<std::string, std::chrono::system_clock::time_point>> end_times;
+    {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        markets.swap(new_markets_);
+        end_times.swap(new_end_times_);
+    }
+
+    for (MarketInfo& info : markets) {
+        MarketState& state = markets_.emplace_back();
+        state.token_id = std::move(info.token_id);
+        state.market_name = std::move(info.market_name);
+        state.market_id = std::move(info.market_id);
+        state.condition_id = std::move(info.condition_id);
+
+        auto end_it = event_end_times_.find(state.condition_id);
         if (end_it != event_end_times_.end()) {
             state.event_end_time = end_it->second;
         }
     }
+
+    for (const auto& [condition_id, end_time] : end_times) {
+        event_end_times_[condition_id] = end_time;
+        for (MarketState& state : markets_) {
+            if (state.condition_id == condition_id) {
+                state.event_end_time = end_time;
+            }
+        }
+    }
+}
+
+void MarketSummaryLogger::applySample(const MarketSample& sample) {
+    MarketState& state = markets_[sample.market];
+    const auto now = sample.time;
+
+    if (state.update_count == 0) {
+        state.first_update = now;
+        state.last_best_bid = sample.best_bid;
+        state.last_best_ask = sample.best_ask;
+    }
     
-    if (best_bid != state.last_best_bid) {
+    if (sample.best_bid != state.last_best_bid) {
         state.bid_changes++;
-        state.last_best_bid = best_bid;
+        state.last_best_bid = sample.best_bid;
     }
-    if (best_ask != state.last_best_ask) {
+    if (sample.best_ask != state.last_best_ask) {
         state.ask_changes++;
-        state.last_best_ask = best_ask;
+        state.last_best_ask = sample.best_ask;
     }
     
-    state.current_mid = mid_price;
-    state.current_spread = best_ask - best_bid;
-    state.current_spread_bps = spread_bps;
-    state.current_best_bid = best_bid;
-    state.current_best_ask = best_ask;
-    state.current_bid_volume = bid_volume;
-    state.current_ask_volume = ask_volume;
-    state.current_bid_levels = bid_levels;
-    state.current_ask_levels = ask_levels;
-
-    if (mid_price > 0) {
-        state.mid_prices.add(mid_price, now);
-    }
-    if (spread_bps > 0) {
-        state.spreads_bps.add(spread_bps, now);
-    }
-    state.bid_volumes.add(bid_volume, now);
-    state.ask_volumes.add(ask_volume, now);
+    state.current_mid = sample.mid_price;
+    state.current_spread = sample.best_ask - sample.best_bid;
+    state.current_spread_bps = sample.spread_bps;
+    state.current_best_bid = sample.best_bid;
+    state.current_best_ask = sample.best_ask;
+    state.current_bid_volume = sample.bid_volume;
+    state.current_ask_volume = sample.ask_volume;
+    state.current_bid_levels = sample.bid_levels;
+    state.current_ask_levels = sample.ask_levels;
+    state.volatility = sample.volatility;
+
+    if (sample.mid_price > 0) {
+        state.mid_prices.add(sample.mid_price, now);
+    }
+    if (sample.spread_bps > 0) {
+        state.spreads_bps.add(sample.spread_bps, now);
+    }
+    state.bid_volumes.add(sample.bid_volume, now);
+    state.ask_volumes.add(sample.ask_volume, now);
     
     state.update_count++;
     state.last_update = now;
 }
 
-void MarketSummaryLogger::setEventEndTime(const std::string& condition_id,
-                                          std::chrono::system_clock::time_point end_time) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    event_end_times_[condition_id] = end_time;
-    
-    for (auto& [token_id, state] : market_states_) {
-        if (state.condition_id == condition_id) {
-            state.event_end_time = end_time;
-        }
-    }
-}
-
 bool MarketSummaryLogger::shouldLogSummary() const {
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - last_summary_time_);
@@ -171,7 +373,7 @@ double MarketSummaryLogger::getMinHoursToEvent() const {
     auto now = std::chrono::system_clock::now();
     double min_hours = -1.0;
     
-    for (const auto& [token_id, state] : market_states_) {
+    for (const MarketState& state : markets_) {
         if (state.event_end_time != std::chrono::system_clock::time_point{}) {
             auto duration = state.event_end_time - now;
             double hours = std::chrono::duration_cast<std::chrono::hours>(duration).count();
@@ -184,14 +386,12 @@ double MarketSummaryLogger::getMinHoursToEvent() const {
     return min_hours;
 }
 
-void MarketSummaryLogger::logSummaries() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (!summary_file_.is_open()) return;
+void MarketSummaryLogger::writeSummaries() {
+    if (!summary_file_.is_open() && !summary_table_) return;
     
     auto now = std::chrono::steady_clock::now();
     
-    for (auto& [token_id, state] : market_states_) {
+    for (MarketState& state : markets_) {
         if (state.update_count == 0) continue;
         
         state.mid_prices.cleanup(now);
@@ -202,6 +402,10 @@ void MarketSummaryLogger::logSummaries() {
         MarketSummary summary = computeSummary(state);
 
         auto time_now = std::chrono::system_clock::now();
+        if (summary_table_) {
+            writeSummaryRow(summary, time_now);
+            continue;
+        }
         auto time_t = std::chrono::system_clock::to_time_t(time_now);
         std::stringstream ss;
         ss << std::put_time(std::gmtime(&time_t), "%Y-%m-%dT%H:%M:%SZ");
@@ -215,6 +419,9 @@ void MarketSummaryLogger::logSummaries() {
                      << summary.best_bid << ","
                      << summary.best_ask << ","
                      << summary.mid_price_volatility << ","
+                     << summary.ewma_volatility << ","
+                     << summary.realized_volatility << ","
+                     << summary.parkinson_volatility << ","
                      << summary.price_trend << ","
                      << summary.max_price_move << ","
                      << summary.quote_change_rate << ","
@@ -230,11 +437,34 @@ void MarketSummaryLogger::logSummaries() {
                      << summary.trading_quality_score << "\n";
     }
     
-    summary_file_.flush();
+    if (summary_file_.is_open()) {
+        summary_file_.flush();
+    }
     last_summary_time_ = now;
     
     LOG_DEBUG("Logged market summaries for {} markets (interval: {}s)", 
-              market_states_.size(), getUpdateInterval().count());
+              markets_.size(), getUpdateInterval().count());
+}
+
+void MarketSummaryLogger::writeSummaryRow(const MarketSummary& summary,
+                                          std::chrono::system_clock::time_point time) {
+    ColumnarWriter& table = *summary_table_;
+    size_t c = 0;
+    table.addInt64(c++, std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count());
+    table.addString(c++, summary.market_name);
+    table.addString(c++, summary.market_id);
+    table.addString(c++, summary.token_id);
+    for (double value : {summary.mid_price, summary.spread_bps, summary.best_bid, summary.best_ask,
+                         summary.mid_price_volatility, summary.ewma_volatility, summary.realized_volatility,
+                         summary.parkinson_volatility, summary.price_trend, summary.max_price_move,
+                         summary.quote_change_rate, summary.bid_stability_score, summary.ask_stability_score,
+                         summary.avg_spread_bps, summary.liquidity_score, summary.depth_score,
+                         summary.update_frequency, summary.volume_trend, summary.hours_to_event}) {
+        table.addDouble(c++, value);
+    }
+    table.addInt64(c++, summary.is_tradeable ? 1 : 0);
+    table.addInt64(c++, summary.trading_quality_score);
+    table.endRow();
 }
 
 MarketSummary MarketSummaryLogger::computeSummary(const MarketState& state) {
@@ -250,6 +480,9 @@ MarketSummary MarketSummaryLogger::computeSummary(const MarketState& state) {
     summary.best_ask = state.current_best_ask;
     
     summary.mid_price_volatility = computeVolatility(state.mid_prices);
+    summary.ewma_volatility = state.volatility.ewma;
+    summary.realized_volatility = state.volatility.realized;
+    summary.parkinson_volatility = state.volatility.parkinson;
     summary.price_trend = computeTrend(state.mid_prices);
     
     double price_range = state.mid_prices.max() - state.mid_prices.min();
@@ -283,9 +516,9 @@ MarketSummary MarketSummaryLogger::computeSummary(const MarketState& state) {
     summary.update_frequency = state.update_count / minutes;
     
     double recent_vol = state.bid_volumes.size() > 0 ? 
-        (state.bid_volumes.values.back() + state.ask_volumes.values.back()) : 0.0;
+        (state.bid_volumes.back() + state.ask_volumes.back()) : 0.0;
     double early_vol = state.bid_volumes.size() > 5 ?
-        (state.bid_volumes.values.front() + state.ask_volumes.values.front()) : recent_vol;
+        (state.bid_volumes.front() + state.ask_volumes.front()) : recent_vol;
     
     summary.volume_trend = (early_vol > 0) ? ((recent_vol - early_vol) / early_vol) : 0.0;
 
@@ -314,26 +547,8 @@ double MarketSummaryLogger::computeVolatility(const RollingWindow& window) {
 
 double MarketSummaryLogger::computeTrend(const RollingWindow& window) {
     if (window.size() < 2) return 0.0;
-    
-    size_t n = window.size();
-    double sum_x = 0.0, sum_y = 0.0, sum_xy = 0.0, sum_x2 = 0.0;
-    
-    for (size_t i = 0; i < n; i++) {
-        double x = static_cast<double>(i);
-        double y = window.values[i];
-        sum_x += x;
-        sum_y += y;
-        sum_xy += x * y;
-        sum_x2 += x * x;
-    }
-    
-    double denominator = (n * sum_x2 - sum_x * sum_x);
-    if (std::abs(denominator) < 1e-10) return 0.0;
-    
-    double slope = (n * sum_xy - sum_x * sum_y) / denominator;
-    
-    double mean_price = sum_y / n;
-    return (mean_price > 0) ? (slope / mean_price) : 0.0;
+    double mean_price = window.mean();
+    return (mean_price > 0) ? (window.slope() / mean_price) : 0.0;
 }
 
 int MarketSummaryLogger::computeQualityScore(const MarketSummary& summary) {
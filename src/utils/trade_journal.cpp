@@ -0,0 +1,147 @@
+#include "utils/trade_journal.hpp"
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace pmm {
+
+namespace journal {
+
+size_t payloadSize(JournalRecordType type) {
+    switch (type) {
+        case JournalRecordType::ORDER_PLACED: return sizeof(OrderPlacedRecord);
+        case JournalRecordType::ORDER_CANCELLED: return sizeof(OrderCancelledRecord);
+        case JournalRecordType::ORDER_FILLED: return sizeof(OrderFilledRecord);
+        case JournalRecordType::FILL_MARKOUT: return sizeof(FillMarkoutRecord);
+        case JournalRecordType::FILL_ADVERSE_SELECTION: return sizeof(FillAdverseSelectionRecord);
+        case JournalRecordType::POSITION: return sizeof(PositionRecord);
+        case JournalRecordType::PRICE_UPDATE: return sizeof(PriceUpdateRecord);
+        case JournalRecordType::PADDING: return 0;
+    }
+    return 0;
+}
+
+bool decode(const char* data, size_t available, JournalRecordView& out) {
+    if (available < sizeof(JournalRecordHeader)) {
+        return false;
+    }
+    out.header = reinterpret_cast<const JournalRecordHeader*>(data);
+    const JournalRecordHeader& header = *out.header;
+    if (header.length > available || header.length % ALIGNMENT != 0 ||
+        header.string_count > JournalRecordView::MAX_STRINGS ||
+        header.type == JournalRecordType::PADDING || header.type > JournalRecordType::PRICE_UPDATE) {
+        return false;
+    }
+
+    const char* end = data + header.length;
+    const char* in = data + sizeof(JournalRecordHeader);
+    out.payload = in;
+    in += aligned(payloadSize(header.type));
+
+    for (size_t i = 0; i < JournalRecordView::MAX_STRINGS; i++) {
+        out.strings[i] = {};
+        if (i >= header.string_count) continue;
+        uint16_t length;
+        if (in + sizeof(length) > end) return false;
+        std::memcpy(&length, in, sizeof(length));
+        in += sizeof(length);
+        if (in + length > end) return false;
+        out.strings[i] = std::string_view(in, length);
+        in += length;
+    }
+    return in <= end;
+}
+
+size_t readFile(const std::filesystem::path& path,
+                const std::function<void(const JournalRecordView&)>& handler) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open journal " + path.string());
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < FILE_MAGIC.size() ||
+        std::string_view(data.data(), FILE_MAGIC.size()) != FILE_MAGIC) {
+        throw std::runtime_error(path.string() + " is not a trade journal");
+    }
+
+    size_t offset = FILE_MAGIC.size();
+    size_t records = 0;
+    JournalRecordView record;
+    while (decode(data.data() + offset, data.size() - offset, record)) {
+        handler(record);
+        offset += record.header->length;
+        records++;
+    }
+    return records;
+}
+
+} // namespace journal
+
+JournalRing::JournalRing(size_t capacity_bytes)
+    : capacity_(capacity_bytes), mask_(capacity_bytes - 1),
+      buffer_(new char[capacity_bytes]) {
+    if (capacity_bytes < 2 * sizeof(JournalRecordHeader) || (capacity_bytes & (capacity_bytes - 1)) != 0) {
+        throw std::invalid_argument("Journal ring capacity must be a power of two");
+    }
+}
+
+char* JournalRing::tryReserve(size_t length) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    size_t offset = tail & mask_;
+    size_t padding = (offset + length > capacity_) ? capacity_ - offset : 0;
+    size_t needed = padding + length;
+
+    if (length > capacity_ / 2) {
+        return nullptr;  // Could never be placed without wrapping
+    }
+    if (tail + needed - cached_head_ > capacity_) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        if (tail + needed - cached_head_ > capacity_) {
+            return nullptr;
+        }
+    }
+
+    if (padding > 0) {
+        // Only the length and type are read back, which fit in 8 bytes
+        JournalRecordHeader filler{static_cast<uint32_t>(padding), JournalRecordType::PADDING, 0, 0};
+        std::memcpy(&buffer_[offset], &filler, journal::ALIGNMENT);
+        offset = 0;
+    }
+    reserved_at_ = tail + padding;
+    return &buffer_[offset];
+}
+
+void JournalRing::commit(size_t length) {
+    tail_.store(reserved_at_ + length, std::memory_order_release);
+}
+
+const char* JournalRing::peek() {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    while (true) {
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return nullptr;
+            }
+        }
+        const char* record = &buffer_[head & mask_];
+        uint32_t length;
+        JournalRecordType type;
+        std::memcpy(&length, record, sizeof(length));
+        std::memcpy(&type, record + offsetof(JournalRecordHeader, type), sizeof(type));
+        if (type != JournalRecordType::PADDING) {
+            peeked_length_ = length;
+            return record;
+        }
+        head += length;
+        head_.store(head, std::memory_order_release);
+    }
+}
+
+void JournalRing::release() {
+    head_.store(head_.load(std::memory_order_relaxed) + peeked_length_, std::memory_order_release);
+    peeked_length_ = 0;
+}
+
+} // namespace pmm
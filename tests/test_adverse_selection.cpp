@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "strategy/adverse_selection.hpp"
+
+using namespace pmm;
+using namespace std::chrono_literals;
+
+class AdverseSelectionTest : public ::testing::Test {
+protected:
+    // A buy at 0.50 whose markout completes with the mid at exit_mid
+    void fillAndMarkOut(Price exit_mid) {
+        as.recordFill("token", now);
+        now += 31s;
+        as.recordMarkout("token", Side::BUY, 0.50, exit_mid);
+    }
+
+    AdverseSelectionManager as;
+    AdverseSelectionManager::Clock::time_point now = AdverseSelectionManager::Clock::now();
+};
+
+TEST_F(AdverseSelectionTest, BaselineWithoutFills) {
+    EXPECT_DOUBLE_EQ(as.getSpreadMultiplier("token", Side::BUY, 0.0), 1.0);
+    auto scores = as.getScores("token", Side::BUY, 0.0);
+    EXPECT_DOUBLE_EQ(scores.toxic_flow_score, 1.0);
+    EXPECT_DOUBLE_EQ(scores.volume_clock_score, 1.0);
+}
+
+TEST_F(AdverseSelectionTest, ToxicMarkoutsWidenTheSpread) {
+    as.recordFill("token", now);
+    EXPECT_DOUBLE_EQ(as.getScores("token", Side::BUY, 0.0).toxic_flow_score, 1.0);  // No markout yet
+
+    as.recordMarkout("token", Side::BUY, 0.50, 0.40);
+    auto scores = as.getScores("token", Side::BUY, 0.0);
+    EXPECT_DOUBLE_EQ(scores.toxic_flow_score, 2.0);
+
+    // 1.3x from the toxic fill history, 2x from fill quality, scaled by the volume clock
+    EXPECT_NEAR(scores.total_multiplier, 1.3 * 2.0 * scores.volume_clock_score, 1e-12);
+    EXPECT_DOUBLE_EQ(as.getWorstSpreadMultiplier("token", 0.0), scores.total_multiplier);
+}
+
+TEST_F(AdverseSelectionTest, EvictedFillsLeaveTheScore) {
+    for (int i = 0; i < 50; i++) {
+        fillAndMarkOut(0.45);  // 10% against us
+    }
+    EXPECT_DOUBLE_EQ(as.getScores("token", Side::BUY, 0.0).toxic_flow_score, 2.0);
+
+    for (int i = 0; i < 25; i++) {
+        fillAndMarkOut(0.50);
+    }
+    EXPECT_DOUBLE_EQ(as.getScores("token", Side::BUY, 0.0).toxic_flow_score, 1.5);
+
+    for (int i = 0; i < 25; i++) {
+        fillAndMarkOut(0.50);
+    }
+    EXPECT_NEAR(as.getScores("token", Side::BUY, 0.0).toxic_flow_score, 1.0, 1e-12);
+}
+
+TEST_F(AdverseSelectionTest, DecayRelaxesTheCachedMultiplier) {
+    fillAndMarkOut(0.40);
+    double before = as.getSpreadMultiplier("token", Side::BUY, 0.0);
+    for (int i = 0; i < 200; i++) {
+        as.decay();
+    }
+    double after = as.getSpreadMultiplier("token", Side::BUY, 0.0);
+    EXPECT_LT(after, before);
+    EXPECT_NEAR(after, 2.0 * as.getScores("token", Side::BUY, 0.0).volume_clock_score, 1e-4);
+}
+
+TEST(VolumeClockTrackerTest, CountsFillsInASlidingWindow) {
+    VolumeClockTracker clock;
+    auto start = std::chrono::steady_clock::time_point{} + 1000s;
+
+    for (int i = 0; i < 30; i++) {
+        clock.recordFill(start + std::chrono::seconds(i));
+    }
+    EXPECT_DOUBLE_EQ(clock.getFillRate(), 30.0 / 60.0);
+
+    // 70s in, the first 11 seconds have left the window
+    clock.recordFill(start + 70s);
+    EXPECT_EQ(clock.window_fills, 20u);
+
+    // A long gap empties it
+    clock.recordFill(start + 1000s);
+    EXPECT_EQ(clock.window_fills, 1u);
+    EXPECT_DOUBLE_EQ(clock.getFillRate(), 1.0 / 60.0);
+}
+
+TEST_F(AdverseSelectionTest, MarketTradesDriveTheVolumeClock) {
+    as.recordTrade("token", 0.50, 100.0, Side::BUY, now);
+    EXPECT_DOUBLE_EQ(as.getScores("token", Side::BUY, 0.0).volume_clock_score, 1.0);
+
+    // A quiet stretch, then a burst at four times the session average
+    as.recordTrade("token", 0.50, 100.0, Side::BUY, now + 600s);
+    as.recordTrade("token", 0.50, 300.0, Side::SELL, now + 601s);
+    const TradeFlow* flow = as.getTradeFlow("token");
+    ASSERT_NE(flow, nullptr);
+    EXPECT_DOUBLE_EQ(flow->volume(), 400.0);
+    EXPECT_NEAR(as.getScores("token", Side::BUY, 0.0).volume_clock_score,
+                std::sqrt(flow->volumeRate() / flow->sessionVolumeRate()), 1e-12);
+    EXPECT_GT(as.getScores("token", Side::BUY, 0.0).volume_clock_score, 1.5);
+}
+
+TEST_F(AdverseSelectionTest, AdvanceLetsAQuietTokenCalmDown) {
+    as.recordTrade("token", 0.50, 100.0, Side::BUY, now);
+    as.recordTrade("token", 0.50, 100.0, Side::BUY, now + 600s);
+    as.recordTrade("token", 0.50, 300.0, Side::SELL, now + 601s);
+    EXPECT_GT(as.getScores("token", Side::BUY, 0.0).volume_clock_score, 1.5);
+
+    // No trades since, so the score would stay put without the timer
+    as.advance(now + 700s);
+    EXPECT_DOUBLE_EQ(as.getTradeFlow("token")->volume(), 0.0);
+    EXPECT_DOUBLE_EQ(as.getScores("token", Side::BUY, 0.0).volume_clock_score, 0.8);
+}
+
+TEST_F(AdverseSelectionTest, AdvanceAgesOurOwnFills) {
+    for (int i = 0; i < 30; i++) {
+        as.recordFill("token", now + std::chrono::seconds(i));
+    }
+    EXPECT_GT(as.getScores("token", Side::BUY, 0.0).volume_clock_score, 1.0);
+
+    as.advance(now + 200s);
+    EXPECT_DOUBLE_EQ(as.getScores("token", Side::BUY, 0.0).volume_clock_score, 0.8);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "strategy/batch_quoter.hpp"
+#include <cstring>
+#include <random>
+
+using namespace pmm;
+
+namespace {
+
+bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// Random books plus prices that land exactly on half cents after the skew
+QuoteBatch randomBatch(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> cents(1, 98);
+    std::uniform_int_distribution<int> width(0, 8);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    QuoteBatch batch;
+    for (size_t i = 0; i < n; i++) {
+        QuoteInputs in;
+        in.best_bid = cents(rng) / 100.0;
+        in.best_ask = in.best_bid + width(rng) / 100.0;
+        in.mid = (in.best_bid + in.best_ask) / 2.0;
+        in.imbalance = (i % 5 == 0) ? 0.0 : unit(rng) * 2.0 - 1.0;
+        in.inventory = (i % 3 == 0) ? 0.0 : (unit(rng) - 0.3) * 3000.0;
+        in.avg_cost = (i % 4 == 0) ? 0.0 : unit(rng);
+        in.inventory_dollars = in.inventory * in.avg_cost;
+        in.max_position = 500.0 + unit(rng) * 1000.0;
+        in.spread_pct = (i % 7 == 0) ? 0.0 : unit(rng) * 0.1;
+        in.spread_multiplier = 1.0 + unit(rng) * 2.0;
+        in.risk_aversion = (i % 6 == 0) ? 0.0 : 0.1;
+        in.volatility = 0.01 + unit(rng) * 0.49;
+        in.time_urgency = unit(rng);
+        in.ttl_seconds = 30 + static_cast<int>(i % 4) * 30;
+        batch.add(in);
+    }
+    return batch;
+}
+
+void expectMatchesScalar(const QuoteBatch& batch) {
+    for (size_t i = 0; i < batch.size(); i++) {
+        Quote expected;
+        bool ok = DefaultQuoting::quote(batch.inputs(i), expected);
+        ASSERT_EQ(batch.valid(i), ok) << "token " << i;
+        EXPECT_TRUE(sameBits(batch.bid[i], expected.bid_price)) << "token " << i;
+        EXPECT_TRUE(sameBits(batch.ask[i], expected.ask_price)) << "token " << i;
+        EXPECT_TRUE(sameBits(batch.quote_size[i], expected.bid_size)) << "token " << i;
+        EXPECT_EQ(batch.quote(i).ttl_seconds, expected.ttl_seconds);
+    }
+}
+
+} // namespace
+
+TEST(BatchQuoterTest, ScalarMatchesDefaultQuoting) {
+    QuoteBatch batch = randomBatch(1001, 1);
+    quoteBatch(batch, BatchKernel::SCALAR);
+    expectMatchesScalar(batch);
+}
+
+TEST(BatchQuoterTest, Avx2MatchesDefaultQuotingBitForBit) {
+    if (bestBatchKernel() != BatchKernel::AVX2) {
+        GTEST_SKIP() << "No AVX2 on this CPU";
+    }
+    for (unsigned seed = 0; seed < 20; seed++) {
+        QuoteBatch batch = randomBatch(1003, seed);  // Not a multiple of 4
+        quoteBatch(batch, BatchKernel::AVX2);
+        expectMatchesScalar(batch);
+        if (HasFailure()) {
+            FAIL() << "seed " << seed;
+        }
+    }
+}
+
+TEST(BatchQuoterTest, RoundsHalfCentsAwayFromZero) {
+    // Bid and ask land on x.5 cents before rounding, as std::round sees them
+    QuoteInputs in;
+    in.best_bid = 0.40;
+    in.best_ask = 0.60;
+    in.mid = 0.50;
+    in.risk_aversion = 0.0;
+    in.spread_pct = 0.05;  // Half width 0.0125
+    in.max_position = 10000.0;
+
+    QuoteBatch batch;
+    for (int i = 0; i < 8; i++) {
+        batch.add(in);
+    }
+    quoteBatch(batch);
+    expectMatchesScalar(batch);
+    EXPECT_TRUE(batch.valid(7));
+}
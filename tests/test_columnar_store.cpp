@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "utils/columnar_store.hpp"
+#include "utils/trading_logger.hpp"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace pmm;
+
+class ColumnarStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir = std::filesystem::temp_directory_path() / "pmm_test_columnar_store";
+        std::filesystem::remove_all(test_dir);
+        std::filesystem::create_directories(test_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir);
+    }
+
+    std::vector<ColumnSpec> schema() {
+        return {
+            {"time", ColumnType::INT64},
+            {"token_id", ColumnType::STRING},
+            {"mid_price", ColumnType::PRICE},
+            {"volume", ColumnType::DOUBLE},
+        };
+    }
+
+    // Token A for the first 100 rows, then alternating B and C
+    void writeRows(ColumnarWriter& writer, int rows) {
+        for (int i = 0; i < rows; i++) {
+            writer.addInt64(0, 1700000000000 + i * 250);
+            writer.addString(1, i < 100 ? "TOKEN_A" : (i % 2 ? "TOKEN_B" : "TOKEN_C"));
+            writer.addDouble(2, 0.40 + (i % 7) * 0.001);
+            writer.addDouble(3, 1000.0 + i * 0.5);
+            writer.endRow();
+        }
+    }
+
+    std::filesystem::path test_dir;
+};
+
+TEST_F(ColumnarStoreTest, RoundTripsEveryColumnType) {
+    {
+        ColumnarWriter writer(test_dir / "t.pmmc", schema(), 64);
+        writeRows(writer, 150);
+        EXPECT_EQ(writer.rows(), 150u);
+    }
+
+    ColumnarReader reader(test_dir / "t.pmmc");
+    ASSERT_EQ(reader.columns().size(), 4u);
+    EXPECT_EQ(reader.columnIndex("mid_price"), 2);
+    EXPECT_EQ(reader.columnIndex("missing"), -1);
+    EXPECT_EQ(reader.blockCount(), 3u);  // 64 + 64 + 22
+    EXPECT_EQ(reader.rowCount(), 150u);
+
+    std::vector<int64_t> times = reader.readInt64(2, 0);
+    ASSERT_EQ(times.size(), 22u);
+    EXPECT_EQ(times[0], 1700000000000 + 128 * 250);
+
+    std::vector<std::string> tokens = reader.readString(1, 1);
+    EXPECT_EQ(tokens[0], "TOKEN_A");
+    EXPECT_EQ(tokens[63], "TOKEN_B");  // Row 127
+
+    std::vector<double> mids = reader.readDouble(0, 2);
+    EXPECT_DOUBLE_EQ(mids[3], 0.403);
+    std::vector<double> volumes = reader.readDouble(0, 3);
+    EXPECT_DOUBLE_EQ(volumes[10], 1005.0);
+
+    // Block stats
+    EXPECT_DOUBLE_EQ(reader.stats(0, 2).min, 0.40);
+    EXPECT_DOUBLE_EQ(reader.stats(0, 2).max, 0.406);
+    EXPECT_DOUBLE_EQ(reader.stats(2, 3).max, 1000.0 + 149 * 0.5);
+    EXPECT_EQ(reader.stats(0, 1).dictionary, std::vector<std::string>{"TOKEN_A"});
+    EXPECT_EQ(reader.stats(2, 1).dictionary.size(), 2u);
+}
+
+TEST_F(ColumnarStoreTest, ScanSkipsBlocksWithoutTheToken) {
+    {
+        ColumnarWriter writer(test_dir / "t.pmmc", schema(), 64);
+        writeRows(writer, 150);
+    }
+    ColumnarReader reader(test_dir / "t.pmmc");
+
+    std::vector<double> volumes = reader.scan("volume", "token_id", "TOKEN_B");
+    ASSERT_EQ(volumes.size(), 25u);  // Odd rows from 101 to 149
+    EXPECT_DOUBLE_EQ(volumes.front(), 1000.0 + 101 * 0.5);
+    // Block 0 only holds TOKEN_A; two chunks each from blocks 1 and 2
+    EXPECT_EQ(reader.chunksDecompressed(), 4u);
+
+    EXPECT_TRUE(reader.scan("volume", "token_id", "TOKEN_Z").empty());
+    EXPECT_EQ(reader.chunksDecompressed(), 4u);
+    EXPECT_THROW(reader.scan("nope", "token_id", "TOKEN_A"), std::invalid_argument);
+}
+
+TEST_F(ColumnarStoreTest, TruncatedFileKeepsWholeBlocks) {
+    {
+        ColumnarWriter writer(test_dir / "t.pmmc", schema(), 64);
+        writeRows(writer, 150);
+    }
+    auto size = std::filesystem::file_size(test_dir / "t.pmmc");
+    std::filesystem::resize_file(test_dir / "t.pmmc", size - 10);
+
+    ColumnarReader reader(test_dir / "t.pmmc");
+    EXPECT_EQ(reader.blockCount(), 2u);
+    EXPECT_EQ(reader.rowCount(), 128u);
+}
+
+TEST_F(ColumnarStoreTest, RejectsMismatchedValues) {
+    ColumnarWriter writer(test_dir / "t.pmmc", schema());
+    EXPECT_THROW(writer.addDouble(0, 1.0), std::logic_error);
+    EXPECT_THROW(writer.addString(2, "x"), std::logic_error);
+    EXPECT_THROW(writer.addInt64(9, 1), std::logic_error);
+
+    writer.addInt64(0, 1);
+    EXPECT_THROW(writer.endRow(), std::logic_error);  // Other columns missing
+
+    std::ofstream(test_dir / "x.csv") << "timestamp\n";
+    EXPECT_THROW(ColumnarReader(test_dir / "x.csv"), std::runtime_error);
+}
+
+TEST_F(ColumnarStoreTest, TradingLoggerWritesColumnarPriceUpdates) {
+    auto logUpdates = [&](JournalFormat format, const std::string& name) {
+        TradingLogger logger(test_dir / name, format);
+        logger.startSession("Test Event");
+        for (int i = 0; i < 10000; i++) {
+            const TokenId token = (i % 4 == 0) ? "TOKEN_YES" : "TOKEN_NO";
+            Price bid = 0.40 + (i / 50 % 10) * 0.01;
+            logger.logPriceUpdate("Will it happen?", "MARKET_001", "0xCOND", token, bid + 0.005, 0.01, 0.0001,
+                                  bid, bid + 0.01, 0.01, 240.0, 1000.0 + i % 13, 800.0, 1800.0 + i % 13,
+                                  0.11, 5, 4, 100.0, 12.0, 0.5);
+        }
+        logger.endSession();
+        return logger.getSessionDir();
+    };
+    std::filesystem::path csv_dir = logUpdates(JournalFormat::CSV, "csv");
+    std::filesystem::path columnar_dir = logUpdates(JournalFormat::COLUMNAR, "columnar");
+    EXPECT_FALSE(std::filesystem::exists(columnar_dir / "price_updates.csv"));
+    EXPECT_TRUE(std::filesystem::exists(columnar_dir / "orders.csv"));
+
+    ColumnarReader reader(columnar_dir / "price_updates.pmmc");
+    EXPECT_EQ(reader.rowCount(), 10000u);
+    std::vector<double> bids = reader.scan("best_bid", "token_id", "TOKEN_YES");
+    ASSERT_EQ(bids.size(), 2500u);
+    EXPECT_DOUBLE_EQ(bids[0], 0.40);
+    EXPECT_DOUBLE_EQ(bids[13], 0.41);  // Row 52
+
+    auto csv_size = std::filesystem::file_size(csv_dir / "price_updates.csv");
+    auto columnar_size = std::filesystem::file_size(columnar_dir / "price_updates.pmmc");
+    EXPECT_LT(columnar_size * 10, csv_size);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "strategy/condition_quoter.hpp"
+#include <random>
+
+using namespace pmm;
+
+namespace {
+
+// What MarketMaker::prepareQuote would gather for a plain-mid market
+QuoteInputs book(Price best_bid, Price best_ask, double inventory = 0.0) {
+    QuoteInputs in;
+    in.best_bid = best_bid;
+    in.best_ask = best_ask;
+    in.mid = (best_bid + best_ask) / 2.0;
+    in.inventory = inventory;
+    return in;
+}
+
+} // namespace
+
+TEST(ConditionQuoterTest, FairValuesSumToOne) {
+    ConditionQuoter binary;
+    binary.addOutcome(0);
+    binary.addOutcome(1);
+    binary.setInputs(0, book(0.60, 0.64));  // Yes mid 0.62
+    binary.setInputs(1, book(0.34, 0.36));  // No mid 0.35
+    ASSERT_TRUE(binary.quote());
+    EXPECT_NEAR(binary.fairValue(0), 0.635, 1e-12);
+    EXPECT_NEAR(binary.fairValue(1), 0.365, 1e-12);
+
+    ConditionQuoter multi;
+    for (TokenHandle h = 0; h < 3; h++) {
+        multi.addOutcome(h);
+    }
+    multi.setInputs(0, book(0.48, 0.52));
+    multi.setInputs(1, book(0.30, 0.34));
+    multi.setInputs(2, book(0.20, 0.24));
+    ASSERT_TRUE(multi.quote());
+    EXPECT_NEAR(multi.fairValue(0) + multi.fairValue(1) + multi.fairValue(2), 1.0, 1e-12);
+    EXPECT_GT(multi.fairValue(0), multi.fairValue(1));
+}
+
+TEST(ConditionQuoterTest, WaitsForEveryBook) {
+    ConditionQuoter quoter;
+    quoter.addOutcome(0);
+    quoter.addOutcome(1);
+    quoter.setInputs(0, book(0.45, 0.55));
+    EXPECT_FALSE(quoter.quote());
+}
+
+TEST(ConditionQuoterTest, UsesEachOutcomesQuoteInputs) {
+    auto quoteWith = [](double volatility, Price yes_fair) {
+        ConditionQuoter quoter;
+        quoter.addOutcome(0);
+        quoter.addOutcome(1);
+        QuoteInputs yes = book(0.40, 0.60, 300.0);
+        yes.volatility = volatility;
+        yes.mid = yes_fair;  // e.g. the market's microprice
+        quoter.setInputs(0, yes);
+        quoter.setInputs(1, book(0.40, 0.60));
+        EXPECT_TRUE(quoter.quote());
+        return quoter;
+    };
+
+    ConditionQuoter calm = quoteWith(0.05, 0.50);
+    ConditionQuoter volatile_yes = quoteWith(0.50, 0.50);
+    // Long Yes lowers the Yes bid, more so the more volatile Yes is
+    EXPECT_LT(volatile_yes.bidPrice(0), calm.bidPrice(0));
+    EXPECT_EQ(volatile_yes.ttlSeconds(0), 90);
+
+    ConditionQuoter leaning = quoteWith(0.05, 0.54);
+    EXPECT_NEAR(leaning.fairValue(0), 0.52, 1e-12);
+    EXPECT_NEAR(leaning.fairValue(1), 0.48, 1e-12);
+}
+
+TEST(ConditionQuoterTest, CompleteSetsCarryNoInventoryRisk) {
+    auto quoteWith = [&](double yes, double no) {
+        ConditionQuoter quoter;
+        quoter.addOutcome(0);
+        quoter.addOutcome(1);
+        QuoteInputs yes_in = book(0.60, 0.64, yes);
+        QuoteInputs no_in = book(0.34, 0.36, no);
+        yes_in.max_position = no_in.max_position = 50.0;
+        quoter.setInputs(0, yes_in);
+        quoter.setInputs(1, no_in);
+        EXPECT_TRUE(quoter.quote());
+        return quoter;
+    };
+
+    ConditionQuoter flat = quoteWith(0, 0);
+    ConditionQuoter hedged = quoteWith(100, 100);
+    EXPECT_NEAR(hedged.inventoryRisk(), 0.0, 1e-9);
+    EXPECT_DOUBLE_EQ(hedged.bidSize(0), flat.bidSize(0));
+    EXPECT_DOUBLE_EQ(hedged.askSize(1), flat.askSize(1));
+
+    // Long Yes alone is risk: buy less Yes, sell less No
+    ConditionQuoter long_yes = quoteWith(100, 0);
+    EXPECT_GT(long_yes.inventoryRisk(), 0.0);
+    EXPECT_LT(long_yes.bidSize(0), flat.bidSize(0));
+    EXPECT_LT(long_yes.askSize(1), flat.askSize(1));
+    EXPECT_GE(long_yes.askSize(0), flat.askSize(0));
+}
+
+TEST(ConditionQuoterTest, NeverCrossesItsOwnBook) {
+    // Books that disagree with each other: Yes + No mids sum to 1.22, so
+    // fair values sit well below both books
+    ConditionQuoter quoter;
+    quoter.addOutcome(0);
+    quoter.addOutcome(1);
+    quoter.setInputs(0, book(0.60, 0.62));
+    quoter.setInputs(1, book(0.60, 0.62));
+    ASSERT_TRUE(quoter.quote());
+
+    for (size_t i = 0; i < 2; i++) {
+        if (quoter.askSize(i) > 0.0) {
+            EXPECT_GE(quoter.askPrice(i), 0.61 - 1e-9);
+        }
+        if (quoter.bidSize(i) > 0.0) {
+            EXPECT_LT(quoter.bidPrice(i), 0.62);
+        }
+    }
+}
+
+TEST(ConditionQuoterTest, QuotesCannotBeArbitragedAgainstEachOther) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> weight(0.1, 1.0);
+    std::uniform_int_distribution<int> outcomes(2, 4);
+
+    for (int trial = 0; trial < 2000; trial++) {
+        ConditionQuoter quoter;
+        int n = outcomes(rng);
+        std::vector<double> w(n);
+        double total = 0.0;
+        for (double& x : w) {
+            x = weight(rng);
+            total += x;
+        }
+        std::vector<QuoteInputs> books;
+        for (int i = 0; i < n; i++) {
+            quoter.addOutcome(i);
+            double mid = std::round(w[i] / total * 100.0) / 100.0;
+            books.push_back(book(std::max(0.01, mid - 0.02), std::min(0.99, mid + 0.02)));
+            books.back().spread_pct = 0.015;
+            quoter.setInputs(i, books.back());
+        }
+        ASSERT_TRUE(quoter.quote());
+
+        double bid_sum = 0.0;
+        double ask_sum = 0.0;
+        bool all_bids = true;
+        bool all_asks = true;
+        for (int i = 0; i < n; i++) {
+            bid_sum += quoter.bidPrice(i);
+            ask_sum += quoter.askPrice(i);
+            all_bids &= quoter.bidSize(i) > 0.0;
+            all_asks &= quoter.askSize(i) > 0.0;
+            if (quoter.bidSize(i) > 0.0 && quoter.askSize(i) > 0.0) {
+                EXPECT_LT(quoter.bidPrice(i), quoter.askPrice(i));
+            }
+            if (quoter.bidSize(i) > 0.0) {
+                EXPECT_LT(quoter.bidPrice(i), books[i].best_ask) << "trial " << trial;
+            }
+            if (quoter.askSize(i) > 0.0) {
+                EXPECT_GT(quoter.askPrice(i), books[i].best_bid) << "trial " << trial;
+            }
+        }
+        if (all_bids) {
+            EXPECT_LT(bid_sum, 1.0 - 1e-9) << "trial " << trial;
+        }
+        if (all_asks) {
+            EXPECT_GT(ask_sum, 1.0 + 1e-9) << "trial " << trial;
+        }
+    }
+}
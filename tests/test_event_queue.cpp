@@ -30,6 +30,27 @@ TEST_F(EventQueueTest, MultipleEvents) {
     }
 }
 
+TEST_F(EventQueueTest, TryPopOnEmptyQueue) {
+    Event event = Event::shutdown("unused");
+    EXPECT_FALSE(queue.tryPop(event));
+    
+    queue.push(Event::timerTick());
+    EXPECT_TRUE(queue.tryPop(event));
+    EXPECT_EQ(event.type, EventType::TIMER_TICK);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(EventQueueTest, PopUntilTimesOutOnEmptyQueue) {
+    Event event = Event::shutdown("unused");
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+    EXPECT_FALSE(queue.popUntil(event, deadline));
+    EXPECT_GE(std::chrono::steady_clock::now(), deadline);
+    
+    queue.push(Event::timerTick());
+    EXPECT_TRUE(queue.popUntil(event, std::chrono::steady_clock::now()));
+    EXPECT_EQ(event.type, EventType::TIMER_TICK);
+}
+
 TEST_F(EventQueueTest, ProducerConsumerThreadSafety) {
     std::atomic<int> consumed{0};
     const int NUM_EVENTS = 100;
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "core/flat_id_map.hpp"
+#include <unordered_map>
+#include <random>
+
+using namespace pmm;
+
+TEST(FlatIdMapTest, InsertFindErase) {
+    FlatIdMap map;
+    map.insert(1, 10);
+    map.insert(2, 20);
+    
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map.find(1), 10u);
+    EXPECT_EQ(map.find(2), 20u);
+    EXPECT_EQ(map.find(3), FlatIdMap::NOT_FOUND);
+    EXPECT_EQ(map.find(0), FlatIdMap::NOT_FOUND);
+    
+    EXPECT_TRUE(map.erase(1));
+    EXPECT_FALSE(map.erase(1));
+    EXPECT_EQ(map.find(1), FlatIdMap::NOT_FOUND);
+    EXPECT_EQ(map.find(2), 20u);
+}
+
+TEST(FlatIdMapTest, GrowsPastInitialCapacity) {
+    FlatIdMap map(16);
+    for (uint64_t id = 1; id <= 1000; id++) {
+        map.insert(id, static_cast<uint32_t>(id * 2));
+    }
+    
+    EXPECT_EQ(map.size(), 1000u);
+    for (uint64_t id = 1; id <= 1000; id++) {
+        EXPECT_EQ(map.find(id), id * 2);
+    }
+}
+
+TEST(FlatIdMapTest, MatchesReferenceUnderChurn) {
+    // Colliding keys exercise the backward-shift delete
+    FlatIdMap map(16);
+    std::unordered_map<uint64_t, uint32_t> reference;
+    std::mt19937_64 rng(42);
+    
+    for (int i = 0; i < 20000; i++) {
+        uint64_t key = 1 + (rng() % 64) * 16 + (rng() % 3);
+        if (rng() % 2) {
+            uint32_t value = static_cast<uint32_t>(rng());
+            map.insert(key, value);
+            reference[key] = value;
+        } else {
+            EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+        }
+    }
+    
+    EXPECT_EQ(map.size(), reference.size());
+    for (const auto& [key, value] : reference) {
+        EXPECT_EQ(map.find(key), value);
+    }
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include "utils/logger.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace pmm;
+
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir = std::filesystem::temp_directory_path() / "pmm_test_logger";
+        std::filesystem::remove_all(test_dir);
+        Logger::init(test_dir.string(), "first");
+    }
+
+    void TearDown() override {
+        Logger::shutdown();
+        std::filesystem::remove_all(test_dir);
+    }
+
+    std::string readLog(const std::filesystem::path& path) {
+        std::ifstream file(path);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    std::filesystem::path test_dir;
+};
+
+TEST_F(LoggerTest, DisabledLevelSkipsArguments) {
+    Logger::get()->set_level(spdlog::level::info);
+
+    int evaluations = 0;
+    auto expensive = [&]() { return ++evaluations; };
+
+    LOG_DEBUG("value {}", expensive());
+    EXPECT_EQ(evaluations, 0);
+
+    LOG_INFO("value {}", expensive());
+    EXPECT_EQ(evaluations, 1);
+
+    // Below the compile-time floor the line is gone at any runtime level
+    Logger::get()->set_level(spdlog::level::trace);
+    LOG_TRACE("value {}", expensive());
+    EXPECT_EQ(evaluations, PMM_LOG_ACTIVE_LEVEL <= PMM_LOG_LEVEL_TRACE ? 2 : 1);
+}
+
+TEST_F(LoggerTest, SessionDirKeepsLevelAndGetsLines) {
+    Logger::get()->set_level(spdlog::level::warn);
+    Logger::updateSessionDir((test_dir / "session").string(), "second");
+    EXPECT_EQ(Logger::get()->level(), spdlog::level::warn);
+
+    LOG_WARN("in the session dir");
+    Logger::shutdown();  // Drains the queue
+
+    EXPECT_NE(readLog(test_dir / "session" / "second_all.log").find("in the session dir"), std::string::npos);
+    EXPECT_EQ(readLog(test_dir / "first_all.log").find("in the session dir"), std::string::npos);
+}
@@ -138,4 +138,20 @@ TEST_F(MarketMakerTest, ReducedProfitRequirementWithTimeUrgency) {
     
     EXPECT_GE(quote->ask_price, 0.50);
     EXPECT_LT(quote->ask_price, 0.52);
-}
\ No newline at end of file
+}
+TEST_F(MarketMakerTest, FairValueModelMovesTheQuote) {
+    book->updateBid(0.48, 1000);
+    book->updateAsk(0.54, 100);
+    
+    MarketMetadata metadata;
+    auto plain = mm->generateQuote(*book, &metadata);
+    metadata.fair_value_model = FairValueModel::MICROPRICE;
+    auto micro = mm->generateQuote(*book, &metadata);
+    ASSERT_TRUE(plain.has_value());
+    ASSERT_TRUE(micro.has_value());
+    
+    // Heavy bids pull the microprice well above the mid
+    EXPECT_GT(micro->bid_price, plain->bid_price);
+    EXPECT_GT(micro->ask_price, plain->ask_price);
+    EXPECT_LT(micro->bid_price, 0.54);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "utils/market_summary_logger.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace pmm;
+
+class MarketSummaryLoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir = std::filesystem::temp_directory_path() / "pmm_test_market_summary";
+        std::filesystem::remove_all(test_dir);
+        std::filesystem::create_directories(test_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir);
+    }
+
+    std::vector<std::string> readLines(const std::filesystem::path& path) {
+        std::vector<std::string> lines;
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    // Splits a row and returns the given column
+    std::string column(const std::string& row, size_t index) {
+        size_t start = 0;
+        for (size_t i = 0; i < index; i++) {
+            start = row.find(',', start) + 1;
+        }
+        return row.substr(start, row.find(',', start) - start);
+    }
+
+    std::filesystem::path test_dir;
+};
+
+TEST_F(MarketSummaryLoggerTest, SummarisesQueuedSamples) {
+    MarketSummaryLogger summaries(test_dir);
+    for (int i = 0; i < 20000; i++) {
+        const TokenId token = (i % 2) ? "TOKEN_NO" : "TOKEN_YES";
+        double bid = (i % 2) ? 0.55 : 0.40 + (i % 10) * 0.001;
+        summaries.updateMarket("Will it happen?", "MARKET_001", "0xCOND", token, bid + 0.005, 250.0,
+                               bid, bid + 0.01, 1000.0, 800.0, 5, 4);
+        if (i % 4000 == 0) {
+            summaries.flush();  // Keeps the queue from overflowing
+        }
+    }
+    summaries.logSummaries();
+    EXPECT_EQ(summaries.droppedSamples(), 0u);
+
+    // The analytics thread may have written its own first pass already;
+    // the requested one is last, one row per market
+    std::vector<std::string> lines = readLines(test_dir / "market_summary.csv");
+    ASSERT_GE(lines.size(), 3u);
+    const std::string& yes = lines[lines.size() - 2];
+    const std::string& no = lines.back();
+    EXPECT_EQ(column(yes, 3), "TOKEN_YES");
+    EXPECT_EQ(column(no, 3), "TOKEN_NO");
+    EXPECT_DOUBLE_EQ(std::stod(column(no, 4)), 0.555);  // mid_price
+    EXPECT_DOUBLE_EQ(std::stod(column(no, 8)), 0.0);    // Flat mid, no volatility
+    EXPECT_GT(std::stod(column(yes, 8)), 0.0);
+    EXPECT_DOUBLE_EQ(std::stod(column(yes, 22)), -1.0);  // No event end time
+}
+
+TEST_F(MarketSummaryLoggerTest, EventEndTimeReachesEveryToken) {
+    MarketSummaryLogger summaries(test_dir);
+    summaries.updateMarket("M", "MARKET_001", "0xCOND", "TOKEN_YES", 0.45, 200.0, 0.44, 0.46, 100.0, 100.0, 1, 1);
+    summaries.setEventEndTime("0xCOND", std::chrono::system_clock::now() + std::chrono::hours(10));
+    // A market first seen after the end time was set picks it up too
+    summaries.updateMarket("M", "MARKET_001", "0xCOND", "TOKEN_NO", 0.55, 200.0, 0.54, 0.56, 100.0, 100.0, 1, 1);
+    summaries.logSummaries();
+
+    std::vector<std::string> lines = readLines(test_dir / "market_summary.csv");
+    ASSERT_GE(lines.size(), 3u);
+    for (size_t i = lines.size() - 2; i < lines.size(); i++) {
+        EXPECT_NEAR(std::stod(column(lines[i], 22)), 10.0, 0.01);
+    }
+}
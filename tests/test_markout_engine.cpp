@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "strategy/markout_engine.hpp"
+#include <stdexcept>
+#include <utility>
+
+using namespace pmm;
+using namespace std::chrono_literals;
+
+class MarkoutEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        engine.onMarkout([this](const MarkoutRecord& fill, size_t horizon) {
+            markouts.push_back({fill.fill_seq, horizon});
+        });
+        engine.onCompletion([this](const MarkoutRecord& fill) { completed.push_back(fill); });
+    }
+
+    void fill(uint64_t seq, MarkoutEngine::Clock::time_point at, Side side = Side::BUY) {
+        MarkoutRecord record;
+        record.fill_seq = seq;
+        record.side = side;
+        record.fill_time = at;
+        record.fill_price = 0.50;
+        record.mid_at_fill = 0.50;
+        engine.registerFill(record);
+    }
+
+    MarkoutEngine engine{{1, 5, 30}};
+    MarkoutEngine::Clock::time_point start = MarkoutEngine::Clock::now();
+    Price mid = 0.55;
+    std::vector<std::pair<uint64_t, size_t>> markouts;  // (fill_seq, horizon)
+    std::vector<MarkoutRecord> completed;
+};
+
+TEST_F(MarkoutEngineTest, CapturesEachHorizonOnce) {
+    fill(1, start);
+    fill(2, start + 3s);
+    auto mid_of = [this](uint32_t) { return mid; };
+
+    engine.capture(start + 2s, mid_of);
+    ASSERT_EQ(markouts.size(), 1u);
+    EXPECT_EQ(markouts[0], std::make_pair(uint64_t{1}, size_t{0}));
+
+    // Nothing new is due, so nothing is captured twice
+    engine.capture(start + 2s, mid_of);
+    EXPECT_EQ(markouts.size(), 1u);
+
+    engine.capture(start + 10s, mid_of);
+    EXPECT_EQ(markouts.size(), 4u);  // Fill 1 at 5s, fill 2 at 1s and 5s
+    EXPECT_TRUE(completed.empty());
+
+    mid = 0.45;
+    engine.capture(start + 31s, mid_of);
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_EQ(completed[0].fill_seq, 1u);
+    EXPECT_DOUBLE_EQ(engine.midAt(completed[0], 5), 0.55);
+    EXPECT_DOUBLE_EQ(engine.midAt(completed[0], 30), 0.45);
+    EXPECT_DOUBLE_EQ(engine.midAt(completed[0], 60), 0.0);  // Not a horizon
+    EXPECT_NEAR(completed[0].priceMove(2), -0.05, 1e-12);
+    EXPECT_EQ(engine.pending(), 1u);
+}
+
+TEST_F(MarkoutEngineTest, SkipsHorizonsWithoutABook) {
+    fill(1, start, Side::SELL);
+    engine.capture(start + 2s, [](uint32_t) { return 0.0; });
+    engine.capture(start + 40s, [this](uint32_t) { return mid; });
+
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_DOUBLE_EQ(completed[0].mid_later[0], 0.0);
+    EXPECT_DOUBLE_EQ(completed[0].mid_later[1], 0.55);
+    EXPECT_NEAR(completed[0].priceMove(1), -0.05, 1e-12);  // A sell, and the mid went up
+}
+
+TEST_F(MarkoutEngineTest, FullRingFlushesTheOldestFill) {
+    for (uint64_t seq = 1; seq <= MarkoutEngine::CAPACITY + 1; seq++) {
+        fill(seq, start);
+    }
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_EQ(completed[0].fill_seq, 1u);
+    EXPECT_EQ(engine.pending(), MarkoutEngine::CAPACITY);
+    EXPECT_EQ(engine.totalFills(), MarkoutEngine::CAPACITY + 1);
+
+    // The flushed fill is never marked out
+    engine.capture(start + 1s, [this](uint32_t) { return mid; });
+    EXPECT_EQ(markouts.size(), MarkoutEngine::CAPACITY);
+    EXPECT_EQ(markouts.front().first, 2u);
+}
+
+TEST_F(MarkoutEngineTest, NextDueIsTheEarliestUncapturedHorizon) {
+    EXPECT_EQ(engine.nextDue(), MarkoutEngine::Clock::time_point::max());
+
+    fill(1, start);
+    fill(2, start + 3s);
+    EXPECT_EQ(engine.nextDue(), start + 1s);
+
+    engine.capture(start + 1s, [this](uint32_t) { return mid; });
+    EXPECT_EQ(engine.nextDue(), start + 4s);  // Fill 2 at 1s comes before fill 1 at 5s
+
+    engine.capture(start + 33s, [this](uint32_t) { return mid; });
+    EXPECT_EQ(engine.nextDue(), MarkoutEngine::Clock::time_point::max());
+}
+
+TEST_F(MarkoutEngineTest, PriceMoveIsMeasuredFromTheMidAtFill) {
+    MarkoutRecord record;
+    record.fill_time = start;
+    record.fill_price = 0.49;  // Bought a cent under the mid
+    record.mid_at_fill = 0.50;
+    engine.registerFill(record);
+    engine.capture(start + 31s, [](uint32_t) { return 0.50; });
+
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_DOUBLE_EQ(completed[0].priceMove(2), 0.0);
+}
+
+TEST(MarkoutEngineConfigTest, RejectsBadHorizons) {
+    EXPECT_THROW(MarkoutEngine(std::vector<int>{}), std::invalid_argument);
+    EXPECT_THROW(MarkoutEngine({5, 1}), std::invalid_argument);
+    EXPECT_THROW(MarkoutEngine({0, 5}), std::invalid_argument);
+    EXPECT_THROW(MarkoutEngine({1, 2, 3, 4, 5, 6, 7, 8, 9}), std::invalid_argument);
+
+    MarkoutEngine engine({5, 30});
+    EXPECT_EQ(engine.horizonIndex(30), 1);
+    EXPECT_EQ(engine.horizonIndex(1), -1);
+}
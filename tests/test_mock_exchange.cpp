@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include "sim/matching_engine.hpp"
+#include "sim/mock_exchange.hpp"
+#include "sim/scenario.hpp"
+#include "network/order_gateway.hpp"
+#include "network/websocket_client.hpp"
+#include "core/event_queue.hpp"
+#include <thread>
+
+using namespace pmm;
+
+// Full-length id; the feed parser assumes real token ids when logging
+static const TokenId TOKEN = "71321045679252212594626385532706912750332728571942532289631379312455583992563";
+
+// Pops events until one of the wanted type arrives or the timeout passes
+static bool waitForEvent(EventQueue& queue, EventType type, Event& out,
+                         std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (queue.tryPop(out)) {
+            if (out.type == type) {
+                return true;
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    return false;
+}
+
+TEST(MatchingEngineTest, NewOrderQueuesBehindDisplayedSize) {
+    MatchingEngine engine;
+    engine.setBook("T", {{0.45, 100.0}}, {{0.55, 100.0}});
+
+    PlaceResult ours = engine.place("T", Side::BUY, 0.45, 10.0);
+    ASSERT_TRUE(ours.accepted);
+    EXPECT_DOUBLE_EQ(ours.resting, 10.0);
+    EXPECT_DOUBLE_EQ(engine.levelSize("T", Side::BUY, 0.45), 110.0);
+
+    // The displayed 100 trades first
+    engine.marketOrder("T", Side::SELL, 100.0);
+    EXPECT_EQ(engine.fills().back().maker_order_id, "");
+    EXPECT_EQ(engine.restingOrderCount(), 1u);
+
+    engine.marketOrder("T", Side::SELL, 4.0);
+    EXPECT_EQ(engine.fills().back().maker_order_id, ours.order_id);
+    EXPECT_DOUBLE_EQ(engine.fills().back().size, 4.0);
+    EXPECT_DOUBLE_EQ(engine.levelSize("T", Side::BUY, 0.45), 6.0);
+}
+
+TEST(MatchingEngineTest, CrossingOrderTradesAtRestingPriceAndRestsRemainder) {
+    MatchingEngine engine;
+    engine.setBook("T", {{0.40, 100.0}}, {{0.55, 50.0}, {0.58, 20.0}});
+    engine.takeChanges();
+
+    PlaceResult result = engine.place("T", Side::BUY, 0.56, 80.0);
+    ASSERT_TRUE(result.accepted);
+    EXPECT_DOUBLE_EQ(result.filled, 50.0);
+    EXPECT_DOUBLE_EQ(result.resting, 30.0);
+    EXPECT_DOUBLE_EQ(engine.fills().back().price, 0.55);
+
+    auto bids = engine.bids("T");
+    ASSERT_EQ(bids.size(), 2u);
+    EXPECT_DOUBLE_EQ(bids[0].first, 0.56);
+    EXPECT_DOUBLE_EQ(bids[0].second, 30.0);
+    EXPECT_DOUBLE_EQ(engine.asks("T").front().first, 0.58);
+
+    // Ask level removed, new bid level added
+    auto changes = engine.takeChanges();
+    ASSERT_EQ(changes.size(), 2u);
+    EXPECT_EQ(changes[0].side, Side::SELL);
+    EXPECT_DOUBLE_EQ(changes[0].size, 0.0);
+    EXPECT_EQ(changes[1].side, Side::BUY);
+    EXPECT_DOUBLE_EQ(changes[1].size, 30.0);
+}
+
+TEST(MatchingEngineTest, CancelAndValidation) {
+    MatchingEngine engine;
+    PlaceResult result = engine.place("T", Side::SELL, 0.70, 5.0);
+    ASSERT_TRUE(result.accepted);
+
+    EXPECT_TRUE(engine.cancel(result.order_id));
+    EXPECT_FALSE(engine.cancel(result.order_id));
+    EXPECT_TRUE(engine.asks("T").empty());
+
+    EXPECT_FALSE(engine.place("T", Side::BUY, 1.0, 5.0).accepted);
+    EXPECT_FALSE(engine.place("T", Side::BUY, 0.5, 0.0).accepted);
+}
+
+TEST(ScenarioTest, LoadsScriptInTimeOrder) {
+    auto script = nlohmann::json::parse(R"([
+        {"at_ms": 20, "type": "trade", "token": "T", "side": "SELL", "size": 5},
+        {"at_ms": 0, "type": "book", "token": "T", "bids": [[0.45, 100]], "asks": [[0.55, 100]]},
+        {"at_ms": 10, "type": "level", "token": "T", "side": "BUY", "price": 0.46, "size": 20}
+    ])");
+    Scenario scenario = Scenario::fromJson(script);
+
+    ASSERT_EQ(scenario.size(), 3u);
+    EXPECT_EQ(scenario.steps()[0].action, ScenarioAction::SET_BOOK);
+    EXPECT_EQ(scenario.steps()[1].action, ScenarioAction::SET_LEVEL);
+    EXPECT_EQ(scenario.steps()[2].action, ScenarioAction::MARKET_ORDER);
+    EXPECT_EQ(scenario.steps()[2].at, std::chrono::milliseconds(20));
+
+    Scenario walk = Scenario::randomWalk("T", 0.50, 0.04, 10, std::chrono::milliseconds(5));
+    ASSERT_EQ(walk.size(), 10u);
+    for (const ScenarioStep& step : walk.steps()) {
+        EXPECT_LT(step.bids.front().first, step.asks.front().first);
+    }
+}
+
+TEST(MockExchangeTest, StreamsBookPriceChangesAndTradesToWebSocketClient) {
+    MockExchange exchange;
+    exchange.start();
+    exchange.setBook(TOKEN, {{0.45, 100.0}}, {{0.55, 80.0}});
+
+    EventQueue queue;
+    PolymarketWebSocketClient client(queue, exchange.wsUrl());
+    client.connect();
+    client.subscribe({TOKEN});
+
+    Event event;
+    ASSERT_TRUE(waitForEvent(queue, EventType::BOOK_SNAPSHOT, event));
+    const auto& book = std::get<BookSnapshotPayload>(event.payload);
+    EXPECT_EQ(book.token_id, TOKEN);
+    ASSERT_EQ(book.bids.size(), 1u);
+    EXPECT_DOUBLE_EQ(book.bids[0].first, 0.45);
+    EXPECT_DOUBLE_EQ(book.asks[0].second, 80.0);
+
+    exchange.setLevel(TOKEN, Side::BUY, 0.46, 25.0);
+    ASSERT_TRUE(waitForEvent(queue, EventType::PRICE_LEVEL_UPDATE, event));
+    const auto& update = std::get<PriceLevelUpdatePayload>(event.payload);
+    ASSERT_EQ(update.bids.size(), 1u);
+    EXPECT_DOUBLE_EQ(update.bids[0].first, 0.46);
+    EXPECT_DOUBLE_EQ(update.bids[0].second, 25.0);
+
+    // Market order prints a trade
+    exchange.marketOrder(TOKEN, Side::SELL, 10.0);
+    ASSERT_TRUE(waitForEvent(queue, EventType::TRADE, event));
+    const auto& trade = std::get<TradePayload>(event.payload);
+    EXPECT_EQ(trade.token_id, TOKEN);
+    EXPECT_DOUBLE_EQ(trade.price, 0.46);
+    EXPECT_DOUBLE_EQ(trade.size, 10.0);
+    EXPECT_EQ(trade.side, Side::SELL);
+    EXPECT_GT(trade.exchange_time_ms, 0);
+
+    client.disconnect();
+    exchange.stop();
+}
+
+TEST(MockExchangeTest, GatewayOrdersRestMatchAndCancel) {
+    MockExchangeConfig config;
+    config.order_latency = std::chrono::milliseconds(2);
+    MockExchange exchange(config);
+    exchange.start();
+    exchange.setBook(TOKEN, {{0.45, 100.0}}, {{0.55, 80.0}});
+
+    EventQueue queue;
+    OrderGateway gateway(queue, exchange.gatewayConfig());
+    gateway.start();
+
+    GatewayCommand resting;
+    resting.order_id = 1;
+    resting.token_id = TOKEN;
+    resting.side = Side::BUY;
+    resting.price = 0.44;
+    resting.size = 10.0;
+
+    auto sent = std::chrono::steady_clock::now();
+    gateway.submit(resting);
+    Event event;
+    ASSERT_TRUE(waitForEvent(queue, EventType::ORDER_ACKED, event));
+    EXPECT_GE(std::chrono::steady_clock::now() - sent, config.order_latency);
+    EXPECT_EQ(exchange.restingOrderCount(), 1u);
+
+    GatewayCommand crossing = resting;
+    crossing.order_id = 2;
+    crossing.price = 0.56;
+    crossing.size = 30.0;
+    gateway.submit(crossing);
+    ASSERT_TRUE(waitForEvent(queue, EventType::ORDER_FILL, event));
+    EXPECT_EQ(std::get<OrderFillPayload>(event.payload).order_id, 2u);
+    EXPECT_DOUBLE_EQ(exchange.asks(TOKEN).front().second, 50.0);
+
+    gateway.submitCancel(1);
+    ASSERT_TRUE(waitForEvent(queue, EventType::ORDER_CANCELLED, event));
+    EXPECT_EQ(exchange.restingOrderCount(), 0u);
+
+    gateway.stop();
+    EXPECT_EQ(exchange.ordersReceived(), 2u);
+    EXPECT_EQ(exchange.cancelsReceived(), 1u);
+    exchange.stop();
+}
@@ -81,4 +81,44 @@ TEST_F(OrderBookTest, BestBidAskOrdering) {
     book.updateAsk(0.52, 1200);
     
     EXPECT_TRUE(approxEqual(book.getBestAsk(), 0.51));  // Lowest ask
-}
\ No newline at end of file
+}
+TEST_F(OrderBookTest, MicropriceLeansTowardTheThinSide) {
+    book.updateBid(0.50, 300);
+    book.updateAsk(0.52, 100);
+    
+    // Three times the size bid: three quarters of the way to the ask
+    EXPECT_TRUE(approxEqual(book.getMicroprice(), 0.515));
+    
+    // The cached figures follow updates
+    book.updateAsk(0.52, 300);
+    EXPECT_TRUE(approxEqual(book.getMicroprice(), 0.51));
+    book.updateAsk(0.52, 0);
+    EXPECT_DOUBLE_EQ(book.getMicroprice(), 0.0);
+}
+
+TEST_F(OrderBookTest, DepthWeightedMidUsesTheTopLevels) {
+    for (int i = 0; i < OrderBook::DEPTH_LEVELS; i++) {
+        book.updateBid(0.50 - i * 0.01, 100);
+    }
+    book.updateBid(0.30, 100000);  // Below the levels that count
+    book.updateAsk(0.52, 100);
+    book.updateAsk(0.55, 300);
+    
+    // Bid VWAP 0.48, ask VWAP 0.5425
+    EXPECT_TRUE(approxEqual(book.getDepthWeightedMid(), (0.48 + 0.5425) / 2.0));
+    EXPECT_TRUE(approxEqual(book.getTotalBidVolume(), 500.0));
+    EXPECT_TRUE(approxEqual(book.getImbalance(), (500.0 - 400.0) / 900.0));
+    EXPECT_TRUE(approxEqual(book.getImbalance(1), 0.0));
+}
+
+TEST_F(OrderBookTest, VwapToSizeWalksTheBook) {
+    book.updateBid(0.50, 100);
+    book.updateAsk(0.52, 100);
+    book.updateAsk(0.55, 300);
+    
+    EXPECT_TRUE(approxEqual(book.getBuyVwap(50), 0.52));
+    EXPECT_TRUE(approxEqual(book.getBuyVwap(200), 0.535));
+    EXPECT_TRUE(approxEqual(book.getSellVwap(100), 0.50));
+    EXPECT_DOUBLE_EQ(book.getBuyVwap(500), 0.0);   // Not enough depth
+    EXPECT_DOUBLE_EQ(book.getSellVwap(101), 0.0);
+}
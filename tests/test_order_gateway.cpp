@@ -0,0 +1,475 @@
+#include <gtest/gtest.h>
+#include "network/order_gateway.hpp"
+#include "strategy/order_manager.hpp"
+#include "core/event_queue.hpp"
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <map>
+#include <thread>
+
+using namespace pmm;
+namespace http = boost::beast::http;
+using tcp = boost::asio::ip::tcp;
+using json = nlohmann::json;
+
+// Minimal CLOB stand-in on localhost. Handles one keep-alive connection at a
+// time and answers pipelined requests in order:
+//   price >= 0.99  -> rejected
+//   price <= 0.01  -> matched on entry
+//   otherwise      -> resting ("live"), listed by GET /data/orders, as one
+//                     list or in pages of page_size
+class MockExchange {
+public:
+    MockExchange() : acceptor_(ioc_, tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0)) {
+        port_ = acceptor_.local_endpoint().port();
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~MockExchange() {
+        stopping_ = true;
+        // Wake the blocking accept
+        boost::system::error_code ec;
+        tcp::socket socket(ioc_);
+        socket.connect(tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), port_), ec);
+        thread_.join();
+    }
+
+    std::string port() const { return std::to_string(port_); }
+
+    std::atomic<int> connections{0};
+    std::atomic<int> post_requests{0};
+    std::atomic<int> delete_requests{0};
+    std::atomic<int> get_requests{0};
+    std::atomic<size_t> largest_batch{0};
+    std::atomic<bool> drop_next_post{false};  // Take the orders, then close without answering
+    std::atomic<bool> fail_gets{false};       // Answer GET /data/orders with a 503
+    std::atomic<size_t> page_size{0};         // 0 = unpaginated
+
+private:
+    boost::asio::io_context ioc_;
+    tcp::acceptor acceptor_;
+    unsigned short port_ = 0;
+    std::thread thread_;
+    std::atomic<bool> stopping_{false};
+
+    std::map<std::string, json> live_orders_;
+    int next_exchange_id_ = 1;
+
+    void run() {
+        while (!stopping_) {
+            tcp::socket socket(ioc_);
+            boost::system::error_code ec;
+            acceptor_.accept(socket, ec);
+            if (ec || stopping_) {
+                break;
+            }
+            connections++;
+            serve(socket);
+        }
+    }
+
+    void serve(tcp::socket& socket) {
+        boost::beast::flat_buffer buffer;
+        while (true) {
+            http::request<http::string_body> request;
+            boost::system::error_code ec;
+            http::read(socket, buffer, request, ec);
+            if (ec) {
+                return;
+            }
+
+            http::response<http::string_body> response{http::status::ok, request.version()};
+            response.set(http::field::content_type, "application/json");
+            response.keep_alive(request.keep_alive());
+            if (request.method() == http::verb::post) {
+                response.body() = handlePost(request.body());
+                if (drop_next_post.exchange(false)) {
+                    return;
+                }
+            } else if (request.method() == http::verb::get) {
+                response.body() = handleGet(std::string(request.target()));
+                if (fail_gets) {
+                    response.result(http::status::service_unavailable);
+                    response.body() = R"({"error":"try again"})";
+                }
+            } else {
+                response.body() = handleDelete(request.body());
+            }
+            response.prepare_payload();
+            http::write(socket, response, ec);
+            if (ec) {
+                return;
+            }
+        }
+    }
+
+    std::string handlePost(const std::string& body) {
+        post_requests++;
+        json orders = json::parse(body);
+        largest_batch = std::max(largest_batch.load(), orders.size());
+
+        json results = json::array();
+        for (const json& entry : orders) {
+            const json& order = entry["order"];
+            double price = order["price"];
+            if (price >= 0.99) {
+                results.push_back({{"success", false}, {"errorMsg", "invalid price"}});
+                continue;
+            }
+            std::string id = "0xEX" + std::to_string(next_exchange_id_++);
+            if (price <= 0.01) {
+                results.push_back({{"success", true}, {"orderID", id}, {"status", "matched"}});
+            } else {
+                // Prices and sizes as strings, like the CLOB
+                live_orders_[id] = {{"id", id},
+                                    {"asset_id", order["tokenID"]},
+                                    {"side", order["side"]},
+                                    {"price", std::to_string(price)},
+                                    {"original_size", std::to_string(order["size"].get<double>())},
+                                    {"size_matched", "0"}};
+                results.push_back({{"success", true}, {"orderID", id}, {"status", "live"}});
+            }
+        }
+        return results.dump();
+    }
+
+    std::string handleGet(const std::string& target) {
+        get_requests++;
+        json orders = json::array();
+        for (const auto& [id, order] : live_orders_) {
+            orders.push_back(order);
+        }
+        if (page_size == 0) {
+            return orders.dump();
+        }
+
+        // The cursor is the offset plus a trailing "=", like the CLOB's base64
+        // cursors, so it arrives escaped; "LTE=" ends the list
+        size_t offset = 0;
+        size_t at = target.find("next_cursor=");
+        if (at != std::string::npos) {
+            std::string cursor = target.substr(at + 12);
+            EXPECT_EQ(cursor.substr(cursor.size() - 3), "%3D");
+            offset = std::stoul(cursor.substr(0, cursor.size() - 3));
+        }
+        size_t end = std::min(orders.size(), offset + page_size);
+        json page = json::array();
+        for (size_t i = offset; i < end; i++) {
+            page.push_back(orders[i]);
+        }
+        std::string next = (end < orders.size()) ? std::to_string(end) + "=" : "LTE=";
+        return json{{"data", page}, {"next_cursor", next}, {"count", page.size()}}.dump();
+    }
+
+    std::string handleDelete(const std::string& body) {
+        delete_requests++;
+        json canceled = json::array();
+        json not_canceled = json::object();
+        json request = json::parse(body);
+        for (const auto& entry : request["orderIDs"]) {
+            std::string id = entry.get<std::string>();
+            if (live_orders_.erase(id)) {
+                canceled.push_back(id);
+            } else {
+                not_canceled[id] = "order not found";
+            }
+        }
+        return json{{"canceled", canceled}, {"not_canceled", not_canceled}}.dump();
+    }
+};
+
+class OrderGatewayTest : public ::testing::Test {
+protected:
+    MockExchange exchange;
+    EventQueue queue;
+
+    GatewayConfig config() const {
+        GatewayConfig config;
+        config.host = "127.0.0.1";
+        config.port = exchange.port();
+        config.use_tls = false;
+        return config;
+    }
+
+    static GatewayCommand place(OrderId id, Price price) {
+        GatewayCommand command;
+        command.type = GatewayCommandType::PLACE;
+        command.order_id = id;
+        command.token_id = "TOKEN_1";
+        command.side = Side::BUY;
+        command.price = price;
+        command.size = 10.0;
+        return command;
+    }
+
+    // Pops the next count events, failing the test on timeout
+    std::vector<Event> waitForEvents(size_t count) {
+        std::vector<Event> events;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (events.size() < count && std::chrono::steady_clock::now() < deadline) {
+            Event event;
+            if (queue.tryPop(event)) {
+                events.push_back(std::move(event));
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        EXPECT_EQ(events.size(), count);
+        return events;
+    }
+};
+
+TEST_F(OrderGatewayTest, BatchesPlacementsOnOneConnection) {
+    OrderGateway gateway(queue, config());
+    for (OrderId id = 1; id <= 20; id++) {
+        ASSERT_TRUE(gateway.submit(place(id, 0.50)));
+    }
+    gateway.start();
+
+    auto events = waitForEvents(20);
+    for (const Event& event : events) {
+        EXPECT_EQ(event.type, EventType::ORDER_ACKED);
+    }
+    EXPECT_EQ(exchange.post_requests.load(), 2);  // 15 + 5
+    EXPECT_EQ(exchange.largest_batch.load(), 15u);
+
+    gateway.submit(place(21, 0.50));
+    waitForEvents(1);
+    gateway.stop();
+
+    EXPECT_EQ(exchange.connections.load(), 1);
+    EXPECT_EQ(gateway.requestsSent(), 3u);
+}
+
+TEST_F(OrderGatewayTest, CancelAfterAckIsConfirmed) {
+    OrderGateway gateway(queue, config());
+    gateway.start();
+    gateway.submit(place(1, 0.40));
+    gateway.submit(place(2, 0.60));
+    waitForEvents(2);
+
+    GatewayCommand cancel;
+    cancel.type = GatewayCommandType::CANCEL;
+    cancel.order_id = 1;
+    gateway.submit(cancel);
+    gateway.submitCancel(2);
+
+    auto events = waitForEvents(2);
+    for (const Event& event : events) {
+        EXPECT_EQ(event.type, EventType::ORDER_CANCELLED);
+    }
+    gateway.stop();
+
+    EXPECT_EQ(gateway.inFlightCount(), 0u);
+}
+
+TEST_F(OrderGatewayTest, ReportsRejectsAndImmediateMatches) {
+    OrderGateway gateway(queue, config());
+    gateway.submit(place(1, 0.995));
+    gateway.submit(place(2, 0.01));
+    gateway.start();
+
+    auto events = waitForEvents(3);
+    gateway.stop();
+
+    ASSERT_EQ(events[0].type, EventType::ORDER_REJECTED);
+    EXPECT_EQ(std::get<OrderRejectedPayload>(events[0].payload).order_id, 1u);
+    EXPECT_EQ(std::get<OrderRejectedPayload>(events[0].payload).request, RejectedRequest::PLACE);
+    EXPECT_EQ(std::get<OrderRejectedPayload>(events[0].payload).reason, "invalid price");
+
+    EXPECT_EQ(events[1].type, EventType::ORDER_ACKED);
+    ASSERT_EQ(events[2].type, EventType::ORDER_FILL);
+    const auto& fill = std::get<OrderFillPayload>(events[2].payload);
+    EXPECT_EQ(fill.order_id, 2u);
+    EXPECT_DOUBLE_EQ(fill.filled_size, 10.0);
+    EXPECT_DOUBLE_EQ(fill.fill_price, 0.01);
+}
+
+TEST_F(OrderGatewayTest, CancelBeforeAckWaitsForExchangeId) {
+    OrderGateway gateway(queue, config());
+    gateway.submit(place(1, 0.50));
+    gateway.submitCancel(1);
+    gateway.start();
+
+    auto events = waitForEvents(2);
+    gateway.stop();
+
+    EXPECT_EQ(events[0].type, EventType::ORDER_ACKED);
+    EXPECT_EQ(events[1].type, EventType::ORDER_CANCELLED);
+    EXPECT_EQ(exchange.delete_requests.load(), 1);
+}
+
+TEST_F(OrderGatewayTest, CancelOfAnOrderNoLongerInFlightIsConfirmed) {
+    OrderGateway gateway(queue, config());
+    gateway.submit(place(1, 0.995));  // Rejected, so the gateway forgets it
+    gateway.start();
+    waitForEvents(1);
+
+    gateway.submitCancel(1);
+    auto events = waitForEvents(1);
+    gateway.stop();
+
+    ASSERT_EQ(events[0].type, EventType::ORDER_CANCELLED);
+    EXPECT_EQ(std::get<OrderCancelledPayload>(events[0].payload).order_id, 1u);
+    EXPECT_EQ(exchange.delete_requests.load(), 0);
+}
+
+TEST_F(OrderGatewayTest, UnreachableExchangeRejectsOrders) {
+    GatewayConfig unreachable = config();
+    {
+        // Grab a free port and release it again
+        boost::asio::io_context ioc;
+        tcp::acceptor acceptor(ioc, tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0));
+        unreachable.port = std::to_string(acceptor.local_endpoint().port());
+    }
+    unreachable.reconnect_backoff = std::chrono::milliseconds(1);
+
+    OrderGateway gateway(queue, unreachable);
+    gateway.submit(place(7, 0.50));
+    gateway.start();
+
+    auto events = waitForEvents(1);
+    gateway.stop();
+
+    ASSERT_EQ(events[0].type, EventType::ORDER_REJECTED);
+    EXPECT_EQ(std::get<OrderRejectedPayload>(events[0].payload).order_id, 7u);
+}
+
+TEST_F(OrderGatewayTest, UnansweredPlacementsAreCheckedAgainstOpenOrders) {
+    GatewayConfig flaky = config();
+    flaky.reconnect_backoff = std::chrono::milliseconds(1);
+    exchange.drop_next_post = true;
+
+    OrderGateway gateway(queue, flaky);
+    gateway.submit(place(1, 0.50));  // Rests on the exchange
+    gateway.submit(place(2, 0.01));  // Matched on entry, so not listed
+    gateway.start();
+
+    auto events = waitForEvents(2);
+    gateway.stop();
+
+    ASSERT_EQ(events[0].type, EventType::ORDER_ACKED);
+    EXPECT_EQ(std::get<OrderAckedPayload>(events[0].payload).order_id, 1u);
+    EXPECT_EQ(std::get<OrderAckedPayload>(events[0].payload).exchange_order_id, "0xEX1");
+    ASSERT_EQ(events[1].type, EventType::ORDER_REJECTED);
+    EXPECT_EQ(std::get<OrderRejectedPayload>(events[1].payload).order_id, 2u);
+    EXPECT_EQ(exchange.get_requests.load(), 1);
+    EXPECT_EQ(exchange.connections.load(), 2);
+    EXPECT_EQ(gateway.unknownCount(), 0u);
+    EXPECT_EQ(gateway.inFlightCount(), 1u);
+}
+
+TEST_F(OrderGatewayTest, UnknownPlacementsWaitForTheLastPage) {
+    GatewayConfig flaky = config();
+    flaky.reconnect_backoff = std::chrono::milliseconds(1);
+    exchange.drop_next_post = true;
+    exchange.page_size = 1;
+
+    OrderGateway gateway(queue, flaky);
+    gateway.submit(place(1, 0.50));
+    gateway.submit(place(2, 0.51));
+    gateway.submit(place(3, 0.52));
+    gateway.start();
+
+    auto events = waitForEvents(3);
+    gateway.stop();
+
+    for (OrderId id = 1; id <= 3; id++) {
+        ASSERT_EQ(events[id - 1].type, EventType::ORDER_ACKED);
+        EXPECT_EQ(std::get<OrderAckedPayload>(events[id - 1].payload).order_id, id);
+    }
+    EXPECT_EQ(exchange.get_requests.load(), 3);
+    EXPECT_EQ(gateway.unknownCount(), 0u);
+}
+
+TEST_F(OrderGatewayTest, FailedOpenOrdersQueryBacksOff) {
+    GatewayConfig flaky = config();
+    flaky.reconnect_backoff = std::chrono::milliseconds(50);
+    exchange.drop_next_post = true;
+    exchange.fail_gets = true;
+
+    OrderGateway gateway(queue, flaky);
+    gateway.submit(place(1, 0.50));
+    gateway.start();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_TRUE(queue.empty());
+    int failed_queries = exchange.get_requests.load();
+    EXPECT_GE(failed_queries, 2);
+    EXPECT_LE(failed_queries, 8);  // About one per backoff, not one per idle wait
+
+    exchange.fail_gets = false;
+    auto events = waitForEvents(1);
+    gateway.stop();
+    ASSERT_EQ(events[0].type, EventType::ORDER_ACKED);
+}
+
+TEST_F(OrderGatewayTest, LiveOrderManagerTracksGatewayEvents) {
+    OrderGateway gateway(queue, config());
+    OrderManager om(queue, TradingMode::LIVE);
+    om.setOrderGateway(&gateway);
+    gateway.start();
+
+    OrderId id = om.placeOrder("TOKEN_1", Side::BUY, 0.45, 10.0, "Test");
+    auto acked = waitForEvents(1);
+    ASSERT_EQ(acked[0].type, EventType::ORDER_ACKED);
+
+    // Cancel is pending until the exchange confirms it, and is only sent once
+    om.cancelOrder(id, "Test");
+    om.cancelAllOrders("TOKEN_1", "Test");
+    EXPECT_EQ(om.getOpenOrderCount(), 1u);
+
+    auto cancelled = waitForEvents(1);
+    ASSERT_EQ(cancelled[0].type, EventType::ORDER_CANCELLED);
+    om.onOrderCancelled(std::get<OrderCancelledPayload>(cancelled[0].payload).order_id);
+    EXPECT_EQ(om.getOpenOrderCount(), 0u);
+
+    gateway.stop();
+    EXPECT_EQ(exchange.delete_requests.load(), 1);
+}
+
+TEST(OrderManagerLiveTest, PlacementRejectAfterCancelDropsTheOrder) {
+    EventQueue queue;
+    OrderManager om(queue, TradingMode::LIVE);  // No gateway: placement is rejected
+
+    OrderId id = om.placeOrder("TOKEN_1", Side::SELL, 0.55, 10.0, "Test");
+    Event event;
+    ASSERT_TRUE(queue.tryPop(event));
+    ASSERT_EQ(event.type, EventType::ORDER_REJECTED);
+
+    // The book moves and cancels the order before the reject is handled
+    om.cancelOrder(id, "Test");
+    const auto& reject = std::get<OrderRejectedPayload>(event.payload);
+    EXPECT_EQ(reject.request, RejectedRequest::PLACE);
+    om.onOrderRejected(reject.order_id, reject.request, reject.reason);
+
+    EXPECT_EQ(om.getOpenOrderCount(), 0u);
+    EXPECT_EQ(om.getAskCount(), 0u);
+}
+
+TEST(OrderManagerLiveTest, RejectedCancelKeepsOrderWorking) {
+    EventQueue queue;
+    OrderGateway gateway(queue);  // Never started: commands just queue up
+    OrderManager om(queue, TradingMode::LIVE);
+    om.setOrderGateway(&gateway);
+
+    OrderId id = om.placeOrder("TOKEN_1", Side::SELL, 0.55, 10.0, "Test");
+    om.cancelOrder(id, "Test");
+    EXPECT_TRUE(queue.empty());
+
+    // What the gateway posts when the exchange doesn't confirm the cancel
+    queue.push(Event::orderRejected(id, RejectedRequest::CANCEL, "Cancel failed: no cancel confirmation"));
+    Event event = queue.pop();
+    const auto& reject = std::get<OrderRejectedPayload>(event.payload);
+    om.onOrderRejected(reject.order_id, reject.request, reject.reason);
+    ASSERT_EQ(om.getOpenOrderCount(), 1u);
+    EXPECT_EQ(om.getOpenOrders("TOKEN_1").begin()->status, OrderStatus::OPEN);
+
+    om.onOrderFilled(id, 4.0);
+    EXPECT_EQ(om.getOpenOrderCount(), 1u);
+    om.onOrderFilled(id, 6.0);
+    EXPECT_EQ(om.getOpenOrderCount(), 0u);
+}
@@ -2,9 +2,35 @@
 #include "strategy/order_manager.hpp"
 #include "core/event_queue.hpp"
 #include "core/types.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
 
 using namespace pmm;
 
+// Counts heap allocations on the thread that enables it, to pin down the
+// requote path; the logger's worker thread writes files on its own
+static thread_local bool g_count_allocations = false;
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    if (g_count_allocations) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
 class OrderManagerTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -23,9 +49,9 @@ TEST_F(OrderManagerTest, PlaceOrder) {
     order.price = 0.50;
     order.size = 100;
     
-    std::string order_id = om->placeOrder(order.token_id, order.side, order.price, order.size, "test_market");
+    OrderId order_id = om->placeOrder(order.token_id, order.side, order.price, order.size, "test_market");
     
-    EXPECT_FALSE(order_id.empty());
+    EXPECT_NE(order_id, INVALID_ORDER_ID);
 }
 
 TEST_F(OrderManagerTest, CancelOrder) {
@@ -35,8 +61,8 @@ TEST_F(OrderManagerTest, CancelOrder) {
     order.price = 0.50;
     order.size = 100;
     
-    std::string order_id = om->placeOrder(order.token_id, order.side, order.price, order.size, "test_market");
-    EXPECT_FALSE(order_id.empty());
+    OrderId order_id = om->placeOrder(order.token_id, order.side, order.price, order.size, "test_market");
+    EXPECT_NE(order_id, INVALID_ORDER_ID);
     
     bool cancelled = om->cancelOrder(order_id, "test_market");
     EXPECT_TRUE(cancelled);
@@ -83,4 +109,129 @@ TEST_F(OrderManagerTest, CancelAllOrders) {
 
     auto active = om->getOpenOrders("test_token");
     EXPECT_EQ(active.size(), 0);
-}
\ No newline at end of file
+}
+TEST_F(OrderManagerTest, CountsBySideAndToken) {
+    om->placeOrder("token_a", Side::BUY, 0.50, 100, "market_a");
+    om->placeOrder("token_a", Side::SELL, 0.52, 100, "market_a");
+    om->placeOrder("token_b", Side::BUY, 0.30, 100, "market_b");
+    
+    EXPECT_EQ(om->getBidCount(), 2u);
+    EXPECT_EQ(om->getAskCount(), 1u);
+    EXPECT_EQ(om->getOpenOrderCount("token_a"), 2u);
+    EXPECT_EQ(om->getOpenOrderCount("token_b"), 1u);
+    EXPECT_EQ(om->getOpenOrderCount("token_c"), 0u);
+    
+    // Cancelling one token leaves the others untouched
+    EXPECT_TRUE(om->cancelAllOrders("token_a", "market_a"));
+    EXPECT_EQ(om->getOpenOrderCount(), 1u);
+    EXPECT_EQ(om->getBidCount(), 1u);
+    EXPECT_EQ(om->getAskCount(), 0u);
+    EXPECT_EQ(om->getOpenOrders("token_b").size(), 1u);
+}
+
+TEST_F(OrderManagerTest, SlotsAreReusedAfterCancel) {
+    for (int i = 0; i < 100; i++) {
+        OrderId bid = om->placeOrder("token_a", Side::BUY, 0.50, 100, "market_a");
+        OrderId ask = om->placeOrder("token_a", Side::SELL, 0.52, 100, "market_a");
+        EXPECT_TRUE(om->cancelOrder(bid, "market_a"));
+        EXPECT_TRUE(om->cancelOrder(ask, "market_a"));
+    }
+    
+    EXPECT_EQ(om->getOpenOrderCount(), 0u);
+    EXPECT_EQ(om->getOpenOrderCount("token_a"), 0u);
+    EXPECT_TRUE(om->getOpenOrders("token_a").empty());
+}
+
+TEST_F(OrderManagerTest, FilledOrdersLeaveTheWorkingSet) {
+    om->placeOrder("token_a", Side::BUY, 0.50, 100, "market_a");
+    om->placeOrder("token_a", Side::SELL, 0.55, 100, "market_a");
+    
+    // Market ask drops through our bid
+    OrderBook book("token_a");
+    book.updateBid(0.48, 100);
+    book.updateAsk(0.49, 100);
+    om->updateOrderBook("token_a", book);
+    
+    Event event = queue->pop();
+    ASSERT_EQ(event.type, EventType::ORDER_FILL);
+    EXPECT_EQ(std::get<OrderFillPayload>(event.payload).side, Side::BUY);
+    
+    EXPECT_EQ(om->getBidCount(), 0u);
+    EXPECT_EQ(om->getAskCount(), 1u);
+    auto open = om->getOpenOrders("token_a");
+    ASSERT_EQ(open.size(), 1u);
+    EXPECT_EQ(open.begin()->side, Side::SELL);
+}
+
+TEST_F(OrderManagerTest, PartialFillsThatSumToTheSizeCompleteTheOrder) {
+    OrderId order_id = om->placeOrder("token_a", Side::BUY, 0.50, 10, "market_a");
+    
+    // A hundred fills of 0.1 sum to just under 10 in floating point
+    for (int i = 0; i < 100; i++) {
+        om->onOrderFilled(order_id, 0.1);
+    }
+    
+    EXPECT_EQ(om->getBidCount(), 0u);
+    EXPECT_TRUE(om->getOpenOrders("token_a").empty());
+}
+
+TEST_F(OrderManagerTest, PaperOrdersFillPartiallyFromLevelUpdates) {
+    OrderBook book("token_a");
+    book.updateBid(0.50, 30);
+    book.updateAsk(0.55, 100);
+    om->updateOrderBook("token_a", book);
+    
+    OrderId bid = om->placeOrder("token_a", Side::BUY, 0.50, 20, "market_a", &book);
+    EXPECT_DOUBLE_EQ(om->getQueueAhead(bid), 30.0);
+    
+    // 10 joins behind us, then the level is swept: 30 ahead of us, then 10 of ours
+    book.updateBid(0.50, 40);
+    om->updateOrderBook("token_a", book, {{0.50, 40}}, {});
+    book.updateBid(0.50, 0);
+    book.updateBid(0.49, 100);
+    om->updateOrderBook("token_a", book, {{0.50, 0}, {0.49, 100}}, {});
+    
+    Event event;
+    ASSERT_TRUE(queue->tryPop(event));
+    ASSERT_EQ(event.type, EventType::ORDER_FILL);
+    EXPECT_EQ(std::get<OrderFillPayload>(event.payload).order_id, bid);
+    EXPECT_DOUBLE_EQ(std::get<OrderFillPayload>(event.payload).filled_size, 10.0);
+    
+    // Partially filled orders keep working
+    auto open = om->getOpenOrders("token_a");
+    ASSERT_EQ(open.size(), 1u);
+    EXPECT_DOUBLE_EQ(open.begin()->filled_size, 10.0);
+    EXPECT_DOUBLE_EQ(om->getQueueAhead(bid), 0.0);
+}
+
+TEST_F(OrderManagerTest, RequoteDoesNotAllocateInSteadyState) {
+    const TokenId token = "44623110248227182263524920709598432835467185438698898378400926229226251167932";
+    
+    OrderBook book(token);
+    book.updateBid(0.40, 1000);
+    book.updateAsk(0.45, 1000);
+    om->updateOrderBook(token, book);
+    
+    // Warm up: token index, pool nodes and recycled token strings
+    om->placeOrder(token, Side::BUY, 0.41, 100, "market");
+    om->placeOrder(token, Side::SELL, 0.44, 100, "market");
+    om->cancelAllOrders(token, "market", CancelReason::QUOTE_UPDATE);
+    
+    g_allocations = 0;
+    g_count_allocations = true;
+    for (int i = 0; i < 1000; i++) {
+        om->cancelAllOrders(token, "market", CancelReason::QUOTE_UPDATE);
+        om->placeOrder(token, Side::BUY, 0.41, 100, "market");
+        om->placeOrder(token, Side::SELL, 0.44, 100, "market");
+        
+        size_t matching = 0;
+        for (const Order& order : om->getOpenOrders(token)) {
+            matching += (order.price > 0.4) ? 1 : 0;
+        }
+        EXPECT_EQ(matching, 2u);
+    }
+    g_count_allocations = false;
+    
+    EXPECT_EQ(g_allocations.load(), 0u);
+    EXPECT_EQ(om->getOpenOrderCount(), 2u);
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include "sim/paper_fill_simulator.hpp"
+#include "data/order_book.hpp"
+
+using namespace pmm;
+
+class PaperFillSimulatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        book.updateBid(0.45, 100);
+        book.updateAsk(0.55, 100);
+    }
+
+    // Apply a delta to the book and the simulator together
+    void setBid(Price price, Size size) {
+        book.updateBid(price, size);
+        sim.onLevelChange(Side::BUY, price, size, book, fills);
+    }
+
+    OrderBook book{"token"};
+    PaperFillSimulator sim;
+    std::vector<PaperFill> fills;
+};
+
+TEST_F(PaperFillSimulatorTest, QueuesBehindDisplayedSizeAtTheTouch) {
+    sim.add(1, Side::BUY, 0.45, 10, book.getBidSize(0.45));
+    EXPECT_DOUBLE_EQ(sim.queueAhead(1), 100.0);
+
+    // Trades at the touch work through the queue ahead of us first
+    setBid(0.45, 40);
+    EXPECT_TRUE(fills.empty());
+    EXPECT_DOUBLE_EQ(sim.queueAhead(1), 40.0);
+
+    // Size joining later is behind us; the sweep takes 40 ahead, then 4 of ours
+    setBid(0.45, 44);
+    book.updateBid(0.44, 200);
+    setBid(0.45, 0);
+    ASSERT_EQ(fills.size(), 1u);
+    EXPECT_EQ(fills[0].ref, 1u);
+    EXPECT_DOUBLE_EQ(fills[0].price, 0.45);
+    EXPECT_DOUBLE_EQ(fills[0].size, 4.0);
+    EXPECT_DOUBLE_EQ(sim.queueAhead(1), 0.0);
+}
+
+TEST_F(PaperFillSimulatorTest, CancelsBehindTheTouchAreProRata) {
+    book.updateBid(0.46, 50);
+    sim.add(1, Side::BUY, 0.45, 10, book.getBidSize(0.45));
+
+    setBid(0.45, 50);
+    EXPECT_DOUBLE_EQ(sim.queueAhead(1), 50.0);
+
+    setBid(0.45, 150);
+    setBid(0.45, 75);
+    EXPECT_DOUBLE_EQ(sim.queueAhead(1), 25.0);
+    EXPECT_TRUE(fills.empty());
+
+    // Changes at other prices never reach the order
+    setBid(0.44, 10);
+    EXPECT_DOUBLE_EQ(sim.queueAhead(1), 25.0);
+}
+
+TEST_F(PaperFillSimulatorTest, CrossingLiquidityTradesOnce) {
+    sim.add(1, Side::BUY, 0.50, 100, 0);
+    sim.add(2, Side::SELL, 0.60, 100, 0);
+
+    book.updateAsk(0.49, 30);
+    sim.checkCrosses(book, fills);
+    ASSERT_EQ(fills.size(), 1u);
+    EXPECT_DOUBLE_EQ(fills[0].size, 30.0);
+    EXPECT_DOUBLE_EQ(fills[0].price, 0.50);
+
+    // The same resting size does not fill us again, new size does
+    fills.clear();
+    sim.checkCrosses(book, fills);
+    EXPECT_TRUE(fills.empty());
+
+    book.updateAsk(0.49, 50);
+    sim.checkCrosses(book, fills);
+    ASSERT_EQ(fills.size(), 1u);
+    EXPECT_DOUBLE_EQ(fills[0].size, 20.0);
+}
+
+TEST_F(PaperFillSimulatorTest, RemovedOrdersStopFilling) {
+    sim.add(1, Side::SELL, 0.55, 10, 0);
+    sim.add(2, Side::SELL, 0.55, 10, 0);
+    sim.remove(1, Side::SELL, 0.55);
+    EXPECT_EQ(sim.size(), 1u);
+    EXPECT_DOUBLE_EQ(sim.queueAhead(1), -1.0);
+
+    book.updateBid(0.56, 100);
+    sim.checkCrosses(book, fills);
+    ASSERT_EQ(fills.size(), 1u);
+    EXPECT_EQ(fills[0].ref, 2u);
+    EXPECT_DOUBLE_EQ(fills[0].size, 10.0);
+}
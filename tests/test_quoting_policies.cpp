@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "strategy/quoting_policies.hpp"
+
+using namespace pmm;
+
+class QuotingPoliciesTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        in.best_bid = 0.48;
+        in.best_ask = 0.54;
+        in.mid = 0.51;
+        in.max_position = 100000.0;
+    }
+
+    QuoteInputs in;
+    Quote quote{};
+};
+
+TEST_F(QuotingPoliciesTest, DefaultQuotesInsideTheMarket) {
+    ASSERT_TRUE(DefaultQuoting::quote(in, quote));
+    EXPECT_GT(quote.bid_price, 0.48);
+    EXPECT_LT(quote.ask_price, 0.54);
+    EXPECT_DOUBLE_EQ(quote.bid_size, CapacitySize::MAX_SIZE);
+    EXPECT_EQ(quote.ttl_seconds, 90);
+}
+
+TEST_F(QuotingPoliciesTest, InventoryAndImbalanceSkewTheQuote) {
+    ASSERT_TRUE(DefaultQuoting::quote(in, quote));
+    Quote flat = quote;
+
+    in.inventory = 10000.0;
+    ASSERT_TRUE(DefaultQuoting::quote(in, quote));
+    EXPECT_LT(quote.bid_price, flat.bid_price);
+
+    in.inventory = 0.0;
+    in.imbalance = 1.0;
+    ASSERT_TRUE(DefaultQuoting::quote(in, quote));
+    EXPECT_GT(quote.bid_price, flat.bid_price);
+    EXPECT_GT(quote.ask_price, flat.ask_price);
+
+    // Symmetric quoting ignores both
+    Quote leaning{};
+    ASSERT_TRUE(SymmetricQuoting::quote(in, leaning));
+    in.inventory = 10000.0;
+    in.imbalance = 0.0;
+    ASSERT_TRUE(SymmetricQuoting::quote(in, quote));
+    EXPECT_DOUBLE_EQ(quote.bid_price, leaning.bid_price);
+    EXPECT_DOUBLE_EQ(quote.ask_price, leaning.ask_price);
+}
+
+TEST_F(QuotingPoliciesTest, CostFloorHoldsTheAskAboveCost) {
+    in.inventory = 100.0;
+    in.avg_cost = 0.52;
+    in.inventory_dollars = 52.0;
+    ASSERT_TRUE(DefaultQuoting::quote(in, quote));
+    EXPECT_DOUBLE_EQ(quote.ask_price, 0.52 * (1.0 + CostFloor::BASE_MIN_PROFIT * (1.0 - 52.0 / 100000.0)));
+
+    // Near close the floor drops below cost
+    in.time_urgency = 0.95;
+    EXPECT_DOUBLE_EQ(CostFloor::minAsk(in), 0.52 * 0.99);
+    EXPECT_DOUBLE_EQ(NoFloor::minAsk(in), 0.0);
+}
+
+TEST_F(QuotingPoliciesTest, RejectsLockedCrossedAndFullPositions) {
+    in.best_ask = 0.485;
+    EXPECT_FALSE(DefaultQuoting::quote(in, quote));
+
+    SetUp();
+    in.max_position = 500.0;
+    in.inventory = 496.0;
+    EXPECT_FALSE(DefaultQuoting::quote(in, quote));
+    EXPECT_LT(quote.bid_size, CapacitySize::MIN_SIZE);
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "core/ring_buffer.hpp"
+
+using namespace pmm;
+
+TEST(FixedRingTest, StartsEmpty) {
+    FixedRing<int, 8> ring;
+    EXPECT_TRUE(ring.empty());
+    EXPECT_FALSE(ring.full());
+    EXPECT_EQ(ring.size(), 0u);
+    EXPECT_EQ(ring.capacity(), 8u);
+}
+
+TEST(FixedRingTest, FifoOrder) {
+    FixedRing<int, 4> ring;
+    ring.push_back(1);
+    ring.push_back(2);
+    ring.push_back(3);
+    
+    EXPECT_EQ(ring.front(), 1);
+    EXPECT_EQ(ring.back(), 3);
+    EXPECT_EQ(ring[1], 2);
+    
+    ring.pop_front();
+    EXPECT_EQ(ring.front(), 2);
+    EXPECT_EQ(ring.size(), 2u);
+}
+
+TEST(FixedRingTest, WrapsAroundWithStableSequences) {
+    FixedRing<int, 4> ring;
+    for (int i = 0; i < 4; i++) {
+        ring.push_back(i);
+    }
+    EXPECT_TRUE(ring.full());
+    
+    // Recycle slots many times over
+    for (int i = 4; i < 100; i++) {
+        ring.pop_front();
+        ring.push_back(i);
+    }
+    
+    EXPECT_EQ(ring.size(), 4u);
+    EXPECT_EQ(ring.headSeq(), 96u);
+    EXPECT_EQ(ring.tailSeq(), 100u);
+    EXPECT_EQ(ring.front(), 96);
+    EXPECT_EQ(ring.atSeq(98), 98);
+    EXPECT_EQ(ring.back(), 99);
+}
+
+TEST(FixedRingTest, PushReturnsStoredSlot) {
+    FixedRing<int, 2> ring;
+    int& slot = ring.push_back(5);
+    slot = 7;
+    EXPECT_EQ(ring.front(), 7);
+    
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(FixedRingTest, PopBackDropsNewest) {
+    FixedRing<int, 4> ring;
+    ring.push_back(1);
+    ring.push_back(2);
+    ring.pop_back();
+    EXPECT_EQ(ring.back(), 1);
+    
+    // The next push reuses the sequence number
+    ring.push_back(3);
+    EXPECT_EQ(ring.tailSeq(), 2u);
+    EXPECT_EQ(ring.atSeq(1), 3);
+}
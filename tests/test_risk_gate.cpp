@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "strategy/risk_gate.hpp"
+#include "strategy/order_manager.hpp"
+#include "core/event_queue.hpp"
+
+using namespace pmm;
+
+static RiskLimits testLimits() {
+    RiskLimits limits;
+    limits.max_order_notional = 50.0;
+    limits.max_condition_net = 100.0;
+    limits.max_condition_gross = 150.0;
+    limits.max_net_exposure = 1000.0;
+    limits.max_gross_exposure = 1000.0;
+    limits.max_orders_per_second = 1000.0;
+    limits.order_burst = 1000.0;
+    return limits;
+}
+
+TEST(RiskGateTest, OrdersCountAgainstWorkingAndPositionExposure) {
+    RiskGate gate(testLimits());
+    auto condition = gate.registerCondition("condition_a");
+    EXPECT_EQ(gate.registerCondition("condition_a"), condition);
+    uint32_t yes = gate.registerOutcome(condition);
+
+    EXPECT_EQ(gate.checkOrder(condition, yes, Side::BUY, 0.50, 200), RiskCheck::ORDER_NOTIONAL);
+    EXPECT_EQ(gate.checkOrder(condition, yes, Side::BUY, 0.50, 100), RiskCheck::OK);
+
+    // $40 held plus $40 working plus a $25 bid would breach the $100 net limit
+    gate.onOrderOpened(condition, Side::BUY, 40.0);
+    gate.onPositionChanged(condition, yes, 80.0, 0.50);
+    EXPECT_EQ(gate.checkOrder(condition, yes, Side::BUY, 0.50, 50), RiskCheck::CONDITION_NET);
+    EXPECT_EQ(gate.checkOrder(condition, yes, Side::BUY, 0.50, 40), RiskCheck::OK);
+
+    // Other conditions only see the portfolio totals
+    auto other = gate.registerCondition("condition_b");
+    EXPECT_EQ(gate.checkOrder(other, gate.registerOutcome(other), Side::BUY, 0.50, 50), RiskCheck::OK);
+
+    gate.onOrderClosed(condition, Side::BUY, 40.0);
+    RiskExposure exposure = gate.conditionExposure(condition);
+    EXPECT_DOUBLE_EQ(exposure.net, 40.0);
+    EXPECT_DOUBLE_EQ(exposure.working_buy, 0.0);
+    EXPECT_DOUBLE_EQ(gate.totalExposure().gross, 40.0);
+}
+
+TEST(RiskGateTest, ReducingOrdersPassAtTheLimit) {
+    RiskGate gate(testLimits());
+    auto condition = gate.registerCondition("condition_a");
+    uint32_t yes = gate.registerOutcome(condition);
+    uint32_t no = gate.registerOutcome(condition);
+    gate.onPositionChanged(condition, yes, 200.0, 0.50);
+
+    EXPECT_EQ(gate.checkOrder(condition, yes, Side::BUY, 0.50, 10), RiskCheck::CONDITION_NET);
+    EXPECT_EQ(gate.checkOrder(condition, yes, Side::SELL, 0.50, 60), RiskCheck::OK);
+
+    // Gross counts both tokens of the condition
+    gate.onPositionChanged(condition, no, -120.0, 0.50);
+    EXPECT_EQ(gate.checkOrder(condition, yes, Side::BUY, 0.50, 20), RiskCheck::CONDITION_GROSS);
+}
+
+TEST(RiskGateTest, CompleteSetsCarryNoExposure) {
+    RiskGate gate(testLimits());
+    auto condition = gate.registerCondition("condition_a");
+    uint32_t yes = gate.registerOutcome(condition);
+    uint32_t no = gate.registerOutcome(condition);
+
+    // 150 Yes at 0.60 and 100 No at 0.40: 100 complete sets and 50 Yes at risk
+    gate.onPositionChanged(condition, yes, 150.0, 0.60);
+    gate.onPositionChanged(condition, no, 100.0, 0.40);
+    EXPECT_DOUBLE_EQ(gate.conditionExposure(condition).net, 30.0);
+    EXPECT_DOUBLE_EQ(gate.conditionExposure(condition).gross, 30.0);
+    EXPECT_DOUBLE_EQ(gate.totalExposure().net, 30.0);
+
+    gate.onPositionChanged(condition, no, 150.0, 0.40);
+    EXPECT_DOUBLE_EQ(gate.conditionExposure(condition).net, 0.0);
+    EXPECT_DOUBLE_EQ(gate.totalExposure().gross, 0.0);
+
+    // At the net limit in Yes, buying No completes sets and passes
+    gate.onPositionChanged(condition, yes, 300.0, 0.50);
+    gate.onPositionChanged(condition, no, 100.0, 0.50);
+    EXPECT_DOUBLE_EQ(gate.conditionExposure(condition).net, 100.0);
+    EXPECT_EQ(gate.checkOrder(condition, yes, Side::BUY, 0.50, 10), RiskCheck::CONDITION_NET);
+    EXPECT_EQ(gate.checkOrder(condition, no, Side::BUY, 0.50, 60), RiskCheck::OK);
+
+    // A third outcome with nothing held breaks the sets
+    gate.registerOutcome(condition);
+    EXPECT_DOUBLE_EQ(gate.conditionExposure(condition).net, 200.0);
+}
+
+TEST(RiskGateTest, RejectsOrdersItCouldNotRegister) {
+    RiskGate gate(testLimits(), 1);
+    auto condition = gate.registerCondition("condition_a");
+    EXPECT_EQ(gate.registerCondition("condition_b"), RiskGate::NO_CONDITION);
+    EXPECT_EQ(gate.registerOutcome(RiskGate::NO_CONDITION), RiskGate::NO_OUTCOME);
+    EXPECT_EQ(gate.checkOrder(RiskGate::NO_CONDITION, 0, Side::BUY, 0.50, 10), RiskCheck::UNREGISTERED);
+
+    for (uint32_t i = 0; i < RiskGate::MAX_OUTCOMES; i++) {
+        EXPECT_EQ(gate.registerOutcome(condition), i);
+    }
+    EXPECT_EQ(gate.registerOutcome(condition), RiskGate::NO_OUTCOME);
+    EXPECT_EQ(gate.checkOrder(condition, RiskGate::NO_OUTCOME, Side::BUY, 0.50, 10), RiskCheck::UNREGISTERED);
+}
+
+TEST(RiskGateTest, RateLimitAllowsBurstThenThrottles) {
+    RiskLimits limits = testLimits();
+    limits.max_orders_per_second = 1.0;
+    limits.order_burst = 3.0;
+    RiskGate gate(limits);
+    auto condition = gate.registerCondition("condition_a");
+    uint32_t yes = gate.registerOutcome(condition);
+
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(gate.checkOrder(condition, yes, Side::BUY, 0.50, 10), RiskCheck::OK);
+    }
+    EXPECT_EQ(gate.checkOrder(condition, yes, Side::BUY, 0.50, 10), RiskCheck::RATE_LIMIT);
+}
+
+TEST(RiskGateTest, KillSwitchBlocksEverything) {
+    RiskGate gate(testLimits());
+    auto condition = gate.registerCondition("condition_a");
+    uint32_t yes = gate.registerOutcome(condition);
+    EXPECT_TRUE(gate.kill());
+    EXPECT_FALSE(gate.kill());
+    EXPECT_EQ(gate.checkOrder(condition, yes, Side::SELL, 0.50, 10), RiskCheck::KILL_SWITCH);
+
+    gate.reset();
+    EXPECT_EQ(gate.checkOrder(condition, yes, Side::SELL, 0.50, 10), RiskCheck::OK);
+}
+
+TEST(RiskGateTest, OrderManagerReportsWorkingNotional) {
+    EventQueue queue;
+    RiskGate gate(testLimits());
+    OrderManager om(queue, TradingMode::PAPER);
+    om.setRiskGate(&gate);
+    auto condition = gate.registerCondition("condition_a");
+    om.setRiskCondition("token_a", condition);
+
+    OrderId bid = om.placeOrder("token_a", Side::BUY, 0.40, 100, "market_a");
+    om.placeOrder("token_a", Side::SELL, 0.60, 50, "market_a");
+    EXPECT_DOUBLE_EQ(gate.conditionExposure(condition).working_buy, 40.0);
+    EXPECT_DOUBLE_EQ(gate.conditionExposure(condition).working_sell, 30.0);
+
+    // A partial fill releases its share, the cancel the rest
+    OrderBook book("token_a");
+    book.updateBid(0.38, 100);
+    book.updateAsk(0.40, 25);
+    om.updateOrderBook("token_a", book);
+    EXPECT_DOUBLE_EQ(gate.conditionExposure(condition).working_buy, 30.0);
+
+    om.cancelOrder(bid, "market_a");
+    om.cancelAllOrders("token_a", "market_a");
+    EXPECT_DOUBLE_EQ(gate.totalExposure().working_buy, 0.0);
+    EXPECT_DOUBLE_EQ(gate.totalExposure().working_sell, 0.0);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "utils/market_summary_logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+
+using namespace pmm;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Brute-force statistics over the samples the window should hold
+struct Expected {
+    double mean = 0, stddev = 0, max = 0, min = 0, slope = 0;
+};
+
+Expected compute(const std::deque<double>& values) {
+    Expected e;
+    if (values.empty()) return e;
+    double n = values.size();
+    for (double v : values) e.mean += v;
+    e.mean /= n;
+    e.max = *std::max_element(values.begin(), values.end());
+    e.min = *std::min_element(values.begin(), values.end());
+    if (values.size() < 2) return e;
+
+    double sq = 0, sum_x = 0, sum_xy = 0, sum_x2 = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        sq += (values[i] - e.mean) * (values[i] - e.mean);
+        sum_x += i;
+        sum_xy += i * values[i];
+        sum_x2 += static_cast<double>(i) * i;
+    }
+    e.stddev = std::sqrt(sq / n);
+    e.slope = (n * sum_xy - sum_x * e.mean * n) / (n * sum_x2 - sum_x * sum_x);
+    return e;
+}
+
+} // namespace
+
+TEST(RollingWindowTest, EmptyAndSingleSample) {
+    RollingWindow window(10s);
+    EXPECT_EQ(window.size(), 0u);
+    EXPECT_EQ(window.mean(), 0.0);
+    EXPECT_EQ(window.max(), 0.0);
+    EXPECT_EQ(window.back(), 0.0);
+
+    window.add(0.45, std::chrono::steady_clock::now());
+    EXPECT_DOUBLE_EQ(window.mean(), 0.45);
+    EXPECT_EQ(window.stddev(), 0.0);
+    EXPECT_EQ(window.slope(), 0.0);
+    EXPECT_DOUBLE_EQ(window.min(), 0.45);
+    EXPECT_DOUBLE_EQ(window.front(), 0.45);
+}
+
+TEST(RollingWindowTest, ExpiresByTime) {
+    RollingWindow window(10s);
+    auto t0 = std::chrono::steady_clock::time_point{} + 1h;
+    window.add(0.9, t0);
+    window.add(0.1, t0 + 5s);
+    window.add(0.5, t0 + 8s);
+    EXPECT_DOUBLE_EQ(window.max(), 0.9);
+
+    window.add(0.4, t0 + 12s);  // 0.9 is now older than 10s
+    EXPECT_EQ(window.size(), 3u);
+    EXPECT_DOUBLE_EQ(window.max(), 0.5);
+    EXPECT_DOUBLE_EQ(window.min(), 0.1);
+    EXPECT_DOUBLE_EQ(window.front(), 0.1);
+
+    window.cleanup(t0 + 30s);
+    EXPECT_EQ(window.size(), 0u);
+    EXPECT_EQ(window.mean(), 0.0);
+}
+
+TEST(RollingWindowTest, MatchesBruteForce) {
+    RollingWindow window(60s);
+    std::deque<std::pair<double, std::chrono::steady_clock::time_point>> reference;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> step(-0.005, 0.005);
+    std::uniform_int_distribution<int> gap_ms(0, 400);
+
+    auto now = std::chrono::steady_clock::time_point{} + 1h;
+    double price = 0.5;
+    for (int i = 0; i < 20000; i++) {
+        // Quiet stretches let the window drain by time; bursts fill it
+        now += std::chrono::milliseconds(i % 5000 < 2500 ? gap_ms(rng) / 10 : gap_ms(rng) * 50);
+        price = std::clamp(price + step(rng), 0.01, 0.99);
+
+        window.add(price, now);
+        reference.push_back({price, now});
+        while (reference.size() > RollingWindow::MAX_SAMPLES ||
+               now - reference.front().second > 60s) {
+            reference.pop_front();
+        }
+
+        if (i % 97 != 0) continue;
+        std::deque<double> values;
+        for (const auto& [v, t] : reference) values.push_back(v);
+        Expected e = compute(values);
+        ASSERT_EQ(window.size(), values.size()) << i;
+        EXPECT_NEAR(window.mean(), e.mean, 1e-12) << i;
+        EXPECT_NEAR(window.stddev(), e.stddev, 1e-9) << i;
+        EXPECT_NEAR(window.slope(), e.slope, 1e-9) << i;
+        EXPECT_EQ(window.max(), e.max) << i;
+        EXPECT_EQ(window.min(), e.min) << i;
+        EXPECT_EQ(window.front(), values.front()) << i;
+    }
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "core/seqlock.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace pmm;
+
+namespace {
+
+struct Snapshot {
+    int64_t a = 0;
+    int64_t b = 0;
+    double c = 0.0;
+    uint32_t d = 0;
+};
+
+} // namespace
+
+TEST(SeqLockTest, DefaultValue) {
+    SeqLock<Snapshot> lock;
+    Snapshot s = lock.load();
+    EXPECT_EQ(s.a, 0);
+    EXPECT_EQ(s.b, 0);
+    EXPECT_EQ(lock.version(), 1u);
+}
+
+TEST(SeqLockTest, StoreThenLoad) {
+    SeqLock<Snapshot> lock;
+    lock.store({7, -7, 1.5, 3});
+    
+    Snapshot s = lock.load();
+    EXPECT_EQ(s.a, 7);
+    EXPECT_EQ(s.b, -7);
+    EXPECT_DOUBLE_EQ(s.c, 1.5);
+    EXPECT_EQ(s.d, 3u);
+    EXPECT_EQ(lock.version(), 2u);
+}
+
+TEST(SeqLockTest, ReadersNeverSeeTornWrites) {
+    SeqLock<Snapshot> lock;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; r++) {
+        readers.emplace_back([&]() {
+            int64_t last = 0;
+            while (!done.load()) {
+                Snapshot s = lock.load();
+                if (s.b != -s.a || s.c != static_cast<double>(s.a) || s.a < last) {
+                    torn++;
+                }
+                last = s.a;
+            }
+        });
+    }
+    
+    for (int64_t i = 1; i <= 200000; i++) {
+        lock.store({i, -i, static_cast<double>(i), static_cast<uint32_t>(i)});
+    }
+    done = true;
+    
+    for (auto& t : readers) {
+        t.join();
+    }
+    
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(lock.load().a, 200000);
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "strategy/strategy_engine.hpp"
 #include "core/event_queue.hpp"
+#include <atomic>
 #include <thread>
 #include <chrono>
 
@@ -54,6 +55,102 @@ TEST_F(StrategyEngineTest, ProcessBookSnapshot) {
     SUCCEED();
 }
 
+TEST_F(StrategyEngineTest, PublishesStatsSnapshot) {
+    std::string token = "test_token_123";
+    strategy->registerMarket(token, "Test Event", "Test Market", "12345", "condition_123");
+    strategy->start();
+    
+    std::vector<std::pair<Price, Size>> bids = {{0.50, 1000.0}, {0.49, 500.0}};
+    std::vector<std::pair<Price, Size>> asks = {{0.51, 800.0}, {0.52, 1200.0}};
+    
+    queue->push(Event::bookSnapshot(token, bids, asks));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    
+    EngineStats stats = strategy->getStats();
+    EXPECT_GT(stats.cycle, 0u);
+    EXPECT_EQ(stats.bid_count, 1u);
+    EXPECT_EQ(stats.ask_count, 1u);
+    EXPECT_EQ(stats.active_order_count, 2u);
+    EXPECT_EQ(stats.active_market_count, 1u);
+    EXPECT_GT(stats.average_spread, 0.0);
+}
+
+TEST_F(StrategyEngineTest, KillSwitchCancelsAndBlocksOrders) {
+    std::string token = "test_token_123";
+    strategy->registerMarket(token, "Test Event", "Test Market", "12345", "condition_123");
+    strategy->start();
+    
+    std::vector<std::pair<Price, Size>> bids = {{0.50, 1000.0}, {0.49, 500.0}};
+    std::vector<std::pair<Price, Size>> asks = {{0.51, 800.0}, {0.52, 1200.0}};
+    
+    queue->push(Event::bookSnapshot(token, bids, asks));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ(strategy->getStats().active_order_count, 2u);
+    EXPECT_GT(strategy->getRiskExposure().working_buy, 0.0);
+    
+    strategy->triggerKillSwitch();
+    EXPECT_TRUE(strategy->isKilled());
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(strategy->getStats().active_order_count, 0u);
+    
+    // New market data no longer produces orders
+    queue->push(Event::bookSnapshot(token, {{0.47, 1000.0}}, {{0.53, 800.0}}));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(strategy->getStats().active_order_count, 0u);
+    EXPECT_DOUBLE_EQ(strategy->getRiskExposure().working_buy, 0.0);
+}
+
+TEST_F(StrategyEngineTest, QuotesBothOutcomesOfACondition) {
+    strategy->registerMarket("yes_token", "Test Event", "Yes", "12345", "condition_123");
+    strategy->registerMarket("no_token", "Test Event", "No", "12345", "condition_123");
+    strategy->start();
+    
+    queue->push(Event::bookSnapshot("yes_token", {{0.60, 1000.0}}, {{0.64, 800.0}}));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    
+    // One book is enough to quote that outcome alone
+    EXPECT_EQ(strategy->getStats().active_order_count, 2u);
+    
+    queue->push(Event::bookSnapshot("no_token", {{0.34, 1000.0}}, {{0.38, 800.0}}));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    
+    EngineStats stats = strategy->getStats();
+    EXPECT_EQ(stats.bid_count, 2u);
+    EXPECT_EQ(stats.ask_count, 2u);
+    EXPECT_EQ(stats.active_market_count, 1u);
+}
+
+TEST_F(StrategyEngineTest, ConfigurationWhileRunningIsQueued) {
+    strategy->start();
+    
+    // Dashboard-style reader running alongside the strategy thread
+    std::atomic<bool> done{false};
+    std::thread reader([&]() {
+        while (!done.load()) {
+            EngineStats stats = strategy->getStats();
+            EXPECT_LE(stats.bid_count + stats.ask_count, stats.active_order_count);
+        }
+    });
+    
+    std::string token = "test_token_123";
+    strategy->registerMarket(token, "Test Event", "Test Market", "12345", "condition_123");
+    strategy->setEventEndTime("condition_123", std::chrono::system_clock::now() + std::chrono::hours(48));
+    
+    std::vector<std::pair<Price, Size>> bids = {{0.50, 1000.0}, {0.49, 500.0}};
+    std::vector<std::pair<Price, Size>> asks = {{0.51, 800.0}, {0.52, 1200.0}};
+    for (int i = 0; i < 50; i++) {
+        queue->push(Event::bookSnapshot(token, bids, asks));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    
+    done = true;
+    reader.join();
+    
+    EngineStats stats = strategy->getStats();
+    EXPECT_EQ(stats.active_market_count, 1u);
+    EXPECT_EQ(stats.active_order_count, 2u);
+}
+
 TEST_F(StrategyEngineTest, PaperTradingSimulation) {
     std::string villa_token = "44623110248227182263524920709598432835467185438698898378400926229226251167932";
     
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include "strategy/token_slots.hpp"
+
+using namespace pmm;
+
+class TokenSlotTableTest : public ::testing::Test {
+protected:
+    TokenSlotTable table;
+};
+
+TEST_F(TokenSlotTableTest, UnknownTokenHasNoHandle) {
+    EXPECT_EQ(table.find("missing"), INVALID_TOKEN_HANDLE);
+    EXPECT_TRUE(table.empty());
+}
+
+TEST_F(TokenSlotTableTest, HandlesAreDenseAndStable) {
+    TokenHandle a = table.findOrCreate("token_a");
+    TokenHandle b = table.findOrCreate("token_b");
+    
+    EXPECT_EQ(a, 0u);
+    EXPECT_EQ(b, 1u);
+    EXPECT_EQ(table.findOrCreate("token_a"), a);
+    EXPECT_EQ(table.find("token_b"), b);
+    EXPECT_EQ(table.size(), 2u);
+    EXPECT_EQ(table[b].token_id, "token_b");
+    EXPECT_EQ(table[b].display_name, "token_b");  // Until the market is registered
+}
+
+TEST_F(TokenSlotTableTest, ColumnsGrowWithSlots) {
+    TokenHandle a = table.findOrCreate("token_a");
+    table.findOrCreate("token_b");
+    
+    auto& cols = table.columns();
+    EXPECT_EQ(cols.quantity.size(), 2u);
+    EXPECT_EQ(cols.mid.size(), 2u);
+    
+    cols.quantity[a] = 50.0;
+    table.findOrCreate("token_c");
+    EXPECT_DOUBLE_EQ(table.columns().quantity[a], 50.0);
+}
+
+TEST_F(TokenSlotTableTest, RefreshBookColumns) {
+    TokenHandle h = table.findOrCreate("token_a");
+    
+    table.refreshBookColumns(h);
+    EXPECT_DOUBLE_EQ(table.columns().mid[h], 0.0);
+    
+    table[h].book.updateBid(0.50, 100);
+    table[h].book.updateAsk(0.52, 100);
+    table.refreshBookColumns(h);
+    
+    EXPECT_NEAR(table.columns().mid[h], 0.51, 1e-9);
+    EXPECT_NEAR(table.columns().spread_pct[h], 0.02 / 0.51, 1e-9);
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "strategy/trade_flow.hpp"
+
+using namespace pmm;
+using namespace std::chrono_literals;
+
+class TradeFlowTest : public ::testing::Test {
+protected:
+    TradeFlow flow{100.0};
+    TradeFlow::Clock::time_point start = TradeFlow::Clock::time_point{} + 1000s;
+};
+
+TEST_F(TradeFlowTest, AggregatesTheLastMinute) {
+    flow.onTrade(0.50, 30.0, Side::BUY, start);
+    flow.onTrade(0.52, 10.0, Side::SELL, start + 10s);
+    EXPECT_EQ(flow.tradeCount(), 2u);
+    EXPECT_DOUBLE_EQ(flow.volume(), 40.0);
+    EXPECT_DOUBLE_EQ(flow.signedVolume(), 20.0);
+    EXPECT_DOUBLE_EQ(flow.imbalance(), 0.5);
+    EXPECT_DOUBLE_EQ(flow.vwap(), (0.50 * 30.0 + 0.52 * 10.0) / 40.0);
+    EXPECT_DOUBLE_EQ(flow.volumeRate(), 40.0 / 60.0);
+
+    // The first trade leaves the window a minute later
+    flow.onTrade(0.51, 5.0, Side::BUY, start + 60s);
+    EXPECT_EQ(flow.tradeCount(), 2u);
+    EXPECT_DOUBLE_EQ(flow.volume(), 15.0);
+    EXPECT_DOUBLE_EQ(flow.signedVolume(), -5.0);
+    EXPECT_DOUBLE_EQ(flow.lastPrice(), 0.51);
+    EXPECT_EQ(flow.totalTrades(), 3u);
+}
+
+TEST_F(TradeFlowTest, SplitsLargeTradesAcrossVolumeBuckets) {
+    flow.onTrade(0.50, 60.0, Side::BUY, start);
+    EXPECT_EQ(flow.completedVolumeBuckets(), 0u);
+
+    // Fills the first bucket 60/40 and a second entirely with sells
+    flow.onTrade(0.49, 140.0, Side::SELL, start + 20s);
+    ASSERT_EQ(flow.completedVolumeBuckets(), 2u);
+    EXPECT_DOUBLE_EQ(flow.vpin(), (20.0 + 100.0) / 200.0);
+    EXPECT_DOUBLE_EQ(flow.secondsPerVolumeBucket(), 10.0);
+}
+
+TEST_F(TradeFlowTest, SessionRateCoversAtLeastAWindow) {
+    EXPECT_DOUBLE_EQ(flow.sessionVolumeRate(), 0.0);
+    flow.onTrade(0.50, 60.0, Side::BUY, start);
+    EXPECT_DOUBLE_EQ(flow.sessionVolumeRate(), 1.0);
+
+    flow.onTrade(0.50, 60.0, Side::BUY, start + 120s);
+    EXPECT_DOUBLE_EQ(flow.sessionVolumeRate(), 1.0);
+    EXPECT_DOUBLE_EQ(flow.volumeRate(), 1.0);
+}
+
+TEST_F(TradeFlowTest, AdvanceAgesTheWindowWithoutTrades) {
+    flow.advance(start);  // Nothing to age yet
+    EXPECT_DOUBLE_EQ(flow.sessionVolumeRate(), 0.0);
+
+    flow.onTrade(0.50, 60.0, Side::BUY, start);
+    flow.advance(start + 30s);
+    EXPECT_DOUBLE_EQ(flow.volume(), 60.0);
+
+    flow.advance(start + 60s);
+    EXPECT_EQ(flow.tradeCount(), 0u);
+    EXPECT_DOUBLE_EQ(flow.volumeRate(), 0.0);
+    EXPECT_DOUBLE_EQ(flow.lastPrice(), 0.50);
+
+    // The quiet stretch counts toward the session average
+    flow.advance(start + 120s);
+    EXPECT_DOUBLE_EQ(flow.sessionVolumeRate(), 0.5);
+}
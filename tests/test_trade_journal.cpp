@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include "utils/journal_csv_writer.hpp"
+#include "utils/trade_journal.hpp"
+#include "utils/trading_logger.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace pmm;
+
+TEST(TradeJournalTest, EncodesAndDecodesARecord) {
+    FillAdverseSelectionRecord payload{42, 1, 0.51, 0.52, 0.48};
+    std::string market = "MARKET_001";
+    size_t length = journal::encodedSize(payload, market, std::string_view("TOKEN"));
+    EXPECT_EQ(length % journal::ALIGNMENT, 0u);
+
+    std::vector<char> buffer(length);
+    journal::encode(buffer.data(), JournalRecordType::FILL_ADVERSE_SELECTION, 123, payload,
+                    market, std::string_view("TOKEN"));
+
+    JournalRecordView record;
+    ASSERT_TRUE(journal::decode(buffer.data(), buffer.size(), record));
+    EXPECT_EQ(record.header->type, JournalRecordType::FILL_ADVERSE_SELECTION);
+    EXPECT_EQ(record.header->time_ns, 123);
+    EXPECT_EQ(record.as<FillAdverseSelectionRecord>().order_id, 42u);
+    EXPECT_DOUBLE_EQ(record.as<FillAdverseSelectionRecord>().mid_30s, 0.48);
+    EXPECT_EQ(record.strings[0], "MARKET_001");
+    EXPECT_EQ(record.strings[1], "TOKEN");
+
+    // Cut short, as at the end of a journal whose writer died
+    EXPECT_FALSE(journal::decode(buffer.data(), buffer.size() - 8, record));
+}
+
+TEST(TradeJournalTest, EncodingIsDeterministic) {
+    OrderFilledRecord payload{7, 1, 0.50, 100.0, 0.0, 0.50, 0.505, 1.0, Side::SELL};
+    size_t length = journal::encodedSize(payload, std::string_view("MKT"), std::string_view("TOKEN_1"));
+
+    // Whatever the ring held before, every gap comes out zero
+    std::vector<char> dirty(length, '\xAB');
+    std::vector<char> clean(length, 0);
+    for (std::vector<char>* buffer : {&dirty, &clean}) {
+        journal::encode(buffer->data(), JournalRecordType::ORDER_FILLED, 5, payload,
+                        std::string_view("MKT"), std::string_view("TOKEN_1"));
+    }
+    EXPECT_EQ(dirty, clean);
+}
+
+TEST(TradeJournalTest, LongStringsAreCutToTheEncodedLength) {
+    FillAdverseSelectionRecord payload{1, 1, 0.5, 0.5, 0.5};
+    std::string long_name(70000, 'x');
+    size_t length = journal::encodedSize(payload, long_name);
+
+    std::vector<char> buffer(length);
+    journal::encode(buffer.data(), JournalRecordType::FILL_ADVERSE_SELECTION, 0, payload, long_name);
+
+    JournalRecordView record;
+    ASSERT_TRUE(journal::decode(buffer.data(), buffer.size(), record));
+    EXPECT_EQ(record.header->length, length);
+    EXPECT_EQ(record.strings[0].size(), size_t{UINT16_MAX});
+}
+
+TEST(TradeJournalTest, RingWrapsWithPadding) {
+    JournalRing ring(256);
+    FillAdverseSelectionRecord payload{0, 0, 0.5, 0.5, 0.5};
+    size_t length = journal::encodedSize(payload);  // 56 bytes, so the fifth record wraps
+
+    for (uint64_t id = 1; id <= 20; id++) {
+        payload.order_id = id;
+        char* slot = ring.tryReserve(length);
+        ASSERT_NE(slot, nullptr);
+        journal::encode(slot, JournalRecordType::FILL_ADVERSE_SELECTION, 0, payload);
+        ring.commit(length);
+
+        const char* data = ring.peek();
+        ASSERT_NE(data, nullptr);
+        JournalRecordView record;
+        ASSERT_TRUE(journal::decode(data, length, record));
+        EXPECT_EQ(record.as<FillAdverseSelectionRecord>().order_id, id);
+        ring.release();
+        EXPECT_EQ(ring.peek(), nullptr);
+    }
+}
+
+TEST(TradeJournalTest, FullRingRefusesUntilReleased) {
+    JournalRing ring(256);
+    FillAdverseSelectionRecord payload{0, 0, 0.5, 0.5, 0.5};
+    size_t length = journal::encodedSize(payload);
+
+    int reserved = 0;
+    while (char* slot = ring.tryReserve(length)) {
+        journal::encode(slot, JournalRecordType::FILL_ADVERSE_SELECTION, 0, payload);
+        ring.commit(length);
+        reserved++;
+    }
+    EXPECT_EQ(reserved, 4);  // 4 * 56 of 256 bytes
+
+    // Releasing one record makes room for the next, padding included
+    ASSERT_NE(ring.peek(), nullptr);
+    ring.release();
+    char* slot = ring.tryReserve(length);
+    ASSERT_NE(slot, nullptr);
+    journal::encode(slot, JournalRecordType::FILL_ADVERSE_SELECTION, 0, payload);
+    ring.commit(length);
+    EXPECT_EQ(ring.tryReserve(length), nullptr);
+
+    int drained = 0;
+    while (ring.peek()) {
+        ring.release();
+        drained++;
+    }
+    EXPECT_EQ(drained, 4);
+    EXPECT_EQ(ring.releasedBytes(), ring.committedBytes());
+}
+
+class TradeJournalFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir = std::filesystem::temp_directory_path() / "pmm_test_trade_journal";
+        std::filesystem::remove_all(test_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir);
+    }
+
+    // Logs the same session through a logger of the given format
+    std::filesystem::path logSession(JournalFormat format, const std::string& name) {
+        TradingLogger logger(test_dir / name, format);
+        logger.startSession("Test Event");
+
+        Order order;
+        order.order_id = 123;
+        order.token_id = "TOKEN_XYZ";
+        order.side = Side::BUY;
+        order.price = 0.55;
+        order.size = 100.0;
+        logger.logOrderPlaced(order, "MARKET_001", 0.50, 0.04, 0.48, 0.52, 0.48, 0.52);
+        logger.logOrderCancelled(123, order, "MARKET_001", CancelReason::TTL_EXPIRED);
+        logger.logOrderFilled("MARKET_001", 124, 1, "TOKEN_XYZ", 0.50, 100.0, Side::BUY, 0.0, 0.50, 0.505, 1.0);
+        logger.updateFillAdverseSelection(124, 1, 0.51, 0.52, 0.48);
+        logger.logPosition("MARKET_001", "TOKEN_XYZ", 100.0, 0.50, fixed_time, fixed_time, Side::BUY, 1, 50.0);
+        logger.logPriceUpdate("Will it happen?", "MARKET_001", "0xCOND", "TOKEN_XYZ", 0.505, 0.1, 0.0005,
+                              0.50, 0.51, 0.01, 198.0, 1000.0, 800.0, 1800.0, 0.11, 5, 4, 100.0, 12.0, 0.5);
+        logger.logFillMarkout("MARKET_001", "TOKEN_XYZ", 124, 1, fixed_time, Side::BUY,
+                              0.50, 0.505, 0.0, 100.0, 0.52, 0.48);
+        logger.endSession();
+        return logger.getSessionDir();
+    }
+
+    // Everything but the timestamp column, which depends on when the line was logged
+    static std::string readWithoutTimestamps(const std::filesystem::path& file) {
+        std::ifstream in(file);
+        std::stringstream out;
+        std::string line;
+        while (std::getline(in, line)) {
+            out << line.substr(line.find(',')) << "\n";
+        }
+        return out.str();
+    }
+
+    std::filesystem::path test_dir;
+    std::chrono::system_clock::time_point fixed_time = std::chrono::system_clock::from_time_t(1700000000);
+};
+
+TEST_F(TradeJournalFileTest, BinaryJournalConvertsToTheSameCsvs) {
+    std::filesystem::path csv_dir = logSession(JournalFormat::CSV, "csv");
+    std::filesystem::path binary_dir = logSession(JournalFormat::BINARY, "binary");
+    EXPECT_FALSE(std::filesystem::exists(binary_dir / "orders.csv"));
+
+    JournalCsvWriter writer(binary_dir);
+    size_t records = journal::readFile(binary_dir / "journal.bin", [&](const JournalRecordView& record) {
+        writer.write(record);
+    });
+    writer.flush();
+    EXPECT_EQ(records, 7u);
+
+    for (const char* name : {"orders.csv", "fills.csv", "positions.csv", "price_updates.csv", "fill_markouts.csv"}) {
+        SCOPED_TRACE(name);
+        std::string expected = readWithoutTimestamps(csv_dir / name);
+        EXPECT_EQ(readWithoutTimestamps(binary_dir / name), expected);
+        EXPECT_GT(std::count(expected.begin(), expected.end(), '\n'), 1);
+    }
+    EXPECT_NE(readWithoutTimestamps(binary_dir / "fills.csv").find(",0.510000,0.520000,0.480000,+0000099.01"),
+              std::string::npos);
+}
+
+TEST_F(TradeJournalFileTest, RejectsFilesThatAreNotJournals) {
+    std::filesystem::create_directories(test_dir);
+    std::ofstream(test_dir / "orders.csv") << "timestamp,market_id\n";
+    auto ignore = [](const JournalRecordView&) {};
+    EXPECT_THROW(journal::readFile(test_dir / "orders.csv", ignore), std::runtime_error);
+    EXPECT_THROW(journal::readFile(test_dir / "missing.bin", ignore), std::runtime_error);
+}
+
+TEST_F(TradeJournalFileTest, DropsFillRowsWhoseMarkoutsNeverCame) {
+    std::filesystem::create_directories(test_dir);
+    JournalCsvWriter writer(test_dir);
+    std::vector<char> buffer;
+    auto write = [&](JournalRecordType type, int64_t time_ns, const auto& payload, auto... strings) {
+        buffer.resize(journal::encodedSize(payload, strings...));
+        journal::encode(buffer.data(), type, time_ns, payload, strings...);
+        JournalRecordView record;
+        ASSERT_TRUE(journal::decode(buffer.data(), buffer.size(), record));
+        writer.write(record);
+    };
+
+    const int64_t second = 1'000'000'000;
+    const int64_t start = 1700000000 * second;
+    OrderFilledRecord fill{124, 1, 0.50, 100.0, 0.0, 0.50, 0.505, 1.0, Side::BUY};
+    write(JournalRecordType::ORDER_FILLED, start, fill, std::string_view("MARKET_001"), std::string_view("TOKEN"));
+    fill.fill_seq = 2;
+    write(JournalRecordType::ORDER_FILLED, start + 600 * second, fill,
+          std::string_view("MARKET_001"), std::string_view("TOKEN"));
+
+    // The first fill's row was given up on when the second came in
+    write(JournalRecordType::FILL_ADVERSE_SELECTION, start + 601 * second,
+          FillAdverseSelectionRecord{124, 1, 0.51, 0.52, 0.48});
+    write(JournalRecordType::FILL_ADVERSE_SELECTION, start + 601 * second,
+          FillAdverseSelectionRecord{124, 2, 0.40, 0.40, 0.40});
+    writer.flush();
+
+    std::string fills = readWithoutTimestamps(test_dir / "fills.csv");
+    EXPECT_EQ(fills.find(",0.510000,0.520000,0.480000,"), std::string::npos);
+    EXPECT_NE(fills.find(",0.400000,0.400000,0.400000,"), std::string::npos);
+}
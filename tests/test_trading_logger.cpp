@@ -28,7 +28,10 @@ protected:
     std::string test_dir;
     std::unique_ptr<TradingLogger> logger;
     
+    // Log calls return before the writer thread gets to them, so the
+    // file helpers wait for it first
     bool fileContainsString(const std::filesystem::path& file, const std::string& str) {
+        logger->flush();
         if (!std::filesystem::exists(file)) return false;
         std::ifstream f(file);
         std::string line;
@@ -41,6 +44,7 @@ protected:
     }
     
     int countLinesInFile(const std::filesystem::path& file) {
+        logger->flush();
         if (!std::filesystem::exists(file)) return 0;
         std::ifstream f(file);
         int count = 0;
@@ -78,7 +82,7 @@ TEST_F(TradingLoggerTest, LogOrderPlaced) {
     logger->startSession("Test Event");
     
     Order order;
-    order.order_id = "ORDER_123";
+    order.order_id = 123;
     order.token_id = "TOKEN_XYZ";
     order.side = Side::BUY;
     order.price = 0.55;
@@ -89,7 +93,7 @@ TEST_F(TradingLoggerTest, LogOrderPlaced) {
     std::string session_id = logger->getSessionId();
     std::filesystem::path orders_file = std::filesystem::path(test_dir) / session_id / "orders.csv";
     
-    EXPECT_TRUE(fileContainsString(orders_file, "ORDER_123"));
+    EXPECT_TRUE(fileContainsString(orders_file, "ORD_123"));
     EXPECT_TRUE(fileContainsString(orders_file, "TOKEN_XYZ"));
     EXPECT_TRUE(fileContainsString(orders_file, "BUY"));
     EXPECT_TRUE(fileContainsString(orders_file, "0.55"));
@@ -101,30 +105,30 @@ TEST_F(TradingLoggerTest, LogOrderCancelled) {
     logger->startSession("Test Event");
     
     Order order;
-    order.order_id = "ORDER_456";
+    order.order_id = 456;
     order.token_id = "TOKEN_ABC";
     order.side = Side::SELL;
     order.price = 0.45;
     order.size = 200.0;
     
-    logger->logOrderCancelled("ORDER_456", order, "MARKET_002");
+    logger->logOrderCancelled(456, order, "MARKET_002");
     
     std::string session_id = logger->getSessionId();
     std::filesystem::path orders_file = std::filesystem::path(test_dir) / session_id / "orders.csv";
     
-    EXPECT_TRUE(fileContainsString(orders_file, "ORDER_456"));
+    EXPECT_TRUE(fileContainsString(orders_file, "ORD_456"));
     EXPECT_TRUE(fileContainsString(orders_file, "CANCELLED"));
 }
 
 TEST_F(TradingLoggerTest, LogOrderFilled) {
     logger->startSession("Test Event");
     
-    logger->logOrderFilled("MARKET_003", "ORDER_789", "TOKEN_DEF", 0.60, 150.0, Side::BUY, 25.50, 0.59, 0.60, 5.5);
+    logger->logOrderFilled("MARKET_003", 789, 1, "TOKEN_DEF", 0.60, 150.0, Side::BUY, 25.50, 0.59, 0.60, 5.5);
     
     std::string session_id = logger->getSessionId();
     std::filesystem::path fills_file = std::filesystem::path(test_dir) / session_id / "fills.csv";
     
-    EXPECT_TRUE(fileContainsString(fills_file, "ORDER_789"));
+    EXPECT_TRUE(fileContainsString(fills_file, "ORD_789"));
     EXPECT_TRUE(fileContainsString(fills_file, "TOKEN_DEF"));
     EXPECT_TRUE(fileContainsString(fills_file, "BUY"));
     EXPECT_TRUE(fileContainsString(fills_file, "0.6"));
@@ -132,6 +136,66 @@ TEST_F(TradingLoggerTest, LogOrderFilled) {
     EXPECT_TRUE(fileContainsString(fills_file, "25.5"));
 }
 
+TEST_F(TradingLoggerTest, LogFillMarkout) {
+    logger->startSession("Test Event");
+    
+    logger->logFillMarkout("MARKET_003", "TOKEN_DEF", 789, 42, std::chrono::system_clock::now(), Side::BUY,
+                           0.50, 0.505, 0.0, 100.0, 0.52, 0.48);
+    
+    std::string session_id = logger->getSessionId();
+    std::filesystem::path markouts_file = std::filesystem::path(test_dir) / session_id / "fill_markouts.csv";
+    
+    EXPECT_EQ(countLinesInFile(markouts_file), 2);
+    EXPECT_TRUE(fileContainsString(markouts_file, "markout_30s_bps"));
+    EXPECT_TRUE(fileContainsString(markouts_file, "TOKEN_DEF,ORD_789,42,BUY"));
+    // BUY with the mid at 0.505, mid moves to 0.52 then 0.48
+    EXPECT_TRUE(fileContainsString(markouts_file, ",297.03,-495.05"));
+}
+
+TEST_F(TradingLoggerTest, UpdateFillAdverseSelectionRewritesTheFillRow) {
+    logger->startSession("Test Event");
+
+    logger->logOrderFilled("MARKET_003", 789, 1, "TOKEN_DEF", 0.50, 100.0, Side::BUY, 0.0, 0.50, 0.505, 1.0);
+    logger->logOrderFilled("MARKET_003", 790, 2, "TOKEN_DEF", 0.51, 100.0, Side::SELL, 0.0, 0.51, 0.505, 1.0);
+    logger->updateFillAdverseSelection(789, 1, 0.51, 0.52, 0.48);
+    logger->updateFillAdverseSelection(789, 1, 0.90, 0.90, 0.90);  // Already written
+    logger->endSession();
+
+    std::string session_id = logger->getSessionId();
+    std::filesystem::path fills_file = std::filesystem::path(test_dir) / session_id / "fills.csv";
+
+    EXPECT_EQ(countLinesInFile(fills_file), 3);
+    EXPECT_TRUE(fileContainsString(fills_file, "ORD_789,TOKEN_DEF,BUY,0.5,100,0,0.5,0,0.505,"));
+    // BUY at 0.50, marked out from the 0.505 mid
+    EXPECT_TRUE(fileContainsString(fills_file, ",0.510000,0.520000,0.480000,+0000099.01,+0000297.03,-0000495.05"));
+    // The next row is intact
+    EXPECT_TRUE(fileContainsString(fills_file, "ORD_790,TOKEN_DEF,SELL"));
+    EXPECT_TRUE(fileContainsString(fills_file, ",0.000000,0.000000,0.000000,+0000000.00,+0000000.00,+0000000.00"));
+}
+
+TEST_F(TradingLoggerTest, PartialFillsOfAnOrderKeepTheirOwnMarkouts) {
+    logger->startSession("Test Event");
+
+    logger->logOrderFilled("MARKET_003", 789, 1, "TOKEN_DEF", 0.50, 40.0, Side::BUY, 0.0, 0.50, 0.505, 1.0);
+    logger->logOrderFilled("MARKET_003", 789, 2, "TOKEN_DEF", 0.50, 60.0, Side::BUY, 0.0, 0.50, 0.505, 2.0);
+    logger->updateFillAdverseSelection(789, 2, 0.40, 0.40, 0.40);
+    logger->updateFillAdverseSelection(789, 1, 0.51, 0.52, 0.48);
+    logger->endSession();
+
+    std::string session_id = logger->getSessionId();
+    std::filesystem::path fills_file = std::filesystem::path(test_dir) / session_id / "fills.csv";
+
+    std::ifstream in(fills_file);
+    std::string header, first, second;
+    std::getline(in, header);
+    std::getline(in, first);
+    std::getline(in, second);
+    EXPECT_NE(first.find(",40,"), std::string::npos);
+    EXPECT_NE(first.find(",0.510000,0.520000,0.480000,"), std::string::npos);
+    EXPECT_NE(second.find(",60,"), std::string::npos);
+    EXPECT_NE(second.find(",0.400000,0.400000,0.400000,"), std::string::npos);
+}
+
 TEST_F(TradingLoggerTest, LogPosition) {
     logger->startSession("Test Event");
     
@@ -154,14 +218,14 @@ TEST_F(TradingLoggerTest, MultipleOrders) {
     logger->startSession("Test Event");
     
     Order order1;
-    order1.order_id = "ORDER_1";
+    order1.order_id = 1;
     order1.token_id = "TOKEN_1";
     order1.side = Side::BUY;
     order1.price = 0.50;
     order1.size = 100.0;
     
     Order order2;
-    order2.order_id = "ORDER_2";
+    order2.order_id = 2;
     order2.token_id = "TOKEN_2";
     order2.side = Side::SELL;
     order2.price = 0.60;
@@ -181,7 +245,7 @@ TEST_F(TradingLoggerTest, EndSessionClosesFiles) {
     logger->startSession("Test Event");
     
     Order order;
-    order.order_id = "ORDER_END";
+    order.order_id = 999;
     order.token_id = "TOKEN_END";
     order.side = Side::BUY;
     order.price = 0.55;
@@ -195,13 +259,13 @@ TEST_F(TradingLoggerTest, EndSessionClosesFiles) {
     std::filesystem::path orders_file = std::filesystem::path(test_dir) / session_id / "orders.csv";
     
     EXPECT_TRUE(std::filesystem::exists(orders_file));
-    EXPECT_TRUE(fileContainsString(orders_file, "ORDER_END"));
+    EXPECT_TRUE(fileContainsString(orders_file, "ORD_999"));
 }
 
 TEST_F(TradingLoggerTest, NoSessionNoLogging) {
     // Don't start session
     Order order;
-    order.order_id = "ORDER_NOSESSION";
+    order.order_id = 7;
     order.token_id = "TOKEN_X";
     order.side = Side::BUY;
     order.price = 0.50;
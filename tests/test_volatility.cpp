@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "data/volatility.hpp"
+#include <cmath>
+
+using namespace pmm;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr double ANNUALIZE = 252.0 * 24.0 * 3600.0;  // One-second intervals
+
+const VolatilityEstimator::Clock::time_point START = VolatilityEstimator::Clock::time_point{} + 1000s;
+
+} // namespace
+
+TEST(VolatilityEstimatorTest, StartsFromTheInitialEstimate) {
+    VolatilityEstimator vol;
+    vol.onMid(0.50, START);
+    vol.onMid(0.60, START + 500ms);  // Same interval, nothing closed yet
+
+    EXPECT_DOUBLE_EQ(vol.ewma(), VolatilityEstimator::INITIAL_VOLATILITY);
+    EXPECT_DOUBLE_EQ(vol.quoteVolatility(), VolatilityEstimator::INITIAL_VOLATILITY);
+    EXPECT_DOUBLE_EQ(vol.realized(), 0.0);
+    EXPECT_EQ(vol.windowSamples(), 0u);
+}
+
+TEST(VolatilityEstimatorTest, EstimatesFromClosedIntervals) {
+    VolatilityEstimator vol;
+    vol.onMid(0.50, START);
+    vol.onMid(0.55, START + 1s);  // Closes an unchanged first interval
+    vol.onMid(0.55, START + 2s);  // Closes a 10% move from 0.50 to 0.55
+
+    ASSERT_EQ(vol.windowSamples(), 2u);
+    EXPECT_NEAR(vol.realized(), std::sqrt(0.01 / 2 * ANNUALIZE), 1e-9);
+
+    double range = 2.0 * 0.05 / 1.05;
+    EXPECT_NEAR(vol.parkinson(), std::sqrt(range * range / (4.0 * std::log(2.0)) / 2 * ANNUALIZE), 1e-9);
+
+    double initial_variance = 0.05 * 0.05 / ANNUALIZE;
+    double ewma_variance = 0.94 * (0.94 * initial_variance) + 0.06 * 0.01;
+    EXPECT_NEAR(vol.ewma(), std::sqrt(ewma_variance * ANNUALIZE), 1e-9);
+    EXPECT_DOUBLE_EQ(vol.quoteVolatility(), VolatilityEstimator::MAX_QUOTE_VOLATILITY);
+}
+
+TEST(VolatilityEstimatorTest, UpdateRateDoesNotChangeReturns) {
+    VolatilityEstimator sparse;
+    VolatilityEstimator busy;
+    for (VolatilityEstimator* vol : {&sparse, &busy}) {
+        vol->onMid(0.50, START);
+    }
+    // The busy book bounces around inside the interval but closes at the same mid
+    for (int i = 1; i < 100; i++) {
+        busy.onMid((i % 2) ? 0.48 : 0.53, START + std::chrono::milliseconds(i * 10));
+    }
+    for (VolatilityEstimator* vol : {&sparse, &busy}) {
+        vol->onMid(0.52, START + 990ms);
+        vol->onMid(0.52, START + 1s);
+    }
+
+    EXPECT_DOUBLE_EQ(busy.realized(), sparse.realized());
+    EXPECT_DOUBLE_EQ(busy.ewma(), sparse.ewma());
+    EXPECT_GT(busy.parkinson(), sparse.parkinson());  // Only the range sees the bounces
+}
+
+TEST(VolatilityEstimatorTest, QuietIntervalsCountAsUnchanged) {
+    VolatilityEstimator vol;
+    vol.onMid(0.50, START);
+    vol.onMid(0.55, START + 1s);
+    vol.onMid(0.55, START + 2s);
+    double realized = vol.realized();
+
+    // Intervals 0 to 100 closed, one of them the move
+    vol.onMid(0.55, START + 101s);
+    ASSERT_EQ(vol.windowSamples(), 101u);
+    EXPECT_NEAR(vol.realized(), realized * std::sqrt(2.0 / 101.0), 1e-9);
+
+    // A gap longer than the window leaves only quiet intervals
+    vol.onMid(0.55, START + 1000s);
+    EXPECT_EQ(vol.windowSamples(), VolatilityEstimator::WINDOW);
+    EXPECT_DOUBLE_EQ(vol.realized(), 0.0);
+    EXPECT_DOUBLE_EQ(vol.quoteVolatility(), VolatilityEstimator::MIN_QUOTE_VOLATILITY);
+}